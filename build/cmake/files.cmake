@@ -446,6 +446,7 @@ set(BASE_CMN_SRC
     src/common/sstream.cpp
     src/common/stdstream.cpp
     src/common/stopwatch.cpp
+    src/common/stratom.cpp
     src/common/strconv.cpp
     src/common/stream.cpp
     src/common/string.cpp
@@ -596,6 +597,7 @@ set(BASE_CMN_HDR
     wx/stdstream.h
     wx/stockitem.h
     wx/stopwatch.h
+    wx/stratom.h
     wx/strconv.h
     wx/stream.h
     wx/string.h
@@ -1083,6 +1085,7 @@ set(GUI_CMN_HDR
     wx/helpbase.h
     wx/helpwin.h
     wx/iconbndl.h
+    wx/imagbatch.h
     wx/imagbmp.h
     wx/image.h
     wx/imaggif.h
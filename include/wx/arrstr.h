@@ -48,6 +48,23 @@ wxDictionaryStringSortDescending(const wxString& s1, const wxString& s2)
     return wxDictionaryStringSortAscending(s2, s1);
 }
 
+// Compare strings in "natural" order, i.e. case-insensitively and comparing
+// the numbers inside them by their values, so that "file9" < "File10".
+WXDLLIMPEXP_BASE int wxCMPFUNC_CONV
+wxCmpNatural(const wxString& s1, const wxString& s2);
+
+inline int wxCMPFUNC_CONV
+wxNaturalStringSortAscending(const wxString& s1, const wxString& s2)
+{
+    return wxCmpNatural(s1, s2);
+}
+
+inline int wxCMPFUNC_CONV
+wxNaturalStringSortDescending(const wxString& s1, const wxString& s2)
+{
+    return wxCmpNatural(s2, s1);
+}
+
 #if wxUSE_STD_CONTAINERS
 
 typedef int (wxCMPFUNC_CONV *CMPFUNCwxString)(wxString*, wxString*);
@@ -71,6 +88,7 @@ public:
     void Sort(bool reverseOrder = false);
     void Sort(CompareFunction function);
     void Sort(CMPFUNCwxString function) { wxArrayStringBase::Sort(function); }
+    void ParallelSort(CompareFunction function = wxStringSortAscending);
 
     size_t Add(const wxString& string, size_t copies = 1)
     {
@@ -238,6 +256,9 @@ public:
     // sort array elements using specified comparison function
   void Sort(CompareFunction compareFunction);
   void Sort(CompareFunction2 compareFunction);
+    // same as Sort() but uses multiple threads for big arrays, the comparison
+    // function must be thread-safe
+  void ParallelSort(CompareFunction compareFunction = wxStringSortAscending);
 
   // comparison
     // compare two arrays case sensitively
@@ -21,6 +21,8 @@
 //  - wxAtomicDec must return a zero value if the value is zero once
 //  decremented else it must return any non-zero value (the true value is OK
 //  but not necessary).
+//  - wxAtomicAdd must return the new value of the variable, i.e. its value
+//  after adding the delta to it.
 
 #if wxUSE_THREADS
 
@@ -41,6 +43,11 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return __sync_sub_and_fetch(&value, 1);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxUint32 delta)
+{
+    return __sync_add_and_fetch(&value, delta);
+}
+
 
 #elif defined(__WINDOWS__)
 
@@ -57,6 +64,12 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return InterlockedDecrement ((LONG*)&value);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxUint32 delta)
+{
+    // InterlockedExchangeAdd() returns the old value
+    return InterlockedExchangeAdd ((LONG*)&value, (LONG)delta) + delta;
+}
+
 #elif defined(__DARWIN__)
 
 #include "libkern/OSAtomic.h"
@@ -70,6 +83,11 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return OSAtomicDecrement32 ((int32_t*)&value);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxUint32 delta)
+{
+    return OSAtomicAdd32Barrier ((int32_t)delta, (int32_t*)&value);
+}
+
 #elif defined (__SOLARIS__)
 
 #include <atomic.h>
@@ -84,6 +102,11 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return atomic_add_32_nv ((uint32_t*)&value, (uint32_t)-1);
 }
 
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxUint32 delta)
+{
+    return atomic_add_32_nv ((uint32_t*)&value, delta);
+}
+
 #else // unknown platform
 
 // it will result in inclusion if the generic implementation code a bit later in this page
@@ -96,6 +119,8 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
 
 inline void wxAtomicInc (wxUint32 &value) { ++value; }
 inline wxUint32 wxAtomicDec (wxUint32 &value) { return --value; }
+inline wxUint32 wxAtomicAdd (wxUint32 &value, wxUint32 delta)
+    { return value += delta; }
 
 #endif // !wxUSE_THREADS
 
@@ -132,6 +157,12 @@ public:
         return --m_value;
     }
 
+    wxInt32 Add(wxInt32 delta)
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        return m_value += delta;
+    }
+
 private:
     volatile wxInt32  m_value;
     wxCriticalSection m_locker;
@@ -139,6 +170,8 @@ private:
 
 inline void wxAtomicInc(wxAtomicInt32 &value) { value.Inc(); }
 inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
+inline wxInt32 wxAtomicAdd(wxAtomicInt32 &value, wxInt32 delta)
+    { return value.Add(delta); }
 
 #else // !wxNEEDS_GENERIC_ATOMIC_OPS
 
@@ -146,6 +179,8 @@ inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
 
 inline void wxAtomicInc(wxInt32 &value) { wxAtomicInc((wxUint32&)value); }
 inline wxInt32 wxAtomicDec(wxInt32 &value) { return wxAtomicDec((wxUint32&)value); }
+inline wxInt32 wxAtomicAdd(wxInt32 &value, wxInt32 delta)
+    { return wxAtomicAdd((wxUint32&)value, (wxUint32)delta); }
 
 typedef wxInt32 wxAtomicInt32;
 
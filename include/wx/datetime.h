@@ -22,6 +22,7 @@
 
 #include "wx/longlong.h"
 #include "wx/anystr.h"
+#include "wx/vector.h"
 
 class WXDLLIMPEXP_FWD_BASE wxDateTime;
 class WXDLLIMPEXP_FWD_BASE wxTimeSpan;
@@ -1517,6 +1518,90 @@ private:
         m_days;
 };
 
+// ----------------------------------------------------------------------------
+// wxDateTimeFormatter: format string pre-parsed once to be used for formatting
+// and parsing many dates using it.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxDateTimeFormatter
+{
+public:
+    // default ctor, SetFormat() must be called before using this object
+    wxDateTimeFormatter()
+    {
+        m_hasDate =
+        m_hasTimeZone =
+        m_compiled = false;
+    }
+
+    // ctor taking the format string using the same syntax as
+    // wxDateTime::Format() and wxDateTime::ParseFormat()
+    explicit wxDateTimeFormatter(const wxString& format) { SetFormat(format); }
+
+    // (re)compile the object to use the given format
+    void SetFormat(const wxString& format);
+
+    // get the format passed to ctor or SetFormat()
+    const wxString& GetFormat() const { return m_format; }
+
+    // return true if the format only uses the specifiers handled directly by
+    // this class, otherwise wxDateTime::Format() and ParseFormat() are used
+    bool IsCompiled() const { return m_compiled; }
+
+
+    // format the date in the given timezone
+    wxString Format(const wxDateTime& dt,
+                    const wxDateTime::TimeZone& tz = wxDateTime::Local) const;
+
+    // format the date into the provided buffer without allocating memory (if
+    // the format is compiled), the result is always NUL-terminated if size is
+    // non-zero but is truncated if the buffer is too small
+    //
+    // returns the length of the full result, i.e. the buffer was big enough
+    // only if the returned value is less than size
+    size_t Format(const wxDateTime& dt,
+                  wxChar *buf,
+                  size_t size,
+                  const wxDateTime::TimeZone& tz = wxDateTime::Local) const;
+
+
+    // parse the date and time from the string: the input is interpreted as
+    // being in the given time zone unless the format contains "%z"
+    //
+    // the date components not present in the format are taken from today and
+    // the time ones are set to 0
+    //
+    // returns false if the string doesn't match the format, otherwise fills
+    // in dt and, if end is non-NULL, sets it to the end of the parsed text
+    bool Parse(const wxString& date,
+               wxDateTime *dt,
+               const wxDateTime::TimeZone& tz = wxDateTime::Local,
+               wxString::const_iterator *end = NULL) const;
+
+private:
+    // a single element of the compiled format
+    struct Item
+    {
+        // the format specifier character or 0 for a literal character
+        char spec;
+
+        // the maximal number of digits when parsing a numeric field
+        unsigned char width;
+
+        // the character itself if this is a literal
+        wxChar ch;
+    };
+
+    wxString m_format;
+    wxVector<Item> m_items;
+
+    // which fields are present in the format
+    bool m_hasDate,
+         m_hasTimeZone;
+
+    bool m_compiled;
+};
+
 // ----------------------------------------------------------------------------
 // wxDateTimeArray: array of dates.
 // ----------------------------------------------------------------------------
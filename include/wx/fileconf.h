@@ -92,6 +92,9 @@
 class WXDLLIMPEXP_FWD_BASE wxFileConfigGroup;
 class WXDLLIMPEXP_FWD_BASE wxFileConfigEntry;
 class WXDLLIMPEXP_FWD_BASE wxFileConfigLineList;
+#if wxUSE_THREADS
+class WXDLLIMPEXP_FWD_BASE wxFileConfigFlushThread;
+#endif // wxUSE_THREADS
 
 #if wxUSE_STREAMS
 class WXDLLIMPEXP_FWD_BASE wxInputStream;
@@ -185,6 +188,17 @@ public:
   void EnableAutoSave() { m_autosave = true; }
   void DisableAutoSave() { m_autosave = false; }
 
+#if wxUSE_THREADS
+  // if enabled, Flush() only makes a copy of the file contents and writes it
+  // to disk in a background thread, so that it returns almost immediately
+  void EnableBackgroundFlush(bool enable = true);
+  bool IsBackgroundFlushEnabled() const { return m_backgroundFlush; }
+
+  // wait until the last background flush, if any, finishes and return false
+  // if it failed, in which case the config is marked as dirty again
+  bool WaitForFlush();
+#endif // wxUSE_THREADS
+
 public:
   // functions to work with this list
   wxFileConfigLineList *LineListAppend(const wxString& str);
@@ -218,8 +232,12 @@ private:
   // common part of from dtor and DeleteAll
   void CleanUp();
 
-  // parse the whole file
-  void Parse(const wxTextBuffer& buffer, bool bLocal);
+  // read the file using m_conv and parse it, return false if it couldn't be
+  // read at all
+  bool LoadFile(const wxString& path, bool bLocal);
+
+  // parse the whole file contents, the text is modified during parsing
+  void Parse(const wxString& name, wxChar *text, size_t len, bool bLocal);
 
   // the same as SetPath("/")
   void SetRootPath();
@@ -255,6 +273,11 @@ private:
   bool m_isDirty;                       // if true, we have unsaved changes
   bool m_autosave;                      // if true, save changes on destruction
 
+#if wxUSE_THREADS
+  bool m_backgroundFlush;               // if true, Flush() uses a thread
+  wxFileConfigFlushThread *m_flushThread; // the last flush thread or NULL
+#endif // wxUSE_THREADS
+
   wxDECLARE_NO_COPY_CLASS(wxFileConfig);
   wxDECLARE_ABSTRACT_CLASS(wxFileConfig);
 };
@@ -12,6 +12,7 @@
 #define _WX_GENERIC_ANIMATEH__
 
 #include "wx/bitmap.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // wxAnimation
@@ -124,7 +125,7 @@ public:     // extended API specific to this implementation of wxAnimateCtrl
     // Specify whether the animation's background colour is to be shown (the default),
     // or whether the window background should show through
     void SetUseWindowBackgroundColour(bool useWinBackground = true)
-        { m_useWinBackgroundColour = useWinBackground; }
+        { m_useWinBackgroundColour = useWinBackground; ClearFrameCache(); }
     bool IsUsingWindowBackgroundColour() const
         { return m_useWinBackgroundColour; }
 
@@ -139,6 +140,13 @@ public:     // extended API specific to this implementation of wxAnimateCtrl
     wxBitmap& GetBackingStore()
         { return m_backingStore; }
 
+    // Set the maximal amount of memory, in bytes, used for caching the
+    // composed frames to avoid composing them again when the animation
+    // loops, 0 disables caching.
+    void SetFrameCacheSize(size_t size);
+    size_t GetFrameCacheSize() const
+        { return m_frameCacheSize; }
+
 protected:      // internal utilities
 
     // resize this control to fit m_animation
@@ -153,6 +161,15 @@ protected:      // internal utilities
     bool RebuildBackingStoreUpToFrame(unsigned int);
     void DrawFrame(wxDC &dc, unsigned int);
 
+    // Cache the backing store as the current frame if there is enough space.
+    void CacheCurrentFrame();
+
+    // Put the current frame into the backing store from the cache if it's
+    // there and return true or just return false otherwise.
+    bool UseCachedFrame();
+
+    void ClearFrameCache();
+
     virtual void DisplayStaticImage() wxOVERRIDE;
     virtual wxSize DoGetBestSize() const wxOVERRIDE;
 
@@ -168,6 +185,12 @@ protected:
     wxBitmap      m_backingStore;     // The frames are drawn here and then blitted
                                       // on the screen
 
+    enum { DEFAULT_FRAME_CACHE_SIZE = 8*1024*1024 };
+
+    wxVector<wxBitmap> m_frameCache;  // The composed frames, may be empty
+    size_t        m_frameCacheSize;   // Maximal size of the cached frames
+    size_t        m_frameCacheUsed;   // Current size of the cached frames
+
 private:
     typedef wxAnimationCtrlBase base_type;
     wxDECLARE_DYNAMIC_CLASS(wxAnimationCtrl);
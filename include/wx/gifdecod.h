@@ -18,6 +18,7 @@
 #include "wx/image.h"
 #include "wx/animdecod.h"
 #include "wx/dynarray.h"
+#include "wx/vector.h"
 
 // internal utility used to store a frame in 8bit-per-pixel format
 class GIFImage;
@@ -52,7 +53,18 @@ public:
     wxGIFDecoder();
     ~wxGIFDecoder();
 
-    // get data of current frame
+    // By default all frames are decoded when loading the GIF, call this
+    // before LoadGIF() to only keep their compressed data in memory instead
+    // and decode them when they're needed. Only a few recently used frames
+    // are kept decoded then, so the pointer returned by GetData() remains
+    // valid only until the data of another frame is retrieved.
+    void SetDecodeOnDemand(bool onDemand = true)
+        { m_decodeOnDemand = onDemand; }
+    bool IsDecodingOnDemand() const
+        { return m_decodeOnDemand; }
+
+    // get data of current frame, may return NULL if decoding it on demand
+    // failed
     unsigned char* GetData(unsigned int frame) const;
     unsigned char* GetPalette(unsigned int frame) const;
     unsigned int GetNcolours(unsigned int frame) const;
@@ -94,10 +106,19 @@ private:
     wxGIFErrorCode dgif(wxInputStream& stream,
                         GIFImage *img, int interl, int bits);
 
+    // decode the frame if it's not decoded yet when decoding on demand
+    unsigned char *DecodeFrame(unsigned int frame);
+
 
     // array of all frames
     wxArrayPtrVoid m_frames;
 
+    // decode frames only when they're needed?
+    bool m_decodeOnDemand;
+
+    // indices of the frames decoded on demand, least recently used first
+    wxVector<unsigned int> m_decodedFrames;
+
     // decoder state vars
     int           m_restbits;       // remaining valid bits
     unsigned int  m_restbyte;       // remaining bytes in this block
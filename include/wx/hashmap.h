@@ -14,6 +14,9 @@
 #include "wx/string.h"
 #include "wx/wxcrt.h"
 
+#include <new>                  // for placement new
+#include <stddef.h>             // for ptrdiff_t
+
 // In wxUSE_STD_CONTAINERS build we prefer to use the standard hash map class
 // but it can be either in non-standard hash_map header (old g++ and some other
 // STL implementations) or in C++0x standard unordered_map which can in turn be
@@ -62,8 +65,6 @@
 
 #define wxNEEDS_WX_HASH_MAP
 
-#include <stddef.h>             // for ptrdiff_t
-
 // private
 struct WXDLLIMPEXP_BASE _wxHashTable_NodeBase
 {
@@ -664,6 +665,508 @@ public: \
 
 #endif // wxNEEDS_WX_HASH_MAP
 
+// ----------------------------------------------------------------------------
+// wxOpenHashMap: hash map using open addressing
+// ----------------------------------------------------------------------------
+
+// This is an alternative hash map implementation which stores the elements
+// directly in a single array instead of allocating a node for each of them,
+// which is faster and uses less memory than the chained hash maps. Its API is
+// the same as that of the maps declared with WX_DECLARE_HASH_MAP(), but,
+// because the elements are moved when the table grows, inserting new elements
+// invalidates all the existing iterators, pointers and references to the
+// elements. Erasing an element only invalidates the iterators pointing to it,
+// so the usual "map.erase(it++)" idiom can still be used.
+//
+// Don't use this class directly, use WX_DECLARE_OPEN_HASH_MAP() and the other
+// related macros defined below.
+//
+// The implementation uses linear probing and keeps, for each slot, a control
+// byte indicating whether it is empty, deleted or used and, in the latter
+// case, containing 7 bits of the key hash, which allows to avoid comparing the
+// keys most of the time.
+
+// value_type of wxOpenHashMap: this is similar to std::pair.
+template <typename K, typename V>
+struct wxOpenHashMapPair
+{
+    typedef K first_type;
+    typedef V second_type;
+
+    wxOpenHashMapPair(const K& f, const V& s) : first(f), second(s) { }
+
+    K first;
+    V second;
+};
+
+// Non-template part of wxOpenHashMap.
+class wxOpenHashMapBase
+{
+protected:
+    // Special values of the control bytes, all values with the high bit set
+    // are special and all the others correspond to the used slots.
+    enum
+    {
+        Ctrl_Empty   = 0x80,
+        Ctrl_Deleted = 0xfe
+    };
+
+    static bool IsUsed(unsigned char ctrl) { return !(ctrl & 0x80); }
+
+    // The hash functions used with wxHashMap are often very simple, e.g. the
+    // identity for the integers, so scramble the bits of the hash value to
+    // use all of them for determining the position in the table.
+    static size_t MixHash(size_t hash)
+    {
+        hash *= static_cast<size_t>(wxULL(0x9e3779b97f4a7c15));
+        return hash ^ (hash >> (sizeof(size_t)*4));
+    }
+
+    // Return the bits of the hash stored in the control byte: they are taken
+    // from the high bits, which are not used for determining the position.
+    static unsigned char GetHashBits(size_t hash)
+    {
+        return static_cast<unsigned char>(hash >> (sizeof(size_t)*8 - 7));
+    }
+
+    // Return the capacity needed for storing the given number of elements
+    // while keeping the load factor under 7/8.
+    static size_t GetCapacityFor(size_t count)
+    {
+        size_t capacity = 8;
+        while ( capacity - capacity / 8 <= count )
+            capacity *= 2;
+
+        return capacity;
+    }
+};
+
+template <typename K, typename V, typename Hash, typename KeyEq>
+class wxOpenHashMap : protected wxOpenHashMapBase
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef wxOpenHashMapPair<K, V> value_type;
+    typedef Hash hasher;
+    typedef KeyEq key_equal;
+
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef const K const_key_type;
+    typedef const V const_mapped_type;
+
+    typedef wxOpenHashMap Self;
+
+    class Iterator
+    {
+    public:
+        Iterator() : m_map(NULL), m_pos(0) { }
+        Iterator(const Self* map, size_t pos)
+            : m_map(const_cast<Self*>(map)), m_pos(pos) { }
+
+        bool operator==(const Iterator& it) const
+            { return m_pos == it.m_pos && m_map == it.m_map; }
+        bool operator!=(const Iterator& it) const
+            { return !(*this == it); }
+
+    protected:
+        void PlusPlus() { m_pos = m_map->SkipUnused(m_pos + 1); }
+
+        Self* m_map;
+        size_t m_pos;
+
+        friend class wxOpenHashMap;
+    };
+
+    class iterator : public Iterator
+    {
+    public:
+        iterator() : Iterator() { }
+        iterator(Self* map, size_t pos) : Iterator(map, pos) { }
+
+        iterator& operator++() { this->PlusPlus(); return *this; }
+        iterator operator++(int)
+            { iterator it = *this; this->PlusPlus(); return it; }
+
+        reference operator*() const
+            { return this->m_map->m_slots[this->m_pos]; }
+        pointer operator->() const
+            { return &this->m_map->m_slots[this->m_pos]; }
+    };
+
+    class const_iterator : public Iterator
+    {
+    public:
+        const_iterator() : Iterator() { }
+        const_iterator(iterator it) : Iterator(it) { }
+        const_iterator(const Self* map, size_t pos) : Iterator(map, pos) { }
+
+        const_iterator& operator++() { this->PlusPlus(); return *this; }
+        const_iterator operator++(int)
+            { const_iterator it = *this; this->PlusPlus(); return it; }
+
+        const_reference operator*() const
+            { return this->m_map->m_slots[this->m_pos]; }
+        const_pointer operator->() const
+            { return &this->m_map->m_slots[this->m_pos]; }
+    };
+
+    struct Insert_Result
+    {
+        Insert_Result(const iterator& f, bool s) : first(f), second(s) { }
+
+        iterator first;
+        bool second;
+    };
+
+    explicit wxOpenHashMap(size_type hint = 100,
+                           const hasher& hf = hasher(),
+                           const key_equal& eq = key_equal())
+        : m_hasher(hf),
+          m_equals(eq)
+    {
+        Init();
+
+        // Don't allocate anything until the first element is inserted to
+        // make empty maps as cheap as possible.
+        m_hint = hint;
+    }
+
+    wxOpenHashMap(const Self& map)
+        : m_hasher(map.m_hasher),
+          m_equals(map.m_equals)
+    {
+        Init();
+        m_hint = map.m_hint;
+
+        Copy(map);
+    }
+
+    Self& operator=(const Self& map)
+    {
+        if ( &map != this )
+        {
+            Free();
+            Init();
+
+            m_hasher = map.m_hasher;
+            m_equals = map.m_equals;
+            m_hint = map.m_hint;
+
+            Copy(map);
+        }
+
+        return *this;
+    }
+
+    ~wxOpenHashMap() { Free(); }
+
+    hasher hash_funct() const { return m_hasher; }
+    key_equal key_eq() const { return m_equals; }
+
+    // Remove all the elements but keep the memory allocated for them.
+    void clear()
+    {
+        for ( size_t n = 0; n < m_capacity; n++ )
+        {
+            if ( IsUsed(m_ctrl[n]) )
+                m_slots[n].~value_type();
+        }
+
+        if ( m_capacity )
+            memset(m_ctrl, Ctrl_Empty, m_capacity);
+
+        m_size =
+        m_deleted = 0;
+    }
+
+    // Preallocate memory for storing the given number of elements.
+    void reserve(size_type count)
+    {
+        const size_t capacity = GetCapacityFor(count);
+        if ( capacity > m_capacity )
+            Rehash(capacity);
+    }
+
+    size_type size() const { return m_size; }
+    size_type max_size() const { return size_type(-1) / sizeof(value_type); }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() { return iterator(this, SkipUnused(0)); }
+    const_iterator begin() const { return const_iterator(this, SkipUnused(0)); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+
+    iterator find(const const_key_type& key)
+        { return iterator(this, Find(key)); }
+    const_iterator find(const const_key_type& key) const
+        { return const_iterator(this, Find(key)); }
+
+    size_type count(const const_key_type& key) const
+        { return Find(key) != m_capacity ? 1u : 0u; }
+
+    mapped_type& operator[](const const_key_type& key)
+    {
+        size_t hash;
+        size_t pos = FindOrPrepareInsert(key, hash);
+        if ( pos == m_capacity )
+            pos = Insert(hash, value_type(key, mapped_type()));
+
+        return m_slots[pos].second;
+    }
+
+    Insert_Result insert(const value_type& v)
+    {
+        size_t hash;
+        size_t pos = FindOrPrepareInsert(v.first, hash);
+        if ( pos != m_capacity )
+            return Insert_Result(iterator(this, pos), false);
+
+        pos = Insert(hash, v);
+        return Insert_Result(iterator(this, pos), true);
+    }
+
+    size_type erase(const key_type& key)
+    {
+        const size_t pos = Find(key);
+        if ( pos == m_capacity )
+            return 0;
+
+        EraseAt(pos);
+        return 1;
+    }
+
+    void erase(const iterator& it) { EraseAt(it.m_pos); }
+    void erase(const const_iterator& it) { EraseAt(it.m_pos); }
+
+private:
+    void Init()
+    {
+        m_slots = NULL;
+        m_ctrl = NULL;
+        m_capacity =
+        m_size =
+        m_deleted = 0;
+    }
+
+    void Free()
+    {
+        clear();
+
+        ::operator delete(m_slots);
+    }
+
+    // Allocate the arrays for the given capacity, the control bytes are
+    // stored after the slots in the same memory block.
+    void Allocate(size_t capacity)
+    {
+        m_slots = static_cast<value_type*>(
+            ::operator new(capacity*(sizeof(value_type) + 1)));
+        m_ctrl = reinterpret_cast<unsigned char*>(m_slots + capacity);
+        memset(m_ctrl, Ctrl_Empty, capacity);
+
+        m_capacity = capacity;
+    }
+
+    void Copy(const Self& map)
+    {
+        if ( !map.m_size )
+            return;
+
+        // Keep the elements at the same positions and preserve the deleted
+        // slots too, as the probe sequences may go through them.
+        Allocate(map.m_capacity);
+        for ( size_t n = 0; n < m_capacity; n++ )
+        {
+            if ( IsUsed(map.m_ctrl[n]) )
+            {
+                new(&m_slots[n]) value_type(map.m_slots[n]);
+                m_size++;
+            }
+
+            m_ctrl[n] = map.m_ctrl[n];
+        }
+
+        m_deleted = map.m_deleted;
+    }
+
+    size_t SkipUnused(size_t pos) const
+    {
+        while ( pos < m_capacity && !IsUsed(m_ctrl[pos]) )
+            pos++;
+
+        return pos;
+    }
+
+    // Return the position of the element with the given key or m_capacity.
+    size_t Find(const const_key_type& key) const
+    {
+        if ( !m_size )
+            return m_capacity;
+
+        const size_t hash = MixHash(m_hasher(key));
+        const unsigned char bits = GetHashBits(hash);
+        const size_t mask = m_capacity - 1;
+
+        // There is always at least one empty slot, so this loop terminates.
+        for ( size_t pos = hash & mask; ; pos = (pos + 1) & mask )
+        {
+            const unsigned char ctrl = m_ctrl[pos];
+            if ( ctrl == bits && m_equals(m_slots[pos].first, key) )
+                return pos;
+
+            if ( ctrl == Ctrl_Empty )
+                return m_capacity;
+        }
+    }
+
+    // Return the position of the existing element with the given key or
+    // m_capacity if there is none, in which case its mixed hash is returned
+    // to be passed to Insert().
+    size_t FindOrPrepareInsert(const const_key_type& key, size_t& hash)
+    {
+        hash = MixHash(m_hasher(key));
+        if ( !m_size )
+            return m_capacity;
+
+        const unsigned char bits = GetHashBits(hash);
+        const size_t mask = m_capacity - 1;
+
+        for ( size_t pos = hash & mask; ; pos = (pos + 1) & mask )
+        {
+            const unsigned char ctrl = m_ctrl[pos];
+            if ( ctrl == bits && m_equals(m_slots[pos].first, key) )
+                return pos;
+
+            if ( ctrl == Ctrl_Empty )
+                return m_capacity;
+        }
+    }
+
+    // Insert a new element known not to be present in the map yet.
+    size_t Insert(size_t hash, const value_type& v)
+    {
+        size_t pos = FindInsertPos(hash);
+
+        // Using an empty slot, unlike reusing a deleted one, increases the
+        // load of the table, so check if it needs to grow: notice that we
+        // count the deleted slots too as they lengthen the probe sequences.
+        if ( !m_capacity ||
+                (m_ctrl[pos] == Ctrl_Empty &&
+                    (m_size + m_deleted + 1) > m_capacity - m_capacity / 8) )
+        {
+            // This doesn't necessarily grow the table if we have enough
+            // deleted slots, in which case it just gets rid of them.
+            Rehash(GetCapacityFor(m_size + 1 > m_hint ? m_size + 1 : m_hint));
+
+            pos = FindInsertPos(hash);
+        }
+
+        new(&m_slots[pos]) value_type(v);
+
+        if ( m_ctrl[pos] == Ctrl_Deleted )
+            m_deleted--;
+        m_ctrl[pos] = GetHashBits(hash);
+        m_size++;
+
+        return pos;
+    }
+
+    // Find the first empty or deleted slot in the probe sequence.
+    size_t FindInsertPos(size_t hash) const
+    {
+        if ( !m_capacity )
+            return 0;
+
+        const size_t mask = m_capacity - 1;
+
+        size_t pos = hash & mask;
+        while ( IsUsed(m_ctrl[pos]) )
+            pos = (pos + 1) & mask;
+
+        return pos;
+    }
+
+    void EraseAt(size_t pos)
+    {
+        m_slots[pos].~value_type();
+
+        // If the next slot is empty, no probe sequence can continue past this
+        // one, so it can be marked as empty too and doesn't need to be kept
+        // as deleted.
+        if ( m_ctrl[(pos + 1) & (m_capacity - 1)] == Ctrl_Empty )
+        {
+            m_ctrl[pos] = Ctrl_Empty;
+        }
+        else
+        {
+            m_ctrl[pos] = Ctrl_Deleted;
+            m_deleted++;
+        }
+
+        m_size--;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        value_type* const slotsOld = m_slots;
+        const unsigned char* const ctrlOld = m_ctrl;
+        const size_t capacityOld = m_capacity;
+
+        Allocate(capacity);
+        m_deleted = 0;
+
+        for ( size_t n = 0; n < capacityOld; n++ )
+        {
+            if ( !IsUsed(ctrlOld[n]) )
+                continue;
+
+            value_type& v = slotsOld[n];
+
+            const size_t hash = MixHash(m_hasher(v.first));
+            const size_t pos = FindInsertPos(hash);
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)
+            new(&m_slots[pos]) value_type(std::move(v));
+#else
+            new(&m_slots[pos]) value_type(v);
+#endif
+            m_ctrl[pos] = ctrlOld[n];
+
+            v.~value_type();
+        }
+
+        ::operator delete(slotsOld);
+    }
+
+    value_type* m_slots;
+    unsigned char* m_ctrl;
+    size_t m_capacity;
+    size_t m_size;
+    size_t m_deleted;
+    size_t m_hint;
+
+    hasher m_hasher;
+    key_equal m_equals;
+
+    friend class Iterator;
+    friend class iterator;
+    friend class const_iterator;
+};
+
+#define _WX_DECLARE_OPEN_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, CLASSEXP ) \
+CLASSEXP CLASSNAME : public wxOpenHashMap< KEY_T, VALUE_T, HASH_T, KEY_EQ_T > \
+{ \
+public: \
+    explicit CLASSNAME( size_type hint = 100, hasher hf = hasher(), \
+                        key_equal eq = key_equal() ) \
+        : wxOpenHashMap< KEY_T, VALUE_T, HASH_T, KEY_EQ_T >( hint, hf, eq ) {} \
+}
+
 // these macros are to be used in the user code
 #define WX_DECLARE_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME) \
     _WX_DECLARE_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, class )
@@ -676,6 +1179,19 @@ public: \
     _WX_DECLARE_HASH_MAP( void*, VALUE_T, wxPointerHash, wxPointerEqual, \
                           CLASSNAME, class )
 
+// these macros declare the hash maps using open addressing, see the comment
+// before wxOpenHashMap above for the differences with the normal ones
+#define WX_DECLARE_OPEN_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME) \
+    _WX_DECLARE_OPEN_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, class )
+
+#define WX_DECLARE_OPEN_STRING_HASH_MAP( VALUE_T, CLASSNAME ) \
+    _WX_DECLARE_OPEN_HASH_MAP( wxString, VALUE_T, wxStringHash, wxStringEqual, \
+                               CLASSNAME, class )
+
+#define WX_DECLARE_OPEN_VOIDPTR_HASH_MAP( VALUE_T, CLASSNAME ) \
+    _WX_DECLARE_OPEN_HASH_MAP( void*, VALUE_T, wxPointerHash, wxPointerEqual, \
+                               CLASSNAME, class )
+
 // and these do exactly the same thing but should be used inside the
 // library
 #define WX_DECLARE_HASH_MAP_WITH_DECL( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, DECL) \
@@ -701,6 +1217,13 @@ public: \
     WX_DECLARE_VOIDPTR_HASH_MAP_WITH_DECL( VALUE_T, CLASSNAME, \
                                            class WXDLLIMPEXP_CORE )
 
+#define WX_DECLARE_OPEN_HASH_MAP_WITH_DECL( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, DECL) \
+    _WX_DECLARE_OPEN_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME, DECL )
+
+#define WX_DECLARE_OPEN_STRING_HASH_MAP_WITH_DECL( VALUE_T, CLASSNAME, DECL ) \
+    _WX_DECLARE_OPEN_HASH_MAP( wxString, VALUE_T, wxStringHash, wxStringEqual, \
+                               CLASSNAME, DECL )
+
 // delete all hash elements
 //
 // NB: the class declaration of the hash elements must be visible from the
@@ -15,6 +15,8 @@
 
 #include "wx/object.h"
 #include "wx/arrstr.h"
+#include "wx/stratom.h"
+#include "wx/vector.h"
 
 class WXDLLIMPEXP_FWD_CORE wxColour;
 class WXDLLIMPEXP_FWD_HTML wxHtmlEntitiesParser;
@@ -83,6 +85,7 @@ public:
 
     // Returns tag's name in uppercase.
     inline wxString GetName() const {return m_Name;}
+    const wxStringAtom& GetNameAtom() const { return m_Name; }
 
     // Returns true if the tag has given parameter. Parameter
     // should always be in uppercase.
@@ -146,10 +149,16 @@ public:
 #endif // WXWIN_COMPATIBILITY_2_8
 
 private:
-    wxString m_Name;
+    // Returns the index of the parameter with the given name or wxNOT_FOUND.
+    int FindParam(const wxString& par) const;
+
+    // Tag and parameter names are atoms as the same few names are used by
+    // all the tags in the document.
+    wxStringAtom m_Name;
     bool m_hasEnding;
     wxString::const_iterator m_Begin, m_End1, m_End2;
-    wxArrayString m_ParamNames, m_ParamValues;
+    wxVector<wxStringAtom> m_ParamNames;
+    wxArrayString m_ParamValues;
 #if WXWIN_COMPATIBILITY_2_8
     wxString::const_iterator m_sourceStart;
 #endif
@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imagbatch.h
+// Purpose:     wxImageBatchLoader for loading images in parallel
+// Author:      wxWidgets team
+// Copyright:   (c) 2020 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGBATCH_H_
+#define _WX_IMAGBATCH_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE && wxUSE_STREAMS
+
+#include "wx/event.h"
+#include "wx/image.h"
+
+//-----------------------------------------------------------------------------
+// wxImageBatchEvent: sent by wxImageBatchLoader when an image is loaded
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_FWD_CORE wxImageBatchEvent;
+
+wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_IMAGE_BATCH_LOADED, wxImageBatchEvent );
+
+class WXDLLIMPEXP_CORE wxImageBatchEvent : public wxEvent
+{
+public:
+    wxImageBatchEvent(wxEventType type = wxEVT_NULL,
+                      size_t index = 0,
+                      const wxImage& image = wxNullImage)
+        : wxEvent(0, type),
+          m_index(index),
+          m_image(image)
+    {
+    }
+
+    // index of the image as returned by wxImageBatchLoader::Add()
+    size_t GetIndex() const { return m_index; }
+
+    // the loaded image, invalid if loading it failed
+    const wxImage& GetImage() const { return m_image; }
+    bool IsOk() const { return m_image.IsOk(); }
+
+    virtual wxEvent *Clone() const wxOVERRIDE { return new wxImageBatchEvent(*this); }
+    virtual wxEventCategory GetEventCategory() const wxOVERRIDE { return wxEVT_CATEGORY_THREAD; }
+
+private:
+    size_t m_index;
+    wxImage m_image;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxImageBatchEvent);
+};
+
+typedef void (wxEvtHandler::*wxImageBatchEventFunction)(wxImageBatchEvent&);
+
+#define wxImageBatchEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxImageBatchEventFunction, func)
+
+#define EVT_IMAGE_BATCH_LOADED(func) \
+    wx__DECLARE_EVT0(wxEVT_IMAGE_BATCH_LOADED, wxImageBatchEventHandler(func))
+
+//-----------------------------------------------------------------------------
+// wxImageBatchLoader: loads several images in parallel
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageBatchLoader
+{
+public:
+    wxImageBatchLoader(wxEvtHandler *handler = NULL, int threads = 0);
+    ~wxImageBatchLoader();
+
+    size_t Add(const wxString& filename, wxBitmapType type = wxBITMAP_TYPE_ANY);
+    size_t Add(wxInputStream *stream, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    size_t GetCount() const;
+    bool IsDone(size_t n) const;
+    wxImage GetImage(size_t n);
+
+    void Wait();
+    void Cancel();
+
+    int GetThreadCount() const;
+
+private:
+    class wxImageBatchLoaderImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBatchLoader);
+};
+
+#endif // wxUSE_IMAGE && wxUSE_STREAMS
+
+#endif // _WX_IMAGBATCH_H_
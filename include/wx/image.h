@@ -57,6 +57,21 @@ enum wxImageResolution
     wxIMAGE_RESOLUTION_CM = 2
 };
 
+// Layouts of the interleaved RGBA data used by wxImage::GetRGBA() and
+// wxImage::SetRGBA()
+enum wxImageRGBAFormat
+{
+    // R, G, B, A bytes with straight alpha, as used by GdkPixbuf or PNG
+    wxIMAGE_FORMAT_RGBA,
+
+    // the same with the colours premultiplied by alpha
+    wxIMAGE_FORMAT_RGBA_PREMULTIPLIED,
+
+    // 32 bit native endian values with alpha in the most significant byte and
+    // the colours premultiplied by it, as used by Cairo or Windows DIBs
+    wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED
+};
+
 // Constants for wxImage::Scale() for determining the level of quality
 enum wxImageResizeQuality
 {
@@ -332,9 +347,18 @@ public:
     wxImage Blur(int radius) const;
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
+    wxImage& BlurInPlace(int radius);
+
+    // approximate gaussian blur with the given standard deviation
+    wxImage GaussianBlur(double sigma) const;
 
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
+    // number of threads used by the functions above for big images, 0 means
+    // to use as many threads as there are CPUs
+    static void SetProcessingThreads(int threads);
+    static int GetProcessingThreads();
+
     // rescales the image in place
     wxImage& Rescale( int width, int height,
                       wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL )
@@ -369,6 +393,9 @@ public:
     // Convert to disabled (dimmed) image.
     wxImage ConvertToDisabled(unsigned char brightness = 255) const;
 
+    // Make the image lighter or darker, see wxColour::ChangeLightness().
+    wxImage ChangeLightness(int alpha) const;
+
     // these routines are slow but safe
     void SetRGB( int x, int y, unsigned char r, unsigned char g, unsigned char b );
     void SetRGB( const wxRect& rect, unsigned char r, unsigned char g, unsigned char b );
@@ -473,6 +500,16 @@ public:
     void InitAlpha();
     void ClearAlpha();
 
+    // copy the image data and alpha to or from a buffer of interleaved RGBA
+    // pixels in the given format, stride is the size of a buffer row in bytes
+    // with 0 meaning 4*width
+    bool GetRGBA(unsigned char* buffer,
+                 wxImageRGBAFormat format = wxIMAGE_FORMAT_RGBA,
+                 int stride = 0) const;
+    bool SetRGBA(const unsigned char* buffer,
+                 wxImageRGBAFormat format = wxIMAGE_FORMAT_RGBA,
+                 int stride = 0);
+
     // return true if this pixel is masked or has alpha less than specified
     // threshold
     bool IsTransparent(int x, int y,
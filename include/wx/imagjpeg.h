@@ -20,6 +20,8 @@
 #include "wx/image.h"
 #include "wx/versioninfo.h"
 
+#define wxIMAGE_OPTION_JPEG_FAST_DECODE wxT("JpegFastDecode")
+
 class WXDLLIMPEXP_CORE wxJPEGHandler: public wxImageHandler
 {
 public:
@@ -53,6 +53,69 @@ private:
     wxDECLARE_DYNAMIC_CLASS(wxTIFFHandler);
 };
 
+#if wxUSE_STREAMS
+
+struct tiff;
+
+//-----------------------------------------------------------------------------
+// wxTIFFReadNotifier
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxTIFFReadNotifier
+{
+public:
+    virtual ~wxTIFFReadNotifier() { }
+
+    // called after reading each band of rows, return false to cancel reading
+    virtual bool OnProgress(int rowsRead, int rowsTotal) = 0;
+};
+
+//-----------------------------------------------------------------------------
+// wxTIFFReader: reads (parts of) TIFF images without loading them entirely
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxTIFFReader
+{
+public:
+    wxTIFFReader();
+    ~wxTIFFReader();
+
+    // the stream must be seekable and must remain valid while it's used
+    bool Open(wxInputStream& stream);
+    bool Open(const wxString& filename);
+
+    bool IsOpened() const { return m_tif != NULL; }
+    void Close();
+
+    // the file can contain several images, e.g. reduced resolution ones
+    int GetImageCount() const;
+    bool SelectImage(int index);
+    int GetSelectedImage() const { return m_index; }
+
+    wxSize GetSize() const;
+    bool IsReducedImage() const;
+
+    // find the smallest image at least as big as the given size
+    int FindImage(const wxSize& size);
+
+    // read the given rectangle of the selected image, all of it by default
+    bool Read(wxImage* image,
+              const wxRect& rect = wxRect(),
+              wxTIFFReadNotifier* notifier = NULL);
+
+private:
+    struct tiff* m_tif;
+
+    // the stream we opened ourselves, if any
+    wxInputStream* m_stream;
+
+    int m_index;
+
+    wxDECLARE_NO_COPY_CLASS(wxTIFFReader);
+};
+
+#endif // wxUSE_STREAMS
+
 #endif // wxUSE_LIBTIFF
 
 #endif // _WX_IMAGTIFF_H_
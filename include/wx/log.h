@@ -65,6 +65,7 @@ class WXDLLIMPEXP_FWD_BASE wxObject;
 
 #if wxUSE_THREADS
     #include "wx/thread.h"
+    #include "wx/atomic.h"
 #endif // wxUSE_THREADS
 
 // wxUSE_LOG_DEBUG enables the debug log messages
@@ -337,6 +338,72 @@ protected:
     virtual wxString FormatTime(time_t t) const;
 };
 
+// ----------------------------------------------------------------------------
+// handles for trace masks and components allowing to check them cheaply
+// ----------------------------------------------------------------------------
+
+// A trace mask which can be used instead of a string with wxLogTrace(): it is
+// registered once, when the object is created, and is kept up to date by
+// wxLog::AddTraceMask() and RemoveTraceMask(), so checking whether it's
+// enabled is just a simple test instead of a search in the list of masks.
+//
+// These objects are typically static or global and must not be destroyed
+// while any other thread can use them.
+class WXDLLIMPEXP_BASE wxLogTraceMaskHandle
+{
+public:
+    explicit wxLogTraceMaskHandle(const wxString& mask);
+    ~wxLogTraceMaskHandle();
+
+    const wxString& GetMask() const { return m_mask; }
+
+    bool IsEnabled() const { return m_enabled; }
+
+private:
+    const wxString m_mask;
+    bool m_enabled;
+
+    friend class wxLog;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogTraceMaskHandle);
+};
+
+// A log component with its effective log level cached, see
+// wxLog::SetComponentLevel(). It can be used as wxLOG_COMPONENT value to make
+// checking whether the log messages are enabled as cheap as possible, e.g.
+//
+//      static wxLogComponentHandle gs_myComponent("my/component");
+//      #define wxLOG_COMPONENT gs_myComponent
+//
+// As with wxLogRecordInfo::component, the string passed to the ctor must be
+// a literal or otherwise remain valid during the entire object lifetime.
+class WXDLLIMPEXP_BASE wxLogComponentHandle
+{
+public:
+    explicit wxLogComponentHandle(const char *component);
+    ~wxLogComponentHandle();
+
+    const char *GetComponent() const { return m_component; }
+
+    // allow passing this object to the functions taking the component name
+    operator const char *() const { return m_component; }
+
+    // get the effective log level for this component
+    inline wxLogLevel GetLevel() const;
+
+private:
+    // the value of m_level if no level was set for this component or any of
+    // its parents, in which case the global log level is used
+    static const wxLogLevel Level_Default = static_cast<wxLogLevel>(-1);
+
+    const char * const m_component;
+    wxLogLevel m_level;
+
+    friend class wxLog;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogComponentHandle);
+};
+
 
 // ----------------------------------------------------------------------------
 // derive from this class to redirect (or suppress, or ...) log messages
@@ -406,6 +473,41 @@ public:
         return IsEnabled() && level <= GetComponentLevel(component);
     }
 
+    static bool IsLevelEnabled(wxLogLevel level, const char *component)
+    {
+        if ( !IsEnabled() )
+            return false;
+
+        // don't bother looking up the component level if no component levels
+        // were set at all, which is by far the most common case
+        return level <= (ms_hasComponentLevels ? GetComponentLevel(component)
+                                               : ms_logLevel);
+    }
+
+    static bool IsLevelEnabled(wxLogLevel level,
+                               const wxLogComponentHandle& component)
+    {
+        return IsEnabled() && level <= component.GetLevel();
+    }
+
+    // this is used by wxLogTrace() to check whether the message should be
+    // logged before evaluating any of its other arguments: for the string
+    // masks this only checks the level as checking the mask itself is
+    // relatively expensive and is done later, but for the handles it's as
+    // cheap as it can be
+    template <typename T, typename C>
+    static bool IsTraceEnabled(const T& WXUNUSED(mask), const C& component)
+    {
+        return IsLevelEnabled(wxLOG_Trace, component);
+    }
+
+    template <typename C>
+    static bool IsTraceEnabled(const wxLogTraceMaskHandle& mask,
+                               const C& component)
+    {
+        return mask.IsEnabled() && IsLevelEnabled(wxLOG_Trace, component);
+    }
+
 
     // enable/disable messages at wxLOG_Verbose level (only relevant if the
     // current log level is greater or equal to it)
@@ -595,6 +697,12 @@ protected:
     // this one as the default implementation of it simply asserts
     virtual void DoLogText(const wxString& msg);
 
+    // override this method to return true if DoLogRecord() can be safely
+    // called from any thread: in this case the messages logged from the other
+    // threads are passed to it immediately instead of being buffered until
+    // they can be flushed from the main thread
+    virtual bool IsThreadSafe() const { return false; }
+
 
     // the rest of the functions are for backwards compatibility only, don't
     // use them in new code; if you're updating your existing code you need to
@@ -641,6 +749,12 @@ private:
     static bool EnableThreadLogging(bool enable = true);
 #endif // wxUSE_THREADS
 
+    // update all the existing wxLogTraceMaskHandle or wxLogComponentHandle
+    // objects after the trace masks or component levels change, must be
+    // called with the corresponding critical section locked
+    static void UpdateTraceMaskHandles();
+    static void UpdateComponentHandles();
+
     // get the active log target for the main thread, auto-creating it if
     // necessary
     //
@@ -676,6 +790,9 @@ private:
 
     static wxLogLevel  ms_logLevel;     // limit logging to levels <= ms_logLevel
 
+    // true if SetComponentLevel() was ever called for a non-empty component
+    static bool        ms_hasComponentLevels;
+
     static size_t      ms_suspendCount; // if positive, logs are not flushed
 
     // format string for strftime(), if empty, time stamping log messages is
@@ -689,6 +806,11 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxLog);
 };
 
+inline wxLogLevel wxLogComponentHandle::GetLevel() const
+{
+    return m_level == Level_Default ? wxLog::GetLogLevel() : m_level;
+}
+
 // ----------------------------------------------------------------------------
 // "trivial" derivations of wxLog
 // ----------------------------------------------------------------------------
@@ -864,6 +986,126 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxLogInterposerTemp);
 };
 
+#if wxUSE_THREADS
+
+// what should wxLogAsync do when its queue is full
+enum wxLogAsyncOverflowPolicy
+{
+    wxLOG_ASYNC_BLOCK,      // wait until the writer thread makes some room
+    wxLOG_ASYNC_DISCARD     // discard the new message and count it as dropped
+};
+
+// a log target which queues the messages and passes them to another log
+// target from a dedicated writer thread, so that the threads logging the
+// messages don't have to wait until they are formatted and output
+class WXDLLIMPEXP_BASE wxLogAsync : public wxLog
+{
+public:
+    // the new object takes ownership of the target, which will be only used
+    // from the writer thread; the capacity is rounded up to a power of 2
+    wxLogAsync(wxLog *target,
+               size_t capacity = 1024,
+               wxLogAsyncOverflowPolicy policy = wxLOG_ASYNC_BLOCK);
+    virtual ~wxLogAsync();
+
+    // get the log target the messages are passed to
+    wxLog *GetTarget() const { return m_target; }
+
+    // get the maximal number of messages which can be queued
+    size_t GetCapacity() const { return m_mask + 1; }
+
+    // get the policy used when the queue is full
+    wxLogAsyncOverflowPolicy GetOverflowPolicy() const { return m_policy; }
+
+    // get the total number of messages discarded because the queue was full
+    unsigned long GetDroppedCount() const;
+
+    // wait until all the messages logged so far are passed to the target and
+    // then flush it
+    virtual void Flush() wxOVERRIDE;
+
+protected:
+    // queue the record to be passed to the target later
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) wxOVERRIDE;
+
+    virtual bool IsThreadSafe() const wxOVERRIDE { return true; }
+
+private:
+    class WriterThread;
+    friend class WriterThread;
+
+    struct Slot;
+
+    // these functions are only called from the writer thread
+
+    // the main loop of the writer thread
+    void WriterLoop();
+
+    // pass the first queued record to the target and return true or return
+    // false if there is no record ready to be written
+    bool WriteNext();
+
+    // log a message about the dropped records if there were any new ones
+    void ReportDropped();
+
+
+    // return true if no records were queued and not written yet
+    bool IsQueueEmpty();
+
+    // wake up the writer thread if it's waiting for new records
+    void WakeUpWriter();
+
+
+    wxLog * const m_target;
+
+    // ring buffer of m_mask + 1 slots and the policy used when it's full
+    Slot * const m_slots;
+    const wxUint32 m_mask;
+    const wxLogAsyncOverflowPolicy m_policy;
+
+    // the sequence number of the next record to be queued and of the next one
+    // to be written: all the records in between are in the ring buffer
+    wxAtomicInt m_tail;
+    wxAtomicInt m_head;
+
+    // the number of records discarded because the queue was full, only
+    // modified if m_policy is wxLOG_ASYNC_DISCARD
+    wxAtomicInt m_dropped;
+
+    // the value of m_dropped last reported by the writer thread
+    wxInt32 m_droppedReported;
+
+    // non-zero while the writer thread is waiting on m_condWrite, see the
+    // WriterState_XXX constants in the implementation
+    wxAtomicInt m_writerWaiting;
+
+    // the writer thread and its id
+    WriterThread *m_thread;
+    wxThreadIdType m_threadId;
+
+    // all the fields below are protected by this mutex
+    wxMutex m_mutex;
+
+    // signalled when the writer thread has something to do
+    wxCondition m_condWrite;
+
+    // signalled when the writer thread completes a flush request
+    wxCondition m_condFlushed;
+
+    // the number of Flush() calls made and processed so far
+    unsigned long m_flushRequested,
+                  m_flushDone;
+
+    // set by dtor to ask the writer thread to exit
+    bool m_stop;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsync);
+};
+
+#endif // wxUSE_THREADS
+
 #if wxUSE_GUI
     // include GUI log targets:
     #include "wx/generic/logg.h"
@@ -955,6 +1197,18 @@ public:
         LogV(format, argptr);
     }
 
+    void LogVTrace(const wxLogTraceMaskHandle& mask,
+                   const wxString& format,
+                   va_list argptr)
+    {
+        if ( !mask.IsEnabled() )
+            return;
+
+        Store(wxLOG_KEY_TRACE_MASK, mask.GetMask());
+
+        LogV(format, argptr);
+    }
+
 
     // vararg functions used by wxLogXXX():
 
@@ -1013,6 +1267,13 @@ public:
         DoLogTrace, DoLogTraceUtf8
     )
 
+    WX_DEFINE_VARARG_FUNC_VOID
+    (
+        LogTrace,
+        2, (const wxLogTraceMaskHandle&, const wxFormatString&),
+        DoLogTraceHandle, DoLogTraceHandleUtf8
+    )
+
 #if WXWIN_COMPATIBILITY_2_8
     WX_DEFINE_VARARG_FUNC_VOID
     (
@@ -1076,6 +1337,20 @@ private:
         va_end(argptr);
     }
 
+    void DoLogTraceHandle(const wxLogTraceMaskHandle& mask,
+                          const wxChar *format, ...)
+    {
+        if ( !mask.IsEnabled() )
+            return;
+
+        Store(wxLOG_KEY_TRACE_MASK, mask.GetMask());
+
+        va_list argptr;
+        va_start(argptr, format);
+        DoCallOnLog(format, argptr);
+        va_end(argptr);
+    }
+
 #if WXWIN_COMPATIBILITY_2_8
     void DoLogTraceMask(wxTraceMask mask, const wxChar *format, ...)
     {
@@ -1145,6 +1420,20 @@ private:
         va_end(argptr);
     }
 
+    void DoLogTraceHandleUtf8(const wxLogTraceMaskHandle& mask,
+                              const char *format, ...)
+    {
+        if ( !mask.IsEnabled() )
+            return;
+
+        Store(wxLOG_KEY_TRACE_MASK, mask.GetMask());
+
+        va_list argptr;
+        va_start(argptr, format);
+        DoCallOnLog(format, argptr);
+        va_end(argptr);
+    }
+
 #if WXWIN_COMPATIBILITY_2_8
     void DoLogTraceMaskUtf8(wxTraceMask mask, const char *format, ...)
     {
@@ -1404,6 +1693,28 @@ public:
     wxLogNull() { }
 };
 
+// Trivial versions of the handle classes which can't be enabled
+class wxLogTraceMaskHandle
+{
+public:
+    explicit wxLogTraceMaskHandle(const wxString& WXUNUSED(mask)) { }
+
+    bool IsEnabled() const { return false; }
+};
+
+class wxLogComponentHandle
+{
+public:
+    explicit wxLogComponentHandle(const char *component)
+        : m_component(component) { }
+
+    const char *GetComponent() const { return m_component; }
+    operator const char *() const { return m_component; }
+
+private:
+    const char * const m_component;
+};
+
 // Dummy macros to replace some functions.
 #define wxSysErrorCode() (unsigned long)0
 #define wxSysErrorMsg( X ) (const wxChar*)NULL
@@ -1451,11 +1762,21 @@ public:
 #endif // wxUSE_LOG_DEBUG/!wxUSE_LOG_DEBUG
 
 #if wxUSE_LOG_TRACE
-    #define wxLogTrace                                                        \
-        if ( !wxLog::IsLevelEnabled(wxLOG_Trace, wxLOG_COMPONENT) )           \
-        {}                                                                    \
-        else                                                                  \
-            wxMAKE_LOGGER(Trace).LogTrace
+    #ifdef HAVE_VARIADIC_MACROS
+        // check the mask before evaluating any other arguments, notice that
+        // the mask expression is evaluated twice
+        #define wxLogTrace(mask, ...)                                         \
+            if ( !wxLog::IsTraceEnabled(mask, wxLOG_COMPONENT) )              \
+            {}                                                                \
+            else                                                              \
+                wxMAKE_LOGGER(Trace).LogTrace(mask, __VA_ARGS__)
+    #else // !HAVE_VARIADIC_MACROS
+        #define wxLogTrace                                                    \
+            if ( !wxLog::IsLevelEnabled(wxLOG_Trace, wxLOG_COMPONENT) )       \
+            {}                                                                \
+            else                                                              \
+                wxMAKE_LOGGER(Trace).LogTrace
+    #endif // HAVE_VARIADIC_MACROS/!HAVE_VARIADIC_MACROS
     #define wxVLogTrace                                                       \
         if ( !wxLog::IsLevelEnabled(wxLOG_Trace, wxLOG_COMPONENT) )           \
         {}                                                                    \
@@ -1471,6 +1792,7 @@ public:
         WX_DEFINE_VARARG_FUNC_NOP(wxLogTrace, 2, (wxTraceMask, const wxFormatString&))
         #endif
         WX_DEFINE_VARARG_FUNC_NOP(wxLogTrace, 2, (const wxString&, const wxFormatString&))
+        WX_DEFINE_VARARG_FUNC_NOP(wxLogTrace, 2, (const wxLogTraceMaskHandle&, const wxFormatString&))
     #endif // HAVE_VARIADIC_MACROS/!HAVE_VARIADIC_MACROS
 #endif // wxUSE_LOG_TRACE/!wxUSE_LOG_TRACE
 
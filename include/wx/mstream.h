@@ -44,7 +44,22 @@ public:
 
     wxStreamBuffer *GetInputStreamBuffer() const { return m_i_streambuf; }
 
+    // Return the pointer to the data which hasn't been read yet and fill size
+    // with its length, allowing to use it directly instead of copying it. The
+    // stream position is not changed, use SeekI() to skip the used data.
+    //
+    // Returns NULL if the data put back into the stream with Ungetch() hasn't
+    // been read yet, as it is not contiguous with the rest of it.
+    const void *GetUnreadData(size_t *size) const;
+
 protected:
+    // ctor for the derived classes which need to initialize the base class
+    // before getting the data: InitFromData() must be called later
+    wxMemoryInputStream();
+
+    // use the given data, which must remain valid for the stream lifetime
+    void InitFromData(const void *data, size_t len);
+
     wxStreamBuffer *m_i_streambuf;
 
     size_t OnSysRead(void *buffer, size_t nbytes) wxOVERRIDE;
@@ -0,0 +1,32 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/image.h
+// Purpose:     Helpers for converting image data with alpha
+// Author:      wxWidgets team
+// Copyright:   (c) 2020 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGE_H_
+#define _WX_PRIVATE_IMAGE_H_
+
+// Returns the component multiplied by alpha, rounded to the nearest integer.
+//
+// This is used by wxImage::GetRGBA() and by all the other code converting
+// straight alpha to the premultiplied one, so that the same data always gives
+// the same results.
+inline unsigned char wxPremultiplyAlpha(unsigned alpha, unsigned component)
+{
+    // This is an exact way to compute (component*alpha)/255 with rounding
+    // without using the slow division.
+    const unsigned t = component*alpha + 128;
+    return static_cast<unsigned char>((t + (t >> 8)) >> 8);
+}
+
+// Undoes the operation above, as far as possible, alpha must be non-zero.
+inline unsigned char wxUnpremultiplyAlpha(unsigned alpha, unsigned component)
+{
+    const unsigned c = (component*255 + alpha/2) / alpha;
+    return static_cast<unsigned char>(c > 255 ? 255 : c);
+}
+
+#endif // _WX_PRIVATE_IMAGE_H_
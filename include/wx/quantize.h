@@ -32,6 +32,8 @@ class WXDLLIMPEXP_FWD_CORE wxPalette;
 #define wxQUANTIZE_INCLUDE_WINDOWS_COLOURS      0x01
 #define wxQUANTIZE_RETURN_8BIT_DATA             0x02
 #define wxQUANTIZE_FILL_DESTINATION_IMAGE       0x04
+#define wxQUANTIZE_NO_DITHERING                 0x08
+#define wxQUANTIZE_REFINE_COLOURS               0x10
 
 class WXDLLIMPEXP_CORE wxQuantize: public wxObject
 {
@@ -67,7 +69,8 @@ public:
     // in_rows and out_rows are arrays [0..h-1] of pointer to rows
     // (in_rows contains w * 3 bytes per row, out_rows w bytes per row)
     // fills out_rows with indexes into palette (which is also stored into palette variable)
-    static void DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows, unsigned char *palette, int desiredNoColours);
+    // flags can contain wxQUANTIZE_NO_DITHERING and wxQUANTIZE_REFINE_COLOURS
+    static void DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows, unsigned char *palette, int desiredNoColours, int flags = 0);
 
 };
 
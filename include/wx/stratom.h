@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/stratom.h
+// Purpose:     wxStringAtom: interned, i.e. unique, immutable strings
+// Created:     2020-03-14
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_STRATOM_H_
+#define _WX_STRATOM_H_
+
+#include "wx/string.h"
+#include "wx/atomic.h"
+
+// ----------------------------------------------------------------------------
+// wxStringAtom: handle to a string stored in the global pool of strings
+// ----------------------------------------------------------------------------
+
+// All atoms created from equal strings share the same pooled copy of the
+// string, so they can be compared and hashed in constant time and don't take
+// any extra memory. The strings are reference-counted and are removed from the
+// pool once the last atom referencing them is destroyed.
+//
+// This class can be used from multiple threads concurrently.
+class WXDLLIMPEXP_BASE wxStringAtom
+{
+public:
+    // Default ctor creates an atom corresponding to the empty string.
+    wxStringAtom() : m_entry(NULL) { }
+
+    // Creating atoms from strings requires looking them up in the pool, so
+    // these ctors are explicit to avoid doing it accidentally.
+    explicit wxStringAtom(const wxString& str) { Init(str); }
+    explicit wxStringAtom(const char* str) { Init(wxString(str)); }
+    explicit wxStringAtom(const wchar_t* str) { Init(wxString(str)); }
+
+    // Create an atom from UTF-8 string, this avoids creating a temporary
+    // wxString if the string is already present in the pool and only
+    // contains ASCII characters, which is the common case for the names of
+    // the elements and attributes in XML or HTML documents, for example.
+    static wxStringAtom FromUTF8(const char* utf8, size_t len = wxNO_LEN);
+
+    wxStringAtom(const wxStringAtom& atom)
+        : m_entry(atom.m_entry)
+    {
+        if ( m_entry )
+            wxAtomicInc(m_entry->m_refCount);
+    }
+
+    wxStringAtom& operator=(const wxStringAtom& atom)
+    {
+        if ( atom.m_entry != m_entry )
+        {
+            if ( atom.m_entry )
+                wxAtomicInc(atom.m_entry->m_refCount);
+
+            Release();
+            m_entry = atom.m_entry;
+        }
+
+        return *this;
+    }
+
+    ~wxStringAtom() { Release(); }
+
+
+    // Accessors.
+    const wxString& GetString() const
+        { return m_entry ? m_entry->m_str : GetEmptyString(); }
+    operator const wxString&() const { return GetString(); }
+
+    bool IsEmpty() const { return m_entry == NULL; }
+    bool empty() const { return IsEmpty(); }
+
+    // Hash value of the string, it is the same for all equal strings.
+    size_t GetHash() const { return m_entry ? m_entry->m_hash : 0; }
+
+    // Comparison is done by just comparing the pointers.
+    bool operator==(const wxStringAtom& atom) const
+        { return m_entry == atom.m_entry; }
+    bool operator!=(const wxStringAtom& atom) const
+        { return m_entry != atom.m_entry; }
+
+
+    // Return the number of distinct strings currently stored in the pool,
+    // this is mostly useful for testing.
+    static size_t GetPoolSize();
+
+private:
+    // This struct is only used by wxStringAtom itself and its pool and is
+    // defined here only to allow inlining copying the atoms.
+    struct Entry
+    {
+        Entry(const wxString& str, size_t hash)
+            : m_str(str), m_hash(hash), m_refCount(1)
+        {
+        }
+
+        const wxString m_str;
+        const size_t m_hash;
+        wxAtomicInt m_refCount;
+
+        wxDECLARE_NO_COPY_CLASS(Entry);
+    };
+
+    explicit wxStringAtom(Entry* entry) : m_entry(entry) { }
+
+    void Init(const wxString& str);
+    void Release();
+
+    static const wxString& GetEmptyString();
+
+    // NULL for the empty string.
+    Entry* m_entry;
+
+    friend class wxStringAtomPool;
+};
+
+// ----------------------------------------------------------------------------
+// Helpers for using wxStringAtom as a key in hash maps
+// ----------------------------------------------------------------------------
+
+struct wxStringAtomHash
+{
+    wxStringAtomHash() { }
+    size_t operator()(const wxStringAtom& atom) const
+        { return atom.GetHash(); }
+};
+
+struct wxStringAtomEqual
+{
+    wxStringAtomEqual() { }
+    bool operator()(const wxStringAtom& a, const wxStringAtom& b) const
+        { return a == b; }
+};
+
+#endif // _WX_STRATOM_H_
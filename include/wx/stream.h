@@ -43,6 +43,14 @@ enum wxStreamError
 
 const int wxEOF = -1;
 
+// a memory buffer used by the scatter/gather functions wxInputStream::ReadV()
+// and wxOutputStream::WriteV(), similar to the standard struct iovec
+struct wxStreamIOVec
+{
+    void *data;
+    size_t size;
+};
+
 // ============================================================================
 // base stream classes: wxInputStream and wxOutputStream
 // ============================================================================
@@ -132,6 +140,11 @@ public:
     // method either reads all the data or returns false.
     bool ReadAll(void *buffer, size_t size);
 
+    // read the data into several buffers, filling each of them completely, as
+    // ReadAll() does, before passing to the next one and stopping at EOF or
+    // error: LastRead() returns the total number of bytes read
+    virtual wxInputStream& ReadV(const wxStreamIOVec *vec, size_t count);
+
     // copy the entire contents of this stream into streamOut, stopping only
     // when EOF is reached or an error occurs
     wxInputStream& Read(wxOutputStream& streamOut);
@@ -243,6 +256,10 @@ public:
     // less data than requested but still return without error.
     bool WriteAll(const void *buffer, size_t size);
 
+    // write the data from several buffers in order, stopping at the first
+    // error: LastWrite() returns the total number of bytes written
+    virtual wxOutputStream& WriteV(const wxStreamIOVec *vec, size_t count);
+
     wxOutputStream& Write(wxInputStream& stream_in);
 
     virtual wxFileOffset SeekO(wxFileOffset pos, wxSeekMode mode = wxFromStart);
@@ -33,6 +33,10 @@
 #include <limits.h>
 #include <stdlib.h>
 
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)
+    #include <utility>      // for std::move()
+#endif
+
 #include "wx/wxcrtbase.h"   // for wxChar, wxStrlen() etc.
 #include "wx/strvararg.h"
 #include "wx/buffer.h"      // for wxCharBuffer
@@ -73,6 +77,14 @@
     #endif
 #endif // wxUSE_STRING_POS_CACHE
 
+// the move ctor and assignment operator below are available since MSVC 2010,
+// but noexcept is only supported starting from MSVC 2015
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(14)
+    #define wxSTRING_NOEXCEPT noexcept
+#else
+    #define wxSTRING_NOEXCEPT
+#endif
+
 class WXDLLIMPEXP_FWD_BASE wxString;
 
 // unless this symbol is predefined to disable the compatibility functions, do
@@ -1099,6 +1111,20 @@ public:
     // copy ctor
   wxString(const wxString& stringSrc) : m_impl(stringSrc.m_impl) { }
 
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)
+    // move ctor: this also takes over the conversion buffers of the other
+    // string to avoid having to allocate them again
+  wxString(wxString&& stringSrc) wxSTRING_NOEXCEPT
+    : m_impl(std::move(stringSrc.m_impl))
+  {
+#if wxUSE_STRING_POS_CACHE
+      stringSrc.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
+
+      SwapConvertedBuffers(stringSrc);
+  }
+#endif // C++11
+
     // string containing nRepeat copies of ch
   wxString(wxUniChar ch, size_t nRepeat = 1 )
     { assign(nRepeat, ch); }
@@ -1818,6 +1844,27 @@ public:
     return *this;
   }
 
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)
+    // from a temporary string, the conversion buffers are exchanged with it
+    // in the same way as in the move ctor
+  wxString& operator=(wxString&& stringSrc) wxSTRING_NOEXCEPT
+  {
+    if ( this != &stringSrc )
+    {
+        wxSTRING_INVALIDATE_CACHE();
+#if wxUSE_STRING_POS_CACHE
+        stringSrc.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
+
+        m_impl = std::move(stringSrc.m_impl);
+
+        SwapConvertedBuffers(stringSrc);
+    }
+
+    return *this;
+  }
+#endif // C++11
+
   wxString& operator=(const wxCStrData& cstr)
     { return *this = cstr.AsString(); }
     // from a character
@@ -3368,29 +3415,45 @@ private:
   // existing code and consistency with std::string::c_str() so returning a
   // temporary buffer won't do and we need to cache the conversion results
 
-  // TODO-UTF8: benchmark various approaches to keeping compatibility buffers
   template<typename T>
   struct ConvertedBuffer
   {
-      // notice that there is no need to initialize m_len here as it's unused
-      // as long as m_str is NULL
-      ConvertedBuffer() : m_str(NULL), m_len(0) {}
+      ConvertedBuffer() : m_str(NULL), m_len(0), m_capacity(0) {}
       ~ConvertedBuffer()
           { free(m_str); }
 
+      // ensure that the buffer can hold a string of the given length and set
+      // its length to it
+      //
+      // the existing buffer is reused if it is big enough: this avoids
+      // reallocating it every time when the string is converted repeatedly,
+      // and also ensures that the pointer returned by a previous conversion
+      // remains valid as long as the string doesn't become longer
       bool Extend(size_t len)
       {
-          // add extra 1 for the trailing NUL
-          void * const str = realloc(m_str, sizeof(T)*(len + 1));
-          if ( !str )
-              return false;
+          if ( !m_str || len > m_capacity )
+          {
+              // add extra 1 for the trailing NUL
+              void * const str = realloc(m_str, sizeof(T)*(len + 1));
+              if ( !str )
+                  return false;
+
+              m_str = static_cast<T *>(str);
+              m_capacity = len;
+          }
 
-          m_str = static_cast<T *>(str);
           m_len = len;
 
           return true;
       }
 
+      void Swap(ConvertedBuffer& other)
+      {
+          wxSwap(m_str, other.m_str);
+          wxSwap(m_len, other.m_len);
+          wxSwap(m_capacity, other.m_capacity);
+      }
+
       const wxScopedCharTypeBuffer<T> AsScopedBuffer() const
       {
           return wxScopedCharTypeBuffer<T>::CreateNonOwned(m_str, m_len);
@@ -3398,8 +3461,21 @@ private:
 
       T *m_str;     // pointer to the string data
       size_t m_len; // length, not size, i.e. in chars and without last NUL
+      size_t m_capacity; // length of the longest string the buffer can hold
   };
 
+  // exchange the conversion buffers with another string, this is used when
+  // moving strings to reuse the buffers of the string being moved from
+  void SwapConvertedBuffers(wxString& str)
+  {
+#if wxUSE_UNICODE
+      m_convertedToChar.Swap(str.m_convertedToChar);
+#endif // wxUSE_UNICODE
+#if !wxUSE_UNICODE_WCHAR
+      m_convertedToWChar.Swap(str.m_convertedToWChar);
+#endif // !wxUSE_UNICODE_WCHAR
+  }
+
 
 #if wxUSE_UNICODE
   // common mb_str() and wxCStrData::AsChar() helper: performs the conversion
@@ -66,6 +66,11 @@ public:
     bool HasMoreTokens() const;
         // get the next token, will return empty string if !HasMoreTokens()
     wxString GetNextToken();
+        // get the next token without copying it: fill in the iterators
+        // pointing to its start and end in the string returned by
+        // GetInputString() and return false if !HasMoreTokens()
+    bool GetNextTokenRange(wxString::const_iterator* tokenStart,
+                           wxString::const_iterator* tokenEnd);
         // get the delimiter which terminated the token last retrieved by
         // GetNextToken() or NUL if there had been no tokens yet or the last
         // one wasn't terminated (but ran to the end of the string)
@@ -76,6 +81,11 @@ public:
         // initial string)
     wxString GetString() const { return wxString(m_pos, m_string.end()); }
 
+        // returns the full string being tokenized: the iterators returned by
+        // GetNextTokenRange() point into it and remain valid until the next
+        // call to SetString() or Reinit()
+    const wxString& GetInputString() const { return m_string; }
+
         // returns the current position (i.e. one index after the last
         // returned token or 0 if GetNextToken() has never been called) in the
         // original string
@@ -117,6 +127,14 @@ protected:
 
     void DoCopyFrom(const wxStringTokenizer& src);
 
+    // check if the given character is one of the delimiters
+    bool IsDelim(wxUniChar ch) const;
+
+    // find the first delimiter or non-delimiter character starting from the
+    // given position, return m_stringEnd if there is none
+    wxString::const_iterator FindDelim(wxString::const_iterator from) const;
+    wxString::const_iterator FindNonDelim(wxString::const_iterator from) const;
+
     enum MoreTokensState
     {
         MoreTokens_Unknown,
@@ -132,6 +150,11 @@ protected:
     wxWxCharBuffer m_delims;        // all possible delimiters
     size_t m_delimsLen;
 
+    // bit mask of ASCII delimiters, allowing to check for them without
+    // searching m_delims, and whether there are any non-ASCII ones too
+    wxUint32 m_asciiDelims[4];
+    bool m_hasNonAsciiDelims;
+
     wxString::const_iterator m_pos; // the current position in m_string
 
     wxStringTokenizerMode m_mode;   // see wxTOKEN_XXX values
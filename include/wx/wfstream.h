@@ -18,8 +18,10 @@
 #include "wx/object.h"
 #include "wx/string.h"
 #include "wx/stream.h"
+#include "wx/mstream.h"
 #include "wx/file.h"
 #include "wx/ffile.h"
+#include "wx/buffer.h"
 
 #if wxUSE_FILE
 
@@ -43,6 +45,8 @@ public:
 
     wxFile* GetFile() const { return m_file; }
 
+    virtual wxInputStream& ReadV(const wxStreamIOVec *vec, size_t count) wxOVERRIDE;
+
 protected:
     wxFileInputStream();
 
@@ -75,6 +79,8 @@ public:
 
     wxFile* GetFile() const { return m_file; }
 
+    virtual wxOutputStream& WriteV(const wxStreamIOVec *vec, size_t count) wxOVERRIDE;
+
 protected:
     wxFileOutputStream();
 
@@ -175,6 +181,31 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxFileStream);
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: memory stream using the file mapped into memory
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFileInputStream : public wxMemoryInputStream
+{
+public:
+    wxMappedFileInputStream(const wxString& fileName);
+    virtual ~wxMappedFileInputStream();
+
+    // returns true if the file is really mapped into memory and false if its
+    // contents had to be read into a buffer instead
+    bool IsMapped() const { return m_mapped; }
+
+private:
+    void *m_data;
+    size_t m_size;
+    bool m_mapped;
+
+    // used for the files which can't be mapped, e.g. pipes or empty files
+    wxMemoryBuffer m_buffer;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFileInputStream);
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
@@ -65,6 +65,20 @@ WXDLLIMPEXP_BASE size_t wxWC2MB(char *buf, const wchar_t *psz, size_t n);
 #include <string.h>
 
 #if wxUSE_UNICODE
+#if wxUSE_STD_STRING && defined(HAVE_STD_WSTRING)
+    // <string> is already included by wx/string.h in this case, so use the
+    // standard library functions which are usually much faster than the
+    // loops below as they're implemented using SIMD instructions if possible
+    inline wxChar* wxTmemchr(const wxChar* s, wxChar c, size_t l)
+    {
+        return const_cast<wxChar*>(std::char_traits<wchar_t>::find(s, l, c));
+    }
+
+    inline int wxTmemcmp(const wxChar* sz1, const wxChar* sz2, size_t len)
+    {
+        return std::char_traits<wchar_t>::compare(sz1, sz2, len);
+    }
+#else // !wxUSE_STD_STRING
     //implement our own wmem variants
     inline wxChar* wxTmemchr(const wxChar* s, wxChar c, size_t l)
     {
@@ -77,13 +91,14 @@ WXDLLIMPEXP_BASE size_t wxWC2MB(char *buf, const wchar_t *psz, size_t n);
 
     inline int wxTmemcmp(const wxChar* sz1, const wxChar* sz2, size_t len)
     {
-        for(; *sz1 == *sz2 && len; --len, ++sz1, ++sz2) {}
+        for(; len && *sz1 == *sz2; --len, ++sz1, ++sz2) {}
 
         if(len)
             return *sz1 < *sz2 ? -1 : *sz1 > *sz2;
         else
             return 0;
     }
+#endif // wxUSE_STD_STRING/!wxUSE_STD_STRING
 
     inline wxChar* wxTmemcpy(wxChar* szOut, const wxChar* szIn, size_t len)
     {
@@ -16,6 +16,7 @@
 #if wxUSE_XML
 
 #include "wx/string.h"
+#include "wx/stratom.h"
 #include "wx/object.h"
 #include "wx/list.h"
 #include "wx/textbuf.h"
@@ -35,6 +36,7 @@ class WXDLLIMPEXP_FWD_XML wxXmlDocument;
 class WXDLLIMPEXP_FWD_XML wxXmlIOHandler;
 class WXDLLIMPEXP_FWD_BASE wxInputStream;
 class WXDLLIMPEXP_FWD_BASE wxOutputStream;
+struct wxXmlParsingContext;
 
 // Represents XML node type.
 enum wxXmlNodeType
@@ -67,18 +69,23 @@ public:
     wxXmlAttribute(const wxString& name, const wxString& value,
                   wxXmlAttribute *next = NULL)
             : m_name(name), m_value(value), m_next(next) {}
+    wxXmlAttribute(const wxStringAtom& name, const wxString& value,
+                  wxXmlAttribute *next = NULL)
+            : m_name(name), m_value(value), m_next(next) {}
     virtual ~wxXmlAttribute() {}
 
     const wxString& GetName() const { return m_name; }
+    const wxStringAtom& GetNameAtom() const { return m_name; }
     const wxString& GetValue() const { return m_value; }
     wxXmlAttribute *GetNext() const { return m_next; }
 
-    void SetName(const wxString& name) { m_name = name; }
+    void SetName(const wxString& name) { m_name = wxStringAtom(name); }
+    void SetName(const wxStringAtom& name) { m_name = name; }
     void SetValue(const wxString& value) { m_value = value; }
     void SetNext(wxXmlAttribute *next) { m_next = next; }
 
 private:
-    wxString m_name;
+    wxStringAtom m_name;
     wxString m_value;
     wxXmlAttribute *m_next;
 };
@@ -126,6 +133,9 @@ public:
     wxXmlNode(wxXmlNodeType type, const wxString& name,
               const wxString& content = wxEmptyString,
               int lineNo = -1);
+    wxXmlNode(wxXmlNodeType type, const wxStringAtom& name,
+              const wxString& content = wxEmptyString,
+              int lineNo = -1);
     virtual void AddChild(wxXmlNode *child);
     virtual bool InsertChild(wxXmlNode *child, wxXmlNode *followingNode);
     virtual bool InsertChildAfter(wxXmlNode *child, wxXmlNode *precedingNode);
@@ -136,6 +146,7 @@ public:
     // access methods:
     wxXmlNodeType GetType() const { return m_type; }
     const wxString& GetName() const { return m_name; }
+    const wxStringAtom& GetNameAtom() const { return m_name; }
     const wxString& GetContent() const { return m_content; }
 
     bool IsWhitespaceOnly() const;
@@ -161,7 +172,8 @@ public:
     int GetLineNumber() const { return m_lineNo; }
 
     void SetType(wxXmlNodeType type) { m_type = type; }
-    void SetName(const wxString& name) { m_name = name; }
+    void SetName(const wxString& name) { m_name = wxStringAtom(name); }
+    void SetName(const wxStringAtom& name) { m_name = name; }
     void SetContent(const wxString& con) { m_content = con; }
 
     void SetParent(wxXmlNode *parent) { m_parent = parent; }
@@ -209,7 +221,7 @@ private:
 
 private:
     wxXmlNodeType m_type;
-    wxString m_name;
+    wxStringAtom m_name;
     wxString m_content;
     wxXmlAttribute *m_attrs;
     wxXmlNode *m_parent, *m_children, *m_next;
@@ -359,6 +371,81 @@ private:
     wxDECLARE_CLASS(wxXmlDocument);
 };
 
+
+// Return value of wxXmlStreamParser::OnStartElement() telling the parser how
+// to handle the element contents.
+enum wxXmlStreamAction
+{
+    wxXML_STREAM_CONTINUE,      // notify about the contents of the element
+    wxXML_STREAM_SKIP,          // skip the element entirely
+    wxXML_STREAM_BUILD_NODE     // build wxXmlNode for the element
+};
+
+// This class parses XML without building the document tree in memory, the
+// derived class is notified about the contents of the document instead and
+// may build wxXmlNode objects only for the elements it is interested in.
+
+class WXDLLIMPEXP_XML wxXmlStreamParser
+{
+public:
+    wxXmlStreamParser() : m_ctx(NULL) {}
+    virtual ~wxXmlStreamParser() {}
+
+    // Parses the XML file or stream, returns TRUE on success, FALSE
+    // otherwise.
+    bool Parse(const wxString& filename,
+               const wxString& encoding = wxT("UTF-8"), int flags = wxXMLDOC_NONE);
+    bool Parse(wxInputStream& stream,
+               const wxString& encoding = wxT("UTF-8"), int flags = wxXMLDOC_NONE);
+
+    // These functions can only be called from the notification functions
+    // while parsing.
+
+    // Stops parsing, Parse() returns TRUE in this case.
+    void Stop();
+    // Returns the line number in the document being parsed.
+    int GetLineNumber() const;
+    // Returns the number of elements enclosing the current position.
+    int GetDepth() const;
+
+    // Information about the document itself, available after the start of
+    // the root element was notified.
+    const wxString& GetVersion() const { return m_version; }
+    const wxString& GetFileEncoding() const { return m_fileEncoding; }
+    const wxXmlDoctype& GetDoctype() const { return m_doctype; }
+
+protected:
+    // Notification functions overridden by the derived class to handle the
+    // document contents. Notice that the strings passed to them are only
+    // valid during the call.
+
+    virtual wxXmlStreamAction
+    OnStartElement(const wxString& WXUNUSED(name),
+                   const wxXmlAttribute *WXUNUSED(attrs))
+        { return wxXML_STREAM_CONTINUE; }
+    virtual void OnEndElement(const wxString& WXUNUSED(name)) { }
+
+    // Called instead of OnEndElement() if OnStartElement() returned
+    // wxXML_STREAM_BUILD_NODE, the node must be deleted by the caller.
+    virtual void OnElementNode(wxXmlNode *node) { delete node; }
+
+    virtual void OnText(const wxString& WXUNUSED(text)) { }
+    virtual void OnCData(const wxString& WXUNUSED(text)) { }
+    virtual void OnComment(const wxString& WXUNUSED(text)) { }
+    virtual void OnProcessingInstruction(const wxString& WXUNUSED(target),
+                                         const wxString& WXUNUSED(data)) { }
+
+private:
+    wxXmlParsingContext *m_ctx;     // only non-NULL while parsing
+    wxString m_version;
+    wxString m_fileEncoding;
+    wxXmlDoctype m_doctype;
+
+    friend struct wxXmlParsingContext;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlStreamParser);
+};
+
 #endif // wxUSE_XML
 
 #endif // _WX_XML_H_
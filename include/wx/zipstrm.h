@@ -15,6 +15,7 @@
 
 #include "wx/archive.h"
 #include "wx/filename.h"
+#include "wx/vector.h"
 
 // some methods from wxZipInputStream and wxZipOutputStream stream do not get
 // exported/imported when compiled with Mingw versions before 3.4.2. So they
@@ -122,6 +123,8 @@ enum wxZipArchiveFormat
 //
 class WXDLLIMPEXP_FWD_BASE wxZipEntry;
 class WXDLLIMPEXP_FWD_BASE wxZipInputStream;
+class WXDLLIMPEXP_FWD_BASE wxZipIndex;
+class WXDLLIMPEXP_FWD_BASE wxZipParallelWriter;
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -279,6 +282,8 @@ private:
 
     friend class wxZipInputStream;
     friend class wxZipOutputStream;
+    friend class wxZipIndex;
+    friend class wxZipParallelWriter;
 
     wxDECLARE_DYNAMIC_CLASS(wxZipEntry);
 };
@@ -370,10 +375,42 @@ private:
     bool m_endrecWritten;
     wxZipArchiveFormat m_format;
 
+    friend class wxZipParallelWriter;
+
     wxDECLARE_NO_COPY_CLASS(wxZipOutputStream);
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipParallelWriter - compresses the entries added to it on several
+// threads and writes them to a wxZipOutputStream in the order in which they
+// were added, using the same headers as writing them directly would.
+
+class WXDLLIMPEXP_BASE wxZipParallelWriter
+{
+public:
+    wxZipParallelWriter(wxZipOutputStream& zip, int threads = 0);
+    ~wxZipParallelWriter();
+
+    bool AddEntry(wxZipEntry *entry, const void *data, size_t size);
+    bool AddEntry(const wxString& name, const void *data, size_t size,
+                  const wxDateTime& dt = wxDateTime::Now());
+    bool AddDirEntry(const wxString& name,
+                     const wxDateTime& dt = wxDateTime::Now());
+
+    bool Finish();
+
+    int GetThreadCount() const;
+
+private:
+    bool WriteEntry(class wxZipCompressJob *job);
+
+    class wxZipParallelWriterImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipParallelWriter);
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // wxZipInputStream
 
@@ -388,6 +425,7 @@ public:
     virtual WXZIPFIX ~wxZipInputStream();
 
     bool OpenEntry(wxZipEntry& entry)   { return DoOpen(&entry); }
+    bool WXZIPFIX OpenEntry(const wxZipIndex& index, size_t n);
     bool WXZIPFIX CloseEntry() wxOVERRIDE;
 
     wxZipEntry *GetNextEntry();
@@ -420,6 +458,8 @@ private:
     bool FindEndRecord();
     bool LoadEndRecord();
 
+    void InitFromIndex(const wxZipIndex& index);
+
     bool AtHeader() const       { return m_headerSize == 0; }
     bool AfterHeader() const    { return m_headerSize > 0 && !m_decomp; }
     bool IsOpened() const       { return m_decomp != NULL; }
@@ -428,9 +468,11 @@ private:
 
     bool DoOpen(wxZipEntry *entry = NULL, bool raw = false);
     bool OpenDecompressor(bool raw = false);
+    wxInputStream& GetCompressedData(wxFileOffset size);
 
     class wxStoredInputStream *m_store;
     class wxZlibInputStream2 *m_inflate;
+    class wxMemoryInputStream *m_memview;
     class wxRawInputStream *m_rawin;
     wxZipEntry m_entry;
     bool m_raw;
@@ -450,11 +492,54 @@ private:
                     wxZipEntry *entry, wxZipInputStream& inputStream);
     friend bool wxZipOutputStream::CopyArchiveMetaData(
                     wxZipInputStream& inputStream);
+    friend class wxZipIndex;
 
     wxDECLARE_NO_COPY_CLASS(wxZipInputStream);
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipIndex - the central directory of a zip loaded in a single read and
+// indexed by name, so that entries can be found without creating a
+// wxZipEntry for every one of them and then opened directly by seeking.
+//
+// Once loaded the index is never modified, so its const methods can be
+// used concurrently from several threads, each one opening the entries on
+// its own stream for the same archive.
+
+class WXDLLIMPEXP_BASE wxZipIndex
+{
+public:
+    wxZipIndex();
+
+    bool Load(wxInputStream& stream, wxMBConv& conv = wxConvLocal);
+
+    bool IsOk() const                   { return m_conv != NULL; }
+    size_t GetCount() const             { return m_records.size(); }
+    wxString GetComment() const         { return m_Comment; }
+
+    int Find(const wxString& name,
+             wxPathFormat format = wxPATH_NATIVE) const;
+    wxZipEntry *GetEntry(size_t n) const;
+
+private:
+    wxString GetInternalName(size_t n) const;
+
+    wxMemoryBuffer m_central;           // the raw central directory
+    wxVector<wxUint32> m_records;       // offsets of the entries in it
+    wxVector<wxUint32> m_hashes;        // hashes of the entry names
+    wxVector<wxUint32> m_table;         // open addressed, entry index + 1
+    wxMBConv *m_conv;
+    wxFileOffset m_centralOffset;
+    wxFileOffset m_offsetAdjustment;
+    wxString m_Comment;
+
+    friend class wxZipInputStream;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipIndex);
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
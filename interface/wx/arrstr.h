@@ -239,6 +239,27 @@ public:
     */
     void Sort(CompareFunction compareFunction);
 
+    /**
+        Sorts the array using multiple threads if possible.
+
+        This function sorts the array in the same order as Sort() with the
+        same @a compareFunction, but may split a big array into several parts
+        and sort them in parallel, using all the available CPUs, and merge the
+        results. This is only done for arrays containing at least several
+        thousands of strings and only if the library was built with thread
+        support and with wxString based on @c std::basic_string, otherwise
+        this function simply behaves as Sort().
+
+        Notice that @a compareFunction is called from several threads
+        simultaneously, so it must be thread-safe. All the standard comparison
+        functions, such as wxStringSortAscending() or wxCmpNatural(), are.
+
+        Unlike Sort(), this function can't be used with wxSortedArrayString.
+
+        @since 3.1.4
+    */
+    void ParallelSort(CompareFunction compareFunction = wxStringSortAscending);
+
     /**
         Compares 2 arrays respecting the case. Returns @true if the arrays have
         different number of elements or if the elements don't match pairwise.
@@ -409,6 +430,52 @@ int wxDictionaryStringSortAscending(const wxString& s1, const wxString& s2);
  */
 int wxDictionaryStringSortAscending(const wxString& s1, const wxString& s2);
 
+/**
+    Compares two strings using the natural sort order.
+
+    The natural order is the order in which the strings containing numbers
+    are usually sorted by humans: the sequences of decimal digits are compared
+    by their numeric values, so that "file2.txt" comes before "file10.txt",
+    and all the other characters are compared case-insensitively, as in the
+    dictionary order.
+
+    The strings which are equal using these rules, e.g. "file01" and "file1"
+    or "File" and "file", are still ordered in a consistent way, so that this
+    function only returns 0 for identical strings.
+
+    This function doesn't allocate any memory and works with numbers of any
+    length, so it can be used to efficiently sort big arrays of file names,
+    see wxNaturalStringSortAscending().
+
+    @return A negative value, 0 or a positive value if @a s1 is less than,
+        equal to or greater than @a s2 respectively.
+
+    @since 3.1.4
+ */
+int wxCmpNatural(const wxString& s1, const wxString& s2);
+
+/**
+    Comparison function comparing strings in natural order.
+
+    This function can be used with wxArrayString::Sort() or passed as an
+    argument to wxSortedArrayString constructor, see wxCmpNatural() for the
+    description of the natural order.
+
+    @see wxNaturalStringSortDescending()
+
+    @since 3.1.4
+ */
+int wxNaturalStringSortAscending(const wxString& s1, const wxString& s2);
+
+/**
+    Comparison function comparing strings in reverse natural order.
+
+    @see wxNaturalStringSortAscending()
+
+    @since 3.1.4
+ */
+int wxNaturalStringSortDescending(const wxString& s1, const wxString& s2);
+
 // ============================================================================
 // Global functions/macros
 // ============================================================================
@@ -38,5 +38,23 @@ void wxAtomicInc(wxAtomicInt& value);
 */
 wxInt32 wxAtomicDec(wxAtomicInt& value);
 
+/**
+    This function adds @a delta to @a value in an atomic manner and returns
+    the new value.
+
+    Unlike wxAtomicDec(), the returned value is always exactly the value of
+    the variable after the addition, so this function can be used to
+    atomically reserve consecutive indices, e.g. slots in a ring buffer shared
+    between several threads. Calling it with zero @a delta can also be used
+    to read the current value of a variable modified by the other threads.
+
+    @see wxAtomicInc, wxAtomicDec
+
+    @header{wx/atomic.h}
+
+    @since 3.1.4
+*/
+wxInt32 wxAtomicAdd(wxAtomicInt& value, wxInt32 delta);
+
 //@}
 
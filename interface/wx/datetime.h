@@ -2149,6 +2149,154 @@ public:
 
 
 
+/**
+    @class wxDateTimeFormatter
+
+    wxDateTimeFormatter is used to format or parse many dates using the same
+    format string.
+
+    The format string uses the same syntax as wxDateTime::Format() and
+    wxDateTime::ParseFormat() but, unlike them, it is analysed only once, when
+    it is passed to the constructor or SetFormat(), rather than on every call.
+    If the format only contains the numeric fields, i.e. @c %%Y, @c %%y,
+    @c %%m, @c %%d, @c %%H, @c %%M, @c %%S, @c %%l and @c %%z (without any
+    explicitly specified width), as well as literal characters and @c %%%%,
+    which is the case for ISO 8601 format and most of the other fixed layouts
+    used in data files, formatting and parsing are done directly by this
+    class, which is much faster than using wxDateTime functions. Any other
+    format is also supported but simply uses wxDateTime methods.
+
+    Example of parsing the timestamps from a file:
+    @code
+    const wxDateTimeFormatter fmt("%Y-%m-%dT%H:%M:%S%z");
+
+    wxDateTime dt;
+    for ( size_t n = 0; n < lines.size(); n++ )
+    {
+        if ( !fmt.Parse(lines[n], &dt) )
+            wxLogWarning("Invalid timestamp at line %zu.", n + 1);
+        ...
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{data}
+
+    @since 3.1.4
+
+    @see wxDateTime::Format(), wxDateTime::ParseFormat()
+*/
+class wxDateTimeFormatter
+{
+public:
+    /**
+        Default constructor.
+
+        SetFormat() must be called before using this object.
+     */
+    wxDateTimeFormatter();
+
+    /**
+        Constructor using the given format.
+
+        This is the same as using the default constructor and calling
+        SetFormat().
+     */
+    explicit wxDateTimeFormatter(const wxString& format);
+
+    /**
+        Set the format to use.
+
+        The format string is analysed by this function and it must be called
+        again if the format is changed.
+     */
+    void SetFormat(const wxString& format);
+
+    /**
+        Returns the format passed to the constructor or SetFormat().
+     */
+    const wxString& GetFormat() const;
+
+    /**
+        Returns @true if the format is handled directly by this class.
+
+        If this function returns @false, Format() and Parse() use
+        wxDateTime::Format() and wxDateTime::ParseFormat(), so they are not
+        faster than calling these functions directly.
+     */
+    bool IsCompiled() const;
+
+    /**
+        Returns the string representation of the date in the given time zone.
+
+        The result is the same as returned by wxDateTime::Format() except
+        that @c %%z always uses the offset of the specified time zone.
+     */
+    wxString Format(const wxDateTime& dt,
+                    const wxDateTime::TimeZone& tz = wxDateTime::Local) const;
+
+    /**
+        Formats the date into the provided buffer.
+
+        If the format is compiled, this function doesn't allocate any memory.
+
+        The output is truncated if it doesn't fit into the buffer but is
+        always @NUL-terminated if @a size is not 0.
+
+        @param dt
+            The date to format, must be valid.
+        @param buf
+            The output buffer of at least @a size characters.
+        @param size
+            The size of the buffer, including the space for the trailing @NUL.
+        @param tz
+            The time zone to represent the date in.
+        @return
+            The length of the full result, not counting the trailing @NUL.
+            If it is greater than or equal to @a size, the output was
+            truncated.
+     */
+    size_t Format(const wxDateTime& dt,
+                  wxChar *buf,
+                  size_t size,
+                  const wxDateTime::TimeZone& tz = wxDateTime::Local) const;
+
+    /**
+        Parses the string using the format of this object.
+
+        The date components not present in the format are taken from today's
+        date and the time components are set to 0, i.e. this function works
+        like wxDateTime::ParseFormat() with wxDateTime::Today() as the default
+        date. Unlike that function, the string is interpreted as the time in
+        the given time zone, unless the format contains @c %%z. In this case,
+        the time zone from the string is used.
+
+        Notice that parsing the time in the local time zone is slower than
+        parsing it in any other one as the system functions need to be used to
+        account for DST.
+
+        @param date
+            The string to parse.
+        @param dt
+            Non-@NULL pointer to the date filled in on success.
+        @param tz
+            The time zone of the time in the string if the format doesn't
+            contain @c %%z.
+        @param end
+            If non-@NULL, filled with the iterator pointing to the first
+            character not parsed on success.
+        @return
+            @true if the string was parsed successfully or @false if it didn't
+            match the format.
+     */
+    bool Parse(const wxString& date,
+               wxDateTime *dt,
+               const wxDateTime::TimeZone& tz = wxDateTime::Local,
+               wxString::const_iterator *end = NULL) const;
+};
+
+
+
 /**
     @class wxDateTimeHolidayAuthority
 
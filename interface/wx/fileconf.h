@@ -118,6 +118,53 @@ public:
     */
     void DisableAutoSave();
 
+    /**
+        Enables or disables writing the file in a background thread.
+
+        If background flushing is enabled, Flush() only makes a copy of the
+        file contents and returns immediately, while the data is written to a
+        temporary file, which then atomically replaces the existing one, by a
+        separate thread. This is useful for big configuration files which are
+        flushed often, e.g. after each user action, as writing them would
+        otherwise block the calling thread.
+
+        Errors occurring in the background thread are logged using wxLogError()
+        and can also be checked for using WaitForFlush(). Notice that Flush()
+        itself waits for the previous background flush, if any, to finish.
+
+        Disabling background flushing waits for the pending flush to finish
+        and the destructor always does it too, so the file is completely
+        written when the object is destroyed.
+
+        This function is only available if @c wxUSE_THREADS is 1.
+
+        @since 3.1.4
+    */
+    void EnableBackgroundFlush(bool enable = true);
+
+    /**
+        Returns @true if background flushing is enabled.
+
+        @see EnableBackgroundFlush()
+
+        @since 3.1.4
+    */
+    bool IsBackgroundFlushEnabled() const;
+
+    /**
+        Waits until the last flush done in the background finishes.
+
+        Returns @true if there was no background flush in progress or if it
+        succeeded and @false if it failed. In the latter case the object is
+        marked as being changed again, so that the next call to Flush() tries
+        to write it again.
+
+        @see EnableBackgroundFlush()
+
+        @since 3.1.4
+    */
+    bool WaitForFlush();
+
     /**
         Allows setting the mode to be used for the config file creation. For example, to
         create a config file which is not readable by other users (useful if it stores
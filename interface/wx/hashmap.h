@@ -124,6 +124,32 @@
     @endcode
 
 
+    @section hashmap_open Hash maps using open addressing
+
+    Since wxWidgets 3.1.4, the following macros can be used instead of the
+    ones above to declare hash map classes with exactly the same interface but
+    using open addressing, i.e. storing all the elements in a single array
+    instead of allocating a separate node for each of them:
+
+    @code
+    WX_DECLARE_OPEN_HASH_MAP( KEY_T, VALUE_T, HASH_T, KEY_EQ_T, CLASSNAME );
+    WX_DECLARE_OPEN_STRING_HASH_MAP( VALUE_T, CLASSNAME );
+    WX_DECLARE_OPEN_VOIDPTR_HASH_MAP( VALUE_T, CLASSNAME );
+    @endcode
+
+    These classes are significantly faster than the normal ones and use less
+    memory, especially for small keys and values, and can be used even when
+    std::unordered_map is used for implementing the normal hash maps. However,
+    as the elements are moved when the table grows, inserting an element into
+    such map invalidates all the iterators, pointers and references to its
+    elements. Erasing an element only invalidates the iterators pointing to it.
+    Also note that the key and value types must be copy constructible.
+
+    The @c reserve() method can be used to preallocate memory for the given
+    number of elements to avoid growing the table several times when many
+    elements are inserted into it.
+
+
     @section hashmap_types Types
 
     In the documentation below you should replace wxHashMap with the name you used
@@ -77,6 +77,16 @@ public:
     */
     wxString GetName() const;
 
+    /**
+        Returns tag's name as an atom.
+
+        This allows comparing the names of the tags without comparing the
+        strings.
+
+        @since 3.1.4
+    */
+    const wxStringAtom& GetNameAtom() const;
+
     /**
         Returns the value of the parameter.
 
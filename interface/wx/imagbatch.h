@@ -0,0 +1,196 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        imagbatch.h
+// Purpose:     interface of wxImageBatchLoader and wxImageBatchEvent
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxImageBatchEvent
+
+    Event sent by wxImageBatchLoader when an image has been loaded.
+
+    @beginEventTable{wxImageBatchEvent}
+    @event{EVT_IMAGE_BATCH_LOADED(func)}
+        Process a @c wxEVT_IMAGE_BATCH_LOADED event, sent when an image added
+        to wxImageBatchLoader was loaded or failed to load.
+    @endEventTable
+
+    @library{wxcore}
+    @category{events,gdi}
+
+    @see wxImageBatchLoader
+
+    @since 3.1.4
+*/
+class wxImageBatchEvent : public wxEvent
+{
+public:
+    /**
+        Constructor, which is only used by wxImageBatchLoader itself.
+    */
+    wxImageBatchEvent(wxEventType type = wxEVT_NULL,
+                      size_t index = 0,
+                      const wxImage& image = wxNullImage);
+
+    /**
+        Returns the index of the image as returned by wxImageBatchLoader::Add().
+    */
+    size_t GetIndex() const;
+
+    /**
+        Returns the loaded image.
+
+        The returned image is invalid if loading it failed.
+    */
+    const wxImage& GetImage() const;
+
+    /**
+        Returns @true if the image was loaded successfully.
+    */
+    bool IsOk() const;
+};
+
+wxEventType wxEVT_IMAGE_BATCH_LOADED;
+
+
+/**
+    @class wxImageBatchLoader
+
+    Loads several images in parallel using a pool of worker threads.
+
+    The images to load, either files or streams, are added using Add() and
+    start loading immediately, in the order in which they were added, as soon
+    as a worker thread becomes available. The results can be retrieved either
+    synchronously, using Wait() or GetImage(), or asynchronously: if an event
+    handler is given to the constructor, a wxImageBatchEvent is queued for it
+    for each image as soon as it is loaded, and processed by the main thread
+    as any other event. Notice that the events are not necessarily sent in the
+    order in which the images were added.
+
+    Example of loading the thumbnails of all files in a directory:
+    @code
+    MyFrame::MyFrame()
+        : m_loader(this)
+    {
+        Bind(wxEVT_IMAGE_BATCH_LOADED, &MyFrame::OnImageLoaded, this);
+
+        wxArrayString files;
+        wxDir::GetAllFiles("images", &files, "*.jpg", wxDIR_FILES);
+        for ( size_t n = 0; n < files.size(); n++ )
+            m_loader.Add(files[n], wxBITMAP_TYPE_JPEG);
+    }
+
+    void MyFrame::OnImageLoaded(wxImageBatchEvent& event)
+    {
+        if ( event.IsOk() )
+            m_thumbnails[event.GetIndex()]->SetBitmap(event.GetImage());
+    }
+    @endcode
+
+    The images are loaded with the handlers registered with wxImage, see
+    @ref image_threads for the restrictions this implies. All the functions
+    of this class must be called from the same thread, typically the main one.
+
+    If wxWidgets was built without threads support, the images are loaded
+    synchronously by Add() itself, but the events are still queued and only
+    processed later.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage::LoadFile(), wxImageBatchEvent
+
+    @since 3.1.4
+*/
+class wxImageBatchLoader
+{
+public:
+    /**
+        Constructor creates the worker threads.
+
+        @param handler
+            If non-@NULL, the object to send wxImageBatchEvent to. It must
+            exist for as long as this object does.
+        @param threads
+            The number of worker threads to use, the number of CPUs (as
+            returned by wxThread::GetCPUCount()) by default.
+    */
+    wxImageBatchLoader(wxEvtHandler *handler = NULL, int threads = 0);
+
+    /**
+        Destructor cancels loading the images which haven't been loaded yet
+        and waits until the worker threads terminate.
+
+        The events already queued for the handler are still delivered.
+    */
+    ~wxImageBatchLoader();
+
+    /**
+        Adds an image file to load.
+
+        @param filename
+            The name of the file to load.
+        @param type
+            The type of the image, as for wxImage::LoadFile(). Passing the
+            specific type avoids trying all the handlers in turn.
+        @return
+            The index of this image, which is the number of images added
+            before it.
+    */
+    size_t Add(const wxString& filename, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    /**
+        Adds an image stream to load.
+
+        This object takes ownership of the stream, which must be non-@NULL,
+        and deletes it once the image is loaded. The stream is read from a
+        worker thread, so it must not be used by any other thread.
+
+        Notice that the stream must be seekable if @a type is
+        @c wxBITMAP_TYPE_ANY.
+    */
+    size_t Add(wxInputStream *stream, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    /**
+        Returns the number of images added so far.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns @true if the image with the given index was loaded (or failed
+        to load, or was cancelled) already.
+    */
+    bool IsDone(size_t n) const;
+
+    /**
+        Returns the image with the given index, waiting until it is loaded if
+        necessary.
+
+        The returned image is invalid if loading it failed or was cancelled.
+    */
+    wxImage GetImage(size_t n);
+
+    /**
+        Waits until all the images added so far are loaded.
+
+        When this function returns, the events for all these images have
+        been queued for the event handler, if any, but not processed yet.
+    */
+    void Wait();
+
+    /**
+        Cancels loading all the images added so far which are not loaded yet.
+
+        No more events are sent for these images and GetImage() returns an
+        invalid image for those of them which hadn't started loading yet. Images added after calling this function are
+        loaded normally.
+    */
+    void Cancel();
+
+    /**
+        Returns the number of worker threads used, which may be 0 if threads
+        are not available.
+    */
+    int GetThreadCount() const;
+};
@@ -22,6 +22,36 @@ enum wxImageResolution
     wxIMAGE_RESOLUTION_CM = 2
 };
 
+/**
+    Layout of the interleaved RGBA data.
+
+    This is used with wxImage::GetRGBA() and wxImage::SetRGBA().
+
+    @since 3.1.4
+ */
+enum wxImageRGBAFormat
+{
+    /**
+        Red, green, blue and alpha bytes, in this order, with the colours not
+        premultiplied by alpha.
+
+        This is the format used by GdkPixbuf or PNG files, for example.
+     */
+    wxIMAGE_FORMAT_RGBA,
+
+    /// The same as wxIMAGE_FORMAT_RGBA but with premultiplied colours.
+    wxIMAGE_FORMAT_RGBA_PREMULTIPLIED,
+
+    /**
+        32 bit values in native byte order, with alpha in the most significant
+        byte followed by red, green and blue, premultiplied by alpha.
+
+        This is the format used by Cairo or Windows DIBs, for example. The
+        buffer using it must be suitably aligned to store 32 bit values.
+     */
+    wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED
+};
+
 /**
     Image resize algorithm.
 
@@ -88,6 +118,8 @@ enum wxImagePNGType
 #define wxIMAGE_OPTION_ORIGINAL_WIDTH                   wxString("OriginalWidth")
 #define wxIMAGE_OPTION_ORIGINAL_HEIGHT                  wxString("OriginalHeight")
 
+#define wxIMAGE_OPTION_JPEG_FAST_DECODE                 wxString("JpegFastDecode")
+
 #define wxIMAGE_OPTION_BMP_FORMAT                       wxString("wxBMP_FORMAT")
 #define wxIMAGE_OPTION_CUR_HOTSPOT_X                    wxString("HotSpotX")
 #define wxIMAGE_OPTION_CUR_HOTSPOT_Y                    wxString("HotSpotY")
@@ -463,6 +495,23 @@ const unsigned char wxIMAGE_ALPHA_THRESHOLD = 0x80;
     Saving GIFs requires images of maximum 8 bpp (see wxQuantize), and the alpha channel converted to a mask (see wxImage::ConvertAlphaToMask).
     Saving an animated GIF requires images of the same size (see wxGIFHandler::SaveAnimation)
 
+
+    @section image_threads Using wxImage from multiple threads
+
+    Different wxImage objects may be used from different threads at the same
+    time, but a single object, including all the copies sharing its data,
+    must only be used by one thread at a time.
+
+    Since wxWidgets 3.1.4, loading and saving images from worker threads is
+    safe with the standard BMP, PNG, JPEG, GIF and TIFF handlers, even though
+    the handler objects themselves are shared by all threads. However the
+    list of handlers must not be modified, i.e. AddHandler(), InsertHandler(),
+    RemoveHandler() and CleanUpHandlers() must not be called, while any image
+    is being loaded or saved. Any errors are logged using wxLog as usual and,
+    as for any messages logged from worker threads, they are only shown when
+    the main thread flushes the log. See wxImageBatchLoader for a convenient
+    way to load many images in parallel.
+
     @library{wxcore}
     @category{gdi}
 
@@ -775,10 +824,45 @@ public:
         specified pixel @a blurRadius. This should not be used when using
         a single mask colour for transparency.
 
-        @see BlurHorizontal(), BlurVertical()
+        @see BlurHorizontal(), BlurVertical(), BlurInPlace(), GaussianBlur()
     */
     wxImage Blur(int blurRadius) const;
 
+    /**
+        Blurs this image in both horizontal and vertical directions.
+
+        This function gives the same result as Blur() but modifies this image
+        instead of returning a new one, which avoids allocating memory for
+        another image of the same size.
+
+        @return Reference to this image.
+
+        @see Blur()
+
+        @since 3.1.4
+    */
+    wxImage& BlurInPlace(int blurRadius);
+
+    /**
+        Returns the image blurred with an approximation of the Gaussian blur.
+
+        The Gaussian blur with the standard deviation @a sigma is approximated
+        by three successive box blurs, which is much faster than using the
+        Gaussian kernel directly, especially for big values of @a sigma, while
+        giving visually very similar results and, unlike Blur(), not producing
+        any box-shaped artefacts. Just as Blur(), this function should not be
+        used when using a single mask colour for transparency.
+
+        @param sigma
+            The standard deviation of the Gaussian, in pixels, which must be
+            non-negative.
+
+        @see Blur()
+
+        @since 3.1.4
+    */
+    wxImage GaussianBlur(double sigma) const;
+
     /**
         Blurs the image in the horizontal direction only. This should not be used
         when using a single mask colour for transparency.
@@ -874,6 +958,12 @@ public:
         Rotates the hue of each pixel in the image by @e angle, which is a double in
         the range of -1.0 to +1.0, where -1.0 corresponds to -360 degrees and +1.0
         corresponds to +360 degrees.
+
+        Since wxWidgets 3.1.4 this function uses integer arithmetic and its
+        results may differ by 1 from those of converting each pixel to HSV
+        using RGBtoHSV(), changing its hue and converting it back to RGB using
+        HSVtoRGB(). Unlike with the latter, rotating the hue by a full circle
+        leaves the colours unchanged.
     */
     void RotateHue(double angle);
 
@@ -893,6 +983,9 @@ public:
         cases it will be quite substantially slower as the bicubic algorithm has to process a
         lot of data.
 
+        Scaling big images can be done using several threads, see
+        SetProcessingThreads().
+
         It should also be noted that the high quality scaling may not work as expected
         when using a single mask colour for transparency, as the scaling will blur the
         image and will therefore remove the mask partially. Using the alpha channel
@@ -938,6 +1031,38 @@ public:
     wxImage Size(const wxSize& size, const wxPoint& pos, int red = -1,
                  int green = -1, int blue = -1) const;
 
+    /**
+        Sets the number of threads used for processing big images.
+
+        Scale(), the blurring functions, such as Blur() or GaussianBlur(), and
+        ComputeHistogram() split big images into bands of rows or columns
+        processed by separate threads if this number is greater than 1. Small
+        images are always processed by the calling thread, as it is faster to
+        do it than to create the additional threads.
+
+        The results don't depend on the number of threads used.
+
+        By default, the images are processed by the calling thread only.
+
+        @param threads
+            The maximal number of threads to use, with the special value 0
+            meaning to use as many threads as there are CPUs.
+
+        @see GetProcessingThreads()
+
+        @since 3.1.4
+     */
+    static void SetProcessingThreads(int threads);
+
+    /**
+        Returns the number of threads used for processing big images.
+
+        See SetProcessingThreads() for more information.
+
+        @since 3.1.4
+     */
+    static int GetProcessingThreads();
+
     //@}
 
 
@@ -1017,6 +1142,18 @@ public:
     */
     wxImage ConvertToDisabled(unsigned char brightness = 255) const;
 
+    /**
+        Returns a lighter or darker version of the image.
+
+        Each pixel, except for the pixels of the mask colour if the image has
+        a mask, is changed in the same way as wxColour::ChangeLightness()
+        changes a colour, i.e. @a alpha of 100 leaves the image unchanged,
+        smaller values make it darker and bigger ones make it lighter.
+
+        @since 3.1.4
+    */
+    wxImage ChangeLightness(int alpha) const;
+
     //@}
 
 
@@ -1044,6 +1181,12 @@ public:
                                     wxImageHistogram);
         @endcode
 
+        The indices of the entries are assigned in the order of the first
+        occurrence of their colours in the image.
+
+        The histogram of big images can be computed using several threads, see
+        SetProcessingThreads().
+
         @return Returns number of colours in the histogram.
     */
     unsigned long ComputeHistogram(wxImageHistogram& histogram) const;
@@ -1239,6 +1382,15 @@ public:
             the image provides the resolution information and can be queried
             after loading the image.
 
+        Options specific to wxJPEGHandler:
+        @li @c wxIMAGE_OPTION_JPEG_FAST_DECODE: If this option is set to a
+            non-zero value, the image is decoded using faster but slightly less
+            accurate algorithms. This is mostly useful together with
+            @c wxIMAGE_OPTION_MAX_WIDTH and @c wxIMAGE_OPTION_MAX_HEIGHT when
+            loading thumbnails, as the loss of quality is barely noticeable for
+            them. This option must be set before calling LoadFile().
+            @since 3.1.4
+
         Options specific to wxPNGHandler:
         @li @c wxIMAGE_OPTION_PNG_FORMAT: Format for saving a PNG file, see
             wxImagePNGType for the supported values.
@@ -1246,6 +1398,9 @@ public:
         @li @c wxIMAGE_OPTION_PNG_FILTER: Filter for saving a PNG file, see libpng
             (http://www.libpng.org/pub/png/libpng-1.2.5-manual.html) for possible values
             (e.g. PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, etc).
+            If this option is not specified but a fast compression level is
+            (0..3), a single filter which is fast to apply is used instead of
+            selecting the best filter for each row, as libpng does by default.
         @li @c wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL: Compression level (0..9) for
             saving a PNG file. An high value creates smaller-but-slower PNG file.
             Note that unlike other formats (e.g. JPEG) the PNG format is always
@@ -1356,6 +1511,36 @@ public:
     */
     bool HasAlpha() const;
 
+    /**
+        Copies the image data to a buffer of interleaved RGBA pixels.
+
+        wxImage stores the colours and alpha channel separately, while many
+        other libraries use interleaved RGBA data. This function converts the
+        image to such data in a single pass, which is more efficient than
+        combining the results of GetData() and GetAlpha() pixel by pixel.
+
+        If the image doesn't have alpha channel, all pixels are opaque in the
+        buffer. The image mask, if any, is not taken into account.
+
+        @param buffer
+            The buffer to fill, which must be big enough for @a stride bytes
+            for every row of the image.
+        @param format
+            The layout of the data in the buffer.
+        @param stride
+            Size of a buffer row in bytes, which must be at least 4 times the
+            image width. The default value of 0 means to use exactly this size.
+        @return @true if the data was copied or @false if the image is invalid
+            or the parameters are incorrect.
+
+        @see SetRGBA()
+
+        @since 3.1.4
+    */
+    bool GetRGBA(unsigned char* buffer,
+                 wxImageRGBAFormat format = wxIMAGE_FORMAT_RGBA,
+                 int stride = 0) const;
+
     /**
         Returns @true if there is a mask active, @false otherwise.
     */
@@ -1612,6 +1797,34 @@ public:
     */
     void ClearAlpha();
 
+    /**
+        Sets the image data and alpha from a buffer of interleaved RGBA
+        pixels.
+
+        This is the counterpart of GetRGBA(). The image must have been already
+        created with the size corresponding to the buffer contents. The alpha
+        channel is created if the image doesn't have it yet and the mask, if
+        any, is reset.
+
+        Notice that converting the data from a premultiplied format is lossy
+        for the colours of the partially transparent pixels.
+
+        @param buffer
+            The buffer containing the data for all image rows.
+        @param format
+            The layout of the data in the buffer.
+        @param stride
+            Size of a buffer row in bytes, which must be at least 4 times the
+            image width. The default value of 0 means to use exactly this size.
+        @return @true if the data was copied or @false if the image is invalid
+            or the parameters are incorrect.
+
+        @since 3.1.4
+    */
+    bool SetRGBA(const unsigned char* buffer,
+                 wxImageRGBAFormat format = wxIMAGE_FORMAT_RGBA,
+                 int stride = 0);
+
     /**
         Sets the image data without performing checks.
 
@@ -46,3 +46,184 @@ protected:
     virtual bool DoCanRead(wxInputStream& stream);
 };
 
+
+/**
+    @class wxTIFFReadNotifier
+
+    Abstract base class for the objects notified about the progress of reading
+    a TIFF image by wxTIFFReader.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.1.4
+*/
+class wxTIFFReadNotifier
+{
+public:
+    /**
+        Called after reading each band of rows of the image.
+
+        @param rowsRead
+            The number of rows read so far.
+        @param rowsTotal
+            The total number of rows to read.
+        @return
+            @true to continue reading or @false to cancel it, in which case
+            wxTIFFReader::Read() returns @false.
+    */
+    virtual bool OnProgress(int rowsRead, int rowsTotal) = 0;
+};
+
+/**
+    @class wxTIFFReader
+
+    Reads TIFF images, or parts of them, without loading them entirely into
+    memory.
+
+    Unlike wxImage::LoadFile(), this class can be used to read only a
+    rectangular part of an image, which is useful for images too big to be
+    loaded entirely, e.g. scanned maps, or to select one of the reduced
+    resolution versions of the image stored in the same file, if any.
+
+    The image is decoded by bands of whole strips or rows of tiles directly
+    into the returned wxImage, so the memory used for reading it, in addition
+    to the image itself, is limited by the size of these bands, except for the
+    images stored as a single compressed strip which libtiff can only decode
+    entirely.
+
+    Example of reading a part of a big image:
+    @code
+    wxTIFFReader reader;
+    if ( reader.Open("map.tif") )
+    {
+        // Use the smallest reduced resolution version at least as big as
+        // the given size, if the file contains any.
+        int index = reader.FindImage(wxSize(4000, 4000));
+        if ( index != wxNOT_FOUND )
+            reader.SelectImage(index);
+
+        wxImage image;
+        if ( reader.Read(&image, wxRect(1000, 1000, 2000, 1500)) )
+            ... use image ...
+    }
+    @endcode
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxTIFFHandler, wxTIFFReadNotifier
+
+    @since 3.1.4
+*/
+class wxTIFFReader
+{
+public:
+    /**
+        Default constructor, Open() must be called before using the reader.
+    */
+    wxTIFFReader();
+
+    /**
+        Destructor closes the reader.
+    */
+    ~wxTIFFReader();
+
+    /**
+        Open the TIFF image from the given stream.
+
+        The stream must be seekable and must remain valid until Close() is
+        called or this object is destroyed.
+
+        Initially, the first image in the file is selected.
+
+        @return @true if the stream contains a valid TIFF file.
+    */
+    bool Open(wxInputStream& stream);
+
+    /**
+        Open the TIFF image from the given file.
+
+        @return @true if the file could be opened and is a valid TIFF file.
+    */
+    bool Open(const wxString& filename);
+
+    /**
+        Return @true if the reader was successfully opened.
+    */
+    bool IsOpened() const;
+
+    /**
+        Close the reader, this is done automatically by the destructor.
+    */
+    void Close();
+
+    /**
+        Return the number of images in the file.
+
+        The file may contain either several pages or several versions of the
+        same image at different resolutions.
+    */
+    int GetImageCount() const;
+
+    /**
+        Select the image to read by Read().
+
+        @param index
+            The index of the image, from 0 to GetImageCount() - 1.
+        @return @true if the image was selected or @false if the index is
+            invalid, in which case the previously selected image remains so.
+    */
+    bool SelectImage(int index);
+
+    /**
+        Return the index of the currently selected image.
+    */
+    int GetSelectedImage() const;
+
+    /**
+        Return the size of the selected image.
+    */
+    wxSize GetSize() const;
+
+    /**
+        Return @true if the selected image is marked as a reduced resolution
+        version of another image in the file.
+    */
+    bool IsReducedImage() const;
+
+    /**
+        Return the index of the smallest image in the file whose both
+        dimensions are at least as big as the given ones.
+
+        This can be used to find the best reduced resolution version of the
+        image to use for showing it at the given size.
+
+        The selected image is not changed by this function.
+
+        @return The index of the image or @c wxNOT_FOUND if all images in the
+            file are smaller than @a size.
+    */
+    int FindImage(const wxSize& size);
+
+    /**
+        Read the given part of the selected image.
+
+        @param image
+            The image to store the pixels in, it is (re)created with the size
+            of @a rect. It gets an alpha channel if the TIFF image has one.
+        @param rect
+            The rectangle to read, which must be inside the image. If it's
+            empty, which is the default, the entire image is read.
+        @param notifier
+            If non-@NULL, notified about the progress of reading. It can
+            cancel reading by returning @false from its
+            wxTIFFReadNotifier::OnProgress().
+        @return @true on success or @false if an error occurred or reading
+            was cancelled by the notifier. In the latter case, no error is
+            logged.
+    */
+    bool Read(wxImage* image,
+              const wxRect& rect = wxRect(),
+              wxTIFFReadNotifier* notifier = NULL);
+};
@@ -163,6 +163,113 @@ protected:
 };
 
 
+/**
+    @class wxLogTraceMaskHandle
+
+    Trace mask which can be checked very quickly.
+
+    Checking whether a string trace mask is enabled requires searching for it
+    in the list of all the masks added with wxLog::AddTraceMask(). This is
+    usually not a problem, but can be noticeable for trace statements in
+    performance-sensitive code. Objects of this class are registered once,
+    when they're created, and are updated whenever the trace masks change,
+    so checking them is just a test of a flag.
+
+    Example of use:
+    @code
+    static wxLogTraceMaskHandle gs_traceParser("parser");
+
+    void Parser::ParseNext()
+    {
+        wxLogTrace(gs_traceParser, "Parsing token %s", GetToken());
+        ...
+    }
+    @endcode
+
+    Notice that the objects of this class are typically global or static and
+    must not be destroyed while they can be used by the other threads.
+
+    @library{wxbase}
+    @category{logging}
+
+    @since 3.1.4
+*/
+class wxLogTraceMaskHandle
+{
+public:
+    /**
+        Creates a handle for the given trace mask.
+    */
+    explicit wxLogTraceMaskHandle(const wxString& mask);
+
+    /**
+        Returns the trace mask.
+    */
+    const wxString& GetMask() const;
+
+    /**
+        Returns @true if the mask was added with wxLog::AddTraceMask().
+    */
+    bool IsEnabled() const;
+};
+
+/**
+    @class wxLogComponentHandle
+
+    Log component with the cached log level.
+
+    Finding the log level of a component requires looking up the component
+    and all its parents among the components for which a level was set using
+    wxLog::SetComponentLevel(). Objects of this class keep the effective level
+    of the component up to date, so that checking it is very cheap.
+
+    They can be passed to any function taking the component name and, in
+    particular, can be used as @c wxLOG_COMPONENT value:
+    @code
+    static wxLogComponentHandle gs_myComponent("myapp/network");
+    #define wxLOG_COMPONENT gs_myComponent
+    @endcode
+
+    Notice that the objects of this class are typically global or static and
+    must not be destroyed while they can be used by the other threads.
+
+    @library{wxbase}
+    @category{logging}
+
+    @since 3.1.4
+*/
+class wxLogComponentHandle
+{
+public:
+    /**
+        Creates a handle for the given component.
+
+        The @a component string is not copied, so it must remain valid
+        during the entire lifetime of this object, e.g. it can be a string
+        literal.
+    */
+    explicit wxLogComponentHandle(const char* component);
+
+    /**
+        Returns the component name.
+    */
+    const char* GetComponent() const;
+
+    /**
+        Returns the component name.
+    */
+    operator const char*() const;
+
+    /**
+        Returns the effective log level of the component.
+
+        This is the level set for this component or its closest parent or,
+        if none, the global log level.
+    */
+    wxLogLevel GetLevel() const;
+};
+
+
 /**
     @class wxLog
 
@@ -369,6 +476,19 @@ public:
      */
     static bool IsLevelEnabled(wxLogLevel level, wxString component);
 
+    /**
+        Returns true if logging at this level is enabled for the component
+        with the given handle.
+
+        This overload does the same thing as the one taking the component
+        name, but is much faster as the effective level of the component is
+        cached in wxLogComponentHandle object.
+
+        @since 3.1.4
+     */
+    static bool IsLevelEnabled(wxLogLevel level,
+                               const wxLogComponentHandle& component);
+
     /**
         Sets the log level for the given component.
 
@@ -601,6 +721,25 @@ protected:
     */
     virtual void DoLogText(const wxString& msg);
 
+    /**
+        Return @true if this log target can be used from any thread.
+
+        By default, the messages logged from threads other than the main one
+        are buffered and only passed to the active log target when it is
+        flushed from the main thread. If this function is overridden to return
+        @true, the messages logged by the other threads are passed to
+        DoLogRecord() immediately instead, so it must be safe to call it
+        concurrently from several threads. Notice that this is not done if
+        repetition counting is enabled, see SetRepetitionCounting().
+
+        The base class version returns @false.
+
+        @see wxLogAsync
+
+        @since 3.1.4
+    */
+    virtual bool IsThreadSafe() const;
+
     //@}
 };
 
@@ -737,6 +876,130 @@ public:
 };
 
 
+/**
+    Possible values for wxLogAsync overflow policy.
+
+    @since 3.1.4
+ */
+enum wxLogAsyncOverflowPolicy
+{
+    /// Wait until there is some free space in the queue.
+    wxLOG_ASYNC_BLOCK,
+
+    /// Discard the new message and count it as dropped.
+    wxLOG_ASYNC_DISCARD
+};
+
+/**
+    @class wxLogAsync
+
+    Log target passing the messages to another log target from a separate
+    thread.
+
+    Formatting the log messages and outputting them can take a significant
+    amount of time, which is undesirable when logging from time-critical code
+    or from many threads at once. wxLogAsync only stores the messages in a
+    fixed size queue, without using any locks if possible, and passes them to
+    the real log target, which is only ever used from its dedicated writer
+    thread. In particular, this means that the time stamps are formatted by
+    the writer thread, although the time of each message is still determined
+    when it is logged.
+
+    The messages are not output immediately but are accumulated in the queue
+    for a short time. If the queue is full, the thread logging a message
+    either waits until the writer thread makes some space in it or simply
+    discards the message, depending on the overflow policy specified when
+    creating wxLogAsync object. In the latter case, a warning with the number
+    of discarded messages is passed to the target when this happens.
+
+    Unlike with the other log targets, the messages logged from threads other
+    than the main one are queued immediately, as wxLogAsync can be used from
+    any thread (see wxLog::IsThreadSafe()), unless repetition counting is
+    enabled.
+
+    Example of usage:
+    @code
+    delete wxLog::SetActiveTarget(new wxLogAsync(new wxLogStderr));
+    @endcode
+
+    Note that the wrapped log target must not be a GUI one, such as wxLogGui,
+    as it's used from the writer thread and not the main one.
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @library{wxbase}
+    @category{logging}
+
+    @since 3.1.4
+*/
+class wxLogAsync : public wxLog
+{
+public:
+    /**
+        Creates the object using the given log target and starts its writer
+        thread.
+
+        If the thread can't be started, the messages are passed to the target
+        synchronously.
+
+        @param target
+            Non-@NULL log target to pass the messages to. wxLogAsync takes
+            ownership of it and deletes it in its destructor.
+        @param capacity
+            The maximal number of messages which can be queued. This value is
+            rounded up to the next power of 2.
+        @param policy
+            What to do when a message is logged while the queue is full.
+    */
+    wxLogAsync(wxLog* target,
+               size_t capacity = 1024,
+               wxLogAsyncOverflowPolicy policy = wxLOG_ASYNC_BLOCK);
+
+    /**
+        Passes all the remaining messages to the target, stops the writer
+        thread and destroys the target.
+
+        Notice that this object must not be destroyed while the other threads
+        can still be logging messages using it.
+    */
+    virtual ~wxLogAsync();
+
+    /**
+        Returns the log target the messages are passed to.
+
+        Notice that it is used from the writer thread, so it can't be safely
+        accessed from any other thread.
+    */
+    wxLog* GetTarget() const;
+
+    /**
+        Returns the maximal number of messages which can be queued.
+    */
+    size_t GetCapacity() const;
+
+    /**
+        Returns the policy used when the queue is full.
+    */
+    wxLogAsyncOverflowPolicy GetOverflowPolicy() const;
+
+    /**
+        Returns the total number of messages discarded because the queue was
+        full.
+
+        This is always 0 when using @c wxLOG_ASYNC_BLOCK policy.
+    */
+    unsigned long GetDroppedCount() const;
+
+    /**
+        Waits until all the messages logged so far are passed to the target
+        and flushes it.
+
+        The target is flushed by the writer thread.
+    */
+    virtual void Flush();
+};
+
+
 /**
     @class wxLogStream
 
@@ -1413,12 +1676,35 @@ void wxVLogError(const char* formatString, va_list argPtr);
     @itemdef{ wxTRACE_OleCalls, Trace OLE method calls (Win32 only) }
     @endDefList
 
+    Notice that the @a mask expression may be evaluated more than once.
+
     @header{wx/log.h}
 */
 void wxLogTrace(const char* mask, const char* formatString, ... );
 void wxVLogTrace(const char* mask, const char* formatString, va_list argPtr);
 //@}
 
+/** @addtogroup group_funcmacro_log */
+//@{
+/**
+    Overloads of wxLogTrace() using a trace mask handle.
+
+    These functions behave in the same way as wxLogTrace() taking the mask
+    string, but checking whether the mask is enabled is much cheaper: when
+    the compiler supports variadic macros, disabled trace statements only
+    test a flag and, in particular, don't evaluate the format string
+    arguments at all.
+
+    @see wxLogTraceMaskHandle
+
+    @header{wx/log.h}
+
+    @since 3.1.4
+*/
+void wxLogTrace(const wxLogTraceMaskHandle& mask, const char* formatString, ... );
+void wxVLogTrace(const wxLogTraceMaskHandle& mask, const char* formatString, va_list argPtr);
+//@}
+
 /** @addtogroup group_funcmacro_log */
 //@{
 /**
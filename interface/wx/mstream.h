@@ -132,5 +132,26 @@ public:
         for that stream.
     */
     wxStreamBuffer* GetInputStreamBuffer() const;
+
+    /**
+        Returns the pointer to the data which hasn't been read from the stream
+        yet.
+
+        This allows the code reading from a memory stream, which can be
+        detected using wxDynamicCast(), to use its data directly instead of
+        copying it into its own buffer. The stream position is not changed by
+        this function, call SeekI() with ::wxFromCurrent to skip over the data
+        used.
+
+        @param size
+            Non-@NULL pointer filled with the number of bytes available.
+        @return
+            The pointer to the data at the current stream position or @NULL
+            if there are pending bytes put back into the stream using
+            Ungetch(), as they are not contiguous with the rest of the data.
+
+        @since 3.1.4
+    */
+    const void* GetUnreadData(size_t* size) const;
 };
 
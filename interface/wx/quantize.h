@@ -5,6 +5,44 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+    Flags used by wxQuantize functions.
+*/
+enum
+{
+    /// Reserve the first 20 palette entries for the Windows system colours.
+    wxQUANTIZE_INCLUDE_WINDOWS_COLOURS  = 0x01,
+
+    /// Return the image data as palette indices.
+    wxQUANTIZE_RETURN_8BIT_DATA         = 0x02,
+
+    /// Fill the destination image with the quantized colours.
+    wxQUANTIZE_FILL_DESTINATION_IMAGE   = 0x04,
+
+    /**
+        Map each pixel to the nearest palette colour without using
+        Floyd-Steinberg dithering.
+
+        This is much faster and gives better results for the images with
+        areas of solid colours, but results in banding in the gradients.
+
+        @since 3.1.4
+     */
+    wxQUANTIZE_NO_DITHERING             = 0x08,
+
+    /**
+        Improve the palette selected by the median cut algorithm using a few
+        iterations of k-means clustering.
+
+        This reduces the quantization error, notably for the images with
+        smooth gradients, at the price of some extra time which depends on the
+        number of distinct colours in the image but not on its size.
+
+        @since 3.1.4
+     */
+    wxQUANTIZE_REFINE_COLOURS           = 0x10
+};
+
 /**
     @class wxQuantize
 
@@ -31,10 +69,14 @@ public:
         (@a in_rows contains @a w * 3 bytes per row, @a out_rows @a w bytes per row).
         Fills @a out_rows with indexes into palette (which is also stored into @a palette
         variable).
+
+        The @a flags parameter, added in wxWidgets 3.1.4, can be a combination
+        of ::wxQUANTIZE_NO_DITHERING and ::wxQUANTIZE_REFINE_COLOURS.
     */
     static void DoQuantize(unsigned int w, unsigned int h,
                            unsigned char** in_rows, unsigned char** out_rows,
-                           unsigned char* palette, int desiredNoColours);
+                           unsigned char* palette, int desiredNoColours,
+                           int flags = 0);
 
     /**
         Reduce the colours in the source image and put the result into the destination image.
@@ -42,6 +84,8 @@ public:
 
         Specify an optional palette pointer to receive the resulting palette.
         This palette may be passed to ConvertImageToBitmap, for example.
+
+        The @a flags parameter is a combination of wxQUANTIZE_XXX constants.
     */
     static bool Quantize(const wxImage& src, wxImage& dest,
                          wxPalette** pPalette, int desiredNoColours = 236,
@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        stratom.h
+// Purpose:     interface of wxStringAtom
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxStringAtom
+
+    wxStringAtom represents an interned string, i.e.\ a string stored in the
+    global pool of strings in which each distinct string is present only once.
+
+    All atoms created from equal strings refer to the same pooled string, so
+    copying and comparing atoms is as cheap as copying and comparing pointers
+    and their hash value is computed only once, when the string is added to
+    the pool. Atoms are useful for storing many copies of the same strings,
+    e.g. element and attribute names in a big XML document, as they don't use
+    any extra memory for each copy.
+
+    The strings in the pool are reference-counted and are removed from it when
+    the last atom referring to them is destroyed, so the pool doesn't grow
+    indefinitely when many different strings are used.
+
+    Creating atoms from strings requires looking them up in the pool, which is
+    relatively expensive, so this is never done implicitly. Once created, an
+    atom can be used wherever a constant string is expected, e.g.:
+    @code
+        const wxStringAtom atom("item");
+        if ( node->GetNameAtom() == atom ) // This just compares the pointers.
+            ...
+        wxLogMessage("Found %s", atom.GetString());
+    @endcode
+
+    This class can be used from multiple threads concurrently.
+
+    @library{wxbase}
+    @category{data}
+
+    @see wxXmlNode::GetNameAtom()
+
+    @since 3.1.4
+*/
+class wxStringAtom
+{
+public:
+    /**
+        Default constructor creates an atom corresponding to the empty string.
+    */
+    wxStringAtom();
+
+    //@{
+    /**
+        Creates an atom for the given string, adding it to the pool if it's not
+        present there yet.
+    */
+    explicit wxStringAtom(const wxString& str);
+    explicit wxStringAtom(const char* str);
+    explicit wxStringAtom(const wchar_t* str);
+    //@}
+
+    /**
+        Creates an atom from the string in UTF-8 encoding.
+
+        This function is more efficient than converting the string to
+        wxString first, as it doesn't need to do it at all for ASCII strings
+        which are already present in the pool.
+
+        @param utf8
+            The string in UTF-8.
+        @param len
+            The length of the string in bytes or @c wxNO_LEN if the string is
+            NUL-terminated.
+        @return
+            The atom corresponding to the given string or the empty atom if
+            the string is not valid UTF-8.
+    */
+    static wxStringAtom FromUTF8(const char* utf8, size_t len = wxNO_LEN);
+
+    /**
+        Copy constructor is cheap as it doesn't copy the string itself.
+    */
+    wxStringAtom(const wxStringAtom& atom);
+
+    /**
+        Assignment operator is cheap as it doesn't copy the string itself.
+    */
+    wxStringAtom& operator=(const wxStringAtom& atom);
+
+    /**
+        Destructor removes the string from the pool if this was the last atom
+        referencing it.
+    */
+    ~wxStringAtom();
+
+    /**
+        Returns the string corresponding to this atom.
+    */
+    const wxString& GetString() const;
+
+    /**
+        Implicit conversion to the string corresponding to this atom.
+    */
+    operator const wxString&() const;
+
+    //@{
+    /**
+        Returns @true if this atom corresponds to the empty string.
+    */
+    bool IsEmpty() const;
+    bool empty() const;
+    //@}
+
+    /**
+        Returns the hash value of the string.
+
+        The hash is computed only once when the string is added to the pool,
+        so this function is very cheap.
+    */
+    size_t GetHash() const;
+
+    //@{
+    /**
+        Compares two atoms.
+
+        This only compares the pointers to the pooled strings and so takes
+        constant time.
+    */
+    bool operator==(const wxStringAtom& atom) const;
+    bool operator!=(const wxStringAtom& atom) const;
+    //@}
+
+    /**
+        Returns the number of distinct strings currently stored in the pool.
+
+        This is mostly useful for debugging and testing.
+    */
+    static size_t GetPoolSize();
+};
+
+/**
+    Hash functor for using wxStringAtom as the key type in wxHashMap or
+    std::unordered_map.
+
+    @since 3.1.4
+*/
+struct wxStringAtomHash
+{
+    size_t operator()(const wxStringAtom& atom) const;
+};
+
+/**
+    Equality functor for using wxStringAtom as the key type in wxHashMap.
+
+    @since 3.1.4
+*/
+struct wxStringAtomEqual
+{
+    bool operator()(const wxStringAtom& a, const wxStringAtom& b) const;
+};
@@ -18,6 +18,23 @@ enum wxStreamError
     wxSTREAM_READ_ERROR         //!< generic read error on the last read call.
 };
 
+/**
+    A memory buffer used by the vectored I/O functions wxInputStream::ReadV()
+    and wxOutputStream::WriteV().
+
+    This structure is similar to the standard @c iovec one.
+
+    @since 3.1.4
+*/
+struct wxStreamIOVec
+{
+    /// Pointer to the buffer data.
+    void *data;
+
+    /// Size of the buffer in bytes.
+    size_t size;
+};
+
 /**
     @class wxStreamBase
 
@@ -550,6 +567,22 @@ public:
     */
     bool WriteAll(const void* buffer, size_t size);
 
+    /**
+        Writes the data from several buffers, in order.
+
+        This function is equivalent to calling WriteAll() for each of the
+        buffers until an error occurs, but some streams, such as
+        wxFileOutputStream under Unix, implement it more efficiently by
+        writing all the data at once.
+
+        LastWrite() returns the total number of bytes written and, if it is
+        less than the total size of all buffers, GetLastError() indicates the
+        error that occurred.
+
+        @since 3.1.4
+    */
+    virtual wxOutputStream& WriteV(const wxStreamIOVec* vec, size_t count);
+
 protected:
     /**
         Internal function. It is called when the stream wants to write data of the
@@ -659,6 +692,22 @@ public:
     */
     bool ReadAll(void* buffer, size_t size);
 
+    /**
+        Reads the data into several buffers.
+
+        Each buffer is filled completely, as with ReadAll(), before the data
+        is read into the next one and reading stops at EOF or on error. Some
+        streams, such as wxFileInputStream under Unix, implement this function
+        more efficiently than by reading into each of the buffers separately.
+
+        LastRead() returns the total number of bytes read and, if it is less
+        than the total size of all buffers, GetLastError() indicates the
+        reason for it.
+
+        @since 3.1.4
+    */
+    virtual wxInputStream& ReadV(const wxStreamIOVec* vec, size_t count);
+
     /**
         Changes the stream current position.
 
@@ -352,6 +352,18 @@ public:
     */
     wxString(const wxString& stringSrc);
 
+    /**
+       Move constructor.
+
+       Takes over the contents of the other string, which is left in a valid
+       but unspecified state, without copying it.
+
+       This constructor is only available when using C++11 compiler.
+
+       @since 3.1.4
+    */
+    wxString(wxString&& stringSrc);
+
     /**
        Construct a string consisting of @a nRepeat copies of ch.
     */
@@ -445,6 +457,18 @@ public:
     */
     wxString operator =(const wxString& str);
 
+    /**
+        Move assignment operator.
+
+        Takes over the contents of the other string, which is left in a valid
+        but unspecified state, without copying it.
+
+        This operator is only available when using C++11 compiler.
+
+        @since 3.1.4
+    */
+    wxString& operator=(wxString&& str);
+
     /**
         Assignment: see the relative wxString constructor.
     */
@@ -666,6 +690,11 @@ public:
         Returns the multibyte (C string) representation of the string
         using @e conv's wxMBConv::cWC2MB method and returns wxCharBuffer.
 
+        Note that the memory used for the result is allocated by the string
+        itself and reused by the subsequent calls to this function, so it is
+        cheap to call it repeatedly for the same string, but the returned
+        buffer is only valid until the string is modified.
+
         @see wc_str(), utf8_str(), c_str(), wxMBConv
     */
     const wxCharBuffer mb_str(const wxMBConv& conv = wxConvLibc) const;
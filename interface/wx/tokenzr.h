@@ -134,6 +134,43 @@ public:
     */
     wxString GetNextToken();
 
+    /**
+        Finds the next token without copying it.
+
+        This function behaves in the same way as GetNextToken() but, instead
+        of returning a new string, fills the provided iterators with the
+        bounds of the token in the string returned by GetInputString(). This
+        avoids allocating memory for each token and can be significantly
+        faster when tokenizing big strings, e.g.
+
+        @code
+        wxStringTokenizer tokenizer(text, "\n");
+        wxString::const_iterator start, end;
+        while ( tokenizer.GetNextTokenRange(&start, &end) )
+        {
+            if ( *start == '#' )
+                continue; // skip comments without allocating anything
+
+            // process the token between start and end here
+        }
+        @endcode
+
+        The iterators remain valid until the next call to SetString() or
+        Reinit() or until the tokenizer object is destroyed.
+
+        @param tokenStart Pointer to the iterator filled with the start of
+            the token, must be non-@NULL.
+        @param tokenEnd Pointer to the iterator filled with the end of the
+            token, i.e. the position after its last character, must be
+            non-@NULL.
+        @return @true if a token was found or @false if there were no more
+            tokens.
+
+        @since 3.1.4
+    */
+    bool GetNextTokenRange(wxString::const_iterator* tokenStart,
+                           wxString::const_iterator* tokenEnd);
+
     /**
         Returns the current position (i.e.\ one index after the last returned
         token or 0 if GetNextToken() has never been called) in the original
@@ -149,6 +186,17 @@ public:
     */
     wxString GetString() const;
 
+    /**
+        Returns the full string being tokenized.
+
+        Unlike GetString(), this function returns the entire string passed to
+        the constructor, SetString() or Reinit(), independently of the current
+        position. The iterators returned by GetNextTokenRange() point into it.
+
+        @since 3.1.4
+    */
+    const wxString& GetInputString() const;
+
     /**
         Returns @true if the tokenizer has further tokens, @false if none are left.
     */
@@ -390,3 +390,56 @@ public:
     bool IsOk() const;
 };
 
+
+
+/**
+    @class wxMappedFileInputStream
+
+    This class represents data read from a file mapped into memory.
+
+    Unlike wxFileInputStream and wxFFileInputStream, this stream doesn't
+    perform any system calls when reading or seeking, as it is a
+    wxMemoryInputStream using the file contents directly. Its data can also be
+    accessed without copying it using wxMemoryInputStream::GetUnreadData(),
+    which is done by wxZlibInputStream, wxZipInputStream and
+    wxXmlDocument::Load(). wxImage::LoadFile() and wxXmlDocument::Load()
+    overloads taking a file name use this class to read the file.
+
+    If the file can't be mapped, e.g. because it is not a regular file, its
+    entire contents is read into memory instead.
+
+    Note that the file must not be truncated while it is mapped, as accessing
+    the pages beyond its new end results in a crash under most systems.
+
+    @library{wxbase}
+    @category{streams}
+
+    @see wxFileInputStream, wxMemoryInputStream
+
+    @since 3.1.4
+*/
+class wxMappedFileInputStream : public wxMemoryInputStream
+{
+public:
+    /**
+        Opens the specified file and maps it into memory.
+
+        @warning
+        You should use IsOk() to verify if the constructor succeeded.
+    */
+    wxMappedFileInputStream(const wxString& fileName);
+
+    /**
+        Unmaps the file.
+
+        The pointers returned by wxMemoryInputStream::GetUnreadData() become
+        invalid after the stream is destroyed.
+    */
+    virtual ~wxMappedFileInputStream();
+
+    /**
+        Returns @true if the file is mapped into memory or @false if its
+        contents had to be read into a buffer instead.
+    */
+    bool IsMapped() const;
+};
@@ -121,6 +121,17 @@ public:
               const wxString& content = wxEmptyString,
               int lineNo = -1);
 
+    /**
+        Same as the constructor above, but takes the already interned name.
+
+        This is more efficient when creating many nodes with the same name.
+
+        @since 3.1.4
+    */
+    wxXmlNode(wxXmlNodeType type, const wxStringAtom& name,
+              const wxString& content = wxEmptyString,
+              int lineNo = -1);
+
     /**
         Copy constructor.
 
@@ -227,6 +238,16 @@ public:
     */
     const wxString& GetName() const;
 
+    /**
+        Returns the name of this node as an atom.
+
+        The names of all nodes are stored as atoms, so this function is cheap
+        and allows to compare the names of different nodes very efficiently.
+
+        @since 3.1.4
+    */
+    const wxStringAtom& GetNameAtom() const;
+
     /**
         Returns a pointer to the sibling of this node or @NULL if there are no
         siblings.
@@ -357,6 +378,13 @@ public:
     */
     void SetName(const wxString& name);
 
+    /**
+        Sets the name of this node to the given atom.
+
+        @since 3.1.4
+    */
+    void SetName(const wxStringAtom& name);
+
     /**
         Sets as sibling the given node.
 
@@ -419,6 +447,14 @@ public:
     wxXmlAttribute(const wxString& name, const wxString& value,
                    wxXmlAttribute* next = NULL);
 
+    /**
+        Creates the attribute with the given interned @a name and @a value.
+
+        @since 3.1.4
+    */
+    wxXmlAttribute(const wxStringAtom& name, const wxString& value,
+                   wxXmlAttribute* next = NULL);
+
     /**
         The virtual destructor.
     */
@@ -429,6 +465,13 @@ public:
     */
     wxString GetName() const;
 
+    /**
+        Returns the name of this attribute as an atom.
+
+        @since 3.1.4
+    */
+    const wxStringAtom& GetNameAtom() const;
+
     /**
         Returns the sibling of this attribute or @NULL if there are no siblings.
     */
@@ -444,6 +487,13 @@ public:
     */
     void SetName(const wxString& name);
 
+    /**
+        Sets the name of this attribute to the given atom.
+
+        @since 3.1.4
+    */
+    void SetName(const wxStringAtom& name);
+
     /**
         Sets the sibling of this attribute.
     */
@@ -934,3 +984,229 @@ public:
     */
     static wxVersionInfo GetLibraryVersionInfo();
 };
+
+
+/**
+    Return value of wxXmlStreamParser::OnStartElement() indicating how the
+    contents of the element should be handled.
+
+    @since 3.1.4
+*/
+enum wxXmlStreamAction
+{
+    /// Notify about the contents of the element as usual.
+    wxXML_STREAM_CONTINUE,
+
+    /// Skip the element contents without notifying about them.
+    wxXML_STREAM_SKIP,
+
+    /// Build wxXmlNode for the element and pass it to OnElementNode().
+    wxXML_STREAM_BUILD_NODE
+};
+
+/**
+    @class wxXmlStreamParser
+
+    Parses XML documents without building the tree of wxXmlNode objects for
+    the entire document.
+
+    Unlike wxXmlDocument, which keeps the entire document in memory, this
+    class notifies about the document contents as it is being parsed by
+    calling its virtual functions, which must be overridden in the derived
+    class, so it can be used for the documents too big to be loaded into
+    memory entirely.
+
+    As it is often convenient to work with wxXmlNode, the derived class can
+    still ask to build it for the elements it is interested in by returning
+    ::wxXML_STREAM_BUILD_NODE from OnStartElement(). Elements not needed at
+    all can be skipped, which is faster than ignoring their contents.
+
+    Parsing uses the same XML parser and encoding handling as wxXmlDocument.
+
+    Example of extracting some data from a big document:
+    @code
+    class ItemsParser : public wxXmlStreamParser
+    {
+    protected:
+        virtual wxXmlStreamAction
+        OnStartElement(const wxString& name, const wxXmlAttribute* attrs)
+        {
+            if ( name == "item" )
+                return wxXML_STREAM_BUILD_NODE;
+            if ( name == "comments" )
+                return wxXML_STREAM_SKIP;
+
+            return wxXML_STREAM_CONTINUE;
+        }
+
+        virtual void OnElementNode(wxXmlNode* node)
+        {
+            // Process the item using wxXmlNode functions, e.g.
+            // node->GetAttribute("id") and node->GetChildren().
+            ...
+
+            delete node;
+        }
+    };
+
+    ItemsParser parser;
+    if ( !parser.Parse("huge.xml") )
+    {
+        ... handle the error ...
+    }
+    @endcode
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument
+
+    @since 3.1.4
+*/
+class wxXmlStreamParser
+{
+public:
+    /**
+        Default constructor.
+    */
+    wxXmlStreamParser();
+
+    /**
+        Virtual destructor.
+    */
+    virtual ~wxXmlStreamParser();
+
+    /**
+        Parses the XML file.
+
+        The file is mapped into memory if possible, see
+        wxMappedFileInputStream.
+
+        @see wxXmlDocument::Load()
+    */
+    bool Parse(const wxString& filename,
+               const wxString& encoding = "UTF-8",
+               int flags = wxXMLDOC_NONE);
+
+    /**
+        Parses the XML document from the given stream.
+
+        Returns @true on success, including the case when parsing was stopped
+        by calling Stop(), or @false if an error occurred, which is logged
+        using wxLogError().
+
+        The parameters have the same meaning as for wxXmlDocument::Load(), in
+        particular whitespace-only text is not notified about unless
+        @c wxXMLDOC_KEEP_WHITESPACE_NODES is specified in @a flags.
+    */
+    bool Parse(wxInputStream& stream,
+               const wxString& encoding = "UTF-8",
+               int flags = wxXMLDOC_NONE);
+
+    /**
+        Stops parsing the document.
+
+        This function can only be called from the notification functions.
+        Parse() returns @true when it is stopped in this way.
+    */
+    void Stop();
+
+    /**
+        Returns the line number of the current position in the document.
+
+        This function can only be called from the notification functions.
+    */
+    int GetLineNumber() const;
+
+    /**
+        Returns the number of elements enclosing the current position.
+
+        This is 0 when the start and the end of the root element are notified
+        about, 1 for its direct children and the text inside it and so on.
+
+        This function can only be called from the notification functions.
+    */
+    int GetDepth() const;
+
+    /**
+        Returns the version of the document.
+
+        This is only available after the start of the root element was
+        notified about.
+    */
+    const wxString& GetVersion() const;
+
+    /**
+        Returns the encoding of the document.
+
+        This is only available after the start of the root element was
+        notified about.
+    */
+    const wxString& GetFileEncoding() const;
+
+    /**
+        Returns the DOCTYPE declaration data of the document.
+
+        This is only available after the start of the root element was
+        notified about.
+    */
+    const wxXmlDoctype& GetDoctype() const;
+
+protected:
+    /**
+        Called when an element starts.
+
+        The linked list of the element attributes can only be used during
+        this call.
+
+        The returned value determines how the element contents is handled:
+        if it is ::wxXML_STREAM_CONTINUE, its contents is notified about as
+        usual, followed by OnEndElement() call. If it is ::wxXML_STREAM_SKIP,
+        neither its contents nor its end is notified about. And if it is
+        ::wxXML_STREAM_BUILD_NODE, the node for this element and all its
+        children is created and passed to OnElementNode() instead of calling
+        the other functions.
+
+        Default implementation returns ::wxXML_STREAM_CONTINUE.
+    */
+    virtual wxXmlStreamAction
+    OnStartElement(const wxString& name, const wxXmlAttribute* attrs);
+
+    /**
+        Called when an element ends.
+    */
+    virtual void OnEndElement(const wxString& name);
+
+    /**
+        Called with the node built for an element if OnStartElement()
+        returned ::wxXML_STREAM_BUILD_NODE for it.
+
+        The node is owned by this function, which should delete it after
+        using it, as the default implementation does.
+    */
+    virtual void OnElementNode(wxXmlNode* node);
+
+    /**
+        Called with the text contents of an element.
+
+        Notice that the entire text between the other parts of the document
+        is passed to this function at once.
+    */
+    virtual void OnText(const wxString& text);
+
+    /**
+        Called with the contents of a CDATA section.
+    */
+    virtual void OnCData(const wxString& text);
+
+    /**
+        Called with the text of a comment.
+    */
+    virtual void OnComment(const wxString& text);
+
+    /**
+        Called for a processing instruction.
+    */
+    virtual void OnProcessingInstruction(const wxString& target,
+                                         const wxString& data);
+};
@@ -436,6 +436,232 @@ public:
         @see overview_archive_byname
     */
     bool OpenEntry(wxZipEntry& entry);
+
+    /**
+        Closes the current entry if one is open, then opens the entry with
+        the index @a n in the given @a index.
+
+        @a index must have been loaded from the same zip file and the zip
+        must be on a seekable stream. If this stream hasn't been used yet,
+        the position of the central directory is taken from the index instead
+        of searching for it in the stream again.
+
+        @since 3.1.4
+    */
+    bool OpenEntry(const wxZipIndex& index, size_t n);
+};
+
+
+
+/**
+    @class wxZipParallelWriter
+
+    Helper for writing many entries to a wxZipOutputStream, compressing them
+    on several threads.
+
+    The entries data is given to AddEntry() in full and copied, then the data
+    is compressed by one of the worker threads while the calling thread can
+    continue adding more entries. The compressed entries are written to the
+    zip stream in the order in which they were added, and only from the
+    thread calling the methods of this class, so the resulting zip file is
+    the same as if the entries were written to wxZipOutputStream directly,
+    including its Zip64 extensions if they're needed.
+
+    To limit the memory use, adding an entry waits for the oldest ones to be
+    written if too many entries or too much data are already pending.
+
+    Example of use:
+    @code
+        wxFFileOutputStream out(path);
+        wxZipOutputStream zip(out);
+        {
+            wxZipParallelWriter writer(zip);
+            for ( size_t n = 0; n < files.size(); n++ )
+            {
+                const wxCharBuffer& data = files[n].data;
+                writer.AddEntry(files[n].name, data.data(), data.length());
+            }
+
+            if ( !writer.Finish() )
+                ... handle the error ...
+        }
+        zip.Close();
+    @endcode
+
+    The compression level used is the level of the zip stream. Only the store
+    and deflate methods are supported for the entries.
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxZipOutputStream
+
+    @since 3.1.4
+*/
+class wxZipParallelWriter
+{
+public:
+    /**
+        Constructor.
+
+        @param zip
+            The stream to write the entries to. No other entries should be
+            written to it while this object exists.
+        @param threads
+            The number of threads to use for compression, by default as many
+            as there are CPUs. If this is 1, or if threads are not available,
+            the entries are compressed on the calling thread.
+    */
+    wxZipParallelWriter(wxZipOutputStream& zip, int threads = 0);
+
+    /**
+        Destructor calls Finish().
+    */
+    ~wxZipParallelWriter();
+
+    /**
+        Adds an entry with the given data.
+
+        Takes ownership of @a entry, which may have its method set to either
+        @c wxZIP_METHOD_STORE or @c wxZIP_METHOD_DEFLATE, or left as default,
+        in which case the data is stored if it couldn't be compressed.
+
+        The data is copied, so the buffer may be reused as soon as this
+        function returns.
+
+        @return @false if an error occurred when writing this or a previously
+            added entry.
+    */
+    bool AddEntry(wxZipEntry *entry, const void *data, size_t size);
+
+    /**
+        Adds an entry with the given name and data.
+    */
+    bool AddEntry(const wxString& name, const void *data, size_t size,
+                  const wxDateTime& dt = wxDateTime::Now());
+
+    /**
+        Adds a directory entry.
+    */
+    bool AddDirEntry(const wxString& name,
+                     const wxDateTime& dt = wxDateTime::Now());
+
+    /**
+        Waits until all the added entries are written to the zip stream.
+
+        wxZipOutputStream::Close() can be called after calling this function.
+
+        @return @true if all entries were written successfully.
+    */
+    bool Finish();
+
+    /**
+        Returns the number of worker threads, which is 0 if the entries are
+        compressed on the calling thread.
+    */
+    int GetThreadCount() const;
+};
+
+
+
+/**
+    @class wxZipIndex
+
+    Index of the central directory of a zip file allowing to open its entries
+    by name without enumerating them.
+
+    Load() reads the whole central directory at once and builds a hash table
+    of the entry names. No wxZipEntry objects are created for this, GetEntry()
+    creates one for the given entry only when it is needed, so looking up a
+    single entry in an archive with a huge number of entries is much faster
+    than iterating over it using wxZipInputStream::GetNextEntry().
+
+    Once loaded, the index is not modified any more and all its methods
+    can be called concurrently from several threads. Each thread must use its
+    own wxZipInputStream, created for its own parent stream, to read the
+    entries data, e.g.
+    @code
+        wxZipIndex index;
+        wxFFileInputStream in(path);
+        if ( index.Load(in) )
+        {
+            // This can be done from any thread.
+            int n = index.Find("dir/file.txt", wxPATH_UNIX);
+            if ( n != wxNOT_FOUND )
+            {
+                wxFFileInputStream threadIn(path);
+                wxZipInputStream zip(threadIn);
+                if ( zip.OpenEntry(index, n) )
+                    ... read the entry data from zip ...
+            }
+        }
+    @endcode
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxZipInputStream
+
+    @since 3.1.4
+*/
+class wxZipIndex
+{
+public:
+    /**
+        Default constructor creates an empty index.
+
+        Load() must be called before using it.
+    */
+    wxZipIndex();
+
+    /**
+        Reads the central directory of the zip in the given stream.
+
+        The stream must be seekable and isn't used by the index any more
+        after this function returns.
+
+        @param stream
+            The stream containing the zip.
+        @param conv
+            The conversion used for the names and comments of the entries not
+            using UTF-8, as for wxZipInputStream. The object is used by the
+            index after Load() returns, so it must remain alive while the
+            index is used.
+        @return @true if the index was loaded successfully.
+    */
+    bool Load(wxInputStream& stream, wxMBConv& conv = wxConvLocal);
+
+    /**
+        Returns @true if the index was successfully loaded.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the number of entries in the index.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the zip comment.
+    */
+    wxString GetComment() const;
+
+    /**
+        Returns the index of the first entry with the given name or
+        @c wxNOT_FOUND.
+
+        The name is converted to the internal zip format in the same way as
+        wxZipEntry::GetInternalName() does it, so a trailing slash is not
+        needed for the directories.
+    */
+    int Find(const wxString& name, wxPathFormat format = wxPATH_NATIVE) const;
+
+    /**
+        Returns a new wxZipEntry object for the entry with the given index.
+
+        The caller is responsible for deleting the returned object.
+    */
+    wxZipEntry *GetEntry(size_t n) const;
 };
 
 
@@ -38,11 +38,11 @@ using namespace wxPrivate;
 // wxAnyValueTypeGlobals
 //-------------------------------------------------------------------------
 
-WX_DECLARE_HASH_MAP(wxAnyValueType*,
-                    wxVariantDataFactory,
-                    wxPointerHash,
-                    wxPointerEqual,
-                    wxAnyTypeToVariantDataFactoryMap);
+WX_DECLARE_OPEN_HASH_MAP(wxAnyValueType*,
+                         wxVariantDataFactory,
+                         wxPointerHash,
+                         wxPointerEqual,
+                         wxAnyTypeToVariantDataFactoryMap);
 
 //
 // Helper class to manage global variables related to type conversion
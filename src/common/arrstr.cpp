@@ -21,6 +21,9 @@
 
 #include "wx/arrstr.h"
 #include "wx/scopedarray.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+#include "wx/wxcrt.h"
 
 #include "wx/beforestd.h"
 #include <algorithm>
@@ -621,6 +624,245 @@ bool wxArrayString::operator==(const wxArrayString& a) const
 
 #endif // !wxUSE_STD_CONTAINERS
 
+// ----------------------------------------------------------------------------
+// parallel sorting
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+struct wxStringLessUsing
+{
+    explicit wxStringLessUsing(wxArrayString::CompareFunction compareFunction)
+        : m_compareFunction(compareFunction)
+    {
+    }
+
+    bool operator()(const wxString& first, const wxString& second) const
+    {
+        return (*m_compareFunction)(first, second) < 0;
+    }
+
+    wxArrayString::CompareFunction m_compareFunction;
+};
+
+// Sorting the strings in different threads is only safe if copying them
+// doesn't modify any shared data, which is not the case for our own
+// copy-on-write wxStringImpl which doesn't use atomic reference counts.
+#if wxUSE_THREADS && wxUSE_STL_BASED_WXSTRING
+
+// The arrays smaller than this are always sorted in the current thread, as it
+// is not worth starting other threads for them.
+const size_t wxPARALLEL_SORT_MIN_COUNT = 10000;
+
+// Thread sorting a part of the array.
+class wxStringSortThread : public wxThread
+{
+public:
+    wxStringSortThread(wxString* first, wxString* last, const wxStringLessUsing& less)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_first(first),
+          m_last(last),
+          m_less(less)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        std::sort(m_first, m_last, m_less);
+
+        return 0;
+    }
+
+private:
+    wxString* const m_first;
+    wxString* const m_last;
+    const wxStringLessUsing m_less;
+
+    wxDECLARE_NO_COPY_CLASS(wxStringSortThread);
+};
+
+#endif // wxUSE_THREADS && wxUSE_STL_BASED_WXSTRING
+
+void DoParallelSort(wxString* first, wxString* last, const wxStringLessUsing& less)
+{
+#if wxUSE_THREADS && wxUSE_STL_BASED_WXSTRING
+    const size_t count = last - first;
+    const int numCPUs = wxThread::GetCPUCount();
+    if ( count >= wxPARALLEL_SORT_MIN_COUNT && numCPUs > 1 )
+    {
+        // Split the array into one part per CPU and sort all of them, except
+        // the last one, in the other threads.
+        const size_t numParts = numCPUs;
+
+        wxVector<wxString*> bounds;
+        for ( size_t n = 0; n <= numParts; n++ )
+            bounds.push_back(first + count*n/numParts);
+
+        wxVector<wxStringSortThread*> threads;
+        for ( size_t n = 0; n < numParts - 1; n++ )
+        {
+            wxStringSortThread* const
+                thread = new wxStringSortThread(bounds[n], bounds[n + 1], less);
+            if ( thread->Run() != wxTHREAD_NO_ERROR )
+            {
+                // Not being able to start the thread is not fatal, just
+                // sort this part in this thread.
+                delete thread;
+                std::sort(bounds[n], bounds[n + 1], less);
+                continue;
+            }
+
+            threads.push_back(thread);
+        }
+
+        std::sort(bounds[numParts - 1], bounds[numParts], less);
+
+        for ( size_t n = 0; n < threads.size(); n++ )
+        {
+            threads[n]->Wait();
+            delete threads[n];
+        }
+
+        // Now merge the sorted parts together.
+        for ( size_t width = 1; width < numParts; width *= 2 )
+        {
+            for ( size_t n = 0; n + width < numParts; n += 2*width )
+            {
+                const size_t end = n + 2*width < numParts ? n + 2*width
+                                                          : numParts;
+                std::inplace_merge(bounds[n], bounds[n + width], bounds[end],
+                                   less);
+            }
+        }
+
+        return;
+    }
+#endif // wxUSE_THREADS && wxUSE_STL_BASED_WXSTRING
+
+    std::sort(first, last, less);
+}
+
+} // anonymous namespace
+
+void wxArrayString::ParallelSort(CompareFunction compareFunction)
+{
+#if !wxUSE_STD_CONTAINERS
+    wxCHECK_RET( !m_autoSort, wxT("can't use this method with sorted arrays") );
+#endif
+
+    if ( IsEmpty() )
+        return;
+
+    wxString* const first = &Item(0);
+    DoParallelSort(first, first + GetCount(), wxStringLessUsing(compareFunction));
+}
+
+// ----------------------------------------------------------------------------
+// natural order comparison
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+inline bool wxIsAsciiDigit(wxUniChar ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+} // anonymous namespace
+
+int wxCMPFUNC_CONV wxCmpNatural(const wxString& s1, const wxString& s2)
+{
+    // This function doesn't create any temporary strings or convert the
+    // numbers to integers, so that it's fast enough for sorting big arrays and
+    // works for arbitrarily long numbers. The strings are compared one
+    // character at a time, except for the sequences of digits which are
+    // compared by their numeric value.
+    //
+    // If the strings are equal using this comparison, the results of the
+    // comparisons of the numbers with different number of leading zeroes and
+    // of characters differing only in case are used to order them, so that 0
+    // is only returned for identical strings.
+    int cmpZeroes = 0,
+        cmpCase = 0;
+
+    wxString::const_iterator i1 = s1.begin(),
+                             i2 = s2.begin();
+    const wxString::const_iterator end1 = s1.end(),
+                                   end2 = s2.end();
+
+    while ( i1 != end1 && i2 != end2 )
+    {
+        const wxUniChar ch1 = *i1,
+                        ch2 = *i2;
+
+        if ( wxIsAsciiDigit(ch1) && wxIsAsciiDigit(ch2) )
+        {
+            // Skip the leading zeroes, they don't affect the value.
+            size_t zeroes1 = 0,
+                   zeroes2 = 0;
+            for ( ; i1 != end1 && *i1 == '0'; ++i1 )
+                zeroes1++;
+            for ( ; i2 != end2 && *i2 == '0'; ++i2 )
+                zeroes2++;
+
+            // The number with more digits is bigger and, if both numbers
+            // have the same number of digits, the first different digit
+            // determines which one is bigger, so find both at once.
+            int cmpDigits = 0;
+            for ( ;; ++i1, ++i2 )
+            {
+                const bool digit1 = i1 != end1 && wxIsAsciiDigit(*i1),
+                           digit2 = i2 != end2 && wxIsAsciiDigit(*i2);
+
+                if ( !digit1 || !digit2 )
+                {
+                    if ( digit1 )
+                        return 1;
+                    if ( digit2 )
+                        return -1;
+
+                    break;
+                }
+
+                if ( !cmpDigits && *i1 != *i2 )
+                    cmpDigits = *i1 < *i2 ? -1 : 1;
+            }
+
+            if ( cmpDigits )
+                return cmpDigits;
+
+            if ( !cmpZeroes && zeroes1 != zeroes2 )
+                cmpZeroes = zeroes1 < zeroes2 ? -1 : 1;
+
+            continue;
+        }
+
+        if ( ch1 != ch2 )
+        {
+            const wxUniChar lower1 = wxTolower(ch1),
+                            lower2 = wxTolower(ch2);
+            if ( lower1 != lower2 )
+                return lower1 < lower2 ? -1 : 1;
+
+            if ( !cmpCase )
+                cmpCase = ch1 < ch2 ? -1 : 1;
+        }
+
+        ++i1;
+        ++i2;
+    }
+
+    if ( i1 != end1 )
+        return 1;
+    if ( i2 != end2 )
+        return -1;
+
+    return cmpZeroes ? cmpZeroes : cmpCase;
+}
+
 // ===========================================================================
 // wxJoin and wxSplit
 // ===========================================================================
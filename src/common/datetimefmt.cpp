@@ -100,10 +100,19 @@ bool GetNumericToken(size_t len,
                      size_t *numScannedDigits = NULL)
 {
     size_t n = 1;
-    wxString s;
+    unsigned long value = 0;
+    bool ok = true;
     while ( p != end && wxIsdigit(*p) )
     {
-        s += *p++;
+        // accumulate the value directly instead of building a string and
+        // converting it as this function is called a lot when parsing dates,
+        // but still fail for non-ASCII digits or overflow as ToULong() did
+        const wxUniChar::value_type ch = (*p++).GetValue();
+        const unsigned long digit = ch - '0';
+        if ( ch < '0' || ch > '9' || value > (ULONG_MAX - digit) / 10 )
+            ok = false;
+        else
+            value = value*10 + digit;
 
         if ( len && ++n > len )
             break;
@@ -114,7 +123,11 @@ bool GetNumericToken(size_t len,
         *numScannedDigits = n - 1;
     }
 
-    return !s.empty() && s.ToULong(number);
+    if ( !ok || n == 1 )
+        return false;
+
+    *number = value;
+    return true;
 }
 
 // scans all alphabetic characters and returns the resulting string
@@ -131,6 +144,93 @@ GetAlphaToken(wxString::const_iterator& p,
     return s;
 }
 
+// parses the time zone offset in "Z", "[+-]HH", "[+-]HHMM" or "[+-]HH:MM"
+// format and returns it in seconds
+bool
+GetTimeZoneOffset(wxString::const_iterator& p,
+                  const wxString::const_iterator& end,
+                  long *offset)
+{
+    // check that we have something here at all
+    if ( p == end )
+        return false;
+
+    if ( *p == wxS('Z') )
+    {
+        // Time is in UTC.
+        ++p;
+        *offset = 0;
+        return true;
+    }
+
+    // Check if there's either a plus, hyphen-minus, or minus sign.
+    bool minusFound;
+    if ( *p == wxS('+') )
+        minusFound = false;
+    else if
+    (
+        *p == wxS('-')
+#if wxUSE_UNICODE
+        || (*p).GetValue() == 0x2212 // U+2212 MINUS SIGN
+#endif
+    )
+        minusFound = true;
+    else
+        return false;   // no match
+
+    ++p;
+
+    // Here should follow exactly 2 digits for hours (HH).
+    const size_t numRequiredDigits = 2;
+    size_t numScannedDigits;
+
+    unsigned long hours;
+    if ( !GetNumericToken(numRequiredDigits, p, end,
+                          &hours, &numScannedDigits)
+         || numScannedDigits != numRequiredDigits)
+    {
+        return false; // No match.
+    }
+
+    // Optionally followed by a colon separator.
+    bool mustHaveMinutes = false;
+    if ( p != end && *p == wxS(':') )
+    {
+        mustHaveMinutes = true;
+        ++p;
+    }
+
+    // Optionally followed by exactly 2 digits for minutes (MM).
+    unsigned long minutes = 0;
+    if ( !GetNumericToken(numRequiredDigits, p, end,
+                          &minutes, &numScannedDigits)
+         || numScannedDigits != numRequiredDigits)
+    {
+        if (mustHaveMinutes || numScannedDigits)
+        {
+            // No match if we must have minutes, or digits
+            // for minutes were specified but not exactly 2.
+            return false;
+        }
+    }
+
+    /*
+    Contemporary offset limits are -12:00 and +14:00.
+    However historically offsets of over +/- 15 hours
+    existed so be a bit more flexible. Info retrieved
+    from Time Zone Database at
+    https://www.iana.org/time-zones.
+    */
+    if ( hours > 15 || minutes > 59 )
+        return false;   // bad format
+
+    *offset = 3600*hours + 60*minutes;
+    if ( minusFound )
+        *offset = -*offset;
+
+    return true;
+}
+
 enum
 {
     DateLang_English = 1,
@@ -1459,87 +1559,10 @@ wxDateTime::ParseFormat(const wxString& date,
                 break;
 
             case wxT('z'):
-                {
-                    // check that we have something here at all
-                    if ( input == end )
-                        return false;
-
-                    if ( *input == wxS('Z') )
-                    {
-                        // Time is in UTC.
-                        ++input;
-                        haveTimeZone = true;
-                        break;
-                    }
-
-                    // Check if there's either a plus, hyphen-minus, or
-                    // minus sign.
-                    bool minusFound;
-                    if ( *input == wxS('+') )
-                        minusFound = false;
-                    else if
-                    (
-                        *input == wxS('-')
-#if wxUSE_UNICODE
-                        || *input == wxString::FromUTF8("\xe2\x88\x92")
-#endif
-                    )
-                        minusFound = true;
-                    else
-                        return false;   // no match
-
-                    ++input;
-
-                    // Here should follow exactly 2 digits for hours (HH).
-                    const size_t numRequiredDigits = 2;
-                    size_t numScannedDigits;
-
-                    unsigned long hours;
-                    if ( !GetNumericToken(numRequiredDigits, input, end,
-                                          &hours, &numScannedDigits)
-                         || numScannedDigits != numRequiredDigits)
-                    {
-                        return false; // No match.
-                    }
-
-                    // Optionally followed by a colon separator.
-                    bool mustHaveMinutes = false;
-                    if ( input != end && *input == wxS(':') )
-                    {
-                        mustHaveMinutes = true;
-                        ++input;
-                    }
-
-                    // Optionally followed by exactly 2 digits for minutes (MM).
-                    unsigned long minutes = 0;
-                    if ( !GetNumericToken(numRequiredDigits, input, end,
-                                          &minutes, &numScannedDigits)
-                         || numScannedDigits != numRequiredDigits)
-                    {
-                        if (mustHaveMinutes || numScannedDigits)
-                        {
-                            // No match if we must have minutes, or digits
-                            // for minutes were specified but not exactly 2.
-                            return false;
-                        }
-                    }
+                if ( !GetTimeZoneOffset(input, end, &timeZone) )
+                    return false;
 
-                    /*
-                    Contemporary offset limits are -12:00 and +14:00.
-                    However historically offsets of over +/- 15 hours
-                    existed so be a bit more flexible. Info retrieved
-                    from Time Zone Database at
-                    https://www.iana.org/time-zones.
-                    */
-                    if ( hours > 15 || minutes > 59 )
-                        return false;   // bad format
-
-                    timeZone = 3600*hours + 60*minutes;
-                    if ( minusFound )
-                        timeZone = -timeZone;
-
-                    haveTimeZone = true;
-                }
+                haveTimeZone = true;
                 break;
 
             case wxT('Z'):       // timezone name
@@ -2419,4 +2442,489 @@ wxString wxTimeSpan::Format(const wxString& format) const
     return str;
 }
 
+// ============================================================================
+// wxDateTimeFormatter
+// ============================================================================
+
+namespace
+{
+
+// returns the number of days since the epoch for the given date in the
+// Gregorian calendar (the month is 1-based here)
+long GetDaysSinceEpoch(long year, long month, long day)
+{
+    // the algorithm counts years starting from March, so that the leap day
+    // is the last one of the year
+    if ( month <= 2 )
+        year--;
+
+    const long era = (year >= 0 ? year : year - 399) / 400;
+    const long yearOfEra = year - era * 400;
+    const long dayOfYear = (153*(month > 2 ? month - 3 : month + 9) + 2)/5 +
+                                day - 1;
+    const long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 +
+                                dayOfYear;
+
+    // 719468 is the number of days from 0000-03-01 to 1970-01-01
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// helper for wxDateTimeFormatter::Format() writing to a fixed size buffer: it
+// never writes past its end but still counts the length of the entire output
+class FormatterOutput
+{
+public:
+    FormatterOutput(wxChar *buf, size_t size)
+        : m_buf(buf), m_size(size), m_len(0)
+    {
+    }
+
+    void Append(wxChar ch)
+    {
+        // always leave space for the trailing NUL
+        if ( m_len + 1 < m_size )
+            m_buf[m_len] = ch;
+
+        m_len++;
+    }
+
+    // append the number padded with zeroes as "%0<width>d" would do
+    void AppendNumber(long n, unsigned width)
+    {
+        unsigned long value;
+        if ( n < 0 )
+        {
+            Append(wxT('-'));
+            value = -(unsigned long)n;
+
+            if ( width )
+                width--;
+        }
+        else
+        {
+            value = n;
+        }
+
+        wxChar digits[32];
+        unsigned count = 0;
+        do
+        {
+            digits[count++] = (wxChar)(wxT('0') + value % 10);
+            value /= 10;
+        } while ( value );
+
+        for ( ; width > count; width-- )
+            Append(wxT('0'));
+
+        while ( count )
+            Append(digits[--count]);
+    }
+
+    // NUL-terminate the output and return its full length
+    size_t Finish()
+    {
+        if ( m_size )
+            m_buf[m_len < m_size ? m_len : m_size - 1] = wxT('\0');
+
+        return m_len;
+    }
+
+private:
+    wxChar * const m_buf;
+    const size_t m_size;
+    size_t m_len;
+};
+
+} // anonymous namespace
+
+void wxDateTimeFormatter::SetFormat(const wxString& format)
+{
+    m_format = format;
+    m_items.clear();
+
+    m_hasTimeZone = false;
+    m_compiled = !format.empty();
+
+    bool haveYear = false,
+         haveMon = false,
+         haveDay = false;
+
+    // notice that we continue even if the format can't be compiled to know
+    // whether it contains the time zone
+    for ( wxString::const_iterator p = format.begin(); p != format.end(); ++p )
+    {
+        Item item;
+        item.spec = 0;
+        item.width = 0;
+        item.ch = 0;
+
+        if ( *p != wxT('%') )
+        {
+            const wxUniChar ch = *p;
+#if wxUSE_UNICODE
+    #if SIZEOF_WCHAR_T == 2
+            // we can't represent this character by a single wxChar
+            if ( !ch.IsBMP() )
+                m_compiled = false;
+    #endif
+            item.ch = static_cast<wxChar>(ch.GetValue());
+#else // !wxUSE_UNICODE
+            if ( !ch.GetAsChar(&item.ch) )
+                m_compiled = false;
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+
+            m_items.push_back(item);
+            continue;
+        }
+
+        if ( ++p == format.end() )
+        {
+            // let wxDateTime deal with this error
+            m_compiled = false;
+            break;
+        }
+
+        // only handle the numeric fields which are formatted in the same way
+        // in any locale, anything else (including explicitly specified width)
+        // is handled by wxDateTime itself
+        switch ( (*p).GetValue() )
+        {
+            case wxT('Y'):
+                haveYear = true;
+                item.width = 4;
+                break;
+
+            case wxT('y'):
+                haveYear = true;
+                item.width = 2;
+                break;
+
+            case wxT('m'):
+                haveMon = true;
+                item.width = 2;
+                break;
+
+            case wxT('d'):
+                haveDay = true;
+                item.width = 2;
+                break;
+
+            case wxT('H'):
+            case wxT('M'):
+            case wxT('S'):
+                item.width = 2;
+                break;
+
+            case wxT('l'):
+                item.width = 3;
+                break;
+
+            case wxT('z'):
+                m_hasTimeZone = true;
+                break;
+
+            case wxT('%'):
+                break;
+
+            default:
+                m_compiled = false;
+                continue;
+        }
+
+        item.spec = static_cast<char>((*p).GetValue());
+        m_items.push_back(item);
+    }
+
+    m_hasDate = haveYear && haveMon && haveDay;
+
+    if ( !m_compiled )
+        m_items.clear();
+}
+
+wxString
+wxDateTimeFormatter::Format(const wxDateTime& dt,
+                            const wxDateTime::TimeZone& tz) const
+{
+    if ( !m_compiled )
+        return dt.Format(m_format, tz);
+
+    // the result almost always fits into this buffer
+    wxChar buf[128];
+    const size_t len = Format(dt, buf, WXSIZEOF(buf), tz);
+    if ( len < WXSIZEOF(buf) )
+        return wxString(buf, len);
+
+    wxCharTypeBuffer<wxChar> bufLong(len);
+    Format(dt, bufLong.data(), len + 1, tz);
+    return wxString(bufLong.data(), len);
+}
+
+size_t
+wxDateTimeFormatter::Format(const wxDateTime& dt,
+                            wxChar *buf,
+                            size_t size,
+                            const wxDateTime::TimeZone& tz) const
+{
+    wxCHECK_MSG( buf || !size, 0, wxS("NULL buffer") );
+
+    if ( !m_compiled )
+    {
+        size_t len;
+        const wxCharTypeBuffer<wxChar>
+            str(dt.Format(m_format, tz).tchar_str<wxChar>(&len));
+
+        if ( size )
+        {
+            const size_t lenCopy = len < size ? len : size - 1;
+            memcpy(buf, str.data(), lenCopy*sizeof(wxChar));
+            buf[lenCopy] = wxT('\0');
+        }
+
+        return len;
+    }
+
+    const wxDateTime::Tm tm = dt.GetTm(tz);
+
+    FormatterOutput out(buf, size);
+    for ( wxVector<Item>::const_iterator it = m_items.begin();
+          it != m_items.end();
+          ++it )
+    {
+        // the output here must be the same as in wxDateTime::Format()
+        switch ( it->spec )
+        {
+            case 0:
+                out.Append(it->ch);
+                break;
+
+            case 'd':
+                out.AppendNumber(tm.mday, 2);
+                break;
+
+            case 'H':
+                out.AppendNumber(tm.hour, 2);
+                break;
+
+            case 'l':
+                out.AppendNumber(tm.msec, 3);
+                break;
+
+            case 'm':
+                out.AppendNumber(tm.mon + 1, 2);
+                break;
+
+            case 'M':
+                out.AppendNumber(tm.min, 2);
+                break;
+
+            case 'S':
+                out.AppendNumber(tm.sec, 2);
+                break;
+
+            case 'y':
+                out.AppendNumber(tm.year % 100, 2);
+                break;
+
+            case 'Y':
+                out.AppendNumber(tm.year, 4);
+                break;
+
+            case 'z':
+                {
+                    long ofs = tz.GetOffset();
+                    if ( ofs == -wxGetTimeZone() && dt.IsDST() == 1 )
+                        ofs += wxDateTime::DST_OFFSET;
+
+                    if ( ofs < 0 )
+                    {
+                        out.Append(wxT('-'));
+                        ofs = -ofs;
+                    }
+                    else
+                    {
+                        out.Append(wxT('+'));
+                    }
+
+                    out.AppendNumber(100*(ofs/3600) + (ofs/60)%60, 4);
+                }
+                break;
+
+            case '%':
+                out.Append(wxT('%'));
+                break;
+        }
+    }
+
+    return out.Finish();
+}
+
+bool
+wxDateTimeFormatter::Parse(const wxString& date,
+                           wxDateTime *dt,
+                           const wxDateTime::TimeZone& tz,
+                           wxString::const_iterator *end) const
+{
+    wxCHECK_MSG( dt, false, wxS("NULL pointer") );
+
+    if ( !m_compiled )
+    {
+        wxString::const_iterator endParse;
+        if ( !dt->ParseFormat(date, m_format, wxDateTime::Today(), &endParse) )
+            return false;
+
+        if ( !m_hasTimeZone && !tz.IsLocal() )
+            dt->MakeFromTimezone(tz);
+
+        if ( end )
+            *end = endParse;
+
+        return true;
+    }
+
+    // the values of the fields: notice that we must use the same defaults as
+    // wxDateTime::ParseFormat() with today's date as the default one
+    int year = 0;
+    unsigned long mon = 0,
+                  mday = 0,
+                  hour = 0,
+                  min = 0,
+                  sec = 0,
+                  msec = 0;
+    long timeZone = 0;
+
+    bool haveYear = false,
+         haveMon = false,
+         haveDay = false;
+
+    wxString::const_iterator input = date.begin();
+    const wxString::const_iterator inputEnd = date.end();
+    for ( wxVector<Item>::const_iterator it = m_items.begin();
+          it != m_items.end();
+          ++it )
+    {
+        unsigned long num;
+        switch ( it->spec )
+        {
+            case 0:
+                if ( wxIsspace(it->ch) )
+                {
+                    // a white space in the format string matches 0 or more
+                    // white spaces in the input
+                    while ( input != inputEnd && wxIsspace(*input) )
+                        ++input;
+                }
+                else if ( input == inputEnd || *input++ != it->ch )
+                {
+                    return false;
+                }
+                break;
+
+            case '%':
+                if ( input == inputEnd || *input++ != wxT('%') )
+                    return false;
+                break;
+
+            case 'z':
+                if ( !GetTimeZoneOffset(input, inputEnd, &timeZone) )
+                    return false;
+                break;
+
+            default:
+                if ( !GetNumericToken(it->width, input, inputEnd, &num) )
+                    return false;
+
+                switch ( it->spec )
+                {
+                    case 'd':
+                        if ( num < 1 || num > 31 )
+                            return false;
+                        mday = num;
+                        haveDay = true;
+                        break;
+
+                    case 'H':
+                        if ( num > 23 )
+                            return false;
+                        hour = num;
+                        break;
+
+                    case 'l':
+                        msec = num;
+                        break;
+
+                    case 'm':
+                        if ( num < 1 || num > 12 )
+                            return false;
+                        mon = num - 1;
+                        haveMon = true;
+                        break;
+
+                    case 'M':
+                        if ( num > 59 )
+                            return false;
+                        min = num;
+                        break;
+
+                    case 'S':
+                        if ( num > 61 )
+                            return false;
+                        sec = num;
+                        break;
+
+                    case 'y':
+                        if ( num > 99 )
+                            return false;
+                        year = (num > 30 ? 1900 : 2000) + (int)num;
+                        haveYear = true;
+                        break;
+
+                    case 'Y':
+                        year = (int)num;
+                        haveYear = true;
+                        break;
+                }
+        }
+    }
+
+    if ( !m_hasDate )
+    {
+        const wxDateTime::Tm tmToday = wxDateTime::Today().GetTm();
+        if ( !haveYear )
+            year = tmToday.year;
+        if ( !haveMon )
+            mon = tmToday.mon;
+        if ( !haveDay )
+            mday = tmToday.mday;
+    }
+
+    if ( mday > wxDateTime::GetNumberOfDays((wxDateTime::Month)mon, year) )
+        return false;
+
+    if ( m_hasTimeZone || !tz.IsLocal() )
+    {
+        // we don't need to go through the local time at all in this case
+        if ( !m_hasTimeZone )
+            timeZone = tz.GetOffset();
+
+        wxLongLong value = GetDaysSinceEpoch(year, mon + 1, mday);
+        value *= 24*60*60;
+        value += 60*(60*hour + min) + sec - timeZone;
+        value *= 1000;
+        value += msec;
+
+        *dt = wxDateTime(value);
+    }
+    else
+    {
+        dt->Set(mday, (wxDateTime::Month)mon, year, hour, min, sec, msec);
+        if ( !dt->IsValid() )
+            return false;
+    }
+
+    if ( end )
+        *end = input;
+
+    return true;
+}
+
 #endif // wxUSE_DATETIME
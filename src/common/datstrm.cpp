@@ -21,6 +21,7 @@
 
 #ifndef WX_PRECOMP
     #include "wx/math.h"
+    #include "wx/utils.h"
 #endif //WX_PRECOMP
 
 namespace
@@ -39,6 +40,70 @@ union Float64Data
     wxUint32 i[2];
 };
 
+// helpers for reading and writing arrays of numbers: the bytes of all of them
+// are swapped in a single simple loop, which the compiler can vectorize, and
+// then the entire array, or a chunk of it, is read or written at once
+inline bool NeedsSwap(bool be_order)
+{
+    return be_order != (wxBYTE_ORDER == wxBIG_ENDIAN);
+}
+
+inline wxUint16 SwapBytes(wxUint16 v) { return wxUINT16_SWAP_ALWAYS(v); }
+inline wxUint32 SwapBytes(wxUint32 v) { return wxUINT32_SWAP_ALWAYS(v); }
+#if wxHAS_INT64
+inline wxUint64 SwapBytes(wxUint64 v) { return wxUINT64_SWAP_ALWAYS(v); }
+#endif // wxHAS_INT64
+
+// swap the bytes of count elements of type T, dst and src may be the same
+template <typename T>
+void SwapElements(void *dst, const void *src, size_t count)
+{
+    char *d = static_cast<char *>(dst);
+    const char *s = static_cast<const char *>(src);
+    for ( size_t n = 0; n < count; n++, d += sizeof(T), s += sizeof(T) )
+    {
+        T v;
+        memcpy(&v, s, sizeof(T));
+        v = SwapBytes(v);
+        memcpy(d, &v, sizeof(T));
+    }
+}
+
+template <typename T>
+void ReadArray(wxInputStream *input, void *buffer, size_t count, bool be_order)
+{
+    input->Read(buffer, count * sizeof(T));
+
+    if ( NeedsSwap(be_order) )
+        SwapElements<T>(buffer, buffer, count);
+}
+
+template <typename T>
+void WriteArray(wxOutputStream *output, const void *buffer, size_t count,
+                bool be_order)
+{
+    if ( !NeedsSwap(be_order) )
+    {
+        output->Write(buffer, count * sizeof(T));
+        return;
+    }
+
+    // swap the data in chunks to avoid allocating memory for all of it
+    T chunk[4096 / sizeof(T)];
+    const char *p = static_cast<const char *>(buffer);
+    while ( count )
+    {
+        const size_t n = wxMin(count, WXSIZEOF(chunk));
+        SwapElements<T>(chunk, p, n);
+
+        if ( output->Write(chunk, n * sizeof(T)).LastWrite() != n * sizeof(T) )
+            break;
+
+        p += n * sizeof(T);
+        count -= n;
+    }
+}
+
 } // anonymous namespace
 
 // ----------------------------------------------------------------------------
@@ -288,51 +353,14 @@ template <class T>
 static
 void DoReadI64(T *buffer, size_t size, wxInputStream *input, bool be_order)
 {
-    typedef T DataType;
-    unsigned char *pchBuffer = (unsigned char*) buffer;
-    // TODO: Check for overflow when size is of type uint and is > than 512m
-    input->Read(pchBuffer, size * 8);
-    if ( be_order )
-    {
-        for ( wxUint32 i = 0; i < size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else // little endian
-    {
-        for ( wxUint32 i=0; i<size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
+    ReadArray<wxUint64>(input, buffer, size, be_order);
 }
 
 template <class T>
 static
 void DoWriteI64(const T *buffer, size_t size, wxOutputStream *output, bool be_order)
 {
-  typedef T DataType;
-  if ( be_order )
-  {
-    for ( size_t i = 0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_LE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
-  else // little endian
-  {
-    for ( size_t i=0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_BE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
+    WriteArray<wxUint64>(output, buffer, size, be_order);
 }
 
 #endif // wxLongLong_t
@@ -391,46 +419,12 @@ wxLongLong wxDataInputStream::ReadLL(void)
 
 void wxDataInputStream::Read32(wxUint32 *buffer, size_t size)
 {
-    m_input->Read(buffer, size * 4);
-
-    if (m_be_order)
-    {
-        for (wxUint32 i=0; i<size; i++)
-        {
-            wxUint32 v = wxUINT32_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else
-    {
-        for (wxUint32 i=0; i<size; i++)
-        {
-            wxUint32 v = wxUINT32_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
+    ReadArray<wxUint32>(m_input, buffer, size, m_be_order);
 }
 
 void wxDataInputStream::Read16(wxUint16 *buffer, size_t size)
 {
-  m_input->Read(buffer, size * 2);
-
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size; i++)
-    {
-      wxUint16 v = wxUINT16_SWAP_ON_LE(*buffer);
-      *(buffer++) = v;
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size; i++)
-    {
-      wxUint16 v = wxUINT16_SWAP_ON_BE(*buffer);
-      *(buffer++) = v;
-    }
-  }
+    ReadArray<wxUint16>(m_input, buffer, size, m_be_order);
 }
 
 void wxDataInputStream::Read8(wxUint8 *buffer, size_t size)
@@ -440,18 +434,34 @@ void wxDataInputStream::Read8(wxUint8 *buffer, size_t size)
 
 void wxDataInputStream::ReadDouble(double *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    *(buffer++) = ReadDouble();
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        for ( size_t i = 0; i < size; i++ )
+            buffer[i] = ReadDouble();
+    }
+    else
+#endif // wxUSE_APPLE_IEEE
+    {
+        // the values are stored in IEEE format, just as in memory
+        ReadArray<wxUint64>(m_input, buffer, size, m_be_order);
+    }
 }
 
 void wxDataInputStream::ReadFloat(float *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    *(buffer++) = ReadFloat();
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        for ( size_t i = 0; i < size; i++ )
+            buffer[i] = ReadFloat();
+    }
+    else
+#endif // wxUSE_APPLE_IEEE
+    {
+        // the values are stored in IEEE format, just as in memory
+        ReadArray<wxUint32>(m_input, buffer, size, m_be_order);
+    }
 }
 
 wxDataInputStream& wxDataInputStream::operator>>(wxString& s)
@@ -703,46 +713,12 @@ void wxDataOutputStream::WriteLL(const wxULongLong &ll)
 
 void wxDataOutputStream::Write32(const wxUint32 *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint32 i32 = wxUINT32_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint32 i32 = wxUINT32_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
+    WriteArray<wxUint32>(m_output, buffer, size, m_be_order);
 }
 
 void wxDataOutputStream::Write16(const wxUint16 *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint16 i16 = wxUINT16_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint16 i16 = wxUINT16_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
+    WriteArray<wxUint16>(m_output, buffer, size, m_be_order);
 }
 
 void wxDataOutputStream::Write8(const wxUint8 *buffer, size_t size)
@@ -752,18 +728,34 @@ void wxDataOutputStream::Write8(const wxUint8 *buffer, size_t size)
 
 void wxDataOutputStream::WriteDouble(const double *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    WriteDouble(*(buffer++));
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        for ( size_t i = 0; i < size; i++ )
+            WriteDouble(buffer[i]);
+    }
+    else
+#endif // wxUSE_APPLE_IEEE
+    {
+        // the values are stored in IEEE format, just as in memory
+        WriteArray<wxUint64>(m_output, buffer, size, m_be_order);
+    }
 }
 
 void wxDataOutputStream::WriteFloat(const float *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    WriteFloat(*(buffer++));
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        for ( size_t i = 0; i < size; i++ )
+            WriteFloat(buffer[i]);
+    }
+    else
+#endif // wxUSE_APPLE_IEEE
+    {
+        // the values are stored in IEEE format, just as in memory
+        WriteArray<wxUint32>(m_output, buffer, size, m_be_order);
+    }
 }
 
 wxDataOutputStream& wxDataOutputStream::operator<<(const wxString& string)
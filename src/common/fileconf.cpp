@@ -36,13 +36,20 @@
 
 #include  "wx/file.h"
 #include  "wx/textfile.h"
-#include  "wx/memtext.h"
 #include  "wx/config.h"
 #include  "wx/fileconf.h"
 #include  "wx/filefn.h"
 
 #include "wx/base64.h"
 
+#if wxUSE_STREAMS
+    #include "wx/wfstream.h"
+#endif // wxUSE_STREAMS
+
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif // wxUSE_THREADS
+
 #include  "wx/stdpaths.h"
 
 #if defined(__WINDOWS__)
@@ -58,6 +65,11 @@
 
 #define FILECONF_TRACE_MASK wxT("fileconf")
 
+// checking the trace mask using this handle is much cheaper than using the
+// string directly, which matters as the line list functions use wxLogTrace()
+// for every line of the file
+static wxLogTraceMaskHandle gs_traceMask(FILECONF_TRACE_MASK);
+
 // ----------------------------------------------------------------------------
 // global functions declarations
 // ----------------------------------------------------------------------------
@@ -76,6 +88,16 @@ static wxString FilterOutEntryName(const wxString& str);
 // get the name to use in wxFileConfig ctor
 static wxString GetAppName(const wxString& appname);
 
+// convert the raw file contents to the text which can be parsed
+static wxWxCharBuffer
+ConvertFileContents(const char *data, size_t len, const wxMBConv& conv,
+                    size_t *textLen);
+
+// write the text to the temporary file and replace the original one with it
+static bool WriteConfigFile(wxTempFile& file,
+                            const wxString& text,
+                            const wxMBConv& conv);
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -161,7 +183,8 @@ public:
                   GetLine()     const { return m_pLine;      }
 
   // modify entry attributes
-  void SetValue(const wxString& strValue, bool bUser = true);
+  // returns false if the value didn't change
+  bool SetValue(const wxString& strValue, bool bUser = true);
   void SetLine(wxFileConfigLineList *pLine);
 
     wxDECLARE_NO_COPY_CLASS(wxFileConfigEntry);
@@ -308,11 +331,8 @@ void wxFileConfig::Init()
     // parse the global file
     if ( m_fnGlobalFile.IsOk() && m_fnGlobalFile.FileExists() )
     {
-        wxTextFile fileGlobal(m_fnGlobalFile.GetFullPath());
-
-        if ( fileGlobal.Open(*m_conv/*ignored in ANSI build*/) )
+        if ( LoadFile(m_fnGlobalFile.GetFullPath(), false /* global */) )
         {
-            Parse(fileGlobal, false /* global */);
             SetRootPath();
         }
         else
@@ -324,10 +344,8 @@ void wxFileConfig::Init()
     // parse the local file
     if ( m_fnLocalFile.IsOk() && m_fnLocalFile.FileExists() )
     {
-        wxTextFile fileLocal(m_fnLocalFile.GetFullPath());
-        if ( fileLocal.Open(*m_conv/*ignored in ANSI build*/) )
+        if ( LoadFile(m_fnLocalFile.GetFullPath(), true /* local */) )
         {
-            Parse(fileLocal, true /* local */);
             SetRootPath();
         }
         else
@@ -361,6 +379,11 @@ wxFileConfig::wxFileConfig(const wxString& appName, const wxString& vendorName,
               m_fnGlobalFile(strGlobal),
               m_conv(conv.Clone())
 {
+#if wxUSE_THREADS
+    m_backgroundFlush = false;
+    m_flushThread = NULL;
+#endif // wxUSE_THREADS
+
     // Make up names for files if empty
     if ( !m_fnLocalFile.IsOk() && (style & wxCONFIG_USE_LOCAL_FILE) )
         m_fnLocalFile = GetLocalFile(GetAppName(), style);
@@ -400,6 +423,11 @@ wxFileConfig::wxFileConfig(wxInputStream &inStream, const wxMBConv& conv)
     m_isDirty = false;
     m_autosave = true;
 
+#if wxUSE_THREADS
+    m_backgroundFlush = false;
+    m_flushThread = NULL;
+#endif // wxUSE_THREADS
+
     // always local_file when this constructor is called (?)
     SetStyle(GetStyle() | wxCONFIG_USE_LOCAL_FILE);
 
@@ -429,47 +457,17 @@ wxFileConfig::wxFileConfig(wxInputStream &inStream, const wxMBConv& conv)
     }
     while ( !inStream.Eof() );
 
-#if wxUSE_UNICODE
     size_t len;
-    cbuf = conv.cMB2WC((char *)buf.GetData(), buf.GetDataLen() + 1, &len);
-    if ( !len && buf.GetDataLen() )
+    cbuf = ConvertFileContents((char *)buf.GetData(), buf.GetDataLen(),
+                               conv, &len);
+    if ( !cbuf && buf.GetDataLen() )
     {
         wxLogError(_("Failed to read config options."));
     }
-#else // !wxUSE_UNICODE
-    // no need for conversion
-    cbuf = wxCharBuffer::CreateNonOwned((char *)buf.GetData(), buf.GetDataLen());
-#endif // wxUSE_UNICODE/!wxUSE_UNICODE
 
     // parse the input contents if there is anything to parse
     if ( cbuf )
-    {
-        // now break it into lines
-        wxMemoryText memText;
-        for ( const wxChar *s = cbuf; ; ++s )
-        {
-            const wxChar *e = s;
-            while ( *e != '\0' && *e != '\n' && *e != '\r' )
-                ++e;
-
-            // notice that we throw away the original EOL kind here, maybe we
-            // should preserve it?
-            if ( e != s )
-                memText.AddLine(wxString(s, e));
-
-            if ( *e == '\0' )
-                break;
-
-            // skip the second EOL byte if it's a DOS one
-            if ( *e == '\r' && e[1] == '\n' )
-                ++e;
-
-            s = e;
-        }
-
-        // Finally we can parse it all.
-        Parse(memText, true /* local */);
-    }
+        Parse(wxEmptyString, cbuf.data(), len, true /* local */);
 
     SetRootPath();
     ResetDirty();
@@ -491,6 +489,11 @@ void wxFileConfig::CleanUp()
 
 wxFileConfig::~wxFileConfig()
 {
+#if wxUSE_THREADS
+    // the file must be completely written when we return
+    EnableBackgroundFlush(false);
+#endif // wxUSE_THREADS
+
     if ( m_autosave )
         Flush();
 
@@ -503,22 +506,85 @@ wxFileConfig::~wxFileConfig()
 // parse a config file
 // ----------------------------------------------------------------------------
 
-void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
+bool wxFileConfig::LoadFile(const wxString& path, bool bLocal)
 {
+  // map the file into memory and convert it directly from there instead of
+  // reading it into a wxTextFile first, which is significantly slower for
+  // big files as it needs to make several copies of each line
+#if wxUSE_STREAMS
+  wxMappedFileInputStream file(path);
+  if ( file.GetLastError() == wxSTREAM_READ_ERROR )
+    return false;
+
+  size_t size;
+  const char * const data = static_cast<const char *>(file.GetUnreadData(&size));
+#else // !wxUSE_STREAMS
+  wxFile file;
+  if ( !file.Open(path) )
+    return false;
+
+  const wxFileOffset length = file.Length();
+  if ( length == wxInvalidOffset )
+    return false;
+
+  const size_t size = static_cast<size_t>(length);
+  wxCharBuffer buf(size);
+  if ( file.Read(buf.data(), size) != static_cast<ssize_t>(size) )
+    return false;
+
+  const char * const data = buf.data();
+#endif // wxUSE_STREAMS/!wxUSE_STREAMS
+
+  if ( !size )
+    return true;
+
+  size_t len;
+  wxWxCharBuffer text = ConvertFileContents(data, size, *m_conv, &len);
+  if ( !text )
+  {
+    wxLogError(_("Failed to read text file \"%s\"."), path);
+    return false;
+  }
 
-  size_t nLineCount = buffer.GetLineCount();
+  Parse(path, text.data(), len, bLocal);
 
-  for ( size_t n = 0; n < nLineCount; n++ )
+  return true;
+}
+
+void wxFileConfig::Parse(const wxString& name, wxChar *text, size_t len,
+                         bool bLocal)
+{
+  const wxChar * const textEnd = text + len;
+
+  wxChar *pLine = text;
+  for ( size_t n = 0; pLine != textEnd; n++ )
   {
-    wxString strLine = buffer[n];
-    // FIXME-UTF8: rewrite using iterators, without this buffer
-    wxWxCharBuffer buf(strLine.c_str());
+    // find the end of this line: any of "\n", "\r\n" or "\r" can be used
+    wxChar *pLineEnd = pLine;
+    while ( pLineEnd != textEnd && *pLineEnd != wxT('\n') && *pLineEnd != wxT('\r') )
+      pLineEnd++;
+
+    wxChar *pNext = pLineEnd;
+    if ( pNext != textEnd )
+    {
+      if ( *pNext == wxT('\r') && pNext + 1 != textEnd && pNext[1] == wxT('\n') )
+        pNext++;
+      pNext++;
+    }
+
+    // terminate the line in place, this is fine even for the last line as
+    // the buffer is always NUL-terminated, so that we can parse it directly
+    *pLineEnd = wxT('\0');
+
+    const wxChar * const buf = pLine;
+    pLine = pNext;
+
     const wxChar *pStart;
     const wxChar *pEnd;
 
     // add the line to linked list
     if ( bLocal )
-      LineListAppend(strLine);
+      LineListAppend(wxString(buf, pLineEnd));
 
 
     // skip leading spaces
@@ -546,7 +612,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
       if ( *pEnd != wxT(']') ) {
         wxLogError(_("file '%s': unexpected character %c at line %zu."),
-                   buffer.GetName(), *pEnd, n + 1);
+                   name, *pEnd, n + 1);
         continue; // skip this line
       }
 
@@ -582,7 +648,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
           default:
             wxLogWarning(_("file '%s', line %zu: '%s' ignored after group header."),
-                         buffer.GetName(), n + 1, pEnd);
+                         name, n + 1, pEnd);
             bCont = false;
         }
       }
@@ -603,7 +669,13 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
         pEnd++;
       }
 
-      wxString strKey(FilterInEntryName(wxString(pStart, pEnd).Trim()));
+      // trim the trailing spaces before making a string from the key, as
+      // wxString::Trim() would do
+      const wxChar *pKeyEnd = pEnd;
+      while ( pKeyEnd != pStart && pKeyEnd[-1] < 127 && wxIsspace(pKeyEnd[-1]) )
+        pKeyEnd--;
+
+      wxString strKey(FilterInEntryName(wxString(pStart, pKeyEnd)));
 
       // skip whitespace
       while ( wxIsspace(*pEnd) )
@@ -611,7 +683,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
       if ( *pEnd++ != wxT('=') ) {
         wxLogError(_("file '%s', line %zu: '=' expected."),
-                   buffer.GetName(), n + 1);
+                   name, n + 1);
       }
       else {
         wxFileConfigEntry *pEntry = m_pCurrentGroup->FindEntry(strKey);
@@ -624,7 +696,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           if ( bLocal && pEntry->IsImmutable() ) {
             // immutable keys can't be changed by user
             wxLogWarning(_("file '%s', line %zu: value for immutable key '%s' ignored."),
-                         buffer.GetName(), n + 1, strKey.c_str());
+                         name, n + 1, strKey.c_str());
             continue;
           }
           // the condition below catches the cases (a) and (b) but not (c):
@@ -634,7 +706,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           // which is exactly what we want.
           else if ( !bLocal || pEntry->IsLocal() ) {
             wxLogWarning(_("file '%s', line %zu: key '%s' was first found at line %d."),
-                         buffer.GetName(), n + 1, strKey.c_str(), pEntry->Line());
+                         name, n + 1, strKey.c_str(), pEntry->Line());
 
           }
         }
@@ -907,7 +979,7 @@ bool wxFileConfig::DoWriteString(const wxString& key, const wxString& szValue)
     wxConfigPathChanger     path(this, key);
     wxString                strName = path.Name();
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("  Writing String '%s' = '%s' to Group '%s'"),
                 strName.c_str(),
                 szValue.c_str(),
@@ -921,7 +993,7 @@ bool wxFileConfig::DoWriteString(const wxString& key, const wxString& szValue)
 
             // ... except if it's empty in which case it's a way to force it's creation
 
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("  Creating group %s"),
                     m_pCurrentGroup->Name().c_str() );
 
@@ -945,18 +1017,19 @@ bool wxFileConfig::DoWriteString(const wxString& key, const wxString& szValue)
 
         if ( pEntry == 0 )
         {
-            wxLogTrace( FILECONF_TRACE_MASK,
+            wxLogTrace( gs_traceMask,
                         wxT("  Adding Entry %s"),
                         strName.c_str() );
             pEntry = m_pCurrentGroup->AddEntry(strName);
         }
 
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("  Setting value %s"),
                     szValue.c_str() );
-        pEntry->SetValue(szValue);
 
-        SetDirty();
+        // don't rewrite the file just because the same value was written
+        if ( pEntry->SetValue(szValue) )
+            SetDirty();
     }
 
     return true;
@@ -976,22 +1049,94 @@ bool wxFileConfig::DoWriteBinary(const wxString& key, const wxMemoryBuffer& buf)
 
 #endif // wxUSE_BASE64
 
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// wxFileConfigFlushThread: writes the file contents for Flush()
+// ----------------------------------------------------------------------------
+
+class wxFileConfigFlushThread : public wxThread
+{
+public:
+    // the temporary file is created in the ctor, i.e. in the calling thread,
+    // so that it uses the umask set there; the text is taken from the caller
+    wxFileConfigFlushThread(const wxString& path,
+                            wxString& text,
+                            const wxMBConv& conv)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_file(path),
+          m_conv(conv.Clone())
+    {
+        m_text.swap(text);
+    }
+
+    virtual ~wxFileConfigFlushThread()
+    {
+        delete m_conv;
+    }
+
+    bool IsOpened() const { return m_file.IsOpened(); }
+
+    // can be called directly if the thread couldn't be started
+    bool Write()
+    {
+        return WriteConfigFile(m_file, m_text, *m_conv);
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        return Write() ? (ExitCode)1 : (ExitCode)0;
+    }
+
+private:
+    wxTempFile m_file;
+    wxString m_text;
+    wxMBConv *m_conv;
+
+    wxDECLARE_NO_COPY_CLASS(wxFileConfigFlushThread);
+};
+
+void wxFileConfig::EnableBackgroundFlush(bool enable)
+{
+    if ( !enable )
+        WaitForFlush();
+
+    m_backgroundFlush = enable;
+}
+
+bool wxFileConfig::WaitForFlush()
+{
+    if ( !m_flushThread )
+        return true;
+
+    const bool ok = m_flushThread->Wait() == (wxThread::ExitCode)1;
+
+    delete m_flushThread;
+    m_flushThread = NULL;
+
+    // the changes still need to be saved
+    if ( !ok )
+        SetDirty();
+
+    return ok;
+}
+
+#endif // wxUSE_THREADS
+
 bool wxFileConfig::Flush(bool /* bCurrentOnly */)
 {
   if ( !IsDirty() || !m_fnLocalFile.GetFullPath() )
     return true;
 
+#if wxUSE_THREADS
+  // ensure that the previous flush doesn't overwrite the file after this one
+  WaitForFlush();
+#endif // wxUSE_THREADS
+
   // set the umask if needed
   wxCHANGE_UMASK(m_umask);
 
-  wxTempFile file(m_fnLocalFile.GetFullPath());
-
-  if ( !file.IsOpened() )
-  {
-    wxLogError(_("can't open user configuration file."));
-    return false;
-  }
-
   // write all strings to file
   wxString filetext;
   filetext.reserve(4096);
@@ -1000,19 +1145,52 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
     filetext << p->Text() << wxTextFile::GetEOL();
   }
 
-  if ( !file.Write(filetext, *m_conv) )
+#if wxUSE_THREADS
+  if ( m_backgroundFlush )
   {
-    wxLogError(_("can't write user configuration file."));
-    return false;
+    wxFileConfigFlushThread * const
+        thread = new wxFileConfigFlushThread(m_fnLocalFile.GetFullPath(),
+                                             filetext, *m_conv);
+    if ( !thread->IsOpened() )
+    {
+      delete thread;
+
+      wxLogError(_("can't open user configuration file."));
+      return false;
+    }
+
+    if ( thread->Run() != wxTHREAD_NO_ERROR )
+    {
+      // write the file synchronously then
+      const bool ok = thread->Write();
+      delete thread;
+
+      if ( !ok )
+        return false;
+    }
+    else
+    {
+      // the result will be checked in WaitForFlush()
+      m_flushThread = thread;
+    }
+
+    ResetDirty();
+
+    return true;
   }
+#endif // wxUSE_THREADS
 
-  if ( !file.Commit() )
-  {
-      wxLogError(_("Failed to update user configuration file."));
+  wxTempFile file(m_fnLocalFile.GetFullPath());
 
-      return false;
+  if ( !file.IsOpened() )
+  {
+    wxLogError(_("can't open user configuration file."));
+    return false;
   }
 
+  if ( !WriteConfigFile(file, filetext, *m_conv) )
+    return false;
+
   ResetDirty();
 
   return true;
@@ -1136,6 +1314,11 @@ bool wxFileConfig::DeleteGroup(const wxString& key)
 
 bool wxFileConfig::DeleteAll()
 {
+#if wxUSE_THREADS
+  // don't let the background flush recreate the file after deleting it
+  WaitForFlush();
+#endif // wxUSE_THREADS
+
   CleanUp();
 
   if ( m_fnLocalFile.IsOk() )
@@ -1162,14 +1345,14 @@ bool wxFileConfig::DeleteAll()
 
 wxFileConfigLineList *wxFileConfig::LineListAppend(const wxString& str)
 {
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("    ** Adding Line '%s'"),
                 str.c_str() );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1190,11 +1373,11 @@ wxFileConfigLineList *wxFileConfig::LineListAppend(const wxString& str)
 
     m_linesTail = pLine;
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1206,16 +1389,16 @@ wxFileConfigLineList *wxFileConfig::LineListAppend(const wxString& str)
 wxFileConfigLineList *wxFileConfig::LineListInsert(const wxString& str,
                                                    wxFileConfigLineList *pLine)
 {
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("    ** Inserting Line '%s' after '%s'"),
                 str.c_str(),
                 ((pLine) ? (const wxChar*)pLine->Text().c_str()
                          : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1241,11 +1424,11 @@ wxFileConfigLineList *wxFileConfig::LineListInsert(const wxString& str,
         pLine->SetNext(pNewLine);
     }
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1255,14 +1438,14 @@ wxFileConfigLineList *wxFileConfig::LineListInsert(const wxString& str,
 
 void wxFileConfig::LineListRemove(wxFileConfigLineList *pLine)
 {
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("    ** Removing Line '%s'"),
                 pLine->Text().c_str() );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1284,11 +1467,11 @@ void wxFileConfig::LineListRemove(wxFileConfigLineList *pLine)
     else
         pNext->SetPrev(pPrev);
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        head: %s"),
                 ((m_linesHead) ? (const wxChar*)m_linesHead->Text().c_str()
                                : wxEmptyString) );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("        tail: %s"),
                 ((m_linesTail) ? (const wxChar*)m_linesTail->Text().c_str()
                                : wxEmptyString) );
@@ -1389,13 +1572,13 @@ void wxFileConfigGroup::SetLine(wxFileConfigLineList *pLine)
 // have it or in the very beginning if we're the root group.
 wxFileConfigLineList *wxFileConfigGroup::GetGroupLine()
 {
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("  GetGroupLine() for Group '%s'"),
                 Name().c_str() );
 
     if ( !m_pLine )
     {
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("    Getting Line item pointer") );
 
         wxFileConfigGroup   *pParent = Parent();
@@ -1403,7 +1586,7 @@ wxFileConfigLineList *wxFileConfigGroup::GetGroupLine()
         // this group wasn't present in local config file, add it now
         if ( pParent )
         {
-            wxLogTrace( FILECONF_TRACE_MASK,
+            wxLogTrace( gs_traceMask,
                         wxT("    checking parent '%s'"),
                         pParent->Name().c_str() );
 
@@ -1449,7 +1632,7 @@ wxFileConfigLineList *wxFileConfigGroup::GetLastGroupLine()
 // one immediately after the group line itself.
 wxFileConfigLineList *wxFileConfigGroup::GetLastEntryLine()
 {
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("  GetLastEntryLine() for Group '%s'"),
                 Name().c_str() );
 
@@ -1649,17 +1832,17 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
 {
     wxCHECK_MSG( pGroup, false, wxT("deleting non existing group?") );
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("Deleting group '%s' from '%s'"),
                 pGroup->Name().c_str(),
                 Name().c_str() );
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("  (m_pLine) = prev: %p, this %p, next %p"),
                 m_pLine ? static_cast<void*>(m_pLine->Prev()) : 0,
                 static_cast<void*>(m_pLine),
                 m_pLine ? static_cast<void*>(m_pLine->Next()) : 0 );
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("  text: '%s'"),
                 m_pLine ? (const wxChar*)m_pLine->Text().c_str()
                         : wxEmptyString );
@@ -1667,7 +1850,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     // delete all entries...
     size_t nCount = pGroup->m_aEntries.GetCount();
 
-    wxLogTrace(FILECONF_TRACE_MASK,
+    wxLogTrace(gs_traceMask,
                wxT("Removing %lu entries"), (unsigned long)nCount );
 
     for ( size_t nEntry = 0; nEntry < nCount; nEntry++ )
@@ -1676,7 +1859,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
 
         if ( pLine )
         {
-            wxLogTrace( FILECONF_TRACE_MASK,
+            wxLogTrace( gs_traceMask,
                         wxT("    '%s'"),
                         pLine->Text().c_str() );
             m_pConfig->LineListRemove(pLine);
@@ -1686,7 +1869,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     // ...and subgroups of this subgroup
     nCount = pGroup->m_aSubgroups.GetCount();
 
-    wxLogTrace( FILECONF_TRACE_MASK,
+    wxLogTrace( gs_traceMask,
                 wxT("Removing %lu subgroups"), (unsigned long)nCount );
 
     for ( size_t nGroup = 0; nGroup < nCount; nGroup++ )
@@ -1698,11 +1881,11 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     wxFileConfigLineList *pLine = pGroup->m_pLine;
     if ( pLine )
     {
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("  Removing line for group '%s' : '%s'"),
                     pGroup->Name().c_str(),
                     pLine->Text().c_str() );
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("  Removing from group '%s' : '%s'"),
                     Name().c_str(),
                     ((m_pLine) ? (const wxChar*)m_pLine->Text().c_str()
@@ -1712,7 +1895,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
         // because the last entry's line is surely !NULL
         if ( pGroup == m_pLastGroup )
         {
-            wxLogTrace( FILECONF_TRACE_MASK,
+            wxLogTrace( gs_traceMask,
                         wxT("  Removing last group") );
 
             // our last entry is being deleted, so find the last one which
@@ -1746,7 +1929,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     }
     else
     {
-        wxLogTrace( FILECONF_TRACE_MASK,
+        wxLogTrace( gs_traceMask,
                     wxT("  No line entry for Group '%s'?"),
                     pGroup->Name().c_str() );
     }
@@ -1847,19 +2030,19 @@ void wxFileConfigEntry::SetLine(wxFileConfigLineList *pLine)
 
 // second parameter is false if we read the value from file and prevents the
 // entry from being marked as 'dirty'
-void wxFileConfigEntry::SetValue(const wxString& strValue, bool bUser)
+bool wxFileConfigEntry::SetValue(const wxString& strValue, bool bUser)
 {
     if ( bUser && IsImmutable() )
     {
         wxLogWarning( _("attempt to change immutable key '%s' ignored."),
                       Name().c_str());
-        return;
+        return false;
     }
 
     // do nothing if it's the same value: but don't test for it if m_bHasValue
     // hadn't been set yet or we'd never write empty values to the file
     if ( m_bHasValue && strValue == m_strValue )
-        return;
+        return false;
 
     m_bHasValue = true;
     m_strValue = strValue;
@@ -1896,6 +2079,8 @@ void wxFileConfigEntry::SetValue(const wxString& strValue, bool bUser)
             Group()->SetLastEntry(this);
         }
     }
+
+    return true;
 }
 
 // ============================================================================
@@ -1931,9 +2116,11 @@ int CompareGroups(wxFileConfigGroup *p1, wxFileConfigGroup *p2)
 // undo FilterOutValue
 static wxString FilterInValue(const wxString& str)
 {
+    // most values don't use any quoting at all, don't copy them char by char
+    if ( str.empty() || (str[0] != '"' && str.find('\\') == wxString::npos) )
+        return str;
+
     wxString strResult;
-    if ( str.empty() )
-        return strResult;
 
     strResult.reserve(str.length());
 
@@ -2052,6 +2239,9 @@ static wxString FilterOutValue(const wxString& str)
 // undo FilterOutEntryName
 static wxString FilterInEntryName(const wxString& str)
 {
+  if ( str.find(wxT('\\')) == wxString::npos )
+    return str;
+
   wxString strResult;
   strResult.Alloc(str.Len());
 
@@ -2098,6 +2288,39 @@ static wxString FilterOutEntryName(const wxString& str)
   return strResult;
 }
 
+static wxWxCharBuffer
+ConvertFileContents(const char *data, size_t len, const wxMBConv& conv,
+                    size_t *textLen)
+{
+#if wxUSE_UNICODE
+    return conv.cMB2WC(data, len, textLen);
+#else // !wxUSE_UNICODE
+    // no need for conversion
+    *textLen = len;
+    return wxCharBuffer(data, len);
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+}
+
+static bool WriteConfigFile(wxTempFile& file,
+                            const wxString& text,
+                            const wxMBConv& conv)
+{
+  if ( !file.Write(text, conv) )
+  {
+    wxLogError(_("can't write user configuration file."));
+    return false;
+  }
+
+  if ( !file.Commit() )
+  {
+      wxLogError(_("Failed to update user configuration file."));
+
+      return false;
+  }
+
+  return true;
+}
+
 // we can't put ?: in the ctor initializer list because it confuses some
 // broken compilers (Borland C++)
 static wxString GetAppName(const wxString& appName)
@@ -22,6 +22,7 @@
 #endif
 
 #include "wx/archive.h"
+#include "wx/zipstrm.h"
 #include "wx/private/fileback.h"
 
 //---------------------------------------------------------------------------
@@ -34,6 +35,9 @@
 // wxArchiveFSCacheData class below. It was done that way to allow sharing
 // between instances of wxFileSystem, though that's a feature not used in this
 // version.
+//
+// For zips on seekable streams entries are looked up in a wxZipIndex of the
+// central directory instead of enumerating the archive up to the entry.
 //---------------------------------------------------------------------------
 
 WX_DECLARE_STRING_HASH_MAP(wxArchiveEntry*, wxArchiveFSEntryHash);
@@ -66,6 +70,11 @@ private:
     wxArchiveFSEntry *AddToCache(wxArchiveEntry *entry);
     void CloseStreams();
 
+#if wxUSE_ZIPSTREAM
+    void InitZipIndex(const wxArchiveClassFactory& factory);
+    wxArchiveEntry *GetFromZipIndex(const wxString& name);
+#endif // wxUSE_ZIPSTREAM
+
     int m_refcount;
 
     wxArchiveFSEntryHash m_hash;
@@ -75,6 +84,14 @@ private:
     wxBackingFile m_backer;
     wxInputStream *m_stream;
     wxArchiveInputStream *m_archive;
+
+#if wxUSE_ZIPSTREAM
+    // entries found using the index, kept apart from the ones found by
+    // enumerating the archive which must stay in the archive order
+    wxArchiveFSEntryHash m_indexed;
+    wxZipIndex *m_zipIndex;
+    wxMBConv *m_zipConv;
+#endif // wxUSE_ZIPSTREAM
 };
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
@@ -87,6 +104,9 @@ wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
     m_stream(new wxBackedInputStream(backer)),
     m_archive(factory.NewStream(*m_stream))
 {
+#if wxUSE_ZIPSTREAM
+    InitZipIndex(factory);
+#endif // wxUSE_ZIPSTREAM
 }
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
@@ -98,11 +118,18 @@ wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
     m_stream(stream),
     m_archive(factory.NewStream(*m_stream))
 {
+#if wxUSE_ZIPSTREAM
+    InitZipIndex(factory);
+#endif // wxUSE_ZIPSTREAM
 }
 
 wxArchiveFSCacheDataImpl::~wxArchiveFSCacheDataImpl()
 {
     WX_CLEAR_HASH_MAP(wxArchiveFSEntryHash, m_hash);
+#if wxUSE_ZIPSTREAM
+    WX_CLEAR_HASH_MAP(wxArchiveFSEntryHash, m_indexed);
+    delete m_zipIndex;
+#endif // wxUSE_ZIPSTREAM
 
     wxArchiveFSEntry *entry = m_begin;
 
@@ -133,6 +160,56 @@ void wxArchiveFSCacheDataImpl::CloseStreams()
     wxDELETE(m_stream);
 }
 
+#if wxUSE_ZIPSTREAM
+
+void wxArchiveFSCacheDataImpl::InitZipIndex(
+        const wxArchiveClassFactory& factory)
+{
+    m_zipIndex = NULL;
+    m_zipConv = NULL;
+
+    // the index is only loaded when the first entry is looked up
+    if (m_stream && m_stream->IsSeekable() &&
+            wxDynamicCast(&factory, wxZipClassFactory))
+        m_zipConv = &factory.GetConv();
+}
+
+wxArchiveEntry *wxArchiveFSCacheDataImpl::GetFromZipIndex(
+        const wxString& name)
+{
+    wxArchiveFSEntryHash::iterator it = m_indexed.find(name);
+
+    if (it != m_indexed.end())
+        return it->second;
+
+    if (!m_zipIndex)
+    {
+        m_zipIndex = new wxZipIndex;
+        if (!m_zipIndex->Load(*m_stream, *m_zipConv))
+        {
+            // fall back to enumerating the archive
+            wxDELETE(m_zipIndex);
+            m_zipConv = NULL;
+            return NULL;
+        }
+    }
+
+    int n = m_zipIndex->Find(name, wxPATH_UNIX);
+    if (n == wxNOT_FOUND)
+        return NULL;
+
+    wxArchiveEntry *entry = m_zipIndex->GetEntry(n);
+    if (entry && entry->GetName(wxPATH_UNIX) != name)
+        wxDELETE(entry);
+
+    if (entry)
+        m_indexed[name] = entry;
+
+    return entry;
+}
+
+#endif // wxUSE_ZIPSTREAM
+
 wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name)
 {
     wxArchiveFSEntryHash::iterator it = m_hash.find(name);
@@ -143,6 +220,15 @@ wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name)
     if (!m_archive)
         return NULL;
 
+#if wxUSE_ZIPSTREAM
+    if (m_zipConv)
+    {
+        wxArchiveEntry *entry = GetFromZipIndex(name);
+        if (entry || m_zipIndex)
+            return entry;
+    }
+#endif // wxUSE_ZIPSTREAM
+
     wxArchiveEntry *entry;
 
     while ((entry = m_archive->GetNextEntry()) != NULL)
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "wx/gifdecod.h"
+#include "wx/mstream.h"
 #include "wx/scopedarray.h"
 #include "wx/scopedptr.h"
 #include "wx/scopeguard.h"
@@ -42,6 +43,9 @@ enum
 
 #define GetFrame(n)     ((GIFImage*)m_frames[n])
 
+// the maximal number of frames decoded on demand kept in memory
+static const size_t MAX_DECODED_FRAMES = 4;
+
 //---------------------------------------------------------------------------
 // GIFImage
 //---------------------------------------------------------------------------
@@ -65,6 +69,13 @@ public:
     unsigned int ncolours;          // number of colours
     wxString comment;
 
+    // compressed data, only used when decoding on demand, and the
+    // parameters needed for decoding it
+    unsigned char *data;
+    size_t datalen;
+    int interl;
+    int bits;
+
     wxDECLARE_NO_COPY_CLASS(GIFImage);
 };
 
@@ -87,6 +98,10 @@ GIFImage::GIFImage()
     p = (unsigned char *) NULL;
     pal = (unsigned char *) NULL;
     ncolours = 0;
+    data = (unsigned char *) NULL;
+    datalen = 0;
+    interl = 0;
+    bits = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -95,6 +110,7 @@ GIFImage::GIFImage()
 
 wxGIFDecoder::wxGIFDecoder()
 {
+    m_decodeOnDemand = false;
 }
 
 wxGIFDecoder::~wxGIFDecoder()
@@ -110,11 +126,62 @@ void wxGIFDecoder::Destroy()
         GIFImage *f = (GIFImage*)m_frames[i];
         free(f->p);
         free(f->pal);
+        free(f->data);
         delete f;
     }
 
     m_frames.Clear();
     m_nFrames = 0;
+
+    m_decodedFrames.clear();
+}
+
+//---------------------------------------------------------------------------
+// Decoding frames on demand
+//---------------------------------------------------------------------------
+
+unsigned char *wxGIFDecoder::DecodeFrame(unsigned int frame)
+{
+    GIFImage * const img = GetFrame(frame);
+
+    // move the frame to the end of the list of the recently used ones
+    for ( size_t n = 0; n < m_decodedFrames.size(); n++ )
+    {
+        if ( m_decodedFrames[n] == frame )
+        {
+            m_decodedFrames.erase(m_decodedFrames.begin() + n);
+            m_decodedFrames.push_back(frame);
+
+            return img->p;
+        }
+    }
+
+    // free the least recently used frame if there are too many of them
+    if ( m_decodedFrames.size() == MAX_DECODED_FRAMES )
+    {
+        GIFImage * const old = GetFrame(m_decodedFrames[0]);
+        free(old->p);
+        old->p = NULL;
+
+        m_decodedFrames.erase(m_decodedFrames.begin());
+    }
+
+    img->p = (unsigned char *) malloc(img->w * img->h);
+    if ( !img->p )
+        return NULL;
+
+    wxMemoryInputStream stream(img->data, img->datalen);
+    if ( dgif(stream, img, img->interl, img->bits) != wxGIF_OK )
+    {
+        free(img->p);
+        img->p = NULL;
+
+        return NULL;
+    }
+
+    m_decodedFrames.push_back(frame);
+
+    return img->p;
 }
 
 
@@ -145,6 +212,12 @@ bool wxGIFDecoder::ConvertToImage(unsigned int frame, wxImage *image) const
 
     pal = GetPalette(frame);
     src = GetData(frame);
+    if ( !src )
+    {
+        image->Destroy();
+        return false;
+    }
+
     dst = image->GetData();
     transparent = GetTransparentColourIndex(frame);
 
@@ -276,7 +349,17 @@ wxColour wxGIFDecoder::GetTransparentColour(unsigned int frame) const
                     pal[n*3 + 2]);
 }
 
-unsigned char* wxGIFDecoder::GetData(unsigned int frame) const    { return (GetFrame(frame)->p); }
+unsigned char* wxGIFDecoder::GetData(unsigned int frame) const
+{
+    if ( m_decodeOnDemand )
+    {
+        // decoding the frame doesn't change the logical state of the object
+        return const_cast<wxGIFDecoder *>(this)->DecodeFrame(frame);
+    }
+
+    return (GetFrame(frame)->p);
+}
+
 unsigned char* wxGIFDecoder::GetPalette(unsigned int frame) const { return (GetFrame(frame)->pal); }
 unsigned int wxGIFDecoder::GetNcolours(unsigned int frame) const  { return (GetFrame(frame)->ncolours); }
 int wxGIFDecoder::GetTransparentColourIndex(unsigned int frame) const  { return (GetFrame(frame)->transparent); }
@@ -611,6 +694,32 @@ bool wxGIFDecoder::DoCanRead(wxInputStream &stream) const
 }
 
 
+// ReadSubBlocks:
+//  Reads the data sub-blocks of an image, including their sizes and the
+//  terminating empty block, into the given buffer as is. Stops at the end
+//  of the stream if the data is truncated.
+//
+static void ReadSubBlocks(wxInputStream& stream, wxMemoryBuffer& buf)
+{
+    for ( ;; )
+    {
+        const int len = stream.GetC();
+        if ( len == wxEOF )
+            break;
+
+        buf.AppendByte((char)len);
+        if ( !len )
+            break;
+
+        void * const data = buf.GetAppendBuf(len);
+        stream.Read(data, len);
+        buf.UngetAppendBuf(stream.LastRead());
+        if ( stream.LastRead() != (size_t)len )
+            break;
+    }
+}
+
+
 // LoadGIF:
 //  Reads and decodes one or more GIF images, depending on whether
 //  animated GIF support is enabled. Can read GIFs with any bit
@@ -631,6 +740,7 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
     unsigned char pal[768];
     unsigned char buf[16];
     bool anim = true;
+    wxMemoryBuffer data;
 
     // check GIF signature
     if (!CanRead(stream))
@@ -841,11 +951,17 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 pimg->disposal = disposal;
                 pimg->delay = delay;
 
-                // allocate memory for image and palette
-                pimg->p   = (unsigned char *) malloc((unsigned int)size);
-                pimg->pal = (unsigned char *) malloc(768);
+                // allocate memory for image, unless it's decoded later, and
+                // palette
+                if ( !m_decodeOnDemand )
+                {
+                    pimg->p = (unsigned char *) malloc((unsigned int)size);
+                    if ( !pimg->p )
+                        return wxGIF_MEMERR;
+                }
 
-                if ((!pimg->p) || (!pimg->pal))
+                pimg->pal = (unsigned char *) malloc(768);
+                if ( !pimg->pal )
                     return wxGIF_MEMERR;
 
                 // load local color map if available, else use global map
@@ -869,10 +985,28 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 if (bits == 0)
                     return wxGIF_INVFORMAT;
 
-                // decode image
-                wxGIFErrorCode result = dgif(stream, pimg.get(), interl, bits);
-                if (result != wxGIF_OK)
-                    return result;
+                if ( m_decodeOnDemand )
+                {
+                    // just keep the compressed data to decode it later
+                    data.SetDataLen(0);
+                    ReadSubBlocks(stream, data);
+
+                    pimg->datalen = data.GetDataLen();
+                    pimg->data = (unsigned char *) malloc(pimg->datalen);
+                    if ( !pimg->data )
+                        return wxGIF_MEMERR;
+
+                    memcpy(pimg->data, data.GetData(), pimg->datalen);
+                    pimg->interl = interl;
+                    pimg->bits = bits;
+                }
+                else
+                {
+                    // decode image
+                    wxGIFErrorCode result = dgif(stream, pimg.get(), interl, bits);
+                    if (result != wxGIF_OK)
+                        return result;
+                }
 
                 guardDestroy.Dismiss();
 
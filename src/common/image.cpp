@@ -28,8 +28,15 @@
     #include "wx/colour.h"
 #endif
 
+#include "wx/imagbatch.h"
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
+#include "wx/private/image.h"
+
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+    #include "wx/msgqueue.h"
+#endif
 
 // For memcpy
 #include <string.h>
@@ -91,6 +98,9 @@ public:
     int             m_loadFlags;
     static int      sm_defaultLoadFlags;
 
+    // global number of threads used by the image processing functions
+    static int      sm_processingThreads;
+
 #if wxUSE_PALETTE
     wxPalette       m_palette;
 #endif // wxUSE_PALETTE
@@ -104,6 +114,9 @@ public:
 // For compatibility, if nothing else, loading is verbose by default.
 int wxImageRefData::sm_defaultLoadFlags = wxImage::Load_Verbose;
 
+// Image processing doesn't use any additional threads by default.
+int wxImageRefData::sm_processingThreads = 1;
+
 wxImageRefData::wxImageRefData()
 {
     m_width = 0;
@@ -430,6 +443,18 @@ wxImage wxImage::ShrinkBy( int xFactor , int yFactor ) const
     return image;
 }
 
+/* static */
+void wxImage::SetProcessingThreads(int threads)
+{
+    wxImageRefData::sm_processingThreads = threads;
+}
+
+/* static */
+int wxImage::GetProcessingThreads()
+{
+    return wxImageRefData::sm_processingThreads;
+}
+
 wxImage
 wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
 {
@@ -566,303 +591,833 @@ wxImage wxImage::ResampleNearest(int width, int height) const
 namespace
 {
 
-struct BoxPrecalc
+// ----------------------------------------------------------------------------
+// Processing image parts in parallel
+// ----------------------------------------------------------------------------
+
+// Don't use threads for images with fewer pixels per thread than this, the
+// overhead of creating them is not worth it.
+const size_t MIN_PIXELS_PER_THREAD = 128*1024;
+
+// Base class for the operations which can process different bands of the
+// image independently and hence in parallel. The bands consist of rows or of
+// columns, depending on the operation.
+class BandsProcessor
 {
-    int boxStart;
-    int boxEnd;
+public:
+    virtual ~BandsProcessor() { }
+
+    // Process the rows or columns in [start, end) range.
+    virtual void ProcessBand(int start, int end) = 0;
+
+    // Process all the rows or columns, using up to the number of threads
+    // returned by wxImage::GetProcessingThreads() if the number of pixels
+    // processed is big enough.
+    void ProcessAll(int count, size_t pixels);
 };
 
-void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
+#if wxUSE_THREADS
+
+class BandThread : public wxThread
 {
-    const int newDim = boxes.size();
-    wxASSERT( oldDim > 0 && newDim > 0 );
+public:
+    BandThread(BandsProcessor& processor, int start, int end)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_processor(processor),
+          m_start(start),
+          m_end(end)
+    {
+    }
 
-    // We need to map pixel values in the range [-0.5 .. (newDim-1)+0.5]
-    // to the pixel values in the range [-0.5 .. (oldDim-1)+0.5].
-    // Transformation function is therefore:
-    //   pOld = sc * (pNew + 0.5) - 0.5, where sc = oldDim/newDim
-    //
-    // A new pixel pNew in the interval [pNew-0.5 .. pNew+0.5]
-    // is mapped to the old pixel in the interval [pOldLoBound..pOldUpBound],
-    // where:
-    //   pOldLoBound = sc * ((pNew-0.5) + 0.5) - 0.5 = sc * pNew - 0.5
-    //   pOldUpBound = sc * ((pNew+0.5) + 0.5) - 0.5 = sc * (pNew+1) - 0.5
-    // So, the lower bound of the pixel box (interval) is:
-    //   boxStart = round(pOldLoBound) = trunc((sc * pNew - 0.5) + 0.5) = trunc(sc * pNew)
-    // and the upper bound is:
-    // - if fraction(pOldUpBound) != 0.5 (bound inside the pixel):
-    //   boxEnd = round(pixOldUpBound) = trunc((sc * (pNew+1) - 0.5) + 0.5) = trunc(sc * (pNew+1))
-    //    e.g. for UpBound = 7.2 -> boxEnd = 7
-    //         for UpBound = 7.6 -> boxEnd = 8
-    // - if fraction(pOldUpBound) == 0.5 (bound at the edge of the pixel):
-    //   boxEnd = round(pOldUpBound)-1 = trunc((sc * (pNew+1) - 0.5) + 0.5) - 1 = trunc(sc * (pNew+1))-1
-    //    e.g. for UpBound = 7.5 -> boxEnd = 7 (not 8)
-    //
-    // In integer arithmetic:
-    //  boxStart = (oldDim * pNew) / newDim
-    //  boxEnd:
-    //   vEnd =  oldDim * (pNew+1) = oldDim * pNew + oldDim
-    //  if vEnd % newDim != 0 (frac(pOldUpBound) != 0.5) => boxEnd = vEnd / newDim
-    //  if vEnd % newDim == 0 (frac(pOldUpBound) == 0.5) => boxEnd = (vEnd / newDim) - 1
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_processor.ProcessBand(m_start, m_end);
+        return 0;
+    }
 
-    int v = 0; // oldDim * 0
-    for ( int dst = 0; dst < newDim; dst++ )
+private:
+    BandsProcessor& m_processor;
+    const int m_start;
+    const int m_end;
+};
+
+#endif // wxUSE_THREADS
+
+void BandsProcessor::ProcessAll(int count, size_t pixels)
+{
+#if wxUSE_THREADS
+    int threads = wxImage::GetProcessingThreads();
+    if ( threads <= 0 )
+        threads = wxThread::GetCPUCount();
+
+    if ( static_cast<size_t>(threads) > pixels / MIN_PIXELS_PER_THREAD )
+        threads = static_cast<int>(pixels / MIN_PIXELS_PER_THREAD);
+    if ( threads > count )
+        threads = count;
+
+    if ( threads > 1 )
     {
-        BoxPrecalc& precalc = boxes[dst];
-        precalc.boxStart = v/newDim;
-        v += oldDim;
-        precalc.boxEnd = v%newDim != 0 ? v/newDim : (v/newDim)-1;
+        // the first band is processed by this thread itself
+        wxVector<wxThread*> bandThreads;
+        for ( int n = 1; n < threads; n++ )
+        {
+            const int start = (count*n) / threads;
+            const int end = (count*(n + 1)) / threads;
+
+            wxThread *thread = new BandThread(*this, start, end);
+            if ( thread->Run() != wxTHREAD_NO_ERROR )
+            {
+                delete thread;
+                ProcessBand(start, end);
+                continue;
+            }
+
+            bandThreads.push_back(thread);
+        }
+
+        ProcessBand(0, count / threads);
+
+        for ( size_t n = 0; n < bandThreads.size(); n++ )
+        {
+            bandThreads[n]->Wait();
+            delete bandThreads[n];
+        }
+
+        return;
     }
+#else // !wxUSE_THREADS
+    wxUnusedVar(pixels);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    ProcessBand(0, count);
 }
 
-} // anonymous namespace
+// ----------------------------------------------------------------------------
+// Separable resampling
+// ----------------------------------------------------------------------------
 
-wxImage wxImage::ResampleBox(int width, int height) const
+// All the resampling algorithms below except the nearest neighbour one compute
+// each destination pixel as a weighted sum of the source pixels, with the
+// weight being the product of the weights in the horizontal and vertical
+// directions. This allows to resample the image in two passes, one for each
+// direction, instead of computing the full sum for each pixel. Both passes
+// use integer arithmetic in simple loops which the compiler can vectorize.
+
+// Number of fractional bits in the fixed point weights, which add up to 1.
+const int RESAMPLE_WEIGHT_BITS = 14;
+
+// Number of fractional bits kept in the results of the first pass.
+const int RESAMPLE_EXTRA_BITS = 8;
+
+// Weights of the source pixels for all destination pixels in one direction.
+class ResampleWeights
 {
-    // This function implements a simple pre-blur/box averaging method for
-    // downsampling that gives reasonably smooth results To scale the image
-    // down we will need to gather a grid of pixels of the size of the scale
-    // factor in each direction and then do an averaging of the pixels.
+public:
+    ResampleWeights() : m_maxTaps(0) { }
 
-    wxImage ret_image(width, height, false);
+    // Add the next destination pixel computed from the given number of
+    // source pixels starting from the given one with the given weights.
+    void Add(int start, const double *weights, int taps);
+
+    // Add the next destination pixel computed as the average of the source
+    // pixels.
+    void AddUniform(int start, int taps);
+
+    // Add the next destination pixel computed from the source pixels with
+    // the given offsets, which must be non-decreasing and can only be
+    // repeated at the image edges, and the given weights.
+    void AddClamped(const int *offsets, const double *weights, int count);
+
+    // The source pixels used for a single destination pixel.
+    struct Entry
+    {
+        int start;      // the first source pixel
+        int taps;       // the number of source pixels
+        int index;      // the index of the first weight in GetWeights()
+    };
+
+    // Return the entries for all destination pixels and all their weights,
+    // as raw pointers to avoid the overhead of checked indexing in the loops.
+    const Entry *GetEntries() const { return &m_entries[0]; }
+    const int *GetWeights() const { return &m_weights[0]; }
 
-    wxVector<BoxPrecalc> vPrecalcs(height);
-    wxVector<BoxPrecalc> hPrecalcs(width);
+    int GetMaxTaps() const { return m_maxTaps; }
 
-    ResampleBoxPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
+private:
+    // Add a new entry and return the index of its weights.
+    int DoAdd(int start, int taps);
+
+    wxVector<Entry> m_entries;
+    wxVector<int> m_weights;
+    int m_maxTaps;
+};
+
+int ResampleWeights::DoAdd(int start, int taps)
+{
+    Entry entry;
+    entry.start = start;
+    entry.taps = taps;
+    entry.index = static_cast<int>(m_weights.size());
+    m_entries.push_back(entry);
+
+    if ( taps > m_maxTaps )
+        m_maxTaps = taps;
+
+    m_weights.resize(entry.index + taps);
+    return entry.index;
+}
 
+void ResampleWeights::Add(int start, const double *weights, int taps)
+{
+    const int index = DoAdd(start, taps);
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+    double total = 0;
+    for ( int n = 0; n < taps; n++ )
+        total += weights[n];
 
-    if ( src_alpha )
+    // Round the cumulative sums rather than the individual weights to make
+    // sure that the weights add up to exactly 1 and each of them is off by
+    // less than 1 from its real value.
+    double sum = 0;
+    int last = 0;
+    for ( int n = 0; n < taps; n++ )
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        sum += weights[n];
+
+        const int next = total > 0
+                            ? static_cast<int>(sum / total *
+                                    (1 << RESAMPLE_WEIGHT_BITS) + 0.5)
+                            : ((n + 1) << RESAMPLE_WEIGHT_BITS) / taps;
+        m_weights[index + n] = next - last;
+        last = next;
     }
+}
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+void ResampleWeights::AddUniform(int start, int taps)
+{
+    const int index = DoAdd(start, taps);
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    int last = 0;
+    for ( int n = 0; n < taps; n++ )
     {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        const int next = ((n + 1) << RESAMPLE_WEIGHT_BITS) / taps;
+        m_weights[index + n] = next - last;
+        last = next;
+    }
+}
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+void ResampleWeights::AddClamped(const int *offsets,
+                                 const double *weights,
+                                 int count)
+{
+    double merged[4] = { 0 };
+    wxASSERT( count <= static_cast<int>(WXSIZEOF(merged)) );
+
+    const int start = offsets[0];
+    for ( int n = 0; n < count; n++ )
+        merged[offsets[n] - start] += weights[n];
+
+    Add(start, merged, offsets[count - 1] - start + 1);
+}
+
+// Number of destination pixels processed at once by the second pass, small
+// enough for their sums to remain in the cache.
+const int RESAMPLE_BLOCK_SIZE = 256;
+
+// Compute the sums of the elements of the given rows, starting from the given
+// offset, multiplied by the weights. The rows are processed in pairs to halve
+// the number of passes over the sums.
+template <typename T, typename U>
+void SumWeightedRows(T *sums,
+                     const U * const *rows,
+                     const int *weights,
+                     int taps,
+                     int offset,
+                     int size)
+{
+    int k;
+    if ( taps % 2 )
+    {
+        const U * const row = rows[0] + offset;
+        const T w = weights[0];
+        for ( int i = 0; i < size; i++ )
+            sums[i] = w * row[i];
+
+        k = 1;
+    }
+    else
+    {
+        const U * const row0 = rows[0] + offset;
+        const U * const row1 = rows[1] + offset;
+        const T w0 = weights[0];
+        const T w1 = weights[1];
+        for ( int i = 0; i < size; i++ )
+            sums[i] = w0 * row0[i] + w1 * row1[i];
 
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+        k = 2;
+    }
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+    for ( ; k < taps; k += 2 )
+    {
+        const U * const row0 = rows[k] + offset;
+        const U * const row1 = rows[k + 1] + offset;
+        const T w0 = weights[k];
+        const T w1 = weights[k + 1];
+        for ( int i = 0; i < size; i++ )
+            sums[i] += w0 * row0[i] + w1 * row1[i];
+    }
+}
+
+// Resamples the image data using the given weights.
+//
+// The first pass resamples the source data in one direction and keeps
+// RESAMPLE_EXTRA_BITS of the fractional part of the results, the second pass
+// resamples them in the other direction and stores the destination pixels.
+// The image is resampled vertically first if its height decreases, as this
+// reduces the number of rows to resample horizontally, which is the slower
+// operation, and horizontally first otherwise.
+//
+// If the image has alpha, the colours may be premultiplied by it before
+// resampling, so that the fully transparent pixels don't affect the result.
+class ImageResampler : public BandsProcessor
+{
+public:
+    ImageResampler(const wxImage& src,
+                   wxImage& dst,
+                   const ResampleWeights& hWeights,
+                   const ResampleWeights& vWeights,
+                   bool premultiply)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_dstWidth(dst.GetWidth()),
+          m_hWeights(hWeights),
+          m_vWeights(vWeights),
+          m_premultiply(premultiply && m_srcAlpha),
+          m_verticalFirst(dst.GetHeight() < src.GetHeight()),
+          m_channels(m_srcAlpha ? 4 : 3)
+    {
+    }
+
+    virtual void ProcessBand(int rowStart, int rowEnd) wxOVERRIDE;
+
+private:
+    void ProcessRowsHorizontalFirst(int rowStart, int rowEnd);
+    void ProcessRowsVerticalFirst(int rowStart, int rowEnd);
+
+    // The first pass: resample the given source row horizontally or the
+    // source rows used by the given destination row vertically.
+    void ResampleRowHorizontally(int srcRow, wxInt32 *out) const;
+    void ResampleRowsVertically(int dstRow,
+                                const unsigned char **rows,
+                                wxInt32 *out) const;
+
+    // The second pass: compute the sums for the given destination pixels
+    // from the results of the first pass.
+    template <int Channels, typename T>
+    void SumColumns(T *sums, const wxInt32 *row, int x, int count) const;
+
+    // Store the sums computed by the second pass in the destination row.
+    void StorePixels(const wxInt32 *sums, int row, int x, int count) const;
+    void StorePremultipliedPixels(const wxInt64 *sums,
+                                  int row, int x, int count) const;
+
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    const int m_srcWidth;
+
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_dstWidth;
+
+    const ResampleWeights& m_hWeights;
+    const ResampleWeights& m_vWeights;
+
+    const bool m_premultiply;
+    const bool m_verticalFirst;
+    const int m_channels;
+
+    wxDECLARE_NO_COPY_CLASS(ImageResampler);
+};
+
+void ImageResampler::ResampleRowHorizontally(int srcRow, wxInt32 *out) const
+{
+    // When premultiplying, the colours are multiplied by alpha too.
+    const int shift = RESAMPLE_WEIGHT_BITS - RESAMPLE_EXTRA_BITS;
+    const int half = 1 << (shift - 1);
+
+    const unsigned char * const src = m_srcData + srcRow*m_srcWidth*3;
+
+    const ResampleWeights::Entry *entry = m_hWeights.GetEntries();
+    const int * const allWeights = m_hWeights.GetWeights();
+
+    if ( !m_srcAlpha )
+    {
+        for ( int x = 0; x < m_dstWidth; x++, entry++ )
+        {
+            const int * const weights = allWeights + entry->index;
+            const int taps = entry->taps;
+            const unsigned char *p = src + entry->start*3;
+
+            int r = 0, g = 0, b = 0;
+            for ( int k = 0; k < taps; k++, p += 3 )
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                r += weights[k] * p[0];
+                g += weights[k] * p[1];
+                b += weights[k] * p[2];
+            }
 
-                    if (src_alpha)
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
-                    }
+            out[0] = (r + half) >> shift;
+            out[1] = (g + half) >> shift;
+            out[2] = (b + half) >> shift;
+            out += 3;
+        }
 
-                    averaged_pixels++;
-                }
+        return;
+    }
+
+    const unsigned char * const srcAlpha = m_srcAlpha + srcRow*m_srcWidth;
+
+    for ( int x = 0; x < m_dstWidth; x++, entry++ )
+    {
+        const int * const weights = allWeights + entry->index;
+        const int taps = entry->taps;
+        const unsigned char *p = src + entry->start*3;
+        const unsigned char * const pa = srcAlpha + entry->start;
+
+        int r = 0, g = 0, b = 0, a = 0;
+        if ( m_premultiply )
+        {
+            for ( int k = 0; k < taps; k++, p += 3 )
+            {
+                const int wa = weights[k] * pa[k];
+                r += wa * p[0];
+                g += wa * p[1];
+                b += wa * p[2];
+                a += wa;
+            }
+        }
+        else
+        {
+            for ( int k = 0; k < taps; k++, p += 3 )
+            {
+                r += weights[k] * p[0];
+                g += weights[k] * p[1];
+                b += weights[k] * p[2];
+                a += weights[k] * pa[k];
             }
+        }
+
+        out[0] = (r + half) >> shift;
+        out[1] = (g + half) >> shift;
+        out[2] = (b + half) >> shift;
+        out[3] = (a + half) >> shift;
+        out += 4;
+    }
+}
+
+void ImageResampler::ResampleRowsVertically(int dstRow,
+                                            const unsigned char **rows,
+                                            wxInt32 *out) const
+{
+    const int shift = RESAMPLE_WEIGHT_BITS - RESAMPLE_EXTRA_BITS;
+    const int half = 1 << (shift - 1);
+
+    const ResampleWeights::Entry& entry = m_vWeights.GetEntries()[dstRow];
+    const int * const weights = m_vWeights.GetWeights() + entry.index;
+
+    const int size = m_srcWidth*m_channels;
+
+    if ( !m_srcAlpha )
+    {
+        // This is the simplest and most common case, in which the rows can be
+        // just summed, which is done in blocks to keep the sums in the cache.
+        for ( int k = 0; k < entry.taps; k++ )
+            rows[k] = m_srcData + (entry.start + k)*size;
+
+        for ( int start = 0; start < size; start += RESAMPLE_BLOCK_SIZE*4 )
+        {
+            const int count = size - start < RESAMPLE_BLOCK_SIZE*4
+                                ? size - start
+                                : RESAMPLE_BLOCK_SIZE*4;
 
-            // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
+            SumWeightedRows(out + start, rows, weights, entry.taps,
+                            start, count);
+        }
+    }
+    else
+    {
+        for ( int i = 0; i < size; i++ )
+            out[i] = 0;
+
+        for ( int k = 0; k < entry.taps; k++ )
+        {
+            const int srcRow = entry.start + k;
+            const unsigned char *p = m_srcData + srcRow*m_srcWidth*3;
+            const unsigned char * const pa = m_srcAlpha + srcRow*m_srcWidth;
+            const int w = weights[k];
+
+            wxInt32 *o = out;
+            if ( m_premultiply )
             {
-                if (sum_a)
+                for ( int x = 0; x < m_srcWidth; x++, p += 3, o += 4 )
                 {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
+                    const int wa = w * pa[x];
+                    o[0] += wa * p[0];
+                    o[1] += wa * p[1];
+                    o[2] += wa * p[2];
+                    o[3] += wa;
                 }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
             }
             else
             {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
+                for ( int x = 0; x < m_srcWidth; x++, p += 3, o += 4 )
+                {
+                    o[0] += w * p[0];
+                    o[1] += w * p[1];
+                    o[2] += w * p[2];
+                    o[3] += w * pa[x];
+                }
             }
-            dst_data += 3;
         }
     }
 
-    return ret_image;
+    for ( int i = 0; i < size; i++ )
+        out[i] = (out[i] + half) >> shift;
 }
 
-namespace
+// The number of channels is a template parameter to allow the compiler to
+// unroll the innermost loops.
+template <int Channels, typename T>
+void ImageResampler::SumColumns(T *sums,
+                                const wxInt32 *row,
+                                int x,
+                                int count) const
 {
+    const ResampleWeights::Entry *entry = m_hWeights.GetEntries() + x;
+    const int * const allWeights = m_hWeights.GetWeights();
 
-struct BilinearPrecalc
+    for ( int i = 0; i < count; i++, entry++, sums += Channels )
+    {
+        const int * const weights = allWeights + entry->index;
+        const wxInt32 *p = row + entry->start*Channels;
+
+        T pixel[Channels] = { 0 };
+        for ( int k = 0; k < entry->taps; k++, p += Channels )
+        {
+            const T w = weights[k];
+            for ( int c = 0; c < Channels; c++ )
+                pixel[c] += w * p[c];
+        }
+
+        for ( int c = 0; c < Channels; c++ )
+            sums[c] = pixel[c];
+    }
+}
+
+void ImageResampler::StorePixels(const wxInt32 *sums,
+                                 int row, int x, int count) const
 {
-    int offset1;
-    int offset2;
-    double dd;
-    double dd1;
-};
+    const int shift = RESAMPLE_WEIGHT_BITS + RESAMPLE_EXTRA_BITS;
+    const int half = 1 << (shift - 1);
+
+    const int pos = row*m_dstWidth + x;
+    unsigned char *dst = m_dstData + pos*3;
+
+    if ( !m_srcAlpha )
+    {
+        for ( int i = 0; i < count*3; i++ )
+            dst[i] = static_cast<unsigned char>((sums[i] + half) >> shift);
 
-inline void DoCalc(BilinearPrecalc& precalc, double srcpix, int srcpixmax)
+        return;
+    }
+
+    unsigned char * const dstAlpha = m_dstAlpha + pos;
+    for ( int i = 0; i < count; i++, sums += 4, dst += 3 )
+    {
+        dst[0] = static_cast<unsigned char>((sums[0] + half) >> shift);
+        dst[1] = static_cast<unsigned char>((sums[1] + half) >> shift);
+        dst[2] = static_cast<unsigned char>((sums[2] + half) >> shift);
+        dstAlpha[i] = static_cast<unsigned char>((sums[3] + half) >> shift);
+    }
+}
+
+void ImageResampler::StorePremultipliedPixels(const wxInt64 *sums,
+                                              int row, int x, int count) const
 {
-    int srcpix1 = int(srcpix);
-    int srcpix2 = srcpix1 == srcpixmax ? srcpix1 : srcpix1 + 1;
+    const int shift = RESAMPLE_WEIGHT_BITS + RESAMPLE_EXTRA_BITS;
+    const wxInt64 half = 1 << (shift - 1);
+
+    const int pos = row*m_dstWidth + x;
+    unsigned char *dst = m_dstData + pos*3;
+    unsigned char * const dstAlpha = m_dstAlpha + pos;
+
+    for ( int i = 0; i < count; i++, sums += 4, dst += 3 )
+    {
+        // Both the colours and alpha are scaled by the same factor here, so
+        // dividing them gives the colour value.
+        const wxInt64 a = sums[3];
+        if ( a > 0 )
+        {
+            const double scale = 1.0 / a;
+            for ( int c = 0; c < 3; c++ )
+            {
+                const int value = static_cast<int>(sums[c]*scale + 0.5);
+                dst[c] = static_cast<unsigned char>(value < 255 ? value : 255);
+            }
+        }
+        else
+        {
+            dst[0] =
+            dst[1] =
+            dst[2] = 0;
+        }
 
-    precalc.dd = srcpix - (int)srcpix;
-    precalc.dd1 = 1.0 - precalc.dd;
-    precalc.offset1 = srcpix1 < 0.0
-                        ? 0
-                        : srcpix1 > srcpixmax
-                            ? srcpixmax
-                            : (int)srcpix1;
-    precalc.offset2 = srcpix2 < 0.0
-                        ? 0
-                        : srcpix2 > srcpixmax
-                            ? srcpixmax
-                            : (int)srcpix2;
+        dstAlpha[i] = static_cast<unsigned char>((a + half) >> shift);
+    }
 }
 
-void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
+void ImageResampler::ProcessBand(int rowStart, int rowEnd)
 {
-    const int newDim = precalcs.size();
-    wxASSERT( oldDim > 0 && newDim > 0 );
-    const int srcpixmax = oldDim - 1;
-    if ( newDim > 1 )
+    if ( m_verticalFirst )
+        ProcessRowsVerticalFirst(rowStart, rowEnd);
+    else
+        ProcessRowsHorizontalFirst(rowStart, rowEnd);
+}
+
+void ImageResampler::ProcessRowsHorizontalFirst(int rowStart, int rowEnd)
+{
+    // The results of the horizontal pass for the source rows used by the
+    // current destination row are cached, and as the rows used by the
+    // successive destination rows overlap, each source row is usually only
+    // resampled horizontally once.
+    const int rowSize = m_dstWidth*m_channels;
+    const int cacheSize = m_vWeights.GetMaxTaps();
+
+    wxVector<wxInt32> cache(cacheSize*rowSize);
+    wxVector<int> cachedRows(cacheSize, -1);
+    wxVector<const wxInt32*> rows(cacheSize);
+
+    // Premultiplied colours need more bits than fit into 32 bit integers.
+    wxInt32 sums[RESAMPLE_BLOCK_SIZE*4];
+    wxInt64 sums64[RESAMPLE_BLOCK_SIZE*4];
+
+    const ResampleWeights::Entry * const entries = m_vWeights.GetEntries();
+    const int * const allWeights = m_vWeights.GetWeights();
+
+    for ( int y = rowStart; y < rowEnd; y++ )
     {
-        // We want to map pixels in the range [0..newDim-1]
-        // to the range [0..oldDim-1]
-        const double scale_factor = double(oldDim-1) / (newDim-1);
+        const ResampleWeights::Entry& entry = entries[y];
+        const int taps = entry.taps;
 
-        for ( int dsty = 0; dsty < newDim; dsty++ )
+        for ( int k = 0; k < taps; k++ )
         {
-            // We need to calculate the source pixel to interpolate from - Y-axis
-            double srcpix = (double)dsty * scale_factor;
+            const int srcRow = entry.start + k;
+            const int slot = srcRow % cacheSize;
+            wxInt32 * const cached = &cache[slot*rowSize];
+            if ( cachedRows[slot] != srcRow )
+            {
+                ResampleRowHorizontally(srcRow, cached);
+                cachedRows[slot] = srcRow;
+            }
 
-            DoCalc(precalcs[dsty], srcpix, srcpixmax);
+            rows[k] = cached;
+        }
+
+        const int * const weights = allWeights + entry.index;
+        for ( int x = 0; x < m_dstWidth; x += RESAMPLE_BLOCK_SIZE )
+        {
+            const int count = m_dstWidth - x < RESAMPLE_BLOCK_SIZE
+                                ? m_dstWidth - x
+                                : RESAMPLE_BLOCK_SIZE;
+
+            const int offset = x*m_channels;
+            const int size = count*m_channels;
+
+            if ( m_premultiply )
+            {
+                SumWeightedRows(sums64, &rows[0], weights, taps, offset, size);
+                StorePremultipliedPixels(sums64, y, x, count);
+            }
+            else
+            {
+                SumWeightedRows(sums, &rows[0], weights, taps, offset, size);
+                StorePixels(sums, y, x, count);
+            }
         }
     }
-    else
+}
+
+void ImageResampler::ProcessRowsVerticalFirst(int rowStart, int rowEnd)
+{
+    wxVector<wxInt32> row(m_srcWidth*m_channels);
+    wxVector<const unsigned char*> rows(m_vWeights.GetMaxTaps());
+
+    wxInt32 sums[RESAMPLE_BLOCK_SIZE*4];
+    wxInt64 sums64[RESAMPLE_BLOCK_SIZE*4];
+
+    for ( int y = rowStart; y < rowEnd; y++ )
     {
-        // Let's take the pixel from the center of the source image.
-        double srcpix = (double)srcpixmax / 2.0;
+        ResampleRowsVertically(y, &rows[0], &row[0]);
 
-        DoCalc(precalcs[0], srcpix, srcpixmax);
+        for ( int x = 0; x < m_dstWidth; x += RESAMPLE_BLOCK_SIZE )
+        {
+            const int count = m_dstWidth - x < RESAMPLE_BLOCK_SIZE
+                                ? m_dstWidth - x
+                                : RESAMPLE_BLOCK_SIZE;
+
+            if ( m_premultiply )
+            {
+                SumColumns<4>(sums64, &row[0], x, count);
+                StorePremultipliedPixels(sums64, y, x, count);
+            }
+            else if ( m_srcAlpha )
+            {
+                SumColumns<4>(sums, &row[0], x, count);
+                StorePixels(sums, y, x, count);
+            }
+            else
+            {
+                SumColumns<3>(sums, &row[0], x, count);
+                StorePixels(sums, y, x, count);
+            }
+        }
     }
 }
 
-} // anonymous namespace
-
-wxImage wxImage::ResampleBilinear(int width, int height) const
+// Create the resampled image using the given weights.
+wxImage DoResample(const wxImage& src,
+                   const ResampleWeights& hWeights,
+                   const ResampleWeights& vWeights,
+                   int width,
+                   int height,
+                   bool premultiply)
 {
-    // This function implements a Bilinear algorithm for resampling.
     wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
 
-    if ( src_alpha )
-    {
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    if ( src.HasAlpha() )
         ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
 
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    ImageResampler resampler(src, ret_image, hWeights, vWeights, premultiply);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
+    const size_t srcPixels = static_cast<size_t>(src.GetWidth())*src.GetHeight();
+    const size_t dstPixels = static_cast<size_t>(width)*height;
+    resampler.ProcessAll(height, srcPixels + dstPixels);
+
+    return ret_image;
+}
+
+// ----------------------------------------------------------------------------
+// Weights for the different resampling algorithms
+// ----------------------------------------------------------------------------
+
+void ResampleBoxPrecalc(ResampleWeights& weights, int newDim, int oldDim)
+{
+    wxASSERT( oldDim > 0 && newDim > 0 );
+
+    // We need to map pixel values in the range [-0.5 .. (newDim-1)+0.5]
+    // to the pixel values in the range [-0.5 .. (oldDim-1)+0.5].
+    // Transformation function is therefore:
+    //   pOld = sc * (pNew + 0.5) - 0.5, where sc = oldDim/newDim
+    //
+    // A new pixel pNew in the interval [pNew-0.5 .. pNew+0.5]
+    // is mapped to the old pixel in the interval [pOldLoBound..pOldUpBound],
+    // where:
+    //   pOldLoBound = sc * ((pNew-0.5) + 0.5) - 0.5 = sc * pNew - 0.5
+    //   pOldUpBound = sc * ((pNew+0.5) + 0.5) - 0.5 = sc * (pNew+1) - 0.5
+    // So, the lower bound of the pixel box (interval) is:
+    //   boxStart = round(pOldLoBound) = trunc((sc * pNew - 0.5) + 0.5) = trunc(sc * pNew)
+    // and the upper bound is:
+    // - if fraction(pOldUpBound) != 0.5 (bound inside the pixel):
+    //   boxEnd = round(pixOldUpBound) = trunc((sc * (pNew+1) - 0.5) + 0.5) = trunc(sc * (pNew+1))
+    //    e.g. for UpBound = 7.2 -> boxEnd = 7
+    //         for UpBound = 7.6 -> boxEnd = 8
+    // - if fraction(pOldUpBound) == 0.5 (bound at the edge of the pixel):
+    //   boxEnd = round(pOldUpBound)-1 = trunc((sc * (pNew+1) - 0.5) + 0.5) - 1 = trunc(sc * (pNew+1))-1
+    //    e.g. for UpBound = 7.5 -> boxEnd = 7 (not 8)
+    //
+    // In integer arithmetic:
+    //  boxStart = (oldDim * pNew) / newDim
+    //  boxEnd:
+    //   vEnd =  oldDim * (pNew+1) = oldDim * pNew + oldDim
+    //  if vEnd % newDim != 0 (frac(pOldUpBound) != 0.5) => boxEnd = vEnd / newDim
+    //  if vEnd % newDim == 0 (frac(pOldUpBound) == 0.5) => boxEnd = (vEnd / newDim) - 1
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    int v = 0; // oldDim * 0
+    for ( int dst = 0; dst < newDim; dst++ )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
+        const int boxStart = v/newDim;
+        v += oldDim;
+        const int boxEnd = v%newDim != 0 ? v/newDim : (v/newDim)-1;
 
+        weights.AddUniform(boxStart, boxEnd - boxStart + 1);
+    }
+}
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+inline void DoCalcBilinear(ResampleWeights& weights, double srcpix, int srcpixmax)
+{
+    int srcpix1 = int(srcpix);
+    int srcpix2 = srcpix1 == srcpixmax ? srcpix1 : srcpix1 + 1;
 
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
+    const double dd = srcpix - (int)srcpix;
 
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
+    int offsets[2];
+    offsets[0] = srcpix1 < 0.0
+                    ? 0
+                    : srcpix1 > srcpixmax
+                        ? srcpixmax
+                        : (int)srcpix1;
+    offsets[1] = srcpix2 < 0.0
+                    ? 0
+                    : srcpix2 > srcpixmax
+                        ? srcpixmax
+                        : (int)srcpix2;
 
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+    const double w[2] = { 1.0 - dd, dd };
 
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+    weights.AddClamped(offsets, w, 2);
+}
 
-            // result lines
+void ResampleBilinearPrecalc(ResampleWeights& weights, int newDim, int oldDim)
+{
+    wxASSERT( oldDim > 0 && newDim > 0 );
+    const int srcpixmax = oldDim - 1;
+    if ( newDim > 1 )
+    {
+        // We want to map pixels in the range [0..newDim-1]
+        // to the range [0..oldDim-1]
+        const double scale_factor = double(oldDim-1) / (newDim-1);
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
+        for ( int dsty = 0; dsty < newDim; dsty++ )
+        {
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            double srcpix = (double)dsty * scale_factor;
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            DoCalcBilinear(weights, srcpix, srcpixmax);
         }
     }
+    else
+    {
+        // Let's take the pixel from the center of the source image.
+        double srcpix = (double)srcpixmax / 2.0;
 
-    return ret_image;
+        DoCalcBilinear(weights, srcpix, srcpixmax);
+    }
 }
 
 // The following two local functions are for the B-spline weighting of the
 // bicubic sampling algorithm
-static inline double spline_cube(double value)
+inline double spline_cube(double value)
 {
     return value <= 0.0 ? 0.0 : value * value * value;
 }
 
-static inline double spline_weight(double value)
+inline double spline_weight(double value)
 {
     return (spline_cube(value + 2) -
             4 * spline_cube(value + 1) +
@@ -870,35 +1425,31 @@ static inline double spline_weight(double value)
             4 * spline_cube(value - 1)) / 6;
 }
 
-
-namespace
-{
-
-struct BicubicPrecalc
-{
-    double weight[4];
-    int offset[4];
-};
-
-inline void DoCalc(BicubicPrecalc& precalc, double srcpixd, int oldDim)
+inline void DoCalcBicubic(ResampleWeights& weights, double srcpixd, int oldDim)
 {
     const double dd = srcpixd - static_cast<int>(srcpixd);
 
+    // Edge pixels are handled by clamping the offsets, i.e. taking the
+    // nearest pixel along the border, which extends the border pixels out to
+    // infinity.
+    int offsets[4];
+    double w[4];
     for ( int k = -1; k <= 2; k++ )
     {
-        precalc.offset[k + 1] = srcpixd + k < 0.0
+        offsets[k + 1] = srcpixd + k < 0.0
             ? 0
             : srcpixd + k >= oldDim
                 ? oldDim - 1
                 : static_cast<int>(srcpixd + k);
 
-        precalc.weight[k + 1] = spline_weight(k - dd);
+        w[k + 1] = spline_weight(k - dd);
     }
+
+    weights.AddClamped(offsets, w, 4);
 }
 
-void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
+void ResampleBicubicPrecalc(ResampleWeights& weights, int newDim, int oldDim)
 {
-    const int newDim = aWeight.size();
     wxASSERT( oldDim > 0 && newDim > 0 );
 
     if ( newDim > 1 )
@@ -912,7 +1463,7 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
             // We need to calculate the source pixel to interpolate from - Y-axis
             const double srcpixd = static_cast<double>(dstd) * scale_factor;
 
-            DoCalc(aWeight[dstd], srcpixd, oldDim);
+            DoCalcBicubic(weights, srcpixd, oldDim);
         }
     }
     else
@@ -920,12 +1471,38 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
         // Let's take the pixel from the center of the source image.
         const double srcpixd = static_cast<double>(oldDim - 1) / 2.0;
 
-        DoCalc(aWeight[0], srcpixd, oldDim);
+        DoCalcBicubic(weights, srcpixd, oldDim);
     }
 }
 
 } // anonymous namespace
 
+wxImage wxImage::ResampleBox(int width, int height) const
+{
+    // This function implements a simple pre-blur/box averaging method for
+    // downsampling that gives reasonably smooth results To scale the image
+    // down we will need to gather a grid of pixels of the size of the scale
+    // factor in each direction and then do an averaging of the pixels.
+    //
+    // Colours are weighted by alpha, so that transparent pixels don't
+    // affect the colour of the result.
+    ResampleWeights hWeights, vWeights;
+    ResampleBoxPrecalc(hWeights, width, M_IMGDATA->m_width);
+    ResampleBoxPrecalc(vWeights, height, M_IMGDATA->m_height);
+
+    return DoResample(*this, hWeights, vWeights, width, height, true);
+}
+
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    ResampleWeights hWeights, vWeights;
+    ResampleBilinearPrecalc(hWeights, width, M_IMGDATA->m_width);
+    ResampleBilinearPrecalc(vWeights, height, M_IMGDATA->m_height);
+
+    return DoResample(*this, hWeights, vWeights, width, height, false);
+}
+
 // This is the bicubic resampling algorithm
 wxImage wxImage::ResampleBicubic(int width, int height) const
 {
@@ -941,226 +1518,386 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     // upsampling by large factors.  This is basically because a slight
     // gaussian blur is being performed to get the smooth look of the upsampled
     // image.
-
-    // Edge pixels: 3-4 possible solutions
-    // - (Wrap/tile) Wrap the image, take the color value from the opposite
-    // side of the image.
-    // - (Mirror)    Duplicate edge pixels, so that pixel at coordinate (2, n),
-    // where n is nonpositive, will have the value of (2, 1).
-    // - (Ignore)    Simply ignore the edge pixels and apply the kernel only to
-    // pixels which do have all neighbours.
-    // - (Clamp)     Choose the nearest pixel along the border. This takes the
-    // border pixels and extends them out to infinity.
     //
-    // NOTE: below the y_offset and x_offset variables are being set for edge
-    // pixels using the "Mirror" method mentioned above
+    // Colours are weighted by alpha, as for the box resampling.
+    ResampleWeights hWeights, vWeights;
+    ResampleBicubicPrecalc(hWeights, width, M_IMGDATA->m_width);
+    ResampleBicubicPrecalc(vWeights, height, M_IMGDATA->m_height);
 
-    wxImage ret_image;
+    return DoResample(*this, hWeights, vWeights, width, height, true);
+}
+
+// ----------------------------------------------------------------------------
+// Blurring
+// ----------------------------------------------------------------------------
 
-    ret_image.Create(width, height, false);
+namespace
+{
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+// Width of the strips of columns processed by the vertical blur: the running
+// sums for all the pixels of a row of a strip remain in the cache, unlike for
+// the full rows of big images, while the rows are still long enough to be
+// read efficiently.
+const int BLUR_STRIP_WIDTH = 64;
 
-    if ( src_alpha )
+// Divides the sums of the pixels in the blur box by the number of pixels in
+// it, optionally rounding the result instead of truncating it.
+class BlurDivider
+{
+public:
+    BlurDivider(int radius, bool round)
+        : m_area(2*radius + 1),
+          m_bias(round ? m_area/2 : 0)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        // Multiplying by the inverse of the area gives the same results as
+        // the much slower division as long as the sums multiplied by the
+        // area fit into 32 bits, which is the case for all but huge radii.
+        m_mult = m_area < 4096 ? ((wxUint64(1) << 32) + m_area - 1) / m_area
+                               : 0;
     }
 
-    // Precalculate weights
-    wxVector<BicubicPrecalc> vPrecalcs(height);
-    wxVector<BicubicPrecalc> hPrecalcs(width);
+    unsigned char operator()(unsigned sum) const
+    {
+        sum += m_bias;
+        return static_cast<unsigned char>(m_mult ? (sum*m_mult) >> 32
+                                                 : sum / m_area);
+    }
+
+private:
+    unsigned m_area;
+    unsigned m_bias;
+    wxUint64 m_mult;
+};
+
+// Blur a row of pixels with the given number of channels, the pixels beyond
+// the row ends are considered to be the same as the edge pixels.
+template <int Channels>
+void BlurRow(unsigned char *dst,
+             const unsigned char *src,
+             int width,
+             int radius,
+             const BlurDivider& divide)
+{
+    const int last = width - 1;
+
+    unsigned sums[Channels];
+    for ( int c = 0; c < Channels; c++ )
+        sums[c] = (radius + 1)*src[c];
+
+    const int inside = radius < last ? radius : last;
+    for ( int k = 1; k <= inside; k++ )
+    {
+        for ( int c = 0; c < Channels; c++ )
+            sums[c] += src[k*Channels + c];
+    }
+
+    for ( int c = 0; c < Channels; c++ )
+        sums[c] += (radius - inside)*src[last*Channels + c];
+
+    for ( int x = 0; ; x++ )
+    {
+        for ( int c = 0; c < Channels; c++ )
+            dst[x*Channels + c] = divide(sums[c]);
+
+        if ( x == last )
+            break;
 
-    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
+        // Move the box to the right.
+        const int add = x + radius + 1;
+        const int remove = x - radius;
+        const unsigned char * const
+            pAdd = src + (add < last ? add : last)*Channels;
+        const unsigned char * const
+            pRemove = src + (remove > 0 ? remove : 0)*Channels;
+        for ( int c = 0; c < Channels; c++ )
+            sums[c] += pAdd[c] - pRemove[c];
+    }
+}
+
+// Blur the given number of bytes in each row of an image plane vertically.
+//
+// The destination may be the same as the source, in which case ring must be
+// a buffer big enough for min(radius, height - 1) + 1 rows, used to preserve
+// the original values still needed after overwriting them.
+void BlurColumns(unsigned char *dst,
+                 const unsigned char *src,
+                 int count,
+                 size_t stride,
+                 int height,
+                 int radius,
+                 const BlurDivider& divide,
+                 unsigned *sums,
+                 unsigned char *ring)
+{
+    const int last = height - 1;
+    const int inside = radius < last ? radius : last;
+
+    for ( int i = 0; i < count; i++ )
+        sums[i] = (radius + 1)*src[i];
+
+    for ( int k = 1; k <= inside; k++ )
+    {
+        const unsigned char * const row = src + k*stride;
+        for ( int i = 0; i < count; i++ )
+            sums[i] += row[i];
+    }
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    if ( radius > inside )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+        const unsigned char * const row = src + last*stride;
+        const unsigned outside = radius - inside;
+        for ( int i = 0; i < count; i++ )
+            sums[i] += outside*row[i];
+    }
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+    const int ringRows = inside + 1;
+    for ( int y = 0; ; y++ )
+    {
+        unsigned char * const out = dst + y*stride;
+
+        // Find the row leaving the box when moving it down.
+        const int remove = y - radius > 0 ? y - radius : 0;
+        const unsigned char *pRemove;
+        if ( ring )
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+            memcpy(ring + (y % ringRows)*count, out, count);
+            pRemove = ring + (remove % ringRows)*count;
+        }
+        else
+        {
+            pRemove = src + remove*stride;
+        }
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+        for ( int i = 0; i < count; i++ )
+            out[i] = divide(sums[i]);
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
-            {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+        if ( y == last )
+            break;
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    }
-                }
-            }
+        const int add = y + radius + 1;
+        const unsigned char * const pAdd = src + (add < last ? add : last)*stride;
+        for ( int i = 0; i < count; i++ )
+            sums[i] += pAdd[i] - pRemove[i];
+    }
+}
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if ( sum_a )
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)sum_a;
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
+// Blurs the image using the given box blur passes in one direction. The
+// destination image may be the same as the source one.
+class ImageBlurrer : public BandsProcessor
+{
+public:
+    ImageBlurrer(const wxImage& src,
+                 wxImage& dst,
+                 const wxVector<int>& radii,
+                 bool round,
+                 bool vertical)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_radii(radii),
+          m_vertical(vertical)
+    {
+        for ( size_t n = 0; n < radii.size(); n++ )
+            m_dividers.push_back(BlurDivider(radii[n], round));
+    }
+
+    void Blur()
+    {
+        const size_t pixels = static_cast<size_t>(m_width)*m_height*m_radii.size();
+        if ( m_vertical )
+            ProcessAll((m_width + BLUR_STRIP_WIDTH - 1) / BLUR_STRIP_WIDTH, pixels);
+        else
+            ProcessAll(m_height, pixels);
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        if ( m_vertical )
+            BlurStrips(start, end);
+        else
+            BlurRows(start, end);
+    }
+
+private:
+    void BlurRows(int rowStart, int rowEnd) const;
+    void BlurStrips(int stripStart, int stripEnd) const;
+
+    // Apply all blur passes to a single row, using the provided buffers for
+    // the intermediate results.
+    template <int Channels>
+    void BlurRowPasses(unsigned char *dst,
+                       const unsigned char *src,
+                       unsigned char *buf1,
+                       unsigned char *buf2) const;
+
+    // Apply all blur passes to the columns of an image plane.
+    void BlurColumnPasses(unsigned char *dst,
+                          const unsigned char *src,
+                          int count,
+                          size_t stride,
+                          unsigned *sums,
+                          unsigned char *ring) const;
+
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_width;
+    const int m_height;
+
+    const wxVector<int>& m_radii;
+    wxVector<BlurDivider> m_dividers;
+
+    const bool m_vertical;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBlurrer);
+};
+
+template <int Channels>
+void ImageBlurrer::BlurRowPasses(unsigned char *dst,
+                                 const unsigned char *src,
+                                 unsigned char *buf1,
+                                 unsigned char *buf2) const
+{
+    const unsigned char *cur = src;
+    if ( src == dst )
+    {
+        memcpy(buf1, src, m_width*Channels);
+        cur = buf1;
+    }
+
+    const size_t passes = m_radii.size();
+    for ( size_t n = 0; n < passes; n++ )
+    {
+        unsigned char * const out = n == passes - 1 ? dst
+                                                    : cur == buf1 ? buf2 : buf1;
+        BlurRow<Channels>(out, cur, m_width, m_radii[n], m_dividers[n]);
+        cur = out;
+    }
+}
+
+void ImageBlurrer::BlurRows(int rowStart, int rowEnd) const
+{
+    wxVector<unsigned char> buf1(m_width*3);
+    wxVector<unsigned char> buf2(m_width*3);
+
+    for ( int y = rowStart; y < rowEnd; y++ )
+    {
+        const size_t pos = static_cast<size_t>(y)*m_width;
+
+        BlurRowPasses<3>(m_dstData + pos*3, m_srcData + pos*3,
+                         &buf1[0], &buf2[0]);
+
+        if ( m_srcAlpha )
+        {
+            BlurRowPasses<1>(m_dstAlpha + pos, m_srcAlpha + pos,
+                             &buf1[0], &buf2[0]);
+        }
+    }
+}
+
+void ImageBlurrer::BlurColumnPasses(unsigned char *dst,
+                                    const unsigned char *src,
+                                    int count,
+                                    size_t stride,
+                                    unsigned *sums,
+                                    unsigned char *ring) const
+{
+    // All passes but the first one are done in place.
+    for ( size_t n = 0; n < m_radii.size(); n++ )
+    {
+        const unsigned char * const from = n == 0 ? src : dst;
+        BlurColumns(dst, from, count, stride, m_height,
+                    m_radii[n], m_dividers[n], sums,
+                    from == dst ? ring : NULL);
+    }
+}
+
+void ImageBlurrer::BlurStrips(int stripStart, int stripEnd) const
+{
+    int maxRadius = 0;
+    for ( size_t n = 0; n < m_radii.size(); n++ )
+    {
+        if ( m_radii[n] > maxRadius )
+            maxRadius = m_radii[n];
+    }
+
+    const int ringRows = (maxRadius < m_height - 1 ? maxRadius : m_height - 1) + 1;
+
+    wxVector<unsigned> sums(BLUR_STRIP_WIDTH*3);
+    wxVector<unsigned char> ring(ringRows*BLUR_STRIP_WIDTH*3);
+
+    for ( int strip = stripStart; strip < stripEnd; strip++ )
+    {
+        const int x = strip*BLUR_STRIP_WIDTH;
+        const int count = m_width - x < BLUR_STRIP_WIDTH ? m_width - x
+                                                         : BLUR_STRIP_WIDTH;
+
+        BlurColumnPasses(m_dstData + x*3, m_srcData + x*3,
+                         count*3, m_width*3, &sums[0], &ring[0]);
+
+        if ( m_srcAlpha )
+        {
+            BlurColumnPasses(m_dstAlpha + x, m_srcAlpha + x,
+                             count, m_width, &sums[0], &ring[0]);
         }
     }
+}
 
-    return ret_image;
+enum
+{
+    Blur_Horizontal = 1,
+    Blur_Vertical = 2,
+    Blur_Both = Blur_Horizontal | Blur_Vertical
+};
+
+// Blur the image in the given directions with the given box blur passes. The
+// destination image must have the same size and alpha as the source one, or
+// be the same image.
+void DoBlur(const wxImage& src,
+            wxImage& dst,
+            const wxVector<int>& radii,
+            bool round,
+            int directions)
+{
+    if ( directions & Blur_Horizontal )
+    {
+        ImageBlurrer blurrer(src, dst, radii, round, false);
+        blurrer.Blur();
+    }
+
+    if ( directions & Blur_Vertical )
+    {
+        // If the image had been already blurred horizontally, blur the
+        // result in place instead of allocating another image.
+        ImageBlurrer blurrer(directions & Blur_Horizontal ? dst : src,
+                             dst, radii, round, true);
+        blurrer.Blur();
+    }
+}
+
+// Blur the image in the given directions using a box of the given radius.
+void DoBoxBlur(const wxImage& src, wxImage& dst, int blurRadius, int directions)
+{
+    // Keep truncating the averages for compatibility.
+    DoBlur(src, dst, wxVector<int>(1, blurRadius), false, directions);
 }
 
+} // anonymous namespace
+
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
+    wxCHECK_MSG( blurRadius >= 0, wxImage(), wxS("invalid blur radius") );
+
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    DoBoxBlur(*this, ret_image, blurRadius, Blur_Horizontal);
 
     return ret_image;
 }
@@ -1168,102 +1905,15 @@ wxImage wxImage::BlurHorizontal(int blurRadius) const
 // Blur in the vertical direction
 wxImage wxImage::BlurVertical(int blurRadius) const
 {
+    wxCHECK_MSG( blurRadius >= 0, wxImage(), wxS("invalid blur radius") );
+
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    // Blurring in the vertical direction is done for the strips of columns
+    // as this is much more cache-friendly than processing each column.
+    DoBoxBlur(*this, ret_image, blurRadius, Blur_Vertical);
 
     return ret_image;
 }
@@ -1271,12 +1921,64 @@ wxImage wxImage::BlurVertical(int blurRadius) const
 // The new blur function
 wxImage wxImage::Blur(int blurRadius) const
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+    wxCHECK_MSG( blurRadius >= 0, wxImage(), wxS("invalid blur radius") );
+
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    // Blur the image in each direction, the vertical blur is done in place.
+    DoBoxBlur(*this, ret_image, blurRadius, Blur_Both);
+
+    return ret_image;
+}
+
+wxImage& wxImage::BlurInPlace(int blurRadius)
+{
+    wxCHECK_MSG( IsOk(), *this, wxS("invalid image") );
+    wxCHECK_MSG( blurRadius >= 0, *this, wxS("invalid blur radius") );
+
+    AllocExclusive();
+
+    DoBoxBlur(*this, *this, blurRadius, Blur_Both);
+
+    return *this;
+}
+
+wxImage wxImage::GaussianBlur(double sigma) const
+{
+    wxCHECK_MSG( sigma >= 0, wxImage(), wxS("invalid standard deviation") );
+
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    // The Gaussian blur is approximated by 3 successive box blurs with the
+    // box sizes chosen to give the same standard deviation as explained in
+    // Kovesi, "Fast Almost-Gaussian Filtering" (2010): the first m boxes
+    // have the biggest odd size not greater than the ideal one and the rest
+    // of them the next odd size.
+    const int passes = 3;
+    const double variance12 = 12*sigma*sigma;
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    int sizeLower = static_cast<int>(sqrt(variance12/passes + 1));
+    if ( sizeLower % 2 == 0 )
+        sizeLower--;
+
+    const int m = wxRound((variance12 - passes*sizeLower*sizeLower
+                            - 4*passes*sizeLower - 3*passes) /
+                          (-4*sizeLower - 4));
+
+    wxVector<int> radii;
+    for ( int n = 0; n < passes; n++ )
+    {
+        const int size = n < m ? sizeLower : sizeLower + 2;
+        radii.push_back((size - 1) / 2);
+    }
+
+    // Round the intermediate results to avoid accumulating the truncation
+    // errors of all passes.
+    DoBlur(*this, ret_image, radii, true, Blur_Both);
 
     return ret_image;
 }
@@ -1716,26 +2418,68 @@ void wxImage::Replace( unsigned char r1, unsigned char g1, unsigned char b1,
 {
     wxCHECK_RET( IsOk(), wxT("invalid image") );
 
+    if ( r1 == r2 && g1 == g2 && b1 == b2 )
+        return;
+
     AllocExclusive();
 
     unsigned char *data = GetData();
 
-    const int w = GetWidth();
-    const int h = GetHeight();
+    const size_t count = size_t(GetWidth())*GetHeight();
 
-    for (int j = 0; j < h; j++)
-        for (int i = 0; i < w; i++)
+    // Avoid branches, including the short-circuiting ones, in this loop to
+    // allow the compiler to vectorize it.
+    for ( size_t n = 0; n < count; n++, data += 3 )
+    {
+        const bool match = (data[0] == r1) & (data[1] == g1) & (data[2] == b1);
+        data[0] = match ? r2 : data[0];
+        data[1] = match ? g2 : data[1];
+        data[2] = match ? b2 : data[2];
+    }
+}
+
+namespace
+{
+
+// Stores the colour components of the image pixels transformed using the
+// given lookup table in dst, which may be the same as the image data, except
+// for the pixels of the mask colour, if any, which are copied unchanged.
+void
+ApplyColourLUT(const wxImage& image, unsigned char* dst, const unsigned char* lut)
+{
+    const unsigned char* src = image.GetData();
+    size_t count = size_t(image.GetWidth())*image.GetHeight();
+
+    if ( !image.HasMask() )
+    {
+        for ( size_t n = 0; n < 3*count; n++ )
+            dst[n] = lut[src[n]];
+        return;
+    }
+
+    const unsigned char maskR = image.GetMaskRed();
+    const unsigned char maskG = image.GetMaskGreen();
+    const unsigned char maskB = image.GetMaskBlue();
+
+    for ( ; count; count--, src += 3, dst += 3 )
+    {
+        if ( src[0] == maskR && src[1] == maskG && src[2] == maskB )
         {
-            if ((data[0] == r1) && (data[1] == g1) && (data[2] == b1))
-            {
-                data[0] = r2;
-                data[1] = g2;
-                data[2] = b2;
-            }
-            data += 3;
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+        }
+        else
+        {
+            dst[0] = lut[src[0]];
+            dst[1] = lut[src[1]];
+            dst[2] = lut[src[2]];
         }
+    }
 }
 
+} // anonymous namespace
+
 wxImage wxImage::ConvertToGreyscale(void) const
 {
     return ConvertToGreyscale(0.299, 0.587, 0.114);
@@ -1746,35 +2490,45 @@ wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double wei
     wxImage image;
     wxCHECK_MSG(IsOk(), image, "invalid image");
 
-    const int w = M_IMGDATA->m_width;
-    const int h = M_IMGDATA->m_height;
-    size_t size = size_t(w) * h;
-    image.Create(w, h, false);
-    const unsigned char* alpha = M_IMGDATA->m_alpha;
-    if (alpha)
-    {
-        image.SetAlpha();
-        memcpy(image.GetAlpha(), alpha, size);
-    }
+    size_t size = size_t(M_IMGDATA->m_width) * M_IMGDATA->m_height;
+    image = MakeEmptyClone();
+    if ( M_IMGDATA->m_alpha )
+        memcpy(image.GetAlpha(), M_IMGDATA->m_alpha, size);
+
     const unsigned char mask_r = M_IMGDATA->m_maskRed;
     const unsigned char mask_g = M_IMGDATA->m_maskGreen;
     const unsigned char mask_b = M_IMGDATA->m_maskBlue;
     const bool hasMask = M_IMGDATA->m_hasMask;
-    if (hasMask)
-        image.SetMaskColour(mask_r, mask_g, mask_b);
+
+    // Precompute the products done by wxColour::MakeGrey(), this gives
+    // exactly the same results as it without any multiplications.
+    double lut_r[256], lut_g[256], lut_b[256];
+    for ( int n = 0; n < 256; n++ )
+    {
+        lut_r[n] = n * weight_r;
+        lut_g[n] = n * weight_g;
+        lut_b[n] = n * weight_b;
+    }
 
     const unsigned char* src = M_IMGDATA->m_data;
     unsigned char* dst = image.GetData();
-    while (size--)
+    for ( ; size; size--, src += 3, dst += 3 )
     {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeGrey(&r, &g, &b, weight_r, weight_g, weight_b);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
+        const unsigned char r = src[0];
+        const unsigned char g = src[1];
+        const unsigned char b = src[2];
+        if ( hasMask && r == mask_r && g == mask_g && b == mask_b )
+        {
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+        }
+        else
+        {
+            dst[0] =
+            dst[1] =
+            dst[2] = (wxByte)wxRound(lut_r[r] + lut_g[g] + lut_b[b]);
+        }
     }
     return image;
 }
@@ -1800,15 +2554,18 @@ wxImage wxImage::ConvertToMono( unsigned char r, unsigned char g, unsigned char
             image.SetMaskColour( 0, 0, 0 );
     }
 
-    long size = M_IMGDATA->m_height * M_IMGDATA->m_width;
+    const size_t size = size_t(M_IMGDATA->m_height) * M_IMGDATA->m_width;
 
-    unsigned char *srcd = M_IMGDATA->m_data;
-    unsigned char *tard = image.GetData();
+    const unsigned char *srcd = M_IMGDATA->m_data;
+    unsigned char *tard = data;
 
-    for ( long i = 0; i < size; i++, srcd += 3, tard += 3 )
+    // This does the same thing as wxColour::MakeMono() but without branches.
+    for ( size_t i = 0; i < size; i++, srcd += 3, tard += 3 )
     {
-        bool on = (srcd[0] == r) && (srcd[1] == g) && (srcd[2] == b);
-        wxColourBase::MakeMono(tard + 0, tard + 1, tard + 2, on);
+        const bool on = (srcd[0] == r) & (srcd[1] == g) & (srcd[2] == b);
+        tard[0] =
+        tard[1] =
+        tard[2] = on ? 255 : 0;
     }
 
     return image;
@@ -1819,36 +2576,52 @@ wxImage wxImage::ConvertToDisabled(unsigned char brightness) const
     wxImage image;
     wxCHECK_MSG(IsOk(), image, "invalid image");
 
-    const int w = M_IMGDATA->m_width;
-    const int h = M_IMGDATA->m_height;
-    size_t size = size_t(w) * h;
-    image.Create(w, h, false);
-    const unsigned char* alpha = M_IMGDATA->m_alpha;
-    if (alpha)
+    image = MakeEmptyClone();
+    if ( M_IMGDATA->m_alpha )
     {
-        image.SetAlpha();
-        memcpy(image.GetAlpha(), alpha, size);
+        memcpy(image.GetAlpha(), M_IMGDATA->m_alpha,
+               size_t(M_IMGDATA->m_width) * M_IMGDATA->m_height);
     }
-    const unsigned char mask_r = M_IMGDATA->m_maskRed;
-    const unsigned char mask_g = M_IMGDATA->m_maskGreen;
-    const unsigned char mask_b = M_IMGDATA->m_maskBlue;
-    const bool hasMask = M_IMGDATA->m_hasMask;
-    if (hasMask)
-        image.SetMaskColour(mask_r, mask_g, mask_b);
 
-    const unsigned char* src = M_IMGDATA->m_data;
-    unsigned char* dst = image.GetData();
-    while (size--)
+    // wxColour::MakeDisabled() transforms each component independently, so
+    // it's enough to apply it once to each possible value.
+    unsigned char lut[256];
+    for ( int n = 0; n < 256; n++ )
+    {
+        unsigned char r = n, g = n, b = n;
+        wxColour::MakeDisabled(&r, &g, &b, brightness);
+        lut[n] = r;
+    }
+
+    ApplyColourLUT(*this, image.GetData(), lut);
+
+    return image;
+}
+
+wxImage wxImage::ChangeLightness(int alpha) const
+{
+    wxImage image;
+    wxCHECK_MSG(IsOk(), image, "invalid image");
+
+    image = MakeEmptyClone();
+    if ( M_IMGDATA->m_alpha )
+    {
+        memcpy(image.GetAlpha(), M_IMGDATA->m_alpha,
+               size_t(M_IMGDATA->m_width) * M_IMGDATA->m_height);
+    }
+
+    // As above, wxColour::ChangeLightness() works on each component
+    // independently.
+    unsigned char lut[256];
+    for ( int n = 0; n < 256; n++ )
     {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeDisabled(&r, &g, &b, brightness);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
+        unsigned char r = n, g = n, b = n;
+        wxColour::ChangeLightness(&r, &g, &b, alpha);
+        lut[n] = r;
     }
+
+    ApplyColourLUT(*this, image.GetData(), lut);
+
     return image;
 }
 
@@ -1933,18 +2706,30 @@ void wxImage::SetRGB( const wxRect& rect_, unsigned char r, unsigned char g, uns
         x2 = rect.GetRight() + 1,
         y2 = rect.GetBottom() + 1;
 
-    int x, y, width = GetWidth();
-    for (y = y1; y < y2; y++)
+    if ( x1 == x2 || y1 == y2 )
+        return;
+
+    // Fill the first row and then just copy it to all the other ones.
+    const int width = GetWidth();
+    const size_t rowSize = size_t(x2 - x1)*3;
+    unsigned char* const first = M_IMGDATA->m_data + (size_t(y1)*width + x1)*3;
+    if ( r == g && g == b )
+    {
+        memset(first, r, rowSize);
+    }
+    else
     {
-        unsigned char* data;
-        data = M_IMGDATA->m_data + (y*width + x1)*3;
-        for (x = x1; x < x2; x++)
+        unsigned char* data = first;
+        for ( int x = x1; x < x2; x++ )
         {
             *data++ = r;
             *data++ = g;
             *data++ = b;
         }
     }
+
+    for ( int y = y1 + 1; y < y2; y++ )
+        memcpy(M_IMGDATA->m_data + (size_t(y)*width + x1)*3, first, rowSize);
 }
 
 unsigned char wxImage::GetRed( int x, int y ) const
@@ -2166,6 +2951,247 @@ void wxImage::ClearAlpha()
     M_IMGDATA->m_alpha = NULL;
 }
 
+// ----------------------------------------------------------------------------
+// interleaved RGBA data
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Copy a row of wxImage data, possibly without alpha, to interleaved RGBA.
+void CopyRowToRGBA(unsigned char* dst,
+                   const unsigned char* src,
+                   const unsigned char* alpha,
+                   int width,
+                   bool premultiply)
+{
+    if ( !alpha )
+    {
+        for ( int x = 0; x < width; x++, dst += 4, src += 3 )
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = wxIMAGE_ALPHA_OPAQUE;
+        }
+    }
+    else if ( !premultiply )
+    {
+        for ( int x = 0; x < width; x++, dst += 4, src += 3 )
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = alpha[x];
+        }
+    }
+    else
+    {
+        for ( int x = 0; x < width; x++, dst += 4, src += 3 )
+        {
+            const unsigned a = alpha[x];
+            dst[0] = wxPremultiplyAlpha(a, src[0]);
+            dst[1] = wxPremultiplyAlpha(a, src[1]);
+            dst[2] = wxPremultiplyAlpha(a, src[2]);
+            dst[3] = static_cast<unsigned char>(a);
+        }
+    }
+}
+
+// Same as above but for native endian 32 bit ARGB values, always
+// premultiplied.
+void CopyRowToARGB32(wxUint32* dst,
+                     const unsigned char* src,
+                     const unsigned char* alpha,
+                     int width)
+{
+    if ( !alpha )
+    {
+        for ( int x = 0; x < width; x++, src += 3 )
+            *dst++ = 0xff000000u | src[0] << 16 | src[1] << 8 | src[2];
+    }
+    else
+    {
+        for ( int x = 0; x < width; x++, src += 3 )
+        {
+            const unsigned a = alpha[x];
+            *dst++ = a << 24 |
+                     wxPremultiplyAlpha(a, src[0]) << 16 |
+                     wxPremultiplyAlpha(a, src[1]) <<  8 |
+                     wxPremultiplyAlpha(a, src[2]);
+        }
+    }
+}
+
+// Copy a row of interleaved RGBA data to wxImage data and alpha.
+void CopyRowFromRGBA(unsigned char* dst,
+                     unsigned char* alpha,
+                     const unsigned char* src,
+                     int width,
+                     bool premultiplied)
+{
+    for ( int x = 0; x < width; x++, dst += 3, src += 4 )
+    {
+        const unsigned a = src[3];
+        alpha[x] = static_cast<unsigned char>(a);
+
+        if ( !premultiplied || a == wxIMAGE_ALPHA_OPAQUE )
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+        }
+        else if ( a == wxIMAGE_ALPHA_TRANSPARENT )
+        {
+            dst[0] =
+            dst[1] =
+            dst[2] = 0;
+        }
+        else
+        {
+            dst[0] = wxUnpremultiplyAlpha(a, src[0]);
+            dst[1] = wxUnpremultiplyAlpha(a, src[1]);
+            dst[2] = wxUnpremultiplyAlpha(a, src[2]);
+        }
+    }
+}
+
+void CopyRowFromARGB32(unsigned char* dst,
+                       unsigned char* alpha,
+                       const wxUint32* src,
+                       int width)
+{
+    for ( int x = 0; x < width; x++, dst += 3 )
+    {
+        const wxUint32 argb = *src++;
+        const unsigned a = argb >> 24;
+        alpha[x] = static_cast<unsigned char>(a);
+
+        const unsigned char r = static_cast<unsigned char>(argb >> 16);
+        const unsigned char g = static_cast<unsigned char>(argb >> 8);
+        const unsigned char b = static_cast<unsigned char>(argb);
+
+        if ( a == wxIMAGE_ALPHA_OPAQUE )
+        {
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+        }
+        else if ( a == wxIMAGE_ALPHA_TRANSPARENT )
+        {
+            dst[0] =
+            dst[1] =
+            dst[2] = 0;
+        }
+        else
+        {
+            dst[0] = wxUnpremultiplyAlpha(a, r);
+            dst[1] = wxUnpremultiplyAlpha(a, g);
+            dst[2] = wxUnpremultiplyAlpha(a, b);
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool
+wxImage::GetRGBA(unsigned char* buffer, wxImageRGBAFormat format, int stride) const
+{
+    wxCHECK_MSG( IsOk(), false, wxT("invalid image") );
+    wxCHECK_MSG( buffer, false, wxT("NULL buffer") );
+
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
+    if ( !stride )
+        stride = 4*width;
+    wxCHECK_MSG( stride >= 4*width, false, wxT("invalid stride") );
+
+    const unsigned char* src = M_IMGDATA->m_data;
+    const unsigned char* alpha = M_IMGDATA->m_alpha;
+
+    for ( int y = 0; y < height; y++ )
+    {
+        switch ( format )
+        {
+            case wxIMAGE_FORMAT_RGBA:
+            case wxIMAGE_FORMAT_RGBA_PREMULTIPLIED:
+                CopyRowToRGBA(buffer, src, alpha, width,
+                              format == wxIMAGE_FORMAT_RGBA_PREMULTIPLIED);
+                break;
+
+            case wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED:
+                CopyRowToARGB32(reinterpret_cast<wxUint32*>(buffer),
+                                src, alpha, width);
+                break;
+
+            default:
+                wxFAIL_MSG( wxT("unknown RGBA format") );
+                return false;
+        }
+
+        buffer += stride;
+        src += 3*width;
+        if ( alpha )
+            alpha += width;
+    }
+
+    return true;
+}
+
+bool
+wxImage::SetRGBA(const unsigned char* buffer, wxImageRGBAFormat format, int stride)
+{
+    wxCHECK_MSG( IsOk(), false, wxT("invalid image") );
+    wxCHECK_MSG( buffer, false, wxT("NULL buffer") );
+
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
+    if ( !stride )
+        stride = 4*width;
+    wxCHECK_MSG( stride >= 4*width, false, wxT("invalid stride") );
+
+    AllocExclusive();
+
+    if ( !M_IMGDATA->m_alpha )
+        SetAlpha();
+
+    unsigned char* dst = M_IMGDATA->m_data;
+    unsigned char* alpha = M_IMGDATA->m_alpha;
+
+    for ( int y = 0; y < height; y++ )
+    {
+        switch ( format )
+        {
+            case wxIMAGE_FORMAT_RGBA:
+            case wxIMAGE_FORMAT_RGBA_PREMULTIPLIED:
+                CopyRowFromRGBA(dst, alpha, buffer, width,
+                                format == wxIMAGE_FORMAT_RGBA_PREMULTIPLIED);
+                break;
+
+            case wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED:
+                CopyRowFromARGB32(dst, alpha,
+                                  reinterpret_cast<const wxUint32*>(buffer),
+                                  width);
+                break;
+
+            default:
+                wxFAIL_MSG( wxT("unknown RGBA format") );
+                return false;
+        }
+
+        buffer += stride;
+        dst += 3*width;
+        alpha += width;
+    }
+
+    // the mask is superseded by the alpha channel
+    M_IMGDATA->m_hasMask = false;
+
+    return true;
+}
+
 
 // ----------------------------------------------------------------------------
 // mask support
@@ -2586,6 +3612,13 @@ bool wxImage::LoadFile( const wxString& filename,
 #endif // HAS_LOAD_FROM_RESOURCE
 
 #if HAS_FILE_STREAMS
+#if wxUSE_FILE
+    // Map the file into memory, so that the handlers can seek in it and read
+    // from it without any system calls or extra copying.
+    wxMappedFileInputStream stream(filename);
+    if ( stream.IsOk() && LoadFile(stream, type, index) )
+        return true;
+#else // !wxUSE_FILE
     wxImageFileInputStream stream(filename);
     if ( stream.IsOk() )
     {
@@ -2593,6 +3626,7 @@ bool wxImage::LoadFile( const wxString& filename,
         if ( LoadFile(bstream, type, index) )
             return true;
     }
+#endif // wxUSE_FILE/!wxUSE_FILE
 
     wxLogError(_("Failed to load image from file \"%s\"."), filename);
 #endif // HAS_FILE_STREAMS
@@ -2605,6 +3639,13 @@ bool wxImage::LoadFile( const wxString& WXUNUSED_UNLESS_STREAMS(filename),
                         int WXUNUSED_UNLESS_STREAMS(index) )
 {
 #if HAS_FILE_STREAMS
+#if wxUSE_FILE
+    // Map the file into memory, so that the handlers can seek in it and read
+    // from it without any system calls or extra copying.
+    wxMappedFileInputStream stream(filename);
+    if ( stream.IsOk() && LoadFile(stream, mimetype, index) )
+        return true;
+#else // !wxUSE_FILE
     wxImageFileInputStream stream(filename);
     if ( stream.IsOk() )
     {
@@ -2612,6 +3653,7 @@ bool wxImage::LoadFile( const wxString& WXUNUSED_UNLESS_STREAMS(filename),
         if ( LoadFile(bstream, mimetype, index) )
             return true;
     }
+#endif // wxUSE_FILE/!wxUSE_FILE
 
     wxLogError(_("Failed to load image from file \"%s\"."), filename);
 #endif // HAS_FILE_STREAMS
@@ -2953,6 +3995,311 @@ bool wxImage::SaveFile( wxOutputStream& stream, const wxString& mimetype ) const
     return DoSave(*handler, stream);
 }
 
+// ----------------------------------------------------------------------------
+// wxImageBatchLoader
+// ----------------------------------------------------------------------------
+
+wxDEFINE_EVENT( wxEVT_IMAGE_BATCH_LOADED, wxImageBatchEvent );
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxImageBatchEvent, wxEvent);
+
+namespace
+{
+
+// A single image to load. Until m_done is set it is only used by the thread
+// loading it, and only by the thread using wxImageBatchLoader after this.
+struct ImageBatchJob
+{
+    ImageBatchJob(size_t index,
+                  const wxString& filename,
+                  wxInputStream *stream,
+                  wxBitmapType type)
+        : m_index(index),
+          m_filename(filename),
+          m_stream(stream),
+          m_type(type),
+          m_done(false),
+          m_cancelled(false)
+    {
+    }
+
+    ~ImageBatchJob() { delete m_stream; }
+
+    void Load()
+    {
+        bool ok;
+        if ( m_stream )
+            ok = m_image.LoadFile(*m_stream, m_type);
+        else
+            ok = !m_filename.empty() && m_image.LoadFile(m_filename, m_type);
+
+        if ( !ok )
+            m_image.Destroy();
+
+        wxDELETE(m_stream);
+    }
+
+    const size_t m_index;
+    const wxString m_filename;
+    wxInputStream *m_stream;
+    const wxBitmapType m_type;
+    wxImage m_image;
+
+    // these fields are protected by wxImageBatchLoaderImpl::m_doneMutex
+    bool m_done;
+    bool m_cancelled;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBatchJob);
+};
+
+} // anonymous namespace
+
+#if wxUSE_THREADS
+
+class wxImageBatchThread : public wxThread
+{
+public:
+    wxImageBatchThread(class wxImageBatchLoaderImpl& impl)
+        : wxThread(wxTHREAD_JOINABLE), m_impl(impl) { }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE;
+
+private:
+    class wxImageBatchLoaderImpl& m_impl;
+};
+
+#endif // wxUSE_THREADS
+
+class wxImageBatchLoaderImpl
+{
+public:
+    wxImageBatchLoaderImpl(wxEvtHandler *handler, int threads);
+    ~wxImageBatchLoaderImpl();
+
+    size_t Add(ImageBatchJob *job);
+
+    // loads the job unless it was cancelled and notifies about it, this can
+    // be called from any thread
+    void Process(ImageBatchJob *job);
+
+    void WaitUntilDone(ImageBatchJob *job);
+
+    wxEvtHandler * const m_handler;
+
+    // all the jobs in the order they were added in
+    wxVector<ImageBatchJob*> m_jobs;
+
+#if wxUSE_THREADS
+    // jobs waiting for a loader thread, NULL tells a thread to exit
+    wxMessageQueue<ImageBatchJob*> m_queue;
+    wxMutex m_doneMutex;
+    wxCondition m_doneCond;
+    wxVector<wxThread*> m_threads;
+#endif // wxUSE_THREADS
+};
+
+wxImageBatchLoaderImpl::wxImageBatchLoaderImpl(wxEvtHandler *handler,
+                                               int threads)
+  : m_handler(handler)
+#if wxUSE_THREADS
+    , m_doneCond(m_doneMutex)
+#endif // wxUSE_THREADS
+{
+#if wxUSE_THREADS
+    if ( threads <= 0 )
+        threads = wxThread::GetCPUCount();
+
+    // unlike elsewhere, even a single thread is useful here as it allows to
+    // load the images without blocking the calling thread
+    for ( int n = 0; n < wxMax(threads, 1); n++ )
+    {
+        wxThread *thread = new wxImageBatchThread(*this);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+#else
+    wxUnusedVar(threads);
+#endif // wxUSE_THREADS
+}
+
+wxImageBatchLoaderImpl::~wxImageBatchLoaderImpl()
+{
+#if wxUSE_THREADS
+    for ( size_t n = 0; n < m_threads.size(); n++ )
+        m_queue.Post(NULL);
+    for ( size_t n = 0; n < m_threads.size(); n++ )
+    {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+#endif // wxUSE_THREADS
+
+    for ( size_t n = 0; n < m_jobs.size(); n++ )
+        delete m_jobs[n];
+}
+
+size_t wxImageBatchLoaderImpl::Add(ImageBatchJob *job)
+{
+    m_jobs.push_back(job);
+
+#if wxUSE_THREADS
+    if ( !m_threads.empty() )
+    {
+        m_queue.Post(job);
+        return job->m_index;
+    }
+#endif // wxUSE_THREADS
+
+    Process(job);
+    return job->m_index;
+}
+
+void wxImageBatchLoaderImpl::Process(ImageBatchJob *job)
+{
+#if wxUSE_THREADS
+    bool cancelled;
+    {
+        wxMutexLocker lock(m_doneMutex);
+        cancelled = job->m_cancelled;
+    }
+
+    if ( !cancelled )
+        job->Load();
+
+    wxMutexLocker lock(m_doneMutex);
+
+    // the event shares the image data with the job, so it must be created
+    // before the job becomes accessible to the other threads, and it is
+    // queued before marking the job as done to ensure that the events for
+    // all the images are already pending when Wait() returns
+    if ( m_handler && !job->m_cancelled )
+    {
+        wxQueueEvent(m_handler,
+                     new wxImageBatchEvent(wxEVT_IMAGE_BATCH_LOADED,
+                                           job->m_index, job->m_image));
+    }
+
+    job->m_done = true;
+    m_doneCond.Broadcast();
+#else // !wxUSE_THREADS
+    job->Load();
+    job->m_done = true;
+
+    if ( m_handler )
+    {
+        wxQueueEvent(m_handler,
+                     new wxImageBatchEvent(wxEVT_IMAGE_BATCH_LOADED,
+                                           job->m_index, job->m_image));
+    }
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+void wxImageBatchLoaderImpl::WaitUntilDone(ImageBatchJob *job)
+{
+#if wxUSE_THREADS
+    wxMutexLocker lock(m_doneMutex);
+    while ( !job->m_done )
+        m_doneCond.Wait();
+#else
+    wxUnusedVar(job);
+#endif // wxUSE_THREADS
+}
+
+#if wxUSE_THREADS
+
+wxThread::ExitCode wxImageBatchThread::Entry()
+{
+    ImageBatchJob *job;
+
+    while ( m_impl.m_queue.Receive(job) == wxMSGQUEUE_NO_ERROR && job )
+        m_impl.Process(job);
+
+    return 0;
+}
+
+#endif // wxUSE_THREADS
+
+wxImageBatchLoader::wxImageBatchLoader(wxEvtHandler *handler, int threads)
+  : m_impl(new wxImageBatchLoaderImpl(handler, threads))
+{
+}
+
+wxImageBatchLoader::~wxImageBatchLoader()
+{
+    Cancel();
+    delete m_impl;
+}
+
+size_t wxImageBatchLoader::Add(const wxString& filename, wxBitmapType type)
+{
+    return m_impl->Add(new ImageBatchJob(m_impl->m_jobs.size(),
+                                         filename, NULL, type));
+}
+
+size_t wxImageBatchLoader::Add(wxInputStream *stream, wxBitmapType type)
+{
+    wxASSERT_MSG( stream, wxT("NULL stream") );
+
+    return m_impl->Add(new ImageBatchJob(m_impl->m_jobs.size(),
+                                         wxString(), stream, type));
+}
+
+size_t wxImageBatchLoader::GetCount() const
+{
+    return m_impl->m_jobs.size();
+}
+
+bool wxImageBatchLoader::IsDone(size_t n) const
+{
+    wxCHECK_MSG( n < m_impl->m_jobs.size(), false, wxT("invalid index") );
+
+#if wxUSE_THREADS
+    wxMutexLocker lock(m_impl->m_doneMutex);
+#endif // wxUSE_THREADS
+
+    return m_impl->m_jobs[n]->m_done;
+}
+
+wxImage wxImageBatchLoader::GetImage(size_t n)
+{
+    wxCHECK_MSG( n < m_impl->m_jobs.size(), wxNullImage, wxT("invalid index") );
+
+    ImageBatchJob * const job = m_impl->m_jobs[n];
+    m_impl->WaitUntilDone(job);
+
+    return job->m_image;
+}
+
+void wxImageBatchLoader::Wait()
+{
+    for ( size_t n = 0; n < m_impl->m_jobs.size(); n++ )
+        m_impl->WaitUntilDone(m_impl->m_jobs[n]);
+}
+
+void wxImageBatchLoader::Cancel()
+{
+#if wxUSE_THREADS
+    wxMutexLocker lock(m_impl->m_doneMutex);
+
+    for ( size_t n = 0; n < m_impl->m_jobs.size(); n++ )
+        m_impl->m_jobs[n]->m_cancelled = true;
+#endif // wxUSE_THREADS
+}
+
+int wxImageBatchLoader::GetThreadCount() const
+{
+#if wxUSE_THREADS
+    return m_impl->m_threads.size();
+#else
+    return 0;
+#endif // wxUSE_THREADS
+}
+
 #endif // wxUSE_STREAMS
 
 // ----------------------------------------------------------------------------
@@ -3240,36 +4587,117 @@ void wxImage::RotateHue(double angle)
 {
     AllocExclusive();
 
-    unsigned long count;
-    wxImage::HSVValue hsv;
-    wxImage::RGBValue rgb;
-
     wxASSERT (angle >= -1.0 && angle <= 1.0);
-    count = M_IMGDATA->m_width * M_IMGDATA->m_height;
-    if ( count > 0 && !wxIsNullDouble(angle) )
-    {
-        unsigned char* srcBytePtr;
-        unsigned char* dstBytePtr;
-        srcBytePtr = M_IMGDATA->m_data;
-        dstBytePtr = srcBytePtr;
-        do
+    size_t count = size_t(M_IMGDATA->m_width) * M_IMGDATA->m_height;
+    if ( count == 0 || wxIsNullDouble(angle) )
+        return;
+
+    // This does the same thing as converting each pixel to HSV using
+    // RGBtoHSV(), rotating its hue and converting it back using HSVtoRGB(),
+    // but uses fixed point arithmetic instead. The hue is represented as a
+    // number in [0, 6) range, with the integer part being the sector of the
+    // colour hexagon, and the value and saturation are not needed at all as
+    // the rotation doesn't change the maximum and minimum colour components.
+    enum
+    {
+        HUE_SHIFT = 20,
+        HUE_ONE = 1 << HUE_SHIFT,
+        HUE_MAX = 6 * HUE_ONE
+    };
+
+    int rotation = wxRound(angle * HUE_MAX) % HUE_MAX;
+    if ( rotation < 0 )
+        rotation += HUE_MAX;
+
+    unsigned char* data = M_IMGDATA->m_data;
+    for ( ; count; count--, data += 3 )
+    {
+        const int r = data[0],
+                  g = data[1],
+                  b = data[2];
+
+        int max, min, hue;
+        if ( b > r && b > g )
+        {
+            max = b;
+            min = wxMin(r, g);
+            hue = 4*(max - min) + r - g;
+        }
+        else if ( g > r )
+        {
+            max = g;
+            min = wxMin(r, b);
+            hue = 2*(max - min) + b - r;
+        }
+        else
+        {
+            max = r;
+            min = wxMin(g, b);
+            hue = g - b;
+        }
+
+        const int delta = max - min;
+        if ( !delta )
+        {
+            // grey pixels have no hue and so are not affected
+            continue;
+        }
+
+        if ( hue < 0 )
+            hue += 6*delta;
+
+        hue = static_cast<int>(((wxInt64(hue) << HUE_SHIFT) + delta / 2) / delta)
+                + rotation;
+        if ( hue >= HUE_MAX )
+            hue -= HUE_MAX;
+
+        // the components which change linearly inside the sector: they are
+        // rounded to the nearest value, which ensures that the colours are
+        // preserved exactly when rotating by the full circle, as the error of
+        // the fixed point hue is much less than 1/2 after multiplying it by
+        // delta which is at most 255
+        const int f = (delta * (hue & (HUE_ONE - 1)) + HUE_ONE / 2) >> HUE_SHIFT;
+        const int rising = min + f;
+        const int falling = max - f;
+
+        switch ( hue >> HUE_SHIFT )
         {
-            rgb.red = *srcBytePtr++;
-            rgb.green = *srcBytePtr++;
-            rgb.blue = *srcBytePtr++;
-            hsv = RGBtoHSV(rgb);
+            case 0:
+                data[0] = max;
+                data[1] = rising;
+                data[2] = min;
+                break;
+
+            case 1:
+                data[0] = falling;
+                data[1] = max;
+                data[2] = min;
+                break;
+
+            case 2:
+                data[0] = min;
+                data[1] = max;
+                data[2] = rising;
+                break;
+
+            case 3:
+                data[0] = min;
+                data[1] = falling;
+                data[2] = max;
+                break;
 
-            hsv.hue = hsv.hue + angle;
-            if (hsv.hue > 1.0)
-                hsv.hue = hsv.hue - 1.0;
-            else if (hsv.hue < 0.0)
-                hsv.hue = hsv.hue + 1.0;
+            case 4:
+                data[0] = rising;
+                data[1] = min;
+                data[2] = max;
+                break;
 
-            rgb = HSVtoRGB(hsv);
-            *dstBytePtr++ = rgb.red;
-            *dstBytePtr++ = rgb.green;
-            *dstBytePtr++ = rgb.blue;
-        } while (--count != 0);
+            default:
+                data[0] = max;
+                data[1] = min;
+                data[2] = falling;
+                break;
+        }
     }
 }
 
@@ -3381,6 +4809,206 @@ wxImageHandler::GetResolutionFromOptions(const wxImage& image, int *x, int *y)
 // image histogram stuff
 // ----------------------------------------------------------------------------
 
+namespace
+{
+
+// Counting the colours of the images with fewer pixels than this using the
+// hash map is faster than allocating the tables used for the bigger ones.
+const unsigned long MIN_PIXELS_FOR_DENSE_HISTOGRAM = 16*1024;
+
+// Histogram of a part of the image.
+//
+// Inserting every pixel into wxImageHistogram, which allocates a node for each
+// new colour and looks up the bucket using a division, is slow, so the colours
+// are counted using a flat table with open addressing and linear probing
+// instead and each of them is inserted into wxImageHistogram only once.
+class DenseHistogram
+{
+public:
+    DenseHistogram()
+        : m_slots(INITIAL_SLOTS_COUNT),
+          m_shift(32 - INITIAL_SLOTS_BITS)
+    {
+    }
+
+    // Add all pixels in the given range of RGB data.
+    void AddPixels(const unsigned char* p, const unsigned char* end);
+
+    // Merge this histogram into the given one, assigning the indices to the
+    // colours not present in it yet in the order of their first occurrence.
+    void MergeInto(wxImageHistogram& h, unsigned long& nentries) const;
+
+private:
+    enum
+    {
+        INITIAL_SLOTS_BITS = 12,
+        INITIAL_SLOTS_COUNT = 1 << INITIAL_SLOTS_BITS
+    };
+
+    // Key of the unused slots, which can't be a valid colour.
+    static const wxUint32 EMPTY_KEY = 0xffffffff;
+
+    struct Slot
+    {
+        Slot() : key(EMPTY_KEY), index(0) { }
+
+        wxUint32 key;
+        wxUint32 index;     // in m_keys and m_values
+    };
+
+    // Return the slot for the given key, which is either used by this key or
+    // the empty slot where it should be stored.
+    Slot& FindSlot(wxUint32 key)
+    {
+        const size_t mask = m_slots.size() - 1;
+        for ( size_t n = static_cast<wxUint32>(key * 2654435761u) >> m_shift; ;
+              n = (n + 1) & mask )
+        {
+            Slot& slot = m_slots[n];
+            if ( slot.key == key || slot.key == EMPTY_KEY )
+                return slot;
+        }
+    }
+
+    // Add the given number of pixels of the colour with the given key.
+    void Add(wxUint32 key, unsigned long count)
+    {
+        Slot& slot = FindSlot(key);
+        if ( slot.key == key )
+        {
+            m_values[slot.index] += count;
+            return;
+        }
+
+        slot.key = key;
+        slot.index = static_cast<wxUint32>(m_keys.size());
+        m_keys.push_back(key);
+        m_values.push_back(count);
+
+        // Keep the table at most half full for the probe sequences to remain
+        // short.
+        if ( 2*m_keys.size() > m_slots.size() )
+            Grow();
+    }
+
+    // Double the size of the table.
+    void Grow();
+
+    wxVector<Slot> m_slots;
+
+    // Shift giving the index of the slot from the key hash.
+    int m_shift;
+
+    // Colours in the order of their first occurrence and their counts.
+    wxVector<wxUint32> m_keys;
+    wxVector<unsigned long> m_values;
+};
+
+void DenseHistogram::Grow()
+{
+    const size_t count = 2*m_slots.size();
+    m_slots.clear();
+    m_slots.resize(count);
+    m_shift--;
+
+    for ( size_t n = 0; n < m_keys.size(); n++ )
+    {
+        Slot& slot = FindSlot(m_keys[n]);
+        slot.key = m_keys[n];
+        slot.index = static_cast<wxUint32>(n);
+    }
+}
+
+void DenseHistogram::AddPixels(const unsigned char* p, const unsigned char* end)
+{
+    if ( p == end )
+        return;
+
+    // Count the runs of pixels of the same colour, which are very common in
+    // the images with few colours, all at once.
+    wxUint32 key = wxImageHistogram::MakeKey(p[0], p[1], p[2]);
+    unsigned long count = 1;
+    for ( p += 3; p < end; p += 3 )
+    {
+        const wxUint32 next = wxImageHistogram::MakeKey(p[0], p[1], p[2]);
+        if ( next == key )
+        {
+            count++;
+            continue;
+        }
+
+        Add(key, count);
+        key = next;
+        count = 1;
+    }
+
+    Add(key, count);
+}
+
+void DenseHistogram::MergeInto(wxImageHistogram& h, unsigned long& nentries) const
+{
+    for ( size_t n = 0; n < m_keys.size(); n++ )
+    {
+        wxImageHistogramEntry& entry = h[m_keys[n]];
+        if ( !entry.value )
+            entry.index = nentries++;
+        entry.value += m_values[n];
+    }
+}
+
+// Computes the histograms of the bands of rows of the image in parallel.
+class HistogramProcessor : public BandsProcessor
+{
+public:
+    explicit HistogramProcessor(const wxImage& image)
+        : m_image(image),
+          m_histograms(image.GetHeight())
+    {
+    }
+
+    virtual ~HistogramProcessor()
+    {
+        for ( size_t n = 0; n < m_histograms.size(); n++ )
+            delete m_histograms[n];
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        const size_t stride = 3*static_cast<size_t>(m_image.GetWidth());
+        const unsigned char* const data = m_image.GetData();
+
+        DenseHistogram* const histogram = new DenseHistogram;
+        histogram->AddPixels(data + start*stride, data + end*stride);
+
+        // All bands start at different rows, so different threads never
+        // modify the same element of this vector.
+        m_histograms[start] = histogram;
+    }
+
+    // Merge the histograms of all bands, in order, into the given one.
+    unsigned long MergeInto(wxImageHistogram& h) const
+    {
+        unsigned long nentries = 0;
+        for ( size_t n = 0; n < m_histograms.size(); n++ )
+        {
+            if ( m_histograms[n] )
+                m_histograms[n]->MergeInto(h, nentries);
+        }
+
+        return nentries;
+    }
+
+private:
+    const wxImage& m_image;
+
+    // Histograms of the bands indexed by their first row.
+    wxVector<DenseHistogram*> m_histograms;
+
+    wxDECLARE_NO_COPY_CLASS(HistogramProcessor);
+};
+
+} // anonymous namespace
+
 bool
 wxImageHistogram::FindFirstUnusedColour(unsigned char *r,
                                         unsigned char *g,
@@ -3450,6 +5078,38 @@ wxImage::FindFirstUnusedColour(unsigned char *r,
 //
 unsigned long wxImage::CountColours( unsigned long stopafter ) const
 {
+    const unsigned long pixels = static_cast<unsigned long>(GetWidth()) * GetHeight();
+    if ( pixels >= MIN_PIXELS_FOR_DENSE_HISTOGRAM )
+    {
+        // Use a set of bits, one for each possible colour, which takes 2MB
+        // but is much faster than the hash table for the big images.
+        wxVector<wxUint32> used(1 << 19);
+
+        const unsigned char* p = GetData();
+        unsigned long nentries = 0;
+        unsigned long prev = (unsigned long)-1;
+        for ( unsigned long j = 0; (j < pixels) && (nentries <= stopafter); j++ )
+        {
+            const unsigned long key = wxImageHistogram::MakeKey(p[0], p[1], p[2]);
+            p += 3;
+
+            // Skip the test for the runs of pixels of the same colour.
+            if ( key == prev )
+                continue;
+            prev = key;
+
+            wxUint32& word = used[key >> 5];
+            const wxUint32 bit = 1u << (key & 31);
+            if ( !(word & bit) )
+            {
+                word |= bit;
+                nentries++;
+            }
+        }
+
+        return nentries;
+    }
+
     wxHashTable h;
     wxObject dummy;
     unsigned char *p;
@@ -3487,6 +5147,12 @@ unsigned long wxImage::ComputeHistogram( wxImageHistogram &h ) const
     h.clear();
 
     const unsigned long size = static_cast<unsigned long>(GetWidth()) * GetHeight();
+    if ( size >= MIN_PIXELS_FOR_DENSE_HISTOGRAM )
+    {
+        HistogramProcessor processor(*this);
+        processor.ProcessAll(GetHeight(), size);
+        return processor.MergeInto(h);
+    }
 
     for ( unsigned long n = 0; n < size; n++ )
     {
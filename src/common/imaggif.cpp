@@ -27,6 +27,7 @@
 #include "wx/stream.h"
 #include "wx/anidecod.h" // wxImageArray
 #include "wx/scopedarray.h"
+#include "wx/thread.h"
 
 #define GIF89_HDR     "GIF89a"
 #define NETSCAPE_LOOP "NETSCAPE2.0"
@@ -117,7 +118,9 @@ static bool wxGIFHandler_BufferedOutput(wxOutputStream *, wxUint8 *buf, int c);
 bool wxGIFHandler::LoadFile(wxImage *image, wxInputStream& stream,
     bool verbose, int index)
 {
+    // only decode the frame we need
     wxGIFDecoder decod;
+    decod.SetDecodeOnDemand();
     switch ( decod.LoadGIF(stream) )
     {
         case wxGIF_OK:
@@ -141,7 +144,14 @@ bool wxGIFHandler::LoadFile(wxImage *image, wxInputStream& stream,
             break;
     }
 
-    return decod.ConvertToImage(index != -1 ? (size_t)index : 0, image);
+    if ( !decod.ConvertToImage(index != -1 ? (size_t)index : 0, image) )
+    {
+        if ( verbose )
+            wxLogError(_("GIF: error in GIF image format."));
+        return false;
+    }
+
+    return true;
 }
 
 bool wxGIFHandler::SaveFile(wxImage *image,
@@ -173,7 +183,9 @@ bool wxGIFHandler::DoCanRead( wxInputStream& stream )
 
 int wxGIFHandler::DoGetImageCount( wxInputStream& stream )
 {
+    // there is no need to decode the frames just to count them
     wxGIFDecoder decod;
+    decod.SetDecodeOnDemand();
     wxGIFErrorCode error = decod.LoadGIF(stream);
     if ( (error != wxGIF_OK) && (error != wxGIF_TRUNCATED) )
         return -1;
@@ -239,6 +251,10 @@ bool wxGIFHandler::DoSaveFile(const wxImage& image, wxOutputStream *stream,
         return false;
     }
 
+    // The LZW encoder state lives in the handler object, which is shared by
+    // all the threads saving GIF images, so only one of them may use it.
+    wxCRITICAL_SECTION(GIFEncoder);
+
     if (!InitHashTable())
     {
         wxLogError(_("Couldn't initialize GIF hash table."));
@@ -75,7 +75,7 @@ wxIMPLEMENT_DYNAMIC_CLASS(wxJPEGHandler,wxImageHandler);
 
 //------------- JPEG Data Source Manager
 
-#define JPEG_IO_BUFFER_SIZE   2048
+#define JPEG_IO_BUFFER_SIZE   16384
 
 typedef struct {
     struct jpeg_source_mgr pub;   /* public fields */
@@ -242,6 +242,7 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     // save this before calling Destroy()
     const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
                    maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    const bool fastDecode = image->GetOptionInt(wxIMAGE_OPTION_JPEG_FAST_DECODE) != 0;
     image->Destroy();
 
     cinfo.err = jpeg_std_error( &jerr );
@@ -292,6 +293,14 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         }
     }
 
+    if ( fastDecode )
+    {
+        // trade some quality for speed: this is mostly useful for thumbnails
+        // for which the difference is not noticeable anyhow
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+
     jpeg_start_decompress( &cinfo );
 
     image->Create( cinfo.output_width, cinfo.output_height );
@@ -303,26 +312,47 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     image->SetMask( false );
     ptr = image->GetData();
 
+    // read as many rows at once as the library can return, this is more
+    // efficient than reading them one by one
+    JSAMPROW rows[4];
+    int rowsAtOnce = cinfo.rec_outbuf_height;
+    if ( rowsAtOnce > (int)WXSIZEOF(rows) )
+        rowsAtOnce = WXSIZEOF(rows);
+
     unsigned stride = cinfo.output_width * bytesPerPixel;
-    JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
-                            ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
 
-    while ( cinfo.output_scanline < cinfo.output_height )
+    if (cinfo.out_color_space == JCS_RGB)
     {
-        jpeg_read_scanlines( &cinfo, tempbuf, 1 );
-        if (cinfo.out_color_space == JCS_RGB)
+        // decode directly into the image data
+        while ( cinfo.output_scanline < cinfo.output_height )
         {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
+            JDIMENSION count = cinfo.output_height - cinfo.output_scanline;
+            if ( count > (JDIMENSION)rowsAtOnce )
+                count = rowsAtOnce;
+
+            for ( JDIMENSION n = 0; n < count; n++ )
+                rows[n] = ptr + n*stride;
+
+            ptr += jpeg_read_scanlines( &cinfo, rows, count ) * stride;
         }
-        else // CMYK
+    }
+    else // CMYK
+    {
+        JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
+                                ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, rowsAtOnce );
+
+        while ( cinfo.output_scanline < cinfo.output_height )
         {
-            const unsigned char* inptr = (const unsigned char*) tempbuf[0];
-            for (size_t i = 0; i < cinfo.output_width; i++)
+            const JDIMENSION count = jpeg_read_scanlines( &cinfo, tempbuf, rowsAtOnce );
+            for ( JDIMENSION n = 0; n < count; n++ )
             {
-                wx_cmyk_to_rgb(ptr, inptr);
-                ptr += 3;
-                inptr += 4;
+                const unsigned char* inptr = (const unsigned char*) tempbuf[n];
+                for (size_t i = 0; i < cinfo.output_width; i++)
+                {
+                    wx_cmyk_to_rgb(ptr, inptr);
+                    ptr += 3;
+                    inptr += 4;
+                }
             }
         }
     }
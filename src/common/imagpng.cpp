@@ -244,42 +244,59 @@ bool wxPNGHandler::DoCanRead( wxInputStream& stream )
     return memcmp(hdr, "\211PNG", WXSIZEOF(hdr)) == 0;
 }
 
-// convert data from RGB to wxImage format
+// convert a row of RGBA data to wxImage format, the alpha channel is only
+// allocated when the first non-opaque pixel is found and alpha is then updated
+// to point to the alpha value of the next pixel
 static
-void CopyDataFromPNG(wxImage *image,
-                     unsigned char **lines,
-                     png_uint_32 width,
-                     png_uint_32 height)
+void CopyRowFromPNG(wxImage *image,
+                    const unsigned char *ptrSrc,
+                    png_uint_32 width,
+                    png_uint_32 y,
+                    unsigned char *&alpha)
 {
-    // allocated on demand if we have any non-opaque pixels
-    unsigned char *alpha = NULL;
+    unsigned char *ptrDst = image->GetData() + 3*static_cast<size_t>(width)*y;
 
-    unsigned char *ptrDst = image->GetData();
+    png_uint_32 x = 0;
+    if ( !alpha )
     {
-        for ( png_uint_32 y = 0; y < height; y++ )
+        for ( ; x < width; x++ )
         {
-            const unsigned char *ptrSrc = lines[y];
-            for ( png_uint_32 x = 0; x < width; x++ )
+            // the first time we encounter a transparent pixel we must
+            // allocate alpha channel for the image
+            if ( !IsOpaque(ptrSrc[3]) )
             {
-                unsigned char r = *ptrSrc++;
-                unsigned char g = *ptrSrc++;
-                unsigned char b = *ptrSrc++;
-                unsigned char a = *ptrSrc++;
-
-                // the first time we encounter a transparent pixel we must
-                // allocate alpha channel for the image
-                if ( !IsOpaque(a) && !alpha )
-                    alpha = InitAlpha(image, x, y);
-
-                if ( alpha )
-                    *alpha++ = a;
-
-                *ptrDst++ = r;
-                *ptrDst++ = g;
-                *ptrDst++ = b;
+                alpha = InitAlpha(image, x, y);
+                break;
             }
+
+            *ptrDst++ = *ptrSrc++;
+            *ptrDst++ = *ptrSrc++;
+            *ptrDst++ = *ptrSrc++;
+            ptrSrc++;
         }
     }
+
+    for ( ; x < width; x++ )
+    {
+        *ptrDst++ = *ptrSrc++;
+        *ptrDst++ = *ptrSrc++;
+        *ptrDst++ = *ptrSrc++;
+        *alpha++ = *ptrSrc++;
+    }
+}
+
+// convert data from RGBA to wxImage format
+static
+void CopyDataFromPNG(wxImage *image,
+                     unsigned char **lines,
+                     png_uint_32 width,
+                     png_uint_32 height)
+{
+    // allocated on demand if we have any non-opaque pixels
+    unsigned char *alpha = NULL;
+
+    for ( png_uint_32 y = 0; y < height; y++ )
+        CopyRowFromPNG(image, lines[y], width, y, alpha);
 }
 
 // temporarily disable the warning C4611 (interaction between '_setjmp' and
@@ -297,7 +314,7 @@ void
 wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 {
     png_uint_32 width, height = 0;
-    int bit_depth, color_type;
+    int bit_depth, color_type, interlace_type;
 
     image->Destroy();
 
@@ -323,7 +340,8 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
         return;
 
     png_read_info( png_ptr, info_ptr );
-    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, NULL, NULL, NULL );
+    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+                  &interlace_type, NULL, NULL );
 
     png_set_expand(png_ptr);
     png_set_gray_to_rgb(png_ptr);
@@ -339,10 +357,48 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
         (color_type & PNG_COLOR_MASK_ALPHA) ||
         png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
-    if (!Alloc(width, height, needCopy ? NULL : image->GetData()))
-        return;
+    if ( interlace_type == PNG_INTERLACE_NONE )
+    {
+        // read the rows one by one directly into the image data, without
+        // allocating any buffer for the entire image, which matters for
+        // the huge ones
+        unsigned char *ptr = image->GetData();
+        if ( needCopy )
+        {
+            m_buf = static_cast<unsigned char*>(malloc(width * 4));
+            if ( !m_buf )
+                return;
+        }
+
+        // allocated on demand if we have any non-opaque pixels
+        unsigned char *alpha = NULL;
+
+        for ( png_uint_32 y = 0; y < height; y++ )
+        {
+            if ( needCopy )
+            {
+                png_read_row( png_ptr, m_buf, NULL );
+                CopyRowFromPNG(image, m_buf, width, y, alpha);
+            }
+            else
+            {
+                png_read_row( png_ptr, ptr, NULL );
+                ptr += 3 * width;
+            }
+        }
+    }
+    else // interlaced
+    {
+        // we need to have all the rows in memory to combine the passes
+        if (!Alloc(width, height, needCopy ? NULL : image->GetData()))
+            return;
+
+        png_read_image( png_ptr, lines );
+
+        if (needCopy)
+            CopyDataFromPNG(image, lines, width, height);
+    }
 
-    png_read_image( png_ptr, lines );
     png_read_end( png_ptr, info_ptr );
 
 #if wxUSE_PALETTE
@@ -412,10 +468,6 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     }
 
 
-    // loaded successfully, now init wxImage with this data
-    if (needCopy)
-        CopyDataFromPNG(image, lines, width, height);
-
     // This will indicate to the caller that loading succeeded.
     ok = true;
 }
@@ -662,7 +714,21 @@ bool wxPNGHandler::SaveFile( wxImage *image, wxOutputStream& stream, bool verbos
     }
 
     if (image->HasOption(wxIMAGE_OPTION_PNG_FILTER))
+    {
         png_set_filter( png_ptr, PNG_FILTER_TYPE_BASE, image->GetOptionInt(wxIMAGE_OPTION_PNG_FILTER) );
+    }
+    else if (image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL))
+    {
+        // when speed is preferred to size, don't waste time on trying all the
+        // filters for each row to select the best one: filtering is useless
+        // without compression and a single filter gives almost the same
+        // results with the fast compression levels in much less time
+        const int level = image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL);
+        if ( level == 0 )
+            png_set_filter( png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE );
+        else if ( level <= 3 )
+            png_set_filter( png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_UP );
+    }
 
     if (image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL))
         png_set_compression_level( png_ptr, image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL) );
@@ -755,8 +821,39 @@ bool wxPNGHandler::SaveFile( wxImage *image, wxOutputStream& stream, bool verbos
 
     const unsigned char *pColors = image->GetData();
 
+    // the most common case of saving 8 bit RGB or RGBA data doesn't need the
+    // generic per-pixel conversion below
+    const bool isRGB8 = iColorType == wxPNG_TYPE_COLOUR && iBitDepth == 8 &&
+                            !bHasMask;
+
     for (int y = 0; y != iHeight; ++y)
     {
+        if ( isRGB8 )
+        {
+            png_bytep row_ptr;
+            if ( pAlpha )
+            {
+                unsigned char *pData = data;
+                for (int x = 0; x != iWidth; x++)
+                {
+                    *pData++ = *pColors++;
+                    *pData++ = *pColors++;
+                    *pData++ = *pColors++;
+                    *pData++ = *pAlpha++;
+                }
+
+                row_ptr = data;
+            }
+            else // the image data can be used directly
+            {
+                row_ptr = const_cast<png_bytep>(pColors);
+                pColors += 3 * iWidth;
+            }
+
+            png_write_rows( png_ptr, &row_ptr, 1 );
+            continue;
+        }
+
         unsigned char *pData = data;
         for (int x = 0; x != iWidth; x++)
         {
@@ -32,6 +32,7 @@
     #include "wx/intl.h"
     #include "wx/bitmap.h"
     #include "wx/module.h"
+    #include "wx/utils.h"
     #include "wx/wxcrtvararg.h"
 #endif
 
@@ -43,6 +44,8 @@ extern "C"
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include <limits.h>
+
 #ifndef TIFFLINKAGEMODE
     #define TIFFLINKAGEMODE LINKAGEMODE
 #endif
@@ -285,216 +288,458 @@ TIFFwxOpen(wxOutputStream &stream, const char* name, const char* mode)
     return tif;
 }
 
-bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
-{
-    if (index == -1)
-        index = 0;
-
-    image->Destroy();
-
-    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
+// ----------------------------------------------------------------------------
+// Reading TIFF images directly into wxImage
+// ----------------------------------------------------------------------------
 
-    if (!tif)
-    {
-        if (verbose)
-        {
-            wxLogError( _("TIFF: Error loading image.") );
-        }
+namespace
+{
 
-        return false;
-    }
+// The bands of rows read at once consist of whole strips or rows of tiles, as
+// libtiff decodes them entirely anyhow, but if they're very small, several of
+// them are combined together until the band buffer reaches this size.
+const size_t TIFF_BAND_BUFFER_SIZE = 1024*1024;
 
-    if (!TIFFSetDirectory( tif, (tdir_t)index ))
-    {
-        if (verbose)
-        {
-            wxLogError( _("Invalid TIFF image index.") );
-        }
+// Parameters of the current directory needed for reading it.
+struct TIFFDirInfo
+{
+    explicit TIFFDirInfo(TIFF* tif);
 
-        TIFFClose( tif );
+    uint32 width,
+           height;
 
-        return false;
-    }
+    uint16 samplesPerPixel,
+           bitsPerSample,
+           extraSamples,
+           photometric,
+           planarConfig;
 
-    uint32 w, h;
-    uint32 *raster;
+    bool hasAlpha;
+};
 
-    TIFFGetField( tif, TIFFTAG_IMAGEWIDTH, &w );
-    TIFFGetField( tif, TIFFTAG_IMAGELENGTH, &h );
+TIFFDirInfo::TIFFDirInfo(TIFF* tif)
+{
+    width =
+    height = 0;
+    TIFFGetField( tif, TIFFTAG_IMAGEWIDTH, &width );
+    TIFFGetField( tif, TIFFTAG_IMAGELENGTH, &height );
 
-    uint16 samplesPerPixel = 0;
+    samplesPerPixel = 0;
     (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
 
-    uint16 bitsPerSample = 0;
+    bitsPerSample = 0;
     (void) TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
 
-    uint16 extraSamples;
     uint16* samplesInfo;
     TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
                           &extraSamples, &samplesInfo);
 
-    uint16 photometric;
     if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
     {
         photometric = PHOTOMETRIC_MINISWHITE;
     }
-    const bool hasAlpha = (extraSamples >= 1
+
+    planarConfig = PLANARCONFIG_CONTIG;
+    (void) TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+
+    hasAlpha = (extraSamples >= 1
         && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
             || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
             || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
         || (extraSamples == 0 && samplesPerPixel == 4
             && photometric == PHOTOMETRIC_RGB);
+}
+
+// Read grey or black and white images with alpha, which libtiff doesn't
+// handle correctly, line by line.
+bool
+ReadTIFFGreyAlphaRegion(TIFF* tif,
+                        const TIFFDirInfo& info,
+                        const wxRect& rect,
+                        wxImage* image,
+                        wxTIFFReadNotifier* notifier)
+{
+    unsigned char *buf = (unsigned char *)_TIFFmalloc(TIFFScanlineSize(tif));
+    if ( !buf )
+        return false;
+
+    const bool isGreyScale = (info.bitsPerSample == 8);
+    const bool minIsWhite = (info.photometric == PHOTOMETRIC_MINISWHITE);
+    const int minValue =  minIsWhite ? 255 : 0;
+    const int maxValue = 255 - minValue;
 
-    // guard against integer overflow during multiplication which could result
-    // in allocating a too small buffer and then overflowing it
-    const double bytesNeeded = (double)w * (double)h * sizeof(uint32);
-    if ( bytesNeeded >= wxUINT32_MAX )
+    unsigned char *ptr = image->GetData();
+    unsigned char *alpha = image->GetAlpha();
+
+    // Most compression schemes don't support starting decoding in the middle
+    // of the strip, so start from the beginning of the strip containing the
+    // first row and skip the rows before it.
+    uint32 rowsPerStrip = info.height;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+    if ( !rowsPerStrip )
+        rowsPerStrip = info.height;
+
+    bool ok = true;
+    for ( uint32 row = rect.y / rowsPerStrip * rowsPerStrip; row < (uint32)rect.y; row++ )
     {
-        if ( verbose )
+        if (TIFFReadScanline(tif, buf, row, 0) != 1)
         {
-            wxLogError( _("TIFF: Image size is abnormally big.") );
+            ok = false;
+            break;
         }
+    }
 
-        TIFFClose(tif);
+    for ( int y = 0; ok && y < rect.height; ++y )
+    {
+        if (TIFFReadScanline(tif, buf, (uint32)(rect.y + y), 0) != 1)
+        {
+            ok = false;
+            break;
+        }
 
-        return false;
-    }
+        for ( int x = rect.x; x < rect.x + rect.width; ++x )
+        {
+            uint8 val, a;
+            if (isGreyScale)
+            {
+                val = minIsWhite ? 255 - buf[x*2] : buf[x*2];
+                a = minIsWhite ? 255 - buf[x*2+1] : buf[x*2+1];
+            }
+            else
+            {
+                int mask = buf[x*2/8] << ((x*2)%8);
 
-    raster = (uint32*) _TIFFmalloc( (uint32)bytesNeeded );
+                val = mask & 128 ? maxValue : minValue;
+                a = mask & 64 ? maxValue : minValue;
+            }
 
-    if (!raster)
-    {
-        if (verbose)
+            *(ptr++) = val;
+            *(ptr++) = val;
+            *(ptr++) = val;
+            if ( alpha )
+                *(alpha++) = a;
+        }
+
+        if ( notifier && !notifier->OnProgress(y + 1, rect.height) )
         {
-            wxLogError( _("TIFF: Couldn't allocate memory.") );
+            ok = false;
+            break;
         }
+    }
 
-        TIFFClose( tif );
+    _TIFFfree(buf);
+
+    return ok;
+}
 
+// Read all the other images using libtiff RGBA interface, by bands of rows
+// aligned on the strip or tile boundaries.
+bool
+ReadTIFFRGBARegion(TIFF* tif,
+                   const TIFFDirInfo& info,
+                   const wxRect& rect,
+                   wxImage* image,
+                   wxTIFFReadNotifier* notifier)
+{
+    char msg[1024] = "";
+    TIFFRGBAImage img;
+    if ( !TIFFRGBAImageBegin(&img, tif, 0, msg) )
         return false;
+
+    // The rectangle is in the coordinates of the image as it's displayed,
+    // but libtiff offsets are in the coordinates of the stored image, so
+    // they need to be mirrored for the images which libtiff flips.
+    img.req_orientation = ORIENTATION_TOPLEFT;
+
+    bool flipH = false,
+         flipV = false;
+    switch ( img.orientation )
+    {
+        case ORIENTATION_TOPRIGHT:
+        case ORIENTATION_RIGHTTOP:
+            flipH = true;
+            break;
+
+        case ORIENTATION_BOTRIGHT:
+        case ORIENTATION_RIGHTBOT:
+            flipH =
+            flipV = true;
+            break;
+
+        case ORIENTATION_BOTLEFT:
+        case ORIENTATION_LEFTBOT:
+            flipV = true;
+            break;
     }
 
-    image->Create( (int)w, (int)h );
-    if (!image->IsOk())
+    const uint32 w = info.width,
+                 h = info.height;
+
+    // Decoding starting in the middle of a strip or tile doesn't work for all
+    // formats (e.g. subsampled YCbCr), so always read entire blocks: strips
+    // always span the full image width while tiles are read by whole columns.
+    uint32 blockWidth = w,
+           blockHeight = h;
+    if ( TIFFIsTiled(tif) )
     {
-        if (verbose)
+        TIFFGetField(tif, TIFFTAG_TILEWIDTH, &blockWidth);
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &blockHeight);
+    }
+    else
+    {
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &blockHeight);
+    }
+
+    if ( !blockWidth || blockWidth > w )
+        blockWidth = w;
+    if ( !blockHeight || blockHeight > h )
+        blockHeight = h;
+
+    const uint32 left = flipH ? w - (rect.x + rect.width) : rect.x,
+                 top = flipV ? h - (rect.y + rect.height) : rect.y;
+    const uint32 right = left + rect.width,
+                 bottom = top + rect.height;
+
+    const uint32 readLeft = left / blockWidth * blockWidth;
+    uint32 readRight = (right + blockWidth - 1) / blockWidth * blockWidth;
+    if ( readRight > w )
+        readRight = w;
+    const uint32 readWidth = readRight - readLeft;
+
+    // Don't read the blocks below the rectangle when combining them neither.
+    uint32 readBottom = (bottom + blockHeight - 1) / blockHeight * blockHeight;
+    if ( readBottom > h )
+        readBottom = h;
+
+    uint32 bandHeight = blockHeight;
+    const size_t blockSize = (size_t)readWidth * blockHeight * sizeof(uint32);
+    if ( blockSize < TIFF_BAND_BUFFER_SIZE )
+        bandHeight *= TIFF_BAND_BUFFER_SIZE / blockSize;
+
+    uint32* const raster = (uint32*)
+        _TIFFmalloc((tsize_t)readWidth * bandHeight * sizeof(uint32));
+    if ( !raster )
+    {
+        TIFFRGBAImageEnd(&img);
+        return false;
+    }
+
+    // Horizontal offset of the rectangle in the band buffer, which libtiff
+    // fills in the display orientation.
+    const uint32 offsetX = rect.x - (flipH ? w - readRight : readLeft);
+
+    unsigned char* const data = image->GetData();
+    unsigned char* const alpha = image->GetAlpha();
+
+    bool ok = true;
+    int rowsDone = 0;
+    for ( uint32 row = top / blockHeight * blockHeight; row < bottom; )
+    {
+        uint32 next = row + bandHeight;
+        if ( next > readBottom )
+            next = readBottom;
+
+        img.row_offset = (int)row;
+        img.col_offset = (int)readLeft;
+        if ( !TIFFRGBAImageGet(&img, raster, readWidth, next - row) )
         {
-            wxLogError( _("TIFF: Couldn't allocate memory.") );
+            ok = false;
+            break;
         }
 
-        _TIFFfree( raster );
-        TIFFClose( tif );
+        // Copy the rows of this band which are inside the rectangle.
+        const int bandTop = flipV ? (int)(h - next) : (int)row;
+        const int y1 = wxMax(bandTop, rect.y),
+                  y2 = wxMin(bandTop + (int)(next - row), rect.y + rect.height);
+        for ( int y = y1; y < y2; y++ )
+        {
+            const uint32* src = raster + (size_t)(y - bandTop)*readWidth + offsetX;
+            const size_t pos = (size_t)(y - rect.y)*rect.width;
 
-        return false;
+            unsigned char* dst = data + 3*pos;
+            for ( int x = 0; x < rect.width; x++ )
+            {
+                *(dst++) = (unsigned char)TIFFGetR(src[x]);
+                *(dst++) = (unsigned char)TIFFGetG(src[x]);
+                *(dst++) = (unsigned char)TIFFGetB(src[x]);
+            }
+
+            if ( alpha )
+            {
+                unsigned char* dstAlpha = alpha + pos;
+                for ( int x = 0; x < rect.width; x++ )
+                    *(dstAlpha++) = (unsigned char)TIFFGetA(src[x]);
+            }
+        }
+
+        if ( y2 > y1 )
+            rowsDone += y2 - y1;
+
+        if ( notifier && !notifier->OnProgress(rowsDone, rect.height) )
+        {
+            ok = false;
+            break;
+        }
+
+        row = next;
     }
 
-    if ( hasAlpha )
-        image->SetAlpha();
+    _TIFFfree(raster);
+    TIFFRGBAImageEnd(&img);
 
-    uint16 planarConfig = PLANARCONFIG_CONTIG;
-    (void) TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+    return ok;
+}
 
-    bool ok = true;
+// Read the given rectangle of the current directory into the image which must
+// already have the size of this rectangle and have alpha if info.hasAlpha.
+//
+// The pixels are stored directly into the image, without ever allocating a
+// buffer for the entire TIFF image. If the notifier is specified, it is
+// notified about the progress and can cancel reading, in which case false is
+// returned, as in case of an error.
+bool
+ReadTIFFRegion(TIFF* tif,
+               const TIFFDirInfo& info,
+               const wxRect& rect,
+               wxImage* image,
+               wxTIFFReadNotifier* notifier)
+{
     char msg[1024] = "";
     if
     (
-        (planarConfig == PLANARCONFIG_CONTIG && samplesPerPixel == 2
-            && extraSamples == 1)
+        (info.planarConfig == PLANARCONFIG_CONTIG && info.samplesPerPixel == 2
+            && info.extraSamples == 1)
         &&
         (
             ( !TIFFRGBAImageOK(tif, msg) )
-            || (bitsPerSample == 8)
+            || (info.bitsPerSample == 8)
         )
     )
     {
-        const bool isGreyScale = (bitsPerSample == 8);
-        unsigned char *buf = (unsigned char *)_TIFFmalloc(TIFFScanlineSize(tif));
-        uint32 pos = 0;
-        const bool minIsWhite = (photometric == PHOTOMETRIC_MINISWHITE);
-        const int minValue =  minIsWhite ? 255 : 0;
-        const int maxValue = 255 - minValue;
-
-        /*
-        Decode to ABGR format as that is what the code, that converts to
-        wxImage, later on expects (normally TIFFReadRGBAImageOriented is
-        used to decode which uses an ABGR layout).
-        */
-        for (uint32 y = 0; y < h; ++y)
-        {
-            if (TIFFReadScanline(tif, buf, y, 0) != 1)
-            {
-                ok = false;
-                break;
-            }
+        return ReadTIFFGreyAlphaRegion(tif, info, rect, image, notifier);
+    }
 
-            if (isGreyScale)
-            {
-                for (uint32 x = 0; x < w; ++x)
-                {
-                    uint8 val = minIsWhite ? 255 - buf[x*2] : buf[x*2];
-                    uint8 alpha = minIsWhite ? 255 - buf[x*2+1] : buf[x*2+1];
-                    raster[pos] = val + (val << 8) + (val << 16)
-                        + (alpha << 24);
-                    pos++;
-                }
-            }
-            else
-            {
-                for (uint32 x = 0; x < w; ++x)
-                {
-                    int mask = buf[x*2/8] << ((x*2)%8);
+    return ReadTIFFRGBARegion(tif, info, rect, image, notifier);
+}
 
-                    uint8 val = mask & 128 ? maxValue : minValue;
-                    raster[pos] = val + (val << 8) + (val << 16)
-                        + ((mask & 64 ? maxValue : minValue) << 24);
-                    pos++;
-                }
-            }
-        }
+// Return true if an image of the given size can be created: wxImage uses
+// int for the size of its data, so bigger ones can't.
+inline bool IsTIFFSizeOk(uint32 w, uint32 h)
+{
+    return (double)w * (double)h * 3 <= INT_MAX;
+}
 
-        _TIFFfree(buf);
+// Forwards the notifications to the real notifier, if any, and remembers if
+// reading was cancelled by it.
+class TIFFCancelTracker : public wxTIFFReadNotifier
+{
+public:
+    explicit TIFFCancelTracker(wxTIFFReadNotifier* notifier)
+        : m_notifier(notifier),
+          m_cancelled(false)
+    {
     }
-    else
+
+    virtual bool OnProgress(int rowsRead, int rowsTotal) wxOVERRIDE
     {
-        ok = TIFFReadRGBAImageOriented( tif, w, h, raster,
-            ORIENTATION_TOPLEFT, 0 ) != 0;
+        if ( m_notifier && !m_notifier->OnProgress(rowsRead, rowsTotal) )
+            m_cancelled = true;
+
+        return !m_cancelled;
     }
 
+    bool WasCancelled() const { return m_cancelled; }
+
+private:
+    wxTIFFReadNotifier* const m_notifier;
+    bool m_cancelled;
+
+    wxDECLARE_NO_COPY_CLASS(TIFFCancelTracker);
+};
+
+} // anonymous namespace
+
+bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
+{
+    if (index == -1)
+        index = 0;
+
+    image->Destroy();
+
+    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
 
-    if (!ok)
+    if (!tif)
     {
         if (verbose)
         {
-            wxLogError( _("TIFF: Error reading image.") );
+            wxLogError( _("TIFF: Error loading image.") );
+        }
+
+        return false;
+    }
+
+    if (!TIFFSetDirectory( tif, (tdir_t)index ))
+    {
+        if (verbose)
+        {
+            wxLogError( _("Invalid TIFF image index.") );
         }
 
-        _TIFFfree( raster );
-        image->Destroy();
         TIFFClose( tif );
 
         return false;
     }
 
-    unsigned char *ptr = image->GetData();
+    const TIFFDirInfo info(tif);
+    const uint32 w = info.width,
+                 h = info.height;
 
-    unsigned char *alpha = image->GetAlpha();
+    // wxImage uses int for the size of its data, so bigger images must be
+    // read by parts using wxTIFFReader
+    if ( !IsTIFFSizeOk(w, h) )
+    {
+        if ( verbose )
+        {
+            wxLogError( _("TIFF: Image size is abnormally big.") );
+        }
 
-    uint32 pos = 0;
+        TIFFClose(tif);
 
-    for (uint32 i = 0; i < h; i++)
+        return false;
+    }
+
+    image->Create( (int)w, (int)h, false );
+    if (!image->IsOk())
     {
-        for (uint32 j = 0; j < w; j++)
+        if (verbose)
         {
-            *(ptr++) = (unsigned char)TIFFGetR(raster[pos]);
-            *(ptr++) = (unsigned char)TIFFGetG(raster[pos]);
-            *(ptr++) = (unsigned char)TIFFGetB(raster[pos]);
-            if ( hasAlpha )
-                *(alpha++) = (unsigned char)TIFFGetA(raster[pos]);
+            wxLogError( _("TIFF: Couldn't allocate memory.") );
+        }
+
+        TIFFClose( tif );
+
+        return false;
+    }
+
+    if ( info.hasAlpha )
+        image->SetAlpha();
 
-            pos++;
+    if ( !ReadTIFFRegion(tif, info, wxRect(0, 0, (int)w, (int)h), image, NULL) )
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error reading image.") );
         }
+
+        image->Destroy();
+        TIFFClose( tif );
+
+        return false;
     }
 
+    const uint16 photometric = info.photometric,
+                 samplesPerPixel = info.samplesPerPixel,
+                 bitsPerSample = info.bitsPerSample;
 
     image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
 
@@ -570,8 +815,6 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
             wxString::FromCDouble((double) resY));
     }
 
-    _TIFFfree( raster );
-
     TIFFClose( tif );
 
     return true;
@@ -875,6 +1118,189 @@ bool wxTIFFHandler::DoCanRead( wxInputStream& stream )
            (hdr[0] == 'M' && hdr[1] == 'M');
 }
 
+//-----------------------------------------------------------------------------
+// wxTIFFReader
+//-----------------------------------------------------------------------------
+
+wxTIFFReader::wxTIFFReader()
+{
+    m_tif = NULL;
+    m_stream = NULL;
+    m_index = 0;
+}
+
+wxTIFFReader::~wxTIFFReader()
+{
+    Close();
+}
+
+bool wxTIFFReader::Open(wxInputStream& stream)
+{
+    Close();
+
+    TIFFSetWarningHandler((TIFFErrorHandler) TIFFwxWarningHandler);
+    TIFFSetErrorHandler((TIFFErrorHandler) TIFFwxErrorHandler);
+
+    m_tif = TIFFwxOpen( stream, "image", "r" );
+    if ( !m_tif )
+    {
+        wxLogError( _("TIFF: Error loading image.") );
+        return false;
+    }
+
+    return true;
+}
+
+bool wxTIFFReader::Open(const wxString& filename)
+{
+    wxFileInputStream* const stream = new wxFileInputStream(filename);
+    if ( !stream->IsOk() || !Open(*stream) )
+    {
+        delete stream;
+        return false;
+    }
+
+    m_stream = stream;
+
+    return true;
+}
+
+void wxTIFFReader::Close()
+{
+    if ( m_tif )
+    {
+        TIFFClose(m_tif);
+        m_tif = NULL;
+    }
+
+    wxDELETE(m_stream);
+
+    m_index = 0;
+}
+
+int wxTIFFReader::GetImageCount() const
+{
+    wxCHECK_MSG( IsOpened(), 0, wxT("TIFF reader not opened") );
+
+    return TIFFNumberOfDirectories(m_tif);
+}
+
+bool wxTIFFReader::SelectImage(int index)
+{
+    wxCHECK_MSG( IsOpened(), false, wxT("TIFF reader not opened") );
+
+    if ( index < 0 || !TIFFSetDirectory(m_tif, (tdir_t)index) )
+    {
+        wxLogError( _("Invalid TIFF image index.") );
+
+        // try to keep the previously selected image usable
+        TIFFSetDirectory(m_tif, (tdir_t)m_index);
+
+        return false;
+    }
+
+    m_index = index;
+
+    return true;
+}
+
+wxSize wxTIFFReader::GetSize() const
+{
+    wxCHECK_MSG( IsOpened(), wxDefaultSize, wxT("TIFF reader not opened") );
+
+    const TIFFDirInfo info(m_tif);
+
+    return wxSize((int)info.width, (int)info.height);
+}
+
+bool wxTIFFReader::IsReducedImage() const
+{
+    wxCHECK_MSG( IsOpened(), false, wxT("TIFF reader not opened") );
+
+    uint32 subfileType = 0;
+    (void) TIFFGetField(m_tif, TIFFTAG_SUBFILETYPE, &subfileType);
+
+    return (subfileType & FILETYPE_REDUCEDIMAGE) != 0;
+}
+
+int wxTIFFReader::FindImage(const wxSize& size)
+{
+    wxCHECK_MSG( IsOpened(), wxNOT_FOUND, wxT("TIFF reader not opened") );
+
+    int found = wxNOT_FOUND;
+    double foundArea = 0;
+
+    const int count = GetImageCount();
+    for ( int n = 0; n < count; n++ )
+    {
+        if ( !TIFFSetDirectory(m_tif, (tdir_t)n) )
+            break;
+
+        const TIFFDirInfo info(m_tif);
+        if ( info.width < (uint32)size.x || info.height < (uint32)size.y )
+            continue;
+
+        const double area = (double)info.width * info.height;
+        if ( found == wxNOT_FOUND || area < foundArea )
+        {
+            found = n;
+            foundArea = area;
+        }
+    }
+
+    TIFFSetDirectory(m_tif, (tdir_t)m_index);
+
+    return found;
+}
+
+bool wxTIFFReader::Read(wxImage* image,
+                        const wxRect& rect,
+                        wxTIFFReadNotifier* notifier)
+{
+    wxCHECK_MSG( image, false, wxT("NULL image") );
+    wxCHECK_MSG( IsOpened(), false, wxT("TIFF reader not opened") );
+
+    const TIFFDirInfo info(m_tif);
+
+    wxRect r(rect);
+    if ( r.IsEmpty() )
+        r = wxRect(0, 0, (int)info.width, (int)info.height);
+
+    wxCHECK_MSG( r.x >= 0 && r.y >= 0 &&
+                    (uint32)r.GetRight() < info.width &&
+                    (uint32)r.GetBottom() < info.height,
+                 false, wxT("rectangle outside of the image") );
+
+    if ( !IsTIFFSizeOk(r.width, r.height) )
+    {
+        wxLogError( _("TIFF: Image size is abnormally big.") );
+        return false;
+    }
+
+    if ( !image->Create(r.width, r.height, false) )
+    {
+        wxLogError( _("TIFF: Couldn't allocate memory.") );
+        return false;
+    }
+
+    if ( info.hasAlpha )
+        image->SetAlpha();
+
+    TIFFCancelTracker tracker(notifier);
+    if ( !ReadTIFFRegion(m_tif, info, r, image, &tracker) )
+    {
+        // don't give an error if reading was cancelled
+        if ( !tracker.WasCancelled() )
+            wxLogError( _("TIFF: Error reading image.") );
+
+        image->Destroy();
+
+        return false;
+    }
+
+    return true;
+}
+
 #endif  // wxUSE_STREAMS
 
 /*static*/ wxVersionInfo wxTIFFHandler::GetLibraryVersionInfo()
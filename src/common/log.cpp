@@ -103,6 +103,9 @@ WX_DEFINE_LOG_CS(TraceMask);
 // and this one is used for GetComponentLevels()
 WX_DEFINE_LOG_CS(Levels);
 
+// this one protects the cached time stamp used by wxLog::TimeStamp()
+WX_DEFINE_LOG_CS(TimeStamp);
+
 } // anonymous namespace
 
 #endif // wxUSE_THREADS
@@ -150,6 +153,35 @@ struct PreviousLogInfo
 
 PreviousLogInfo gs_prevLog;
 
+#if wxUSE_DATETIME
+
+// the last time stamp string formatted by wxLog::TimeStamp(): as many log
+// messages are typically logged during the same second, this allows to avoid
+// formatting the same time stamp over and over again
+//
+// NB: all accesses to it must be protected by GetTimeStampCS()
+struct TimeStampCache
+{
+    TimeStampCache()
+    {
+        time = 0;
+    }
+
+    // the time for which the string below was formatted
+    time_t time;
+
+    // the format used, the cache is invalidated if wxLog::SetTimestamp() is
+    // called to change it
+    wxString format;
+
+    // the formatted time stamp, including the trailing separator
+    wxString str;
+};
+
+WX_DEFINE_GLOBAL_VAR(TimeStampCache, LastTimeStamp);
+
+#endif // wxUSE_DATETIME
+
 
 // map containing all components for which log level was explicitly set
 //
@@ -359,6 +391,16 @@ wxLog::OnLog(wxLogLevel level,
         {
             if ( ms_pLogger )
             {
+                // MT-safe targets can be used from this thread directly, but
+                // only if we don't need to count the repeated messages as this
+                // uses global state which can only be accessed from the main
+                // thread
+                if ( ms_pLogger->IsThreadSafe() && !GetRepetitionCounting() )
+                {
+                    ms_pLogger->CallDoLogNow(level, msg, info);
+                    return;
+                }
+
                 // buffer the messages until they can be shown from the main
                 // thread
                 wxCriticalSectionLocker lock(GetBackgroundLogCS());
@@ -587,6 +629,47 @@ void wxLog::DoCreateOnDemand()
 // wxLog components levels
 // ----------------------------------------------------------------------------
 
+namespace
+{
+
+// all the existing wxLogComponentHandle objects
+//
+// NB: all accesses to it must be protected by GetLevelsCS() critical section
+wxVector<wxLogComponentHandle*>& ComponentHandles()
+{
+    static wxVector<wxLogComponentHandle*> s_componentHandles;
+
+    return s_componentHandles;
+}
+
+// find the level explicitly set for this component or one of its parents,
+// return false if there is none
+//
+// NB: must be called with GetLevelsCS() locked
+bool FindComponentLevel(const wxString& componentOrig, wxLogLevel* level)
+{
+    // Make a copy before modifying it in the loop.
+    wxString component = componentOrig;
+
+    const wxStringToNumHashMap& componentLevels = GetComponentLevels();
+    while ( !component.empty() )
+    {
+        wxStringToNumHashMap::const_iterator
+            it = componentLevels.find(component);
+        if ( it != componentLevels.end() )
+        {
+            *level = static_cast<wxLogLevel>(it->second);
+            return true;
+        }
+
+        component = component.BeforeLast('/');
+    }
+
+    return false;
+}
+
+} // anonymous namespace
+
 /* static */
 void wxLog::SetComponentLevel(const wxString& component, wxLogLevel level)
 {
@@ -599,29 +682,71 @@ void wxLog::SetComponentLevel(const wxString& component, wxLogLevel level)
         wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
         GetComponentLevels()[component] = level;
+        ms_hasComponentLevels = true;
+
+        UpdateComponentHandles();
     }
 }
 
 /* static */
-wxLogLevel wxLog::GetComponentLevel(const wxString& componentOrig)
+wxLogLevel wxLog::GetComponentLevel(const wxString& component)
 {
     wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
-    // Make a copy before modifying it in the loop.
-    wxString component = componentOrig;
+    wxLogLevel level;
+    if ( FindComponentLevel(component, &level) )
+        return level;
 
-    const wxStringToNumHashMap& componentLevels = GetComponentLevels();
-    while ( !component.empty() )
+    return GetLogLevel();
+}
+
+/* static */
+void wxLog::UpdateComponentHandles()
+{
+    const wxVector<wxLogComponentHandle*>& handles = ComponentHandles();
+    for ( size_t n = 0; n < handles.size(); n++ )
     {
-        wxStringToNumHashMap::const_iterator
-            it = componentLevels.find(component);
-        if ( it != componentLevels.end() )
-            return static_cast<wxLogLevel>(it->second);
+        wxLogComponentHandle* const handle = handles[n];
 
-        component = component.BeforeLast('/');
+        wxLogLevel level;
+        if ( !FindComponentLevel(handle->m_component, &level) )
+            level = wxLogComponentHandle::Level_Default;
+
+        handle->m_level = level;
     }
+}
 
-    return GetLogLevel();
+// ----------------------------------------------------------------------------
+// wxLogComponentHandle
+// ----------------------------------------------------------------------------
+
+wxLogComponentHandle::wxLogComponentHandle(const char *component)
+    : m_component(component)
+{
+    wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
+
+    wxLogLevel level;
+    if ( !FindComponentLevel(m_component, &level) )
+        level = Level_Default;
+
+    m_level = level;
+
+    ComponentHandles().push_back(this);
+}
+
+wxLogComponentHandle::~wxLogComponentHandle()
+{
+    wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
+
+    wxVector<wxLogComponentHandle*>& handles = ComponentHandles();
+    for ( size_t n = 0; n < handles.size(); n++ )
+    {
+        if ( handles[n] == this )
+        {
+            handles.erase(handles.begin() + n);
+            break;
+        }
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -646,6 +771,15 @@ wxArrayString& TraceMasks()
     return s_traceMasks;
 }
 
+// all the existing wxLogTraceMaskHandle objects, protected by GetTraceMaskCS()
+// just as TraceMasks() itself
+wxVector<wxLogTraceMaskHandle*>& TraceMaskHandles()
+{
+    static wxVector<wxLogTraceMaskHandle*> s_traceMaskHandles;
+
+    return s_traceMaskHandles;
+}
+
 } // anonymous namespace
 
 /* static */ const wxArrayString& wxLog::GetTraceMasks()
@@ -662,6 +796,8 @@ void wxLog::AddTraceMask(const wxString& str)
     wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
 
     TraceMasks().push_back(str);
+
+    UpdateTraceMaskHandles();
 }
 
 void wxLog::RemoveTraceMask(const wxString& str)
@@ -671,6 +807,8 @@ void wxLog::RemoveTraceMask(const wxString& str)
     int index = TraceMasks().Index(str);
     if ( index != wxNOT_FOUND )
         TraceMasks().RemoveAt((size_t)index);
+
+    UpdateTraceMaskHandles();
 }
 
 void wxLog::ClearTraceMasks()
@@ -678,6 +816,20 @@ void wxLog::ClearTraceMasks()
     wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
 
     TraceMasks().Clear();
+
+    UpdateTraceMaskHandles();
+}
+
+/* static */
+void wxLog::UpdateTraceMaskHandles()
+{
+    const wxArrayString& masks = TraceMasks();
+    const wxVector<wxLogTraceMaskHandle*>& handles = TraceMaskHandles();
+    for ( size_t n = 0; n < handles.size(); n++ )
+    {
+        wxLogTraceMaskHandle* const handle = handles[n];
+        handle->m_enabled = masks.Index(handle->m_mask) != wxNOT_FOUND;
+    }
 }
 
 /*static*/ bool wxLog::IsAllowedTraceMask(const wxString& mask)
@@ -697,6 +849,35 @@ void wxLog::ClearTraceMasks()
     return false;
 }
 
+// ----------------------------------------------------------------------------
+// wxLogTraceMaskHandle
+// ----------------------------------------------------------------------------
+
+wxLogTraceMaskHandle::wxLogTraceMaskHandle(const wxString& mask)
+    : m_mask(mask)
+{
+    wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
+
+    m_enabled = TraceMasks().Index(m_mask) != wxNOT_FOUND;
+
+    TraceMaskHandles().push_back(this);
+}
+
+wxLogTraceMaskHandle::~wxLogTraceMaskHandle()
+{
+    wxCRIT_SECT_LOCKER(lock, GetTraceMaskCS());
+
+    wxVector<wxLogTraceMaskHandle*>& handles = TraceMaskHandles();
+    for ( size_t n = 0; n < handles.size(); n++ )
+    {
+        if ( handles[n] == this )
+        {
+            handles.erase(handles.begin() + n);
+            break;
+        }
+    }
+}
+
 // ----------------------------------------------------------------------------
 // wxLog miscellaneous other methods
 // ----------------------------------------------------------------------------
@@ -716,8 +897,19 @@ void wxLog::TimeStamp(wxString *str, time_t t)
 {
     if ( !ms_timestamp.empty() )
     {
-        *str = wxDateTime(t).Format(ms_timestamp);
-        *str += wxS(": ");
+        wxCRIT_SECT_LOCKER(lock, GetTimeStampCS());
+
+        TimeStampCache& cache = GetLastTimeStamp();
+        if ( cache.str.empty() || t != cache.time ||
+                ms_timestamp != cache.format )
+        {
+            cache.time = t;
+            cache.format = ms_timestamp;
+            cache.str = wxDateTime(t).Format(ms_timestamp);
+            cache.str += wxS(": ");
+        }
+
+        *str = cache.str;
     }
 }
 
@@ -983,6 +1175,393 @@ wxLogInterposerTemp::wxLogInterposerTemp()
     #pragma warning(default:4355)
 #endif // VC++
 
+// ----------------------------------------------------------------------------
+// wxLogAsync
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// read the current value of a variable which can be modified by other threads
+inline wxInt32 LoadAtomic(wxAtomicInt& value)
+{
+    return wxAtomicAdd(value, 0);
+}
+
+// return the difference between two sequence numbers, which can wrap around
+inline wxInt32 SeqDiff(wxInt32 a, wxInt32 b)
+{
+    return static_cast<wxInt32>(static_cast<wxUint32>(a) -
+                                static_cast<wxUint32>(b));
+}
+
+// values of wxLogAsync::m_writerWaiting
+enum
+{
+    // the writer thread is running
+    WriterState_Busy,
+
+    // it's waiting for more records to be queued, but will wake up soon to
+    // write the records queued so far anyhow
+    WriterState_Waiting,
+
+    // it's waiting for the records to be queued after having nothing to do
+    // for some time and must be woken up for any new record
+    WriterState_Idle
+};
+
+// the time the writer thread waits for more records before writing the ones
+// already queued, in milliseconds
+const unsigned long WRITER_WAIT_TIMEOUT = 20;
+
+// return the mask corresponding to the ring buffer of at least the given size
+wxUint32 GetRingBufferMask(size_t capacity)
+{
+    // the size must be a power of 2 and can't be too big as we use 32 bit
+    // sequence numbers
+    wxUint32 size = 2;
+    while ( size < capacity && size < 0x40000000 )
+        size <<= 1;
+
+    return size - 1;
+}
+
+} // anonymous namespace
+
+// an entry of the ring buffer: while it's free, its sequence number is equal
+// to the sequence number of the record which will be stored in it and it's
+// incremented by one once the record is stored and can be written out
+struct wxLogAsync::Slot
+{
+    wxAtomicInt seq;
+
+    wxLogLevel level;
+    wxString msg;
+    wxLogRecordInfo info;
+};
+
+class wxLogAsync::WriterThread : public wxThread
+{
+public:
+    explicit WriterThread(wxLogAsync& log)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_log(log)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_log.WriterLoop();
+
+        return NULL;
+    }
+
+private:
+    wxLogAsync& m_log;
+
+    wxDECLARE_NO_COPY_CLASS(WriterThread);
+};
+
+wxLogAsync::wxLogAsync(wxLog *target,
+                       size_t capacity,
+                       wxLogAsyncOverflowPolicy policy)
+          : m_target(target),
+            m_slots(new Slot[GetRingBufferMask(capacity) + 1]),
+            m_mask(GetRingBufferMask(capacity)),
+            m_policy(policy),
+            m_condWrite(m_mutex),
+            m_condFlushed(m_mutex)
+{
+    wxASSERT_MSG( m_target, wxS("wxLogAsync needs a log target") );
+
+    for ( wxUint32 n = 0; n <= m_mask; n++ )
+        m_slots[n].seq = static_cast<wxInt32>(n);
+
+    m_tail = 0;
+    m_head = 0;
+    m_dropped = 0;
+    m_droppedReported = 0;
+    m_writerWaiting = 0;
+
+    m_flushRequested =
+    m_flushDone = 0;
+    m_stop = false;
+
+    // prevent the writer thread from running before m_threadId is set
+    wxMutexLocker lock(m_mutex);
+
+    m_thread = new WriterThread(*this);
+    if ( m_thread->Run() == wxTHREAD_NO_ERROR )
+    {
+        m_threadId = m_thread->GetId();
+    }
+    else
+    {
+        // we'll pass all the records to the target synchronously
+        wxDELETE(m_thread);
+        m_threadId = 0;
+    }
+}
+
+wxLogAsync::~wxLogAsync()
+{
+    if ( m_thread )
+    {
+        {
+            wxMutexLocker lock(m_mutex);
+            m_stop = true;
+            m_condWrite.Signal();
+        }
+
+        // this waits until all the queued records are written out
+        m_thread->Wait();
+        delete m_thread;
+    }
+
+    delete [] m_slots;
+    delete m_target;
+}
+
+unsigned long wxLogAsync::GetDroppedCount() const
+{
+    return static_cast<wxUint32>(LoadAtomic(const_cast<wxAtomicInt&>(m_dropped)));
+}
+
+bool wxLogAsync::IsQueueEmpty()
+{
+    return LoadAtomic(m_head) == LoadAtomic(m_tail);
+}
+
+void wxLogAsync::WakeUpWriter()
+{
+    // waking up the writer thread is relatively expensive, so don't do it for
+    // every record but let them accumulate in the queue for a short time
+    // unless the queue is getting full
+    const wxInt32 state = LoadAtomic(m_writerWaiting);
+    if ( state == WriterState_Idle ||
+            (state == WriterState_Waiting &&
+                SeqDiff(LoadAtomic(m_tail), LoadAtomic(m_head)) >
+                    static_cast<wxInt32>(m_mask / 4)) )
+    {
+        wxMutexLocker lock(m_mutex);
+        m_condWrite.Signal();
+    }
+}
+
+void wxLogAsync::DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info)
+{
+    if ( !m_thread )
+    {
+        wxMutexLocker lock(m_mutex);
+        m_target->LogRecord(level, msg, info);
+        return;
+    }
+
+    // the target itself may log something from the writer thread and we
+    // can't queue it then as we could deadlock waiting for the free space
+    if ( wxThread::GetCurrentId() == m_threadId )
+    {
+        m_target->LogRecord(level, msg, info);
+        return;
+    }
+
+    if ( m_policy == wxLOG_ASYNC_DISCARD )
+    {
+        // notice that this check is not exact as other threads can be queuing
+        // records concurrently, so we may still have to wait below, but not
+        // for more than the number of these threads records
+        if ( SeqDiff(LoadAtomic(m_tail), LoadAtomic(m_head)) >
+                static_cast<wxInt32>(m_mask) )
+        {
+            wxAtomicInc(m_dropped);
+            return;
+        }
+    }
+
+    // reserve the slot for our record
+    const wxInt32 seq = wxAtomicAdd(m_tail, 1) - 1;
+    Slot& slot = m_slots[static_cast<wxUint32>(seq) & m_mask];
+
+    // if the queue is full, wait until the writer thread frees this slot
+    for ( unsigned n = 0; LoadAtomic(slot.seq) != seq; n++ )
+    {
+        if ( n < 100 )
+            wxThread::Yield();
+        else
+            wxMilliSleep(1);
+    }
+
+    slot.level = level;
+    slot.msg = msg;
+    slot.info = info;
+
+    // make the record available to the writer thread
+    wxAtomicInc(slot.seq);
+
+    WakeUpWriter();
+}
+
+bool wxLogAsync::WriteNext()
+{
+    // only this thread modifies m_head, so it can't change while we run
+    const wxInt32 seq = LoadAtomic(m_head);
+    Slot& slot = m_slots[static_cast<wxUint32>(seq) & m_mask];
+    if ( SeqDiff(LoadAtomic(slot.seq), seq) != 1 )
+        return false;
+
+    const wxLogLevel level = slot.level;
+    wxString msg;
+    msg.swap(slot.msg);
+    const wxLogRecordInfo info(slot.info);
+
+    // free the slot for the record which will use it during the next round
+    // before formatting this one, as this can take some time
+    wxAtomicAdd(slot.seq, static_cast<wxInt32>(m_mask));
+    wxAtomicInc(m_head);
+
+    m_target->LogRecord(level, msg, info);
+
+    return true;
+}
+
+void wxLogAsync::ReportDropped()
+{
+    const wxInt32 dropped = LoadAtomic(m_dropped);
+    if ( dropped == m_droppedReported )
+        return;
+
+    const unsigned long
+        count = static_cast<wxUint32>(SeqDiff(dropped, m_droppedReported));
+    m_droppedReported = dropped;
+
+    wxLogRecordInfo info(__FILE__, __LINE__, __WXFUNCTION__, wxLOG_COMPONENT);
+    info.timestamp = time(NULL);
+
+    m_target->LogRecord
+              (
+                wxLOG_Warning,
+                wxString::Format
+                (
+                    wxPLURAL
+                    (
+                        "%lu log message was discarded because the queue was full.",
+                        "%lu log messages were discarded because the queue was full.",
+                        count
+                    ),
+                    count
+                ),
+                info
+              );
+}
+
+void wxLogAsync::WriterLoop()
+{
+    // wait until the ctor finishes
+    {
+        wxMutexLocker lock(m_mutex);
+    }
+
+    // becomes true if we didn't have anything to do for some time
+    bool idle = false;
+
+    for ( ;; )
+    {
+        while ( WriteNext() )
+            idle = false;
+
+        if ( !IsQueueEmpty() )
+        {
+            // another thread has reserved the next slot but hasn't stored the
+            // record in it yet, this shouldn't take long
+            wxThread::Yield();
+            continue;
+        }
+
+        ReportDropped();
+
+        unsigned long flushRequested;
+        bool stop;
+        {
+            wxMutexLocker lock(m_mutex);
+
+            if ( m_flushRequested == m_flushDone && !m_stop )
+            {
+                // WakeUpWriter() only signals the condition if m_writerWaiting
+                // is set, so check if the queue is still empty after setting
+                // it to avoid missing a record queued just before
+                const wxInt32 state = idle ? WriterState_Idle
+                                           : WriterState_Waiting;
+                wxAtomicAdd(m_writerWaiting, state);
+                if ( IsQueueEmpty() )
+                {
+                    if ( idle )
+                    {
+                        m_condWrite.Wait();
+                    }
+                    else
+                    {
+                        idle = m_condWrite.WaitTimeout(WRITER_WAIT_TIMEOUT)
+                                    == wxCOND_TIMEOUT && IsQueueEmpty();
+                    }
+                }
+                wxAtomicAdd(m_writerWaiting, -state);
+                continue;
+            }
+
+            // records logged before the flush request must be written first
+            if ( !IsQueueEmpty() )
+                continue;
+
+            flushRequested = m_flushRequested;
+            stop = m_stop;
+        }
+
+        m_target->Flush();
+
+        {
+            wxMutexLocker lock(m_mutex);
+            m_flushDone = flushRequested;
+            m_condFlushed.Broadcast();
+        }
+
+        if ( stop )
+            break;
+    }
+}
+
+void wxLogAsync::Flush()
+{
+    // this logs the repeated messages count, if any, via our DoLogRecord()
+    wxLog::Flush();
+
+    if ( !m_thread )
+    {
+        wxMutexLocker lock(m_mutex);
+        m_target->Flush();
+        return;
+    }
+
+    // waiting for the writer thread from the writer thread itself would
+    // deadlock and the target is going to be flushed by it soon anyhow
+    if ( wxThread::GetCurrentId() == m_threadId )
+        return;
+
+    wxMutexLocker lock(m_mutex);
+
+    const unsigned long request = ++m_flushRequested;
+    m_condWrite.Signal();
+
+    while ( m_flushDone < request )
+        m_condFlushed.Wait();
+}
+
+#endif // wxUSE_THREADS
+
 // ============================================================================
 // Global functions/variables
 // ============================================================================
@@ -999,6 +1578,7 @@ bool            wxLog::ms_bAutoCreate  = true;
 bool            wxLog::ms_bVerbose     = false;
 
 wxLogLevel      wxLog::ms_logLevel     = wxLOG_Max;  // log everything by default
+bool            wxLog::ms_hasComponentLevels = false;
 
 size_t          wxLog::ms_suspendCount = 0;
 
@@ -44,6 +44,17 @@
 wxIMPLEMENT_ABSTRACT_CLASS(wxMemoryInputStream, wxInputStream);
 
 wxMemoryInputStream::wxMemoryInputStream(const void *data, size_t len)
+{
+    InitFromData(data, len);
+}
+
+wxMemoryInputStream::wxMemoryInputStream()
+{
+    m_i_streambuf = NULL;
+    m_length = 0;
+}
+
+void wxMemoryInputStream::InitFromData(const void *data, size_t len)
 {
     m_i_streambuf = new wxStreamBuffer(wxStreamBuffer::read);
     m_i_streambuf->SetBufferIO(const_cast<void *>(data), len);
@@ -108,6 +119,21 @@ wxMemoryInputStream::~wxMemoryInputStream()
     delete m_i_streambuf;
 }
 
+const void *wxMemoryInputStream::GetUnreadData(size_t *size) const
+{
+    wxCHECK_MSG( size, NULL, wxT("NULL size pointer") );
+
+    *size = 0;
+
+    if ( !m_i_streambuf || m_wback )
+        return NULL;
+
+    const size_t pos = m_i_streambuf->GetIntPosition();
+    *size = m_length - pos;
+
+    return static_cast<const char *>(m_i_streambuf->GetBufferStart()) + pos;
+}
+
 char wxMemoryInputStream::Peek()
 {
     char *buf = (char *)m_i_streambuf->GetBufferStart();
@@ -66,6 +66,9 @@ namespace
 
 #define RIGHT_SHIFT(x,shft) ((x) >> (shft))
 
+/* Clamp a sample with the error correction added to it to the valid range */
+#define RANGE_LIMIT(x) ((x) < 0 ? 0 : (x) > MAXJSAMPLE ? MAXJSAMPLE : (x))
+
 typedef unsigned char JSAMPLE;
 typedef JSAMPLE *JSAMPROW;
 typedef JSAMPROW *JSAMPARRAY;
@@ -77,7 +80,6 @@ typedef struct {
         JSAMPARRAY colormap;
         int actual_number_of_colors;
         int desired_number_of_colors;
-        JSAMPLE *sample_range_limit, *srl_orig;
 } j_decompress;
 
 #if defined(__WINDOWS__)
@@ -189,13 +191,10 @@ struct jpeg_color_quantizer {
  * (In the second pass the histogram space is re-used for pixel mapping data;
  * in that capacity, each cell must be able to store zero to the number of
  * desired colors.  16 bits/cell is plenty for that too.)
- * Since the JPEG code is intended to run in small memory model on 80x86
- * machines, we can't just allocate the histogram in one chunk.  Instead
- * of a true 3-D array, we use a row of pointers to 2-D arrays.  Each
- * pointer corresponds to a C0 value (typically 2^5 = 32 pointers) and
- * each 2-D array has 2^6*2^5 = 2048 or 2^6*2^6 = 4096 entries.  Note that
- * on 80x86 machines, the pointer row is in near memory but the actual
- * arrays are in far memory (same arrangement as we use for image arrays).
+ * Unlike the original JPEG code, which had to run in small memory model on
+ * 80x86 machines and used a row of pointers to 2-D arrays, we allocate the
+ * histogram in one chunk as a true 3-D array: this avoids loading a pointer
+ * for each pixel in the time-critical loops below.
  */
 
 #define MAXNUMCOLORS  (MAXJSAMPLE+1) /* maximum size of colormap */
@@ -223,7 +222,7 @@ typedef wxUint16 histcell;    /* histogram cell; prefer an unsigned type */
 typedef histcell  * histptr;    /* for pointers to histogram cells */
 
 typedef histcell hist1d[HIST_C2_ELEMS]; /* typedefs for the array */
-typedef hist1d  * hist2d;   /* type for the 2nd-level pointers */
+typedef hist1d hist2d[HIST_C1_ELEMS]; /* one plane of the histogram */
 typedef hist2d * hist3d;    /* type for top-level pointer */
 
 
@@ -286,6 +285,10 @@ typedef struct {
   FSERRPTR fserrors;        /* accumulated errors */
   bool on_odd_row;      /* flag to remember which row we are on */
   int * error_limiter;      /* table for clamping the applied error */
+
+  /* Options specified by wxQuantize flags */
+  bool dither;          /* use Floyd-Steinberg dithering in pass 2 */
+  bool refine;          /* refine the colors selected by median cut */
 } my_cquantizer;
 
 typedef my_cquantizer * my_cquantize_ptr;
@@ -651,6 +654,189 @@ select_colors (j_decompress_ptr cinfo, int desired_colors)
 }
 
 
+/*
+ * Median cut selects the colors quickly, but not necessarily optimally: the
+ * boxes are split along a single axis only and the colors near the borders of
+ * a box may be closer to the representative color of another box.  So we can
+ * optionally refine the colormap using a few iterations of Lloyd's (k-means)
+ * algorithm: map every nonzero histogram cell to the nearest colormap entry
+ * and replace each entry by the mean of the cells mapped to it, weighted by
+ * their pixel counts.  This takes time proportional to the number of nonzero
+ * cells times the number of colors, but independent of the image size.
+ */
+
+#define REFINE_ITERATIONS  4    /* maximal number of refinement iterations */
+
+static int
+find_nearest_color (j_decompress_ptr cinfo, int c0, int c1, int c2,
+            const JSAMPLE order[], const int first[])
+/* Find the colormap entry nearest to the given color.  order[] contains the
+ * colormap indexes sorted by their C1 component and first[x] is the position
+ * in it of the first entry with C1 component greater than or equal to x.
+ * This allows to start the search from the entries with the closest C1
+ * component, which has the biggest scale, and stop it as soon as the C1
+ * distance alone exceeds the best distance found so far.
+ */
+{
+  int numcolors = cinfo->actual_number_of_colors;
+  JSAMPROW colormap0 = cinfo->colormap[0];
+  JSAMPROW colormap1 = cinfo->colormap[1];
+  JSAMPROW colormap2 = cinfo->colormap[2];
+  wxInt32 bestdist = 0x7FFFFFFFL;
+  wxInt32 dist, tdist;
+  int best = 0;
+  int i, j;
+
+  /* Search upwards from the first entry with C1 component >= c1 ... */
+  for (j = first[c1]; j < numcolors; j++) {
+    i = GETJSAMPLE(order[j]);
+    tdist = (GETJSAMPLE(colormap1[i]) - c1) * C1_SCALE;
+    dist = tdist*tdist;
+    if (dist >= bestdist)
+      break;
+    tdist = (c0 - GETJSAMPLE(colormap0[i])) * C0_SCALE;
+    dist += tdist*tdist;
+    tdist = (c2 - GETJSAMPLE(colormap2[i])) * C2_SCALE;
+    dist += tdist*tdist;
+    if (dist < bestdist) {
+      bestdist = dist;
+      best = i;
+    }
+  }
+
+  /* ... and then downwards from the last entry with C1 component < c1 */
+  for (j = first[c1] - 1; j >= 0; j--) {
+    i = GETJSAMPLE(order[j]);
+    tdist = (c1 - GETJSAMPLE(colormap1[i])) * C1_SCALE;
+    dist = tdist*tdist;
+    if (dist >= bestdist)
+      break;
+    tdist = (c0 - GETJSAMPLE(colormap0[i])) * C0_SCALE;
+    dist += tdist*tdist;
+    tdist = (c2 - GETJSAMPLE(colormap2[i])) * C2_SCALE;
+    dist += tdist*tdist;
+    if (dist < bestdist) {
+      bestdist = dist;
+      best = i;
+    }
+  }
+
+  return best;
+}
+
+
+typedef struct {
+  /* The coordinates of the center of the cell */
+  int c0, c1, c2;
+  /* The number of pixels in this cell */
+  long count;
+} refine_cell;
+
+
+static void
+refine_colors (j_decompress_ptr cinfo)
+/* Refine the colormap computed by select_colors */
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+  hist3d histogram = cquantize->histogram;
+  int numcolors = cinfo->actual_number_of_colors;
+  JSAMPROW colormap0 = cinfo->colormap[0];
+  JSAMPROW colormap1 = cinfo->colormap[1];
+  JSAMPROW colormap2 = cinfo->colormap[2];
+  refine_cell * cells;
+  wxUint64 * totals;
+  JSAMPLE order[MAXNUMCOLORS];  /* colormap indexes sorted by C1 */
+  int first[MAXJSAMPLE+2];      /* first entry in order[] for each C1 value */
+  histptr histp;
+  long numcells, n;
+  int c0, c1, c2, i, iter;
+
+  /* Collect the nonzero cells of the histogram */
+  numcells = 0;
+  histp = & histogram[0][0][0];
+  for (n = HIST_C0_ELEMS*HIST_C1_ELEMS*HIST_C2_ELEMS; n > 0; n--)
+    if (*histp++ != 0)
+      numcells++;
+
+  cells = (refine_cell *) malloc(numcells * sizeof(refine_cell));
+  numcells = 0;
+  for (c0 = 0; c0 < HIST_C0_ELEMS; c0++)
+    for (c1 = 0; c1 < HIST_C1_ELEMS; c1++) {
+      histp = & histogram[c0][c1][0];
+      for (c2 = 0; c2 < HIST_C2_ELEMS; c2++) {
+    if (*histp != 0) {
+      cells[numcells].c0 = (c0 << C0_SHIFT) + ((1<<C0_SHIFT)>>1);
+      cells[numcells].c1 = (c1 << C1_SHIFT) + ((1<<C1_SHIFT)>>1);
+      cells[numcells].c2 = (c2 << C2_SHIFT) + ((1<<C2_SHIFT)>>1);
+      cells[numcells].count = *histp;
+      numcells++;
+    }
+    histp++;
+      }
+    }
+
+  /* For each color: total count and the sums of all three components */
+  totals = (wxUint64 *) malloc(numcolors * 4 * sizeof(wxUint64));
+
+  for (iter = 0; iter < REFINE_ITERATIONS; iter++) {
+    bool changed = false;
+
+    /* Sort the colormap entries by their C1 component using counting sort */
+    memset((void *) first, 0, sizeof(first));
+    for (i = 0; i < numcolors; i++)
+      first[GETJSAMPLE(colormap1[i]) + 1]++;
+    for (c1 = 1; c1 <= MAXJSAMPLE+1; c1++)
+      first[c1] += first[c1-1];
+    for (i = 0; i < numcolors; i++)
+      order[first[GETJSAMPLE(colormap1[i])]++] = (JSAMPLE) i;
+    /* Now first[x] is the position after the entries with C1 == x, shift */
+    for (c1 = MAXJSAMPLE+1; c1 > 0; c1--)
+      first[c1] = first[c1-1];
+    first[0] = 0;
+
+    memset((void *) totals, 0, numcolors * 4 * sizeof(wxUint64));
+    for (n = 0; n < numcells; n++) {
+      const refine_cell * cellp = & cells[n];
+      int best = find_nearest_color(cinfo, cellp->c0, cellp->c1, cellp->c2,
+                    order, first);
+
+      wxUint64 * totalp = totals + 4*best;
+      totalp[0] += cellp->count;
+      totalp[1] += (wxUint64) cellp->c0 * cellp->count;
+      totalp[2] += (wxUint64) cellp->c1 * cellp->count;
+      totalp[3] += (wxUint64) cellp->c2 * cellp->count;
+    }
+
+    /* Move each color to the mean of its cells, rounding as compute_color
+     * does.  Colors without any cells are left unchanged.
+     */
+    for (i = 0; i < numcolors; i++) {
+      const wxUint64 * totalp = totals + 4*i;
+      wxUint64 total = totalp[0];
+      if (total == 0)
+    continue;
+
+      JSAMPLE m0 = (JSAMPLE) ((totalp[1] + (total>>1)) / total);
+      JSAMPLE m1 = (JSAMPLE) ((totalp[2] + (total>>1)) / total);
+      JSAMPLE m2 = (JSAMPLE) ((totalp[3] + (total>>1)) / total);
+      if (m0 != colormap0[i] || m1 != colormap1[i] || m2 != colormap2[i]) {
+    colormap0[i] = m0;
+    colormap1[i] = m1;
+    colormap2[i] = m2;
+    changed = true;
+      }
+    }
+
+    /* Stop as soon as the colormap converges */
+    if (!changed)
+      break;
+  }
+
+  free(totals);
+  free(cells);
+}
+
+
 /*
  * These routines are concerned with the time-critical task of mapping input
  * colors to the nearest color in the selected colormap.
@@ -995,7 +1181,6 @@ fill_inverse_cmap (j_decompress_ptr cinfo, int c0, int c1, int c2)
  * Map some rows of pixels to the output colormapped representation.
  */
 
-#if 0
 void
 pass2_no_dither (j_decompress_ptr cinfo,
          JSAMPARRAY input_buf, JSAMPARRAY output_buf, int num_rows)
@@ -1028,7 +1213,6 @@ pass2_no_dither (j_decompress_ptr cinfo,
     }
   }
 }
-#endif
 
 void
 pass2_fs_dither (j_decompress_ptr cinfo,
@@ -1049,7 +1233,6 @@ pass2_fs_dither (j_decompress_ptr cinfo,
   int row;
   JDIMENSION col;
   JDIMENSION width = cinfo->output_width;
-  JSAMPLE *range_limit = cinfo->sample_range_limit;
   int *error_limit = cquantize->error_limiter;
   JSAMPROW colormap0 = cinfo->colormap[0];
   JSAMPROW colormap1 = cinfo->colormap[1];
@@ -1105,9 +1288,9 @@ pass2_fs_dither (j_decompress_ptr cinfo,
       cur0 += GETJSAMPLE(inptr[0]);
       cur1 += GETJSAMPLE(inptr[1]);
       cur2 += GETJSAMPLE(inptr[2]);
-      cur0 = GETJSAMPLE(range_limit[cur0]);
-      cur1 = GETJSAMPLE(range_limit[cur1]);
-      cur2 = GETJSAMPLE(range_limit[cur2]);
+      cur0 = RANGE_LIMIT(cur0);
+      cur1 = RANGE_LIMIT(cur1);
+      cur2 = RANGE_LIMIT(cur2);
       /* Index into the cache with adjusted pixel value */
       cachep = & histogram[cur0>>C0_SHIFT][cur1>>C1_SHIFT][cur2>>C2_SHIFT];
       /* If we have not seen this color before, find nearest colormap */
@@ -1251,6 +1434,8 @@ finish_pass1 (j_decompress_ptr cinfo)
   /* Select the representative colors and fill in cinfo->colormap */
   cinfo->colormap = cquantize->sv_colormap;
   select_colors(cinfo, cquantize->desired);
+  if (cquantize->refine)
+    refine_colors(cinfo);
   /* Force next pass to zero the color index table */
   cquantize->needs_zeroed = true;
 }
@@ -1280,10 +1465,13 @@ start_pass_2_quant (j_decompress_ptr cinfo, bool is_pre_scan)
     cquantize->needs_zeroed = true; /* Always zero histogram */
   } else {
     /* Set up method pointers */
-    cquantize->pub.color_quantize = pass2_fs_dither;
+    if (cquantize->dither)
+      cquantize->pub.color_quantize = pass2_fs_dither;
+    else
+      cquantize->pub.color_quantize = pass2_no_dither;
     cquantize->pub.finish_pass = finish_pass2;
 
-    {
+    if (cquantize->dither) {
       size_t arraysize = (size_t) ((cinfo->output_width + 2) *
                    (3 * sizeof(FSERROR)));
       /* Allocate Floyd-Steinberg workspace if we didn't already. */
@@ -1300,10 +1488,7 @@ start_pass_2_quant (j_decompress_ptr cinfo, bool is_pre_scan)
   }
   /* Zero the histogram or inverse color map, if necessary */
   if (cquantize->needs_zeroed) {
-    for (int i = 0; i < HIST_C0_ELEMS; i++) {
-      memset((void  *) histogram[i], 0,
-        HIST_C1_ELEMS*HIST_C2_ELEMS * sizeof(histcell));
-    }
+    memset((void  *) histogram, 0, HIST_C0_ELEMS * sizeof(hist2d));
     cquantize->needs_zeroed = false;
   }
 }
@@ -1331,7 +1516,6 @@ void
 jinit_2pass_quantizer (j_decompress_ptr cinfo)
 {
   my_cquantize_ptr cquantize;
-  int i;
 
   cquantize = (my_cquantize_ptr) malloc(sizeof(my_cquantizer));
   cinfo->cquantize = (jpeg_color_quantizer *) cquantize;
@@ -1339,13 +1523,12 @@ jinit_2pass_quantizer (j_decompress_ptr cinfo)
   cquantize->pub.new_color_map = new_color_map_2_quant;
   cquantize->fserrors = NULL;   /* flag optional arrays not allocated */
   cquantize->error_limiter = NULL;
+  cquantize->dither = true;
+  cquantize->refine = false;
 
 
   /* Allocate the histogram/inverse colormap storage */
   cquantize->histogram = (hist3d) malloc(HIST_C0_ELEMS * sizeof(hist2d));
-  for (i = 0; i < HIST_C0_ELEMS; i++) {
-    cquantize->histogram[i] = (hist2d) malloc(HIST_C1_ELEMS*HIST_C2_ELEMS * sizeof(histcell));
-  }
   cquantize->needs_zeroed = true; /* histogram is garbage now */
 
   /* Allocate storage for the completed colormap, if required.
@@ -1386,33 +1569,6 @@ jinit_2pass_quantizer (j_decompress_ptr cinfo)
 
 
 
-void
-prepare_range_limit_table (j_decompress_ptr cinfo)
-/* Allocate and fill in the sample_range_limit table */
-{
-  JSAMPLE * table;
-  int i;
-
-  table = (JSAMPLE *) malloc((5 * (MAXJSAMPLE+1) + CENTERJSAMPLE) * sizeof(JSAMPLE));
-  cinfo->srl_orig = table;
-  table += (MAXJSAMPLE+1);  /* allow negative subscripts of simple table */
-  cinfo->sample_range_limit = table;
-  /* First segment of "simple" table: limit[x] = 0 for x < 0 */
-  memset(table - (MAXJSAMPLE+1), 0, (MAXJSAMPLE+1) * sizeof(JSAMPLE));
-  /* Main part of "simple" table: limit[x] = x */
-  for (i = 0; i <= MAXJSAMPLE; i++)
-    table[i] = (JSAMPLE) i;
-  table += CENTERJSAMPLE;   /* Point to where post-IDCT table starts */
-  /* End of simple table, rest of first half of post-IDCT table */
-  for (i = CENTERJSAMPLE; i < 2*(MAXJSAMPLE+1); i++)
-    table[i] = MAXJSAMPLE;
-  /* Second half of post-IDCT table */
-  memset(table + (2 * (MAXJSAMPLE+1)), 0,
-      (2 * (MAXJSAMPLE+1) - CENTERJSAMPLE) * sizeof(JSAMPLE));
-  memcpy(table + (4 * (MAXJSAMPLE+1) - CENTERJSAMPLE),
-      cinfo->sample_range_limit, CENTERJSAMPLE * sizeof(JSAMPLE));
-}
-
 } // anonymous namespace
 
 
@@ -1423,7 +1579,7 @@ prepare_range_limit_table (j_decompress_ptr cinfo)
 wxIMPLEMENT_DYNAMIC_CLASS(wxQuantize, wxObject);
 
 void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows,
-    unsigned char *palette, int desiredNoColours)
+    unsigned char *palette, int desiredNoColours, int flags)
 {
     j_decompress dec;
     my_cquantize_ptr cquantize;
@@ -1431,9 +1587,10 @@ void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, uns
     dec.colormap = NULL;
     dec.output_width = w;
     dec.desired_number_of_colors = desiredNoColours;
-    prepare_range_limit_table(&dec);
     jinit_2pass_quantizer(&dec);
     cquantize = (my_cquantize_ptr) dec.cquantize;
+    cquantize->dither = !(flags & wxQUANTIZE_NO_DITHERING);
+    cquantize->refine = (flags & wxQUANTIZE_REFINE_COLOURS) != 0;
 
 
     cquantize->pub.start_pass(&dec, true);
@@ -1451,13 +1608,11 @@ void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, uns
         palette[3 * i + 2] = dec.colormap[2][i];
     }
 
-    for (int ii = 0; ii < HIST_C0_ELEMS; ii++) free(cquantize->histogram[ii]);
     free(cquantize->histogram);
     free(dec.colormap[0]);
     free(dec.colormap[1]);
     free(dec.colormap[2]);
     free(dec.colormap);
-    free(dec.srl_orig);
 
     //free(cquantize->error_limiter);
     free((void*)(cquantize->error_limiter - MAXJSAMPLE)); // To reverse what was done to it
@@ -1510,7 +1665,7 @@ bool wxQuantize::Quantize(const wxImage& src, wxImage& dest,
         outrows[i] = data8bit + w * i;
 
     //RGB->palette
-    DoQuantize(w, h, rows, outrows, palette, desiredNoColours);
+    DoQuantize(w, h, rows, outrows, palette, desiredNoColours, flags);
 
     delete[] rows;
     delete[] outrows;
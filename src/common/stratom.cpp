@@ -0,0 +1,368 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/stratom.cpp
+// Purpose:     wxStringAtom implementation
+// Created:     2020-03-14
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/string.h"
+#endif // WX_PRECOMP
+
+#include "wx/stratom.h"
+#include "wx/thread.h"
+
+// ----------------------------------------------------------------------------
+// private functions
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Hash the string code units using FNV-1a algorithm: the important thing here
+// is that the result is the same for ASCII strings, whether they're given as
+// a sequence of char or wxStringCharType, as it allows FromUTF8() to look up
+// the string without converting it.
+template <typename T>
+inline size_t HashUnits(const T* p, size_t len)
+{
+    wxUint32 hash = 2166136261u;
+    for ( const T* const end = p + len; p != end; ++p )
+    {
+        hash ^= static_cast<wxUint32>(*p);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+inline size_t GetUnitsCount(const wxString& str)
+{
+#if wxUSE_UNICODE_UTF8
+    return str.utf8_length();
+#else
+    return str.length();
+#endif
+}
+
+inline size_t HashString(const wxString& str)
+{
+    return HashUnits(str.wx_str(), GetUnitsCount(str));
+}
+
+// Check if the (not necessarily NUL-terminated) string is in 7 bit ASCII and
+// return its hash if it is.
+inline bool IsASCII(const char* p, size_t len, size_t* hash)
+{
+    for ( size_t n = 0; n < len; n++ )
+    {
+        if ( static_cast<unsigned char>(p[n]) >= 0x80 )
+            return false;
+    }
+
+    *hash = HashUnits(reinterpret_cast<const unsigned char*>(p), len);
+    return true;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxStringAtomPool: the hash table containing all atoms
+// ----------------------------------------------------------------------------
+
+// This is a simple open addressing hash table using linear probing. It only
+// stores the pointers to the entries, so it's as compact as possible and, as
+// the entries cache their hashes, growing it never needs to rehash strings.
+class wxStringAtomPool
+{
+public:
+    typedef wxStringAtom::Entry Entry;
+
+    static wxStringAtomPool& Get()
+    {
+        static wxStringAtomPool s_pool;
+        return s_pool;
+    }
+
+    // Return the existing entry with its reference count incremented or a
+    // new one if there is none yet.
+    Entry* Intern(const wxString& str)
+    {
+        const size_t hash = HashString(str);
+        const size_t units = GetUnitsCount(str);
+
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        size_t slot;
+        for ( slot = FirstSlot(hash); m_table[slot]; slot = NextSlot(slot) )
+        {
+            Entry* const entry = m_table[slot];
+            if ( entry != Deleted() && entry->m_hash == hash &&
+                    GetUnitsCount(entry->m_str) == units &&
+                        entry->m_str == str && AddRef(slot) )
+            {
+                return entry;
+            }
+        }
+
+        return Insert(slot, new Entry(str, hash));
+    }
+
+    // Same as above, but for the ASCII string of the given length.
+    Entry* InternASCII(const char* p, size_t len, size_t hash)
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        size_t slot;
+        for ( slot = FirstSlot(hash); m_table[slot]; slot = NextSlot(slot) )
+        {
+            Entry* const entry = m_table[slot];
+            if ( entry != Deleted() && entry->m_hash == hash &&
+                    GetUnitsCount(entry->m_str) == len )
+            {
+                const wxStringCharType* const s = entry->m_str.wx_str();
+
+                size_t n;
+                for ( n = 0; n < len; n++ )
+                {
+                    if ( static_cast<wxStringCharType>(p[n]) != s[n] )
+                        break;
+                }
+
+                if ( n == len && AddRef(slot) )
+                    return entry;
+            }
+        }
+
+        return Insert(slot, new Entry(wxString::FromAscii(p, len), hash));
+    }
+
+    void Release(Entry* entry)
+    {
+        // Usually this is not the last reference to the entry and then we
+        // don't need to lock anything.
+        if ( wxAtomicDec(entry->m_refCount) != 0 )
+            return;
+
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        // Remove the entry from the table, unless AddRef() had already done
+        // it while we were waiting for the lock. Note that nobody else can
+        // use the entry any more, so it's safe to delete it in any case.
+        for ( size_t slot = FirstSlot(entry->m_hash);
+              m_table[slot];
+              slot = NextSlot(slot) )
+        {
+            if ( m_table[slot] == entry )
+            {
+                RemoveSlot(slot);
+                break;
+            }
+        }
+
+        delete entry;
+    }
+
+    size_t GetCount()
+    {
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        return m_count;
+    }
+
+private:
+    wxStringAtomPool()
+    {
+        m_capacity = 0;
+        m_count =
+        m_used = 0;
+
+        // Allocate the initial table right now to avoid having to check for
+        // it in the lookup functions.
+        Resize(INITIAL_CAPACITY);
+    }
+
+    ~wxStringAtomPool()
+    {
+        // Don't delete the entries here, as the atoms referencing them may
+        // still exist, just forget about them.
+        delete [] m_table;
+    }
+
+    // Special pointer value used for the entries marked as deleted.
+    static Entry* Deleted()
+    {
+        static char s_deletedMarker;
+        return reinterpret_cast<Entry*>(&s_deletedMarker);
+    }
+
+    // Add a reference to the entry found in the table during the lookup.
+    //
+    // This fails if the entry is being destroyed, i.e. if its last reference
+    // has just been released by another thread which is now waiting for the
+    // lock to delete it. In this case the entry is removed from the table
+    // here, so that it's not found again, and a new one must be created.
+    bool AddRef(size_t slot)
+    {
+        Entry* const entry = m_table[slot];
+        if ( wxAtomicAdd(entry->m_refCount, 1) != 1 )
+            return true;
+
+        wxAtomicDec(entry->m_refCount);
+        RemoveSlot(slot);
+
+        return false;
+    }
+
+    void RemoveSlot(size_t slot)
+    {
+        // We can't just empty the slot as this would break the probing chains
+        // of the entries after it, so mark it as deleted instead.
+        m_table[slot] = Deleted();
+        m_count--;
+    }
+
+    size_t FirstSlot(size_t hash) const { return hash & (m_capacity - 1); }
+    size_t NextSlot(size_t slot) const { return (slot + 1) & (m_capacity - 1); }
+
+    Entry* Insert(size_t slot, Entry* entry)
+    {
+        // Reusing deleted slots would be possible too, but this would require
+        // remembering the first such slot during the lookup, so don't bother
+        // and just compact the table when it becomes too full instead.
+        m_table[slot] = entry;
+        m_count++;
+
+        // Keep the load factor under 3/4.
+        if ( ++m_used * 4 > m_capacity * 3 )
+        {
+            size_t capacity = m_capacity;
+            if ( m_count * 2 > m_capacity )
+                capacity *= 2;
+
+            Resize(capacity);
+        }
+
+        return entry;
+    }
+
+    void Resize(size_t capacity)
+    {
+        Entry** const tableOld = m_capacity ? m_table : NULL;
+        const size_t capacityOld = m_capacity;
+
+        m_table = new Entry*[capacity];
+        memset(m_table, 0, capacity*sizeof(Entry*));
+        m_capacity = capacity;
+
+        for ( size_t n = 0; n < capacityOld; n++ )
+        {
+            Entry* const entry = tableOld[n];
+            if ( !entry || entry == Deleted() )
+                continue;
+
+            size_t slot = FirstSlot(entry->m_hash);
+            while ( m_table[slot] )
+                slot = NextSlot(slot);
+
+            m_table[slot] = entry;
+        }
+
+        // Deleted entries are not copied into the new table.
+        m_used = m_count;
+
+        delete [] tableOld;
+    }
+
+    enum { INITIAL_CAPACITY = 256 };
+
+    // The hash table itself: its capacity is always a power of 2 and the
+    // number of used slots, including the deleted ones, is always less than
+    // it, so that the lookup loops always terminate.
+    Entry** m_table;
+    size_t m_capacity;
+
+    // The number of the live entries and of all non-empty slots.
+    size_t m_count,
+           m_used;
+
+    wxCRIT_SECT_DECLARE_MEMBER(m_cs);
+
+    wxDECLARE_NO_COPY_CLASS(wxStringAtomPool);
+};
+
+namespace
+{
+
+// Ensure that the pool is created during the program initialization, before
+// any threads can be started, as initialization of the static variable inside
+// wxStringAtomPool::Get() is not thread-safe in C++98.
+wxStringAtomPool& gs_poolInit = wxStringAtomPool::Get();
+
+} // anonymous namespace
+
+// ============================================================================
+// wxStringAtom implementation
+// ============================================================================
+
+void wxStringAtom::Init(const wxString& str)
+{
+    m_entry = str.empty() ? NULL : wxStringAtomPool::Get().Intern(str);
+}
+
+/* static */
+wxStringAtom wxStringAtom::FromUTF8(const char* utf8, size_t len)
+{
+    if ( !utf8 )
+        return wxStringAtom();
+
+    if ( len == wxNO_LEN )
+        len = strlen(utf8);
+
+    if ( !len )
+        return wxStringAtom();
+
+    size_t hash;
+    if ( IsASCII(utf8, len, &hash) )
+        return wxStringAtom(wxStringAtomPool::Get().InternASCII(utf8, len, hash));
+
+    return wxStringAtom(wxString::FromUTF8(utf8, len));
+}
+
+void wxStringAtom::Release()
+{
+    if ( m_entry )
+    {
+        wxStringAtomPool::Get().Release(m_entry);
+        m_entry = NULL;
+    }
+}
+
+/* static */
+const wxString& wxStringAtom::GetEmptyString()
+{
+    static const wxString s_empty;
+    return s_empty;
+}
+
+/* static */
+size_t wxStringAtom::GetPoolSize()
+{
+    return wxStringAtomPool::Get().GetCount();
+}
@@ -44,6 +44,9 @@
 // the temporary buffer size used when copying from stream to stream
 #define BUF_TEMP_SIZE 4096
 
+// the buffer size used when copying the entire stream to another one
+#define BUF_COPY_SIZE 65536
+
 // ============================================================================
 // implementation
 // ============================================================================
@@ -412,7 +415,35 @@ size_t wxStreamBuffer::Read(void *buffer, size_t size)
     {
         size_t orig_size = size;
 
-        while ( size > 0 )
+        // Reads bigger than our buffer bypass it: take the data remaining in
+        // it and then read directly into the caller buffer as long as there
+        // is enough data to fill our buffer left to read.
+        wxInputStream * const inStream = m_flushable ? GetInputStream() : NULL;
+        bool eof = false;
+        if ( inStream && size > GetBytesLeft() &&
+                size - GetBytesLeft() >= GetBufferSize() )
+        {
+            const size_t left = GetBytesLeft();
+            GetFromBuffer(buffer, left);
+            size -= left;
+            buffer = (char *)buffer + left;
+
+            while ( size >= GetBufferSize() )
+            {
+                const size_t count = inStream->OnSysRead(buffer, size);
+                if ( !count )
+                {
+                    SetError(wxSTREAM_EOF);
+                    eof = true;
+                    break;
+                }
+
+                size -= count;
+                buffer = (char *)buffer + count;
+            }
+        }
+
+        while ( size > 0 && !eof )
         {
             size_t left = GetDataLeft();
 
@@ -494,6 +525,30 @@ size_t wxStreamBuffer::Write(const void *buffer, size_t size)
     {
         size_t orig_size = size;
 
+        // Writes bigger than our buffer bypass it: flush the data already in
+        // it and then write the new data directly.
+        wxOutputStream * const
+            outStream = m_fixed && m_flushable ? GetOutputStream() : NULL;
+        if ( outStream && size >= GetBufferSize() )
+        {
+            if ( m_buffer_pos != m_buffer_start && !FlushBuffer() )
+            {
+                SetError(wxSTREAM_WRITE_ERROR);
+            }
+            else
+            {
+                const size_t count = outStream->OnSysWrite(buffer, size);
+                if ( count != size )
+                    SetError(wxSTREAM_WRITE_ERROR);
+
+                size -= count;
+            }
+
+            // don't write anything more in the loop below
+            orig_size -= size;
+            size = 0;
+        }
+
         while ( size > 0 )
         {
             size_t left = GetBytesLeft();
@@ -893,15 +948,18 @@ char wxInputStream::Peek()
 wxInputStream& wxInputStream::Read(wxOutputStream& stream_out)
 {
     size_t lastcount = 0;
-    char buf[BUF_TEMP_SIZE];
+
+    // use a big buffer as this is typically used for copying entire files and
+    // big reads and writes bypass the buffers of the buffered streams
+    wxCharBuffer buf(BUF_COPY_SIZE);
 
     for ( ;; )
     {
-        size_t bytes_read = Read(buf, WXSIZEOF(buf)).LastRead();
+        size_t bytes_read = Read(buf.data(), BUF_COPY_SIZE).LastRead();
         if ( !bytes_read )
             break;
 
-        if ( stream_out.Write(buf, bytes_read).LastWrite() != bytes_read )
+        if ( stream_out.Write(buf.data(), bytes_read).LastWrite() != bytes_read )
             break;
 
         lastcount += bytes_read;
@@ -953,6 +1011,26 @@ bool wxInputStream::ReadAll(void *buffer_, size_t size)
     return size == 0;
 }
 
+wxInputStream& wxInputStream::ReadV(const wxStreamIOVec *vec, size_t count)
+{
+    size_t totalCount = 0;
+
+    for ( size_t n = 0; n < count; n++ )
+    {
+        if ( !vec[n].size )
+            continue;
+
+        const bool ok = ReadAll(vec[n].data, vec[n].size);
+        totalCount += m_lastcount;
+        if ( !ok )
+            break;
+    }
+
+    m_lastcount = totalCount;
+
+    return *this;
+}
+
 wxFileOffset wxInputStream::SeekI(wxFileOffset pos, wxSeekMode mode)
 {
     // RR: This code is duplicated in wxBufferedInputStream. This is
@@ -1102,6 +1180,26 @@ bool wxOutputStream::WriteAll(const void *buffer_, size_t size)
     return size == 0;
 }
 
+wxOutputStream& wxOutputStream::WriteV(const wxStreamIOVec *vec, size_t count)
+{
+    size_t totalCount = 0;
+
+    for ( size_t n = 0; n < count; n++ )
+    {
+        if ( !vec[n].size )
+            continue;
+
+        const bool ok = WriteAll(vec[n].data, vec[n].size);
+        totalCount += m_lastcount;
+        if ( !ok )
+            break;
+    }
+
+    m_lastcount = totalCount;
+
+    return *this;
+}
+
 wxFileOffset wxOutputStream::TellO() const
 {
     return OnSysTell();
@@ -483,21 +483,13 @@ const wchar_t *wxString::AsWChar(const wxMBConv& conv) const
     if ( lenWC == wxCONV_FAILED )
         return NULL;
 
-    // keep the same buffer if the string size didn't change: this is not only
-    // an optimization but also ensure that code which modifies string
-    // character by character (without changing its length) can continue to use
-    // the pointer returned by a previous wc_str() call even after changing the
+    // this keeps the same buffer if it's big enough: this is not only an
+    // optimization but also ensures that code which modifies string character
+    // by character (without changing its length) can continue to use the
+    // pointer returned by a previous wc_str() call even after changing the
     // string
-
-    // TODO-UTF8: we could check for ">" instead of "!=" here as this would
-    //            allow to save on buffer reallocations but at the cost of
-    //            consuming (even) more memory, we should benchmark this to
-    //            determine if it's worth doing
-    if ( !m_convertedToWChar.m_str || lenWC != m_convertedToWChar.m_len )
-    {
-        if ( !const_cast<wxString *>(this)->m_convertedToWChar.Extend(lenWC) )
-            return NULL;
-    }
+    if ( !const_cast<wxString *>(this)->m_convertedToWChar.Extend(lenWC) )
+        return NULL;
 
     // finally do convert
     m_convertedToWChar.m_str[lenWC] = L'\0';
@@ -530,15 +522,40 @@ const char *wxString::AsChar(const wxMBConv& conv) const
     const size_t lenWC = m_impl.length();
 #endif // wxUSE_UNICODE_UTF8/wxUSE_UNICODE_WCHAR
 
+#if wxUSE_UNICODE_WCHAR
+    // converting ASCII strings to UTF-8 is trivial and very common, so check
+    // for it to avoid calling the conversion object twice, first to find the
+    // length of the result and then to actually convert the string
+    if ( conv.IsUTF8() )
+    {
+        size_t n;
+        for ( n = 0; n < lenWC; n++ )
+        {
+            if ( static_cast<wxUint32>(strWC[n]) >= 0x80 )
+                break;
+        }
+
+        if ( n == lenWC )
+        {
+            if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenWC) )
+                return NULL;
+
+            char * const dst = m_convertedToChar.m_str;
+            for ( n = 0; n < lenWC; n++ )
+                dst[n] = static_cast<char>(strWC[n]);
+            dst[lenWC] = '\0';
+
+            return dst;
+        }
+    }
+#endif // wxUSE_UNICODE_WCHAR
+
     const size_t lenMB = conv.FromWChar(NULL, 0, strWC, lenWC);
     if ( lenMB == wxCONV_FAILED )
         return NULL;
 
-    if ( !m_convertedToChar.m_str || lenMB != m_convertedToChar.m_len )
-    {
-        if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenMB) )
-            return NULL;
-    }
+    if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenMB) )
+        return NULL;
 
     m_convertedToChar.m_str[lenMB] = '\0';
     if ( conv.FromWChar(m_convertedToChar.m_str, lenMB,
@@ -1081,11 +1098,34 @@ int wxString::CmpNoCase(const wxString& s) const
     const pchar_type thisBegin = m_impl.c_str();
     const pchar_type thatBegin = s.m_impl.c_str();
 
-    const pchar_type thisEnd = thisBegin + m_impl.length();
-    const pchar_type thatEnd = thatBegin + s.m_impl.length();
+    const size_t thisLen = m_impl.length();
+    const size_t thatLen = s.m_impl.length();
+
+    const pchar_type thisEnd = thisBegin + thisLen;
+    const pchar_type thatEnd = thatBegin + thatLen;
+
+    // Start by skipping the common prefix of both strings, which can be done
+    // much faster than comparing them case-insensitively as it doesn't
+    // require converting the characters to lower case one by one. This makes
+    // a big difference when sorting many strings with common prefixes, e.g.
+    // file paths. Use memcmp(), which is typically optimized to compare many
+    // bytes at once, for long prefixes.
+    const size_t lenCommon = thisLen < thatLen ? thisLen : thatLen;
+    size_t n = 0;
+
+    static const size_t BLOCK_LEN = 16;
+    while ( n + BLOCK_LEN <= lenCommon &&
+                memcmp(thisBegin + n, thatBegin + n,
+                       BLOCK_LEN*sizeof(thisBegin[0])) == 0 )
+    {
+        n += BLOCK_LEN;
+    }
 
-    pchar_type thisCur = thisBegin;
-    pchar_type thatCur = thatBegin;
+    while ( n < lenCommon && thisBegin[n] == thatBegin[n] )
+        n++;
+
+    pchar_type thisCur = thisBegin + n;
+    pchar_type thatCur = thatBegin + n;
 
     int rc;
     for ( ;; )
@@ -1258,13 +1298,19 @@ wxString wxString::Mid(size_t nFirst, size_t nCount) const
 // in the provided pointer if it is not NULL, otherwise return false
 bool wxString::StartsWith(const wxString& prefix, wxString *rest) const
 {
-    if ( compare(0, prefix.length(), prefix) != 0 )
+    // compare the underlying representations directly: this is equivalent to
+    // comparing the characters but doesn't require finding the length of the
+    // strings in characters, which is expensive in UTF-8 build
+    const size_t lenPrefix = prefix.m_impl.length();
+    if ( lenPrefix > m_impl.length() ||
+            memcmp(m_impl.c_str(), prefix.m_impl.c_str(),
+                   lenPrefix*sizeof(wxStringCharType)) != 0 )
         return false;
 
     if ( rest )
     {
         // put the rest of the string into provided pointer
-        rest->assign(*this, prefix.length(), npos);
+        *rest = FromImpl(m_impl.substr(lenPrefix));
     }
 
     return true;
@@ -1275,15 +1321,20 @@ bool wxString::StartsWith(const wxString& prefix, wxString *rest) const
 // provided pointer if it is not NULL, otherwise return false
 bool wxString::EndsWith(const wxString& suffix, wxString *rest) const
 {
-    int start = length() - suffix.length();
+    // see the comment in StartsWith()
+    const size_t lenSuffix = suffix.m_impl.length();
+    if ( lenSuffix > m_impl.length() )
+        return false;
 
-    if ( start < 0 || compare(start, npos, suffix) != 0 )
+    const size_t start = m_impl.length() - lenSuffix;
+    if ( memcmp(m_impl.c_str() + start, suffix.m_impl.c_str(),
+                lenSuffix*sizeof(wxStringCharType)) != 0 )
         return false;
 
     if ( rest )
     {
         // put the rest of the string into provided pointer
-        rest->assign(*this, 0, start);
+        *rest = FromImpl(m_impl.substr(0, start));
     }
 
     return true;
@@ -1408,19 +1459,26 @@ size_t wxString::Replace(const wxString& strOld,
         const wxStringCharType chOld = strOld.m_impl[0],
                                chNew = strNew.m_impl[0];
 
-        // this loop is the simplified version of the one below
-        for ( size_t pos = 0; ; )
-        {
-            pos = m_impl.find(chOld, pos);
-            if ( pos == npos )
-                break;
-
-            m_impl[pos++] = chNew;
+        const size_t pos = m_impl.find(chOld);
+        if ( pos == npos )
+            return 0;
 
-            uiCount++;
+        wxStringCharType* p = &*m_impl.begin() + pos;
+        if ( !bReplaceAll )
+        {
+            *p = chNew;
+            return 1;
+        }
 
-            if ( !bReplaceAll )
-                break;
+        // work with the buffer directly instead of calling find() again for
+        // each character, which is much slower when there are many of them,
+        // and write this loop in a way allowing the compiler to vectorize it
+        const wxStringCharType* const end = p + (m_impl.length() - pos);
+        for ( ; p != end; ++p )
+        {
+            const bool match = *p == chOld;
+            uiCount += match;
+            *p = match ? chNew : *p;
         }
     }
     else if ( !bReplaceAll)
@@ -1437,8 +1495,55 @@ size_t wxString::Replace(const wxString& strOld,
         const size_t uiOldLen = strOld.m_impl.length();
         const size_t uiNewLen = strNew.m_impl.length();
 
-        // first scan the string to find all positions at which the replacement
-        // should be made
+        if ( uiNewLen <= uiOldLen )
+        {
+            // the string doesn't grow, so we can make all the replacements in
+            // place, in a single pass and without allocating any memory
+            size_t pos = m_impl.find(strOld.m_impl, 0);
+            if ( pos == npos )
+                return 0;
+
+            // note that the new string could be this string itself, so use
+            // memmove() and not memcpy() below
+            wxStringCharType* const buf = &*m_impl.begin();
+            const wxStringCharType* const bufNew = strNew.m_impl.c_str();
+            const size_t len = m_impl.length();
+
+            // the position at which we write the next output character and
+            // from which we read the next input one: the former is never
+            // greater than the latter, so that we don't overwrite anything
+            // before searching in it
+            size_t dst = pos,
+                   src = pos;
+            for ( ;; )
+            {
+                if ( dst != src )
+                    wxTmemmove(buf + dst, buf + src, pos - src);
+                dst += pos - src;
+
+                wxTmemmove(buf + dst, bufNew, uiNewLen);
+                dst += uiNewLen;
+
+                src = pos + uiOldLen;
+
+                uiCount++;
+
+                pos = m_impl.find(strOld.m_impl, src);
+                if ( pos == npos )
+                    break;
+            }
+
+            if ( dst != src )
+            {
+                wxTmemmove(buf + dst, buf + src, len - src);
+                m_impl.erase(dst + len - src);
+            }
+
+            return uiCount;
+        }
+
+        // otherwise first scan the string to find all positions at which the
+        // replacement should be made
         wxVector<size_t> replacePositions;
 
         size_t pos;
@@ -1957,6 +2062,25 @@ int wxString::DoPrintfUtf8(const char *format, ...)
 }
 #endif // wxUSE_UNICODE_UTF8
 
+// size of the stack buffer used by DoStringPrintfV() before falling back to a
+// heap-allocated one: most formatted strings are short and fit into it
+static const int wxPRINTF_STACK_BUFFER_SIZE = 256;
+
+// helpers for DoStringPrintfV() assigning the contents of the stack buffer to
+// the string (notice that, as with the heap buffer, the string is truncated at
+// the first NUL character if any)
+#if wxUSE_UNICODE_UTF8
+static inline void DoAssignPrintfBuffer(wxString& str, const char *buf)
+{
+    str = wxString::FromUTF8Unchecked(buf);
+}
+#endif // wxUSE_UNICODE_UTF8
+
+static inline void DoAssignPrintfBuffer(wxString& str, const wxChar *buf)
+{
+    str = buf;
+}
+
 /*
     Uses wxVsnprintf and places the result into the this string.
 
@@ -2023,6 +2147,37 @@ static int DoStringPrintfV(wxString& str,
 {
     int size = 1024;
 
+    // try formatting into a buffer on the stack first: if the result fits
+    // into it, we avoid allocating (and then shrinking) a big heap buffer
+    {
+#if wxUSE_UNICODE_UTF8
+        typename BufferType::CharType buf[wxPRINTF_STACK_BUFFER_SIZE + 1];
+#else
+        wxChar buf[wxPRINTF_STACK_BUFFER_SIZE + 1];
+#endif
+
+        va_list argptrcopy;
+        wxVaCopy(argptrcopy, argptr);
+        const int len = wxVsnprintf(buf, wxPRINTF_STACK_BUFFER_SIZE,
+                                    format, argptrcopy);
+        va_end(argptrcopy);
+
+        if ( len >= 0 && len < wxPRINTF_STACK_BUFFER_SIZE )
+        {
+            buf[len] = wxT('\0');
+            DoAssignPrintfBuffer(str, buf);
+            return str.length();
+        }
+
+        // otherwise use the loop below which also deals with all the errors
+#if !wxUSE_WXVSNPRINTF
+        // if the system vsnprintf() told us how much space it needs, use it
+        // directly instead of starting with the default size
+        if ( len > 0 )
+            size = len + 1;
+#endif // !wxUSE_WXVSNPRINTF
+    }
+
     for ( ;; )
     {
 #if wxUSE_UNICODE_UTF8
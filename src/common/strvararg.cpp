@@ -25,6 +25,7 @@
 #include "wx/strvararg.h"
 #include "wx/string.h"
 #include "wx/crt.h"
+#include "wx/thread.h"
 #include "wx/private/wxprintf.h"
 
 // ============================================================================
@@ -682,6 +683,129 @@ wxString wxFormatString::InputAsString() const
 namespace
 {
 
+// special values returned by GetFormatArgType() in addition to the
+// wxPrintfArgType ones (which are all greater than or equal to -1)
+const int ArgType_Missing = -2;     // no specifier for this argument
+const int ArgType_Unused = -3;      // argument beyond the last one
+
+// GetArgumentType() is called for every argument of every wxString::Format()
+// call (or any other vararg function) and parsing the entire format string
+// each time is expensive, so keep a small cache of the recently parsed ones.
+//
+// The cache only uses fixed size arrays, so that it doesn't need to be
+// constructed nor destroyed and can be used even during the program
+// initialization or shutdown. Format strings which are too long or have too
+// many arguments are simply not cached.
+//
+// This class is not MT-safe, the caller must ensure serialization.
+template<typename CharType>
+class ParsedFormatCache
+{
+public:
+    enum
+    {
+        MaxEntries = 16,
+        MaxFormatLen = 127,
+        MaxArgs = 16
+    };
+
+    struct Entry
+    {
+        // the pointer to the format string used as the key and a copy of the
+        // string itself used to check that the memory pointed to by it hasn't
+        // been reused for a different string since it was parsed
+        const CharType *format;
+        CharType copy[MaxFormatLen + 1];
+
+        // the wxPrintfArgType of each argument or ArgType_Missing
+        unsigned nargs;
+        signed char argTypes[MaxArgs];
+    };
+
+    // return the cached entry for this format string or NULL
+    const Entry* Find(const CharType *format) const
+    {
+        for ( unsigned n = 0; n < MaxEntries; n++ )
+        {
+            const Entry& entry = m_entries[n];
+            if ( entry.format == format && wxStrcmp(entry.copy, format) == 0 )
+                return &entry;
+        }
+
+        return NULL;
+    }
+
+    // add a new entry replacing the oldest one if possible
+    void Add(const CharType *format,
+             const wxPrintfConvSpecParser<CharType>& parser)
+    {
+        if ( parser.nargs > MaxArgs )
+            return;
+
+        const size_t len = wxStrlen(format);
+        if ( len > MaxFormatLen )
+            return;
+
+        Entry& entry = m_entries[m_next];
+        m_next = (m_next + 1) % MaxEntries;
+
+        entry.format = format;
+        memcpy(entry.copy, format, (len + 1)*sizeof(CharType));
+
+        entry.nargs = parser.nargs;
+        for ( unsigned i = 0; i < parser.nargs; i++ )
+        {
+            entry.argTypes[i] = parser.pspec[i]
+                                    ? static_cast<signed char>(parser.pspec[i]->m_type)
+                                    : ArgType_Missing;
+        }
+    }
+
+private:
+    // notice that this class is only used for static objects, so these fields
+    // are initialized to 0 without needing a ctor
+    Entry m_entries[MaxEntries];
+    unsigned m_next;
+};
+
+// return the wxPrintfArgType of the n-th argument (1-based), ArgType_Missing if
+// it's not referenced by the format string or ArgType_Unused if n is greater
+// than the number of arguments
+template<typename CharType>
+int GetFormatArgType(const CharType *format, unsigned n)
+{
+    static ParsedFormatCache<CharType> s_cache;
+    wxCRIT_SECT_DECLARE(s_csCache);
+
+    {
+        wxCRIT_SECT_LOCKER(lock, s_csCache);
+
+        if ( const typename ParsedFormatCache<CharType>::Entry* const
+                entry = s_cache.Find(format) )
+        {
+            if ( n > entry->nargs )
+                return ArgType_Unused;
+
+            return entry->argTypes[n - 1];
+        }
+    }
+
+    // Don't parse the string while holding the lock, the parser may use
+    // wxString::Format() itself when reporting errors in the format string.
+    wxPrintfConvSpecParser<CharType> parser(format);
+
+    {
+        wxCRIT_SECT_LOCKER(lock, s_csCache);
+
+        s_cache.Add(format, parser);
+    }
+
+    if ( n > parser.nargs )
+        return ArgType_Unused;
+
+    return parser.pspec[n - 1] ? parser.pspec[n - 1]->m_type : ArgType_Missing;
+}
+
 template<typename CharType>
 wxFormatString::ArgumentType DoGetArgumentType(const CharType *format,
                                                unsigned n)
@@ -689,9 +813,9 @@ wxFormatString::ArgumentType DoGetArgumentType(const CharType *format,
     wxCHECK_MSG( format, wxFormatString::Arg_Unknown,
                  "empty format string not allowed here" );
 
-    wxPrintfConvSpecParser<CharType> parser(format);
+    const int argType = GetFormatArgType(format, n);
 
-    if ( n > parser.nargs )
+    if ( argType == ArgType_Unused )
     {
         // The n-th argument doesn't appear in the format string and is unused.
         // This can happen e.g. if a translation of the format string is used
@@ -703,10 +827,10 @@ wxFormatString::ArgumentType DoGetArgumentType(const CharType *format,
         return wxFormatString::Arg_Unused;
     }
 
-    wxCHECK_MSG( parser.pspec[n-1] != NULL, wxFormatString::Arg_Unknown,
+    wxCHECK_MSG( argType != ArgType_Missing, wxFormatString::Arg_Unknown,
                  "requested argument not found - invalid format string?" );
 
-    switch ( parser.pspec[n-1]->m_type )
+    switch ( static_cast<wxPrintfArgType>(argType) )
     {
         case wxPAT_CHAR:
         case wxPAT_WCHAR:
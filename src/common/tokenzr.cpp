@@ -41,36 +41,44 @@
 // helpers
 // ----------------------------------------------------------------------------
 
-static wxString::const_iterator
-find_first_of(const wxChar *delims, size_t len,
-              const wxString::const_iterator& from,
-              const wxString::const_iterator& end)
+// The delimiters are almost always ASCII characters, so check for them using
+// the bit mask instead of searching for each character of the string in the
+// delimiters string, which is much slower.
+inline bool wxStringTokenizer::IsDelim(wxUniChar ch) const
 {
-    wxASSERT_MSG( from <= end,  wxT("invalid index") );
+    const wxUniChar::value_type value = ch.GetValue();
+    if ( value < 0x80 )
+        return (m_asciiDelims[value / 32] & (1u << (value % 32))) != 0;
 
-    for ( wxString::const_iterator i = from; i != end; ++i )
+    return m_hasNonAsciiDelims && wxTmemchr(m_delims, ch, m_delimsLen);
+}
+
+wxString::const_iterator
+wxStringTokenizer::FindDelim(wxString::const_iterator from) const
+{
+    wxASSERT_MSG( from <= m_stringEnd,  wxT("invalid index") );
+
+    for ( ; from != m_stringEnd; ++from )
     {
-        if ( wxTmemchr(delims, *i, len) )
-            return i;
+        if ( IsDelim(*from) )
+            break;
     }
 
-    return end;
+    return from;
 }
 
-static wxString::const_iterator
-find_first_not_of(const wxChar *delims, size_t len,
-                  const wxString::const_iterator& from,
-                  const wxString::const_iterator& end)
+wxString::const_iterator
+wxStringTokenizer::FindNonDelim(wxString::const_iterator from) const
 {
-    wxASSERT_MSG( from <= end,  wxT("invalid index") );
+    wxASSERT_MSG( from <= m_stringEnd,  wxT("invalid index") );
 
-    for ( wxString::const_iterator i = from; i != end; ++i )
+    for ( ; from != m_stringEnd; ++from )
     {
-        if ( !wxTmemchr(delims, *i, len) )
-            return i;
+        if ( !IsDelim(*from) )
+            break;
     }
 
-    return end;
+    return from;
 }
 
 // ----------------------------------------------------------------------------
@@ -136,6 +144,17 @@ void wxStringTokenizer::SetString(const wxString& str,
 #endif
     m_delimsLen = delims.length();
 
+    memset(m_asciiDelims, 0, sizeof(m_asciiDelims));
+    m_hasNonAsciiDelims = false;
+    for ( wxString::const_iterator p = delims.begin(); p != delims.end(); ++p )
+    {
+        const wxUniChar::value_type value = (*p).GetValue();
+        if ( value < 0x80 )
+            m_asciiDelims[value / 32] |= 1u << (value % 32);
+        else
+            m_hasNonAsciiDelims = true;
+    }
+
     m_mode = mode;
 
     Reinit(str);
@@ -159,6 +178,8 @@ void wxStringTokenizer::DoCopyFrom(const wxStringTokenizer& src)
     m_pos = m_string.begin() + (src.m_pos - src.m_string.begin());
     m_delims = src.m_delims;
     m_delimsLen = src.m_delimsLen;
+    memcpy(m_asciiDelims, src.m_asciiDelims, sizeof(m_asciiDelims));
+    m_hasNonAsciiDelims = src.m_hasNonAsciiDelims;
     m_mode = src.m_mode;
     m_lastDelim = src.m_lastDelim;
     m_hasMoreTokens = src.m_hasMoreTokens;
@@ -191,8 +212,7 @@ bool wxStringTokenizer::DoHasMoreTokens() const
 {
     wxCHECK_MSG( IsOk(), false, wxT("you should call SetString() first") );
 
-    if ( find_first_not_of(m_delims, m_delimsLen, m_pos, m_stringEnd)
-         != m_stringEnd )
+    if ( FindNonDelim(m_pos) != m_stringEnd )
     {
         // there are non delimiter characters left, so we do have more tokens
         return true;
@@ -254,28 +274,29 @@ size_t wxStringTokenizer::CountTokens() const
 // token extraction
 // ----------------------------------------------------------------------------
 
-wxString wxStringTokenizer::GetNextToken()
+bool wxStringTokenizer::GetNextTokenRange(wxString::const_iterator* tokenStart,
+                                          wxString::const_iterator* tokenEnd)
 {
-    wxString token;
+    wxCHECK_MSG( tokenStart && tokenEnd, false, wxT("NULL pointer") );
+
     do
     {
         if ( !HasMoreTokens() )
-        {
-            break;
-        }
+            return false;
 
         m_hasMoreTokens = MoreTokens_Unknown;
 
         // find the end of this token
-        wxString::const_iterator pos =
-            find_first_of(m_delims, m_delimsLen, m_pos, m_stringEnd);
+        const wxString::const_iterator pos = FindDelim(m_pos);
+
+        *tokenStart = m_pos;
 
         // and the start of the next one
         if ( pos == m_stringEnd )
         {
             // no more delimiters, the token is everything till the end of
             // string
-            token.assign(m_pos, m_stringEnd);
+            *tokenEnd = m_stringEnd;
 
             // skip the token
             m_pos = m_stringEnd;
@@ -287,21 +308,29 @@ wxString wxStringTokenizer::GetNextToken()
         {
             // in wxTOKEN_RET_DELIMS mode we return the delimiter character
             // with token, otherwise leave it out
-            wxString::const_iterator tokenEnd(pos);
+            *tokenEnd = pos;
             if ( m_mode == wxTOKEN_RET_DELIMS )
-                ++tokenEnd;
-
-            token.assign(m_pos, tokenEnd);
+                ++*tokenEnd;
 
             // skip the token and the trailing delimiter
             m_pos = pos + 1;
 
-            m_lastDelim = (pos == m_stringEnd) ? wxT('\0') : (wxChar)*pos;
+            m_lastDelim = (wxChar)*pos;
         }
     }
-    while ( !AllowEmpty() && token.empty() );
+    while ( !AllowEmpty() && *tokenStart == *tokenEnd );
+
+    return true;
+}
+
+wxString wxStringTokenizer::GetNextToken()
+{
+    wxString::const_iterator tokenStart,
+                             tokenEnd;
+    if ( !GetNextTokenRange(&tokenStart, &tokenEnd) )
+        return wxString();
 
-    return token;
+    return wxString(tokenStart, tokenEnd);
 }
 
 // ----------------------------------------------------------------------------
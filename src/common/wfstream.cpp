@@ -26,6 +26,115 @@
 #include <stdio.h>
 
 #if wxUSE_FILE
+    #ifdef __UNIX__
+        #include <sys/mman.h>
+        #include <sys/uio.h>
+        #include <errno.h>
+        #include <limits.h>
+    #elif defined(__WINDOWS__)
+        #include "wx/msw/wrapwin.h"
+        #include <io.h>
+    #endif
+#endif // wxUSE_FILE
+
+#if wxUSE_FILE
+
+#ifdef __UNIX__
+
+// maximal number of buffers passed to a single readv() or writev() call
+#if defined(IOV_MAX) && IOV_MAX < 64
+    #define wxMAX_IOVEC IOV_MAX
+#else
+    #define wxMAX_IOVEC 64
+#endif
+
+namespace
+{
+
+typedef ssize_t (*wxIOVecFunc)(int fd, const struct iovec *iov, int count);
+
+// Transfer the data using the given function, which must be either readv() or
+// writev(), until all of it is transferred, an error occurs or nothing at all
+// can be transferred, i.e. EOF is reached when reading.
+//
+// Returns the total number of bytes transferred.
+size_t DoVectoredIO(wxIOVecFunc func, int fd,
+                    const wxStreamIOVec *vec, size_t count,
+                    bool& error)
+{
+    size_t total = 0;
+    size_t offset = 0; // the part of vec[0] already transferred
+
+    error = false;
+
+    for ( ;; )
+    {
+        // skip the buffers already transferred and the empty ones
+        while ( count && offset == vec->size )
+        {
+            vec++;
+            count--;
+            offset = 0;
+        }
+
+        if ( !count )
+            break;
+
+        struct iovec iov[wxMAX_IOVEC];
+        int num = 0;
+        for ( ; num < wxMAX_IOVEC && static_cast<size_t>(num) < count; num++ )
+        {
+            const size_t skip = num ? 0 : offset;
+            iov[num].iov_base = static_cast<char *>(vec[num].data) + skip;
+            iov[num].iov_len = vec[num].size - skip;
+        }
+
+        const ssize_t ret = func(fd, iov, num);
+        if ( ret < 0 )
+        {
+            if ( errno == EINTR )
+                continue;
+
+            error = true;
+            break;
+        }
+
+        if ( !ret )
+            break;
+
+        total += ret;
+
+        for ( size_t done = ret; done; )
+        {
+            const size_t left = vec->size - offset;
+            if ( done < left )
+            {
+                offset += done;
+                break;
+            }
+
+            done -= left;
+            vec++;
+            count--;
+            offset = 0;
+        }
+    }
+
+    return total;
+}
+
+size_t GetTotalSize(const wxStreamIOVec *vec, size_t count)
+{
+    size_t size = 0;
+    for ( size_t n = 0; n < count; n++ )
+        size += vec[n].size;
+
+    return size;
+}
+
+} // anonymous namespace
+
+#endif // __UNIX__
 
 // ----------------------------------------------------------------------------
 // wxFileInputStream
@@ -96,6 +205,30 @@ size_t wxFileInputStream::OnSysRead(void *buffer, size_t size)
     return ret;
 }
 
+wxInputStream& wxFileInputStream::ReadV(const wxStreamIOVec *vec, size_t count)
+{
+#ifdef __UNIX__
+    // the data put back into the stream must be returned first, so leave it
+    // to the base class if there is any
+    if ( !m_wback )
+    {
+        bool error;
+        m_lastcount = DoVectoredIO(readv, m_file->fd(), vec, count, error);
+
+        if ( error )
+            m_lasterror = wxSTREAM_READ_ERROR;
+        else if ( m_lastcount < GetTotalSize(vec, count) )
+            m_lasterror = wxSTREAM_EOF;
+        else
+            m_lasterror = wxSTREAM_NO_ERROR;
+
+        return *this;
+    }
+#endif // __UNIX__
+
+    return wxInputStream::ReadV(vec, count);
+}
+
 wxFileOffset wxFileInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
 {
     return m_file->Seek(pos, mode);
@@ -161,6 +294,22 @@ size_t wxFileOutputStream::OnSysWrite(const void *buffer, size_t size)
     return ret;
 }
 
+wxOutputStream& wxFileOutputStream::WriteV(const wxStreamIOVec *vec, size_t count)
+{
+#ifdef __UNIX__
+    bool error;
+    m_lastcount = DoVectoredIO(writev, m_file->fd(), vec, count, error);
+
+    m_lasterror = m_lastcount == GetTotalSize(vec, count)
+                    ? wxSTREAM_NO_ERROR
+                    : wxSTREAM_WRITE_ERROR;
+
+    return *this;
+#else // !__UNIX__
+    return wxOutputStream::WriteV(vec, count);
+#endif // __UNIX__/!__UNIX__
+}
+
 wxFileOffset wxFileOutputStream::OnSysTell() const
 {
     return m_file->Tell();
@@ -263,6 +412,100 @@ bool wxFileStream::IsOk() const
     return wxFileOutputStream::IsOk() && wxFileInputStream::IsOk();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const wxString& fileName)
+{
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+
+    wxFile file;
+    if ( !file.Open(fileName) )
+    {
+        InitFromData(NULL, 0);
+        m_lasterror = wxSTREAM_READ_ERROR;
+        return;
+    }
+
+    // only regular files can be mapped and mapping empty files doesn't work
+    // (nor make sense) anyhow
+    const wxFileOffset len = file.GetKind() == wxFILE_KIND_DISK
+                                ? file.Length()
+                                : wxInvalidOffset;
+    if ( len > 0 && len == static_cast<wxFileOffset>(static_cast<size_t>(len)) )
+    {
+        m_size = static_cast<size_t>(len);
+
+#ifdef __UNIX__
+        void * const data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE,
+                                 file.fd(), 0);
+        if ( data != MAP_FAILED )
+        {
+            m_data = data;
+            m_mapped = true;
+        }
+#elif defined(__WINDOWS__)
+        HANDLE hMapping = ::CreateFileMapping
+                            (
+                                (HANDLE)_get_osfhandle(file.fd()),
+                                NULL,
+                                PAGE_READONLY,
+                                0, 0,
+                                NULL
+                            );
+        if ( hMapping )
+        {
+            m_data = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+            m_mapped = m_data != NULL;
+
+            // the view keeps the mapping object alive
+            ::CloseHandle(hMapping);
+        }
+#endif // __UNIX__/__WINDOWS__
+    }
+
+    if ( !m_mapped )
+    {
+        // fall back to reading the entire file into memory
+        const size_t chunk = m_size ? m_size : 65536;
+        for ( ;; )
+        {
+            const ssize_t count = file.Read(m_buffer.GetAppendBuf(chunk), chunk);
+            if ( count == wxInvalidOffset )
+            {
+                InitFromData(NULL, 0);
+                m_lasterror = wxSTREAM_READ_ERROR;
+                return;
+            }
+
+            m_buffer.UngetAppendBuf(count);
+            if ( !count )
+                break;
+        }
+
+        m_data = m_buffer.GetData();
+        m_size = m_buffer.GetDataLen();
+    }
+
+    // the file can be closed now, the mapping remains valid until unmapped
+    InitFromData(m_data, m_size);
+}
+
+wxMappedFileInputStream::~wxMappedFileInputStream()
+{
+    if ( m_mapped )
+    {
+#ifdef __UNIX__
+        munmap(m_data, m_size);
+#elif defined(__WINDOWS__)
+        ::UnmapViewOfFile(m_data);
+#endif // __UNIX__/__WINDOWS__
+    }
+}
+
 #endif // wxUSE_FILE
 
 #if wxUSE_FFILE
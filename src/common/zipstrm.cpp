@@ -31,6 +31,11 @@
 #include "wx/wfstream.h"
 #include "zlib.h"
 
+#if wxUSE_THREADS
+    #include "wx/msgqueue.h"
+    #include "wx/thread.h"
+#endif
+
 // value for the 'version needed to extract' field (20 means 2.0)
 enum {
     VERSION_NEEDED_TO_EXTRACT = 20,
@@ -686,8 +691,8 @@ static void Unique(wxZipMemory*& zm, size_t size)
 /////////////////////////////////////////////////////////////////////////////
 // Collection of weak references to entries
 
-WX_DECLARE_HASH_MAP(long, wxZipEntry*, wxIntegerHash,
-                    wxIntegerEqual, wxOffsetZipEntryMap_);
+WX_DECLARE_OPEN_HASH_MAP(long, wxZipEntry*, wxIntegerHash,
+                         wxIntegerEqual, wxOffsetZipEntryMap_);
 
 class wxZipWeakLinks
 {
@@ -1612,6 +1617,7 @@ void wxZipInputStream::Init()
 {
     m_store = new wxStoredInputStream(*m_parent_i_stream);
     m_inflate = NULL;
+    m_memview = NULL;
     m_rawin = NULL;
     m_raw = false;
     m_headerSize = 0;
@@ -1632,6 +1638,7 @@ wxZipInputStream::~wxZipInputStream()
 
     delete m_store;
     delete m_inflate;
+    delete m_memview;
     delete m_rawin;
 
     m_weaklinks->Release(this);
@@ -2025,7 +2032,7 @@ bool wxZipInputStream::OpenDecompressor(bool raw /*=false*/)
                 (m_entry.GetMethod() != wxZIP_METHOD_DEFLATE ||
                  wxZlibInputStream::CanHandleGZip())) {
             m_store->Open(compressedSize);
-            m_decomp = OpenDecompressor(*m_store);
+            m_decomp = OpenDecompressor(GetCompressedData(compressedSize));
         } else {
             m_decomp = OpenDecompressor(*m_parent_i_stream);
         }
@@ -2036,6 +2043,32 @@ bool wxZipInputStream::OpenDecompressor(bool raw /*=false*/)
     return IsOk();
 }
 
+// Returns the stream to read the compressed data of the current entry from.
+// When the archive is in memory, e.g. a mapped file, this is a view of the
+// parent stream data, which allows zlib to inflate it without copying it.
+//
+wxInputStream& wxZipInputStream::GetCompressedData(wxFileOffset size)
+{
+    wxMemoryInputStream * const
+        memory = wxDynamicCast(m_parent_i_stream, wxMemoryInputStream);
+    if (!memory || m_entry.GetMethod() != wxZIP_METHOD_DEFLATE)
+        return *m_store;
+
+    size_t len;
+    const void *data = memory->GetUnreadData(&len);
+    if (!data || size > wxFileOffset(len))
+        return *m_store;
+
+    // the old view can be deleted as the decompressor is reopened next
+    delete m_memview;
+    m_memview = new wxMemoryInputStream(data, size_t(size));
+
+    // leave the parent after the data, as reading it through m_store would
+    memory->SeekI(size, wxFromCurrent);
+
+    return *m_memview;
+}
+
 // Can be overridden to add support for additional decompression methods
 //
 wxInputStream *wxZipInputStream::OpenDecompressor(wxInputStream& stream)
@@ -2156,6 +2189,204 @@ size_t wxZipInputStream::OnSysRead(void *buffer, size_t size)
     return count;
 }
 
+void wxZipInputStream::InitFromIndex(const wxZipIndex& index)
+{
+    m_parentSeekable = true;
+    m_position = index.m_centralOffset;
+    m_offsetAdjustment = index.m_offsetAdjustment;
+    m_TotalEntries = index.GetCount();
+    m_Comment = index.m_Comment;
+    m_signature = m_TotalEntries ? CENTRAL_MAGIC : END_MAGIC;
+}
+
+// Open an entry of an index loaded from this archive. If this stream hasn't
+// been used yet there's no need to search for the end record again.
+//
+bool wxZipInputStream::OpenEntry(const wxZipIndex& index, size_t n)
+{
+    wxCHECK_MSG(index.IsOk(), false, wxT("zip index not loaded"));
+
+    wxZipEntryPtr_ entry(index.GetEntry(n));
+    if (!entry.get())
+        return false;
+
+    if (m_position == wxInvalidOffset) {
+        // an index can only be used with a seekable stream
+        wxCHECK(m_parent_i_stream->IsSeekable(), false);
+        InitFromIndex(index);
+    }
+
+    return DoOpen(entry.get());
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Zip index
+
+static inline wxUint32 HashName(const wxString& name)
+{
+    return static_cast<wxUint32>(wxStringHash::stringHash(name.wx_str()));
+}
+
+// the size of the central directory record starting at rec
+static inline size_t CentralRecordSize(const char *rec)
+{
+    return CENTRAL_SIZE + CrackUint16(rec + 28)
+                        + CrackUint16(rec + 30)
+                        + CrackUint16(rec + 32);
+}
+
+wxZipIndex::wxZipIndex()
+  : m_conv(NULL),
+    m_centralOffset(wxInvalidOffset),
+    m_offsetAdjustment(0)
+{
+}
+
+bool wxZipIndex::Load(wxInputStream& stream, wxMBConv& conv /*=wxConvLocal*/)
+{
+    m_central.SetDataLen(0);
+    m_records.clear();
+    m_hashes.clear();
+    m_table.clear();
+    m_conv = NULL;
+    m_Comment.clear();
+
+    wxCHECK_MSG(stream.IsSeekable(), false,
+                wxT("zip index requires a seekable stream"));
+
+    // use wxZipInputStream to find the end record and the central directory
+    wxUint64 totalEntries;
+    {
+        wxZipInputStream zip(stream, conv);
+        if (!zip.LoadEndRecord() || !zip.m_parentSeekable)
+            return false;
+
+        m_centralOffset = zip.m_position;
+        m_offsetAdjustment = zip.m_offsetAdjustment;
+        m_Comment = zip.m_Comment;
+        totalEntries = zip.m_TotalEntries;
+    }
+
+    // the central directory is only followed by the end records, so read
+    // everything up to the end of the stream at once
+    const wxFileOffset end = stream.SeekI(0, wxFromEnd);
+    if (end == wxInvalidOffset || end < m_centralOffset ||
+            end - m_centralOffset > 0xffffffff ||
+            QuietSeek(stream, m_centralOffset) == wxInvalidOffset)
+        return false;
+
+    const size_t size = wx_truncate_cast(size_t, end - m_centralOffset);
+    char *data = static_cast<char*>(m_central.GetWriteBuf(size));
+    size_t lastRead = stream.Read(data, size).LastRead();
+    m_central.UngetWriteBuf(lastRead);
+    if (lastRead != size) {
+        wxLogError(_("error reading zip central directory"));
+        return false;
+    }
+
+    // don't trust the number of entries in the end record blindly, a corrupt
+    // archive could make us reserve a huge amount of memory otherwise
+    m_records.reserve(wx_truncate_cast(size_t,
+                      wxMin(totalEntries, wxUint64(size / CENTRAL_SIZE))));
+
+    size_t pos = 0;
+    while (pos + CENTRAL_SIZE <= size && CrackUint32(data + pos) == CENTRAL_MAGIC)
+    {
+        const size_t recSize = CentralRecordSize(data + pos);
+        if (pos + recSize > size)
+            break;
+        m_records.push_back(static_cast<wxUint32>(pos));
+        pos += recSize;
+    }
+
+    if (pos + 4 > size || (CrackUint32(data + pos) != END_MAGIC &&
+                           CrackUint32(data + pos) != Z64_END_MAGIC)) {
+        wxLogError(_("error reading zip central directory"));
+        m_records.clear();
+        return false;
+    }
+
+    m_conv = &conv;
+
+    // build the hash table, keeping it at most half full
+    size_t tableSize = 16;
+    while (tableSize < 2 * m_records.size())
+        tableSize *= 2;
+    m_table.resize(tableSize, 0);
+    m_hashes.reserve(m_records.size());
+
+    const size_t mask = tableSize - 1;
+    for (size_t n = 0; n < m_records.size(); n++) {
+        const wxUint32 hash = HashName(GetInternalName(n));
+        m_hashes.push_back(hash);
+
+        size_t i = hash & mask;
+        while (m_table[i])
+            i = (i + 1) & mask;
+        m_table[i] = static_cast<wxUint32>(n + 1);
+    }
+
+    return true;
+}
+
+wxString wxZipIndex::GetInternalName(size_t n) const
+{
+    const char *rec = static_cast<const char*>(m_central.GetData())
+                      + m_records[n];
+
+    // Another MSVS 2005 workaround, see wxZipEntry::ReadLocal (FIXME-VC8).
+    wxMBConv& strConv = CrackUint16(rec + 8) & wxZIP_LANG_ENC_UTF8
+                            ? static_cast<wxMBConv&>(wxConvUTF8)
+                            : *m_conv;
+    wxString name(rec + CENTRAL_SIZE, strConv, CrackUint16(rec + 28));
+
+    return wxZipEntry::GetInternalName(name, wxPATH_UNIX);
+}
+
+// Returns the index of the first entry with the given name, or wxNOT_FOUND
+//
+int wxZipIndex::Find(const wxString& name,
+                     wxPathFormat format /*=wxPATH_NATIVE*/) const
+{
+    if (m_table.empty())
+        return wxNOT_FOUND;
+
+    const wxString internal = wxZipEntry::GetInternalName(name, format);
+    const wxUint32 hash = HashName(internal);
+    const size_t mask = m_table.size() - 1;
+
+    for (size_t i = hash & mask; m_table[i]; i = (i + 1) & mask) {
+        const size_t n = m_table[i] - 1;
+        if (m_hashes[n] == hash && GetInternalName(n) == internal)
+            return static_cast<int>(n);
+    }
+
+    return wxNOT_FOUND;
+}
+
+// Returns a new entry, owned by the caller, for the n-th central record
+//
+wxZipEntry *wxZipIndex::GetEntry(size_t n) const
+{
+    wxCHECK_MSG(n < m_records.size(), NULL, wxT("invalid zip index entry"));
+
+    const char *rec = static_cast<const char*>(m_central.GetData())
+                      + m_records[n];
+    wxMemoryInputStream stream(rec + 4, CentralRecordSize(rec) - 4);
+
+    wxZipEntryPtr_ entry(new wxZipEntry);
+    if (!entry->ReadCentral(stream, *m_conv))
+        return NULL;
+
+    if (m_offsetAdjustment)
+        entry->SetOffset(entry->GetOffset() + m_offsetAdjustment);
+    entry->SetKey(entry->GetOffset());
+
+    return entry.release();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Output stream
 
@@ -2324,6 +2555,22 @@ bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
     return true;
 }
 
+// The value of the deflate bits of the flags field for a compression level
+//
+static int GetDeflateFlags(int level)
+{
+    switch (level) {
+        case 0: case 1:
+            return wxZIP_DEFLATE_SUPERFAST;
+        case 2: case 3: case 4:
+            return wxZIP_DEFLATE_FAST;
+        case 8: case 9:
+            return wxZIP_DEFLATE_EXTRA;
+    }
+
+    return wxZIP_DEFLATE_NORMAL;
+}
+
 // Can be overridden to add support for additional compression methods
 //
 wxOutputStream *wxZipOutputStream::OpenCompressor(
@@ -2354,20 +2601,8 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
 
         case wxZIP_METHOD_DEFLATE:
         {
-            int defbits = wxZIP_DEFLATE_NORMAL;
-            switch (GetLevel()) {
-                case 0: case 1:
-                    defbits = wxZIP_DEFLATE_SUPERFAST;
-                    break;
-                case 2: case 3: case 4:
-                    defbits = wxZIP_DEFLATE_FAST;
-                    break;
-                case 8: case 9:
-                    defbits = wxZIP_DEFLATE_EXTRA;
-                    break;
-            }
             entry.SetFlags((entry.GetFlags() & ~wxZIP_DEFLATE_MASK) |
-                            defbits | wxZIP_SUMS_FOLLOW);
+                            GetDeflateFlags(GetLevel()) | wxZIP_SUMS_FOLLOW);
 
             if (!m_deflate)
                 m_deflate = new wxZlibOutputStream2(stream, GetLevel());
@@ -2645,4 +2880,375 @@ size_t wxZipOutputStream::OnSysWrite(const void *buffer, size_t size)
     return m_comp->LastWrite();
 }
 
+
+/////////////////////////////////////////////////////////////////////////////
+// Parallel writer
+
+// A deflate stream reused for compressing many entries, as initializing a
+// new one for each small entry would take as much time as compressing it.
+//
+class wxZipDeflater
+{
+public:
+    wxZipDeflater(int level);
+    ~wxZipDeflater() { if (m_ok) deflateEnd(&m_z); }
+
+    bool Deflate(const void *data, size_t size, wxMemoryBuffer& out);
+
+private:
+    z_stream m_z;
+    bool m_ok;
+};
+
+wxZipDeflater::wxZipDeflater(int level)
+{
+    memset(&m_z, 0, sizeof(m_z));
+    m_ok = deflateInit2(&m_z, level, Z_DEFLATED, -MAX_WBITS,
+                        8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+bool wxZipDeflater::Deflate(const void *data, size_t size, wxMemoryBuffer& out)
+{
+    if (!m_ok || size != (uInt)size || deflateReset(&m_z) != Z_OK)
+        return false;
+
+    // the bound may not fit into uInt even if the size does, but in this case
+    // we don't need all of it anyhow as the data is only useful if it's
+    // smaller than the input, so just limit it
+    const uLong bound = wxMin(deflateBound(&m_z, size), uLong(UINT_MAX));
+    m_z.next_in = static_cast<Byte*>(const_cast<void*>(data));
+    m_z.avail_in = size;
+    m_z.next_out = static_cast<Byte*>(out.GetWriteBuf(bound));
+    m_z.avail_out = bound;
+
+    const bool ok = deflate(&m_z, Z_FINISH) == Z_STREAM_END;
+    out.UngetWriteBuf(ok ? m_z.total_out : 0);
+    return ok;
+}
+
+// An entry added to wxZipParallelWriter. The entry itself is only used by
+// the thread writing the zip, the compressor threads only use the data.
+//
+class wxZipCompressJob
+{
+public:
+    wxZipCompressJob(wxZipEntry *entry, const void *data, size_t size,
+                     bool store);
+    ~wxZipCompressJob() { delete m_entry; }
+
+    void Compress(wxZipDeflater& deflater, int level);
+
+    wxZipEntry *m_entry;
+    wxMemoryBuffer m_data;      // the uncompressed data
+    wxMemoryBuffer m_comp;      // the deflated data, if smaller than m_data
+    wxUint32 m_crc;
+    bool m_store;
+    bool m_done;
+};
+
+wxZipCompressJob::wxZipCompressJob(wxZipEntry *entry,
+                                   const void *data,
+                                   size_t size,
+                                   bool store)
+  : m_entry(entry),
+    m_crc(0),
+    m_store(store),
+    m_done(false)
+{
+    if (size)
+        m_data.AppendData(data, size);
+}
+
+// Computes the crc and deflates the data, if worthwhile, in one go instead
+// of feeding it through a wxZlibOutputStream.
+//
+void wxZipCompressJob::Compress(wxZipDeflater& deflater, int level)
+{
+    const void *data = m_data.GetData();
+    const size_t size = m_data.GetDataLen();
+
+    m_crc = crc32(crc32(0, Z_NULL, 0), static_cast<const Byte*>(data), size);
+
+    // this is the same choice as wxZipOutputStream::OpenCompressor() makes
+    if (m_store || level == 0 || size <= 6)
+        return;
+
+    // fall back to storing the data if it didn't get any smaller
+    if (!deflater.Deflate(data, size, m_comp) || m_comp.GetDataLen() >= size)
+        m_comp.Clear();
+}
+
+#if wxUSE_THREADS
+
+class wxZipCompressThread : public wxThread
+{
+public:
+    wxZipCompressThread(class wxZipParallelWriterImpl& impl)
+        : wxThread(wxTHREAD_JOINABLE), m_impl(impl) { }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE;
+
+private:
+    class wxZipParallelWriterImpl& m_impl;
+};
+
+#endif // wxUSE_THREADS
+
+class wxZipParallelWriterImpl
+{
+public:
+    wxZipParallelWriterImpl(wxZipOutputStream& zip, int threads);
+    ~wxZipParallelWriterImpl();
+
+    wxZipOutputStream& m_zip;
+    const int m_level;
+
+    // the jobs in the order they must be written in, not done necessarily
+    wxVector<wxZipCompressJob*> m_jobs;
+    size_t m_jobsSize;
+    bool m_ok;
+
+    // used for compressing when there are no compressor threads
+    wxZipDeflater *m_deflater;
+
+#if wxUSE_THREADS
+    void WaitUntilDone(wxZipCompressJob *job);
+
+    // jobs waiting for a compressor thread, NULL tells a thread to exit
+    wxMessageQueue<wxZipCompressJob*> m_queue;
+    wxMutex m_doneMutex;
+    wxCondition m_doneCond;
+    wxVector<wxThread*> m_threads;
+#endif // wxUSE_THREADS
+};
+
+// Limits on the data held in memory: adding more entries than this waits
+// for the oldest entry to be written.
+enum {
+    PARALLEL_JOBS_PER_THREAD = 4,
+    PARALLEL_MAX_PENDING_SIZE = 64 * 1024 * 1024
+};
+
+wxZipParallelWriterImpl::wxZipParallelWriterImpl(wxZipOutputStream& zip,
+                                                 int threads)
+  : m_zip(zip),
+    m_level(zip.GetLevel()),
+    m_jobsSize(0),
+    m_ok(true),
+    m_deflater(NULL)
+#if wxUSE_THREADS
+    , m_doneCond(m_doneMutex)
+#endif // wxUSE_THREADS
+{
+#if wxUSE_THREADS
+    if (threads <= 0)
+        threads = wxThread::GetCPUCount();
+
+    // with a single thread there's no reason not to compress synchronously
+    for (int n = 0; threads > 1 && n < threads; n++) {
+        wxThread *thread = new wxZipCompressThread(*this);
+        if (thread->Run() != wxTHREAD_NO_ERROR) {
+            delete thread;
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+#else
+    wxUnusedVar(threads);
+#endif // wxUSE_THREADS
+}
+
+wxZipParallelWriterImpl::~wxZipParallelWriterImpl()
+{
+#if wxUSE_THREADS
+    for (size_t n = 0; n < m_threads.size(); n++)
+        m_queue.Post(NULL);
+    for (size_t n = 0; n < m_threads.size(); n++) {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+#endif // wxUSE_THREADS
+
+    for (size_t n = 0; n < m_jobs.size(); n++)
+        delete m_jobs[n];
+
+    delete m_deflater;
+}
+
+#if wxUSE_THREADS
+
+void wxZipParallelWriterImpl::WaitUntilDone(wxZipCompressJob *job)
+{
+    wxMutexLocker lock(m_doneMutex);
+    while (!job->m_done)
+        m_doneCond.Wait();
+}
+
+wxThread::ExitCode wxZipCompressThread::Entry()
+{
+    wxZipCompressJob *job;
+
+    wxZipDeflater deflater(m_impl.m_level);
+
+    while (m_impl.m_queue.Receive(job) == wxMSGQUEUE_NO_ERROR && job) {
+        job->Compress(deflater, m_impl.m_level);
+
+        wxMutexLocker lock(m_impl.m_doneMutex);
+        job->m_done = true;
+        m_impl.m_doneCond.Broadcast();
+    }
+
+    return 0;
+}
+
+#endif // wxUSE_THREADS
+
+wxZipParallelWriter::wxZipParallelWriter(wxZipOutputStream& zip,
+                                         int threads /*=0*/)
+  : m_impl(new wxZipParallelWriterImpl(zip, threads))
+{
+}
+
+wxZipParallelWriter::~wxZipParallelWriter()
+{
+    Finish();
+    delete m_impl;
+}
+
+int wxZipParallelWriter::GetThreadCount() const
+{
+#if wxUSE_THREADS
+    return m_impl->m_threads.size();
+#else
+    return 0;
+#endif // wxUSE_THREADS
+}
+
+bool wxZipParallelWriter::AddEntry(const wxString& name,
+                                   const void *data,
+                                   size_t size,
+                                   const wxDateTime& dt /*=wxDateTime::Now()*/)
+{
+    return AddEntry(new wxZipEntry(name, dt, size), data, size);
+}
+
+bool wxZipParallelWriter::AddDirEntry(const wxString& name,
+                                      const wxDateTime& dt /*=wxDateTime::Now()*/)
+{
+    wxZipEntry *entry = new wxZipEntry(name, dt);
+    entry->SetIsDir();
+    return AddEntry(entry, NULL, 0);
+}
+
+bool wxZipParallelWriter::AddEntry(wxZipEntry *entry,
+                                   const void *data,
+                                   size_t size)
+{
+    wxZipEntryPtr_ spEntry(entry);
+
+    if (!m_impl->m_ok || !entry)
+        return false;
+
+    const int method = entry->GetMethod();
+    if (method != wxZIP_METHOD_DEFAULT && method != wxZIP_METHOD_STORE &&
+            method != wxZIP_METHOD_DEFLATE) {
+        wxLogError(_("unsupported Zip compression method"));
+        return false;
+    }
+
+    wxZipCompressJob *job =
+        new wxZipCompressJob(spEntry.release(), data, size,
+                             method == wxZIP_METHOD_STORE || entry->IsDir());
+
+#if wxUSE_THREADS
+    if (!m_impl->m_threads.empty()) {
+        m_impl->m_jobs.push_back(job);
+        m_impl->m_jobsSize += size;
+        m_impl->m_queue.Post(job);
+
+        // write out the entries which are already compressed, and wait for
+        // the oldest ones if too much data is pending
+        const size_t maxJobs = PARALLEL_JOBS_PER_THREAD * m_impl->m_threads.size();
+
+        while (!m_impl->m_jobs.empty()) {
+            wxZipCompressJob *first = m_impl->m_jobs.front();
+
+            if (m_impl->m_jobs.size() > maxJobs ||
+                    m_impl->m_jobsSize > PARALLEL_MAX_PENDING_SIZE) {
+                m_impl->WaitUntilDone(first);
+            } else {
+                wxMutexLocker lock(m_impl->m_doneMutex);
+                if (!first->m_done)
+                    break;
+            }
+
+            m_impl->m_jobs.erase(m_impl->m_jobs.begin());
+            m_impl->m_jobsSize -= first->m_data.GetDataLen();
+            if (!WriteEntry(first))
+                return false;
+        }
+
+        return true;
+    }
+#endif // wxUSE_THREADS
+
+    if (!m_impl->m_deflater)
+        m_impl->m_deflater = new wxZipDeflater(m_impl->m_level);
+
+    job->Compress(*m_impl->m_deflater, m_impl->m_level);
+    return WriteEntry(job);
+}
+
+// Writes the entry to the zip stream, which must only be done from the
+// thread using wxZipParallelWriter, and deletes the job.
+//
+bool wxZipParallelWriter::WriteEntry(wxZipCompressJob *job)
+{
+    wxScopedPtr<wxZipCompressJob> spJob(job);
+
+    if (!m_impl->m_ok)
+        return false;
+
+    wxZipEntry *entry = job->m_entry;
+    job->m_entry = NULL;
+
+    const bool deflated = job->m_comp.GetDataLen() > 0;
+    const wxMemoryBuffer& buf = deflated ? job->m_comp : job->m_data;
+
+    entry->SetMethod(deflated ? wxZIP_METHOD_DEFLATE : wxZIP_METHOD_STORE);
+    entry->SetFlags(entry->GetFlags() & ~(wxZIP_DEFLATE_MASK | wxZIP_SUMS_FOLLOW));
+    if (deflated)
+        entry->SetFlags(entry->GetFlags() | GetDeflateFlags(m_impl->m_level));
+    entry->SetSize(job->m_data.GetDataLen());
+    entry->SetCompressedSize(buf.GetDataLen());
+    entry->SetCrc(job->m_crc);
+
+    wxZipOutputStream& zip = m_impl->m_zip;
+
+    m_impl->m_ok = zip.DoCreate(entry, true) &&
+                   zip.Write(buf.GetData(), buf.GetDataLen()).IsOk() &&
+                   zip.CloseEntry();
+
+    return m_impl->m_ok;
+}
+
+// Waits until all the entries are compressed and written to the zip
+//
+bool wxZipParallelWriter::Finish()
+{
+#if wxUSE_THREADS
+    while (!m_impl->m_jobs.empty()) {
+        wxZipCompressJob *first = m_impl->m_jobs.front();
+        m_impl->WaitUntilDone(first);
+        m_impl->m_jobs.erase(m_impl->m_jobs.begin());
+        m_impl->m_jobsSize -= first->m_data.GetDataLen();
+        WriteEntry(first);
+    }
+#endif // wxUSE_THREADS
+
+    return m_impl->m_ok && m_impl->m_zip.IsOk();
+}
+
+
 #endif // wxUSE_ZIPSTREAM
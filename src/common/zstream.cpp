@@ -18,6 +18,7 @@
 #if wxUSE_ZLIB && wxUSE_STREAMS
 
 #include "wx/zstream.h"
+#include "wx/mstream.h"
 #include "wx/versioninfo.h"
 
 #ifndef WX_PRECOMP
@@ -207,15 +208,42 @@ size_t wxZlibInputStream::OnSysRead(void *buffer, size_t size)
   m_inflate->next_out = (unsigned char *)buffer;
   m_inflate->avail_out = size;
 
+  // When reading from memory, e.g. a mapped file, inflate the data in place
+  // instead of copying it to m_z_buffer first. The parent stream is advanced
+  // only by the amount of data actually consumed by zlib.
+  wxMemoryInputStream * const
+    memory = wxDynamicCast(m_parent_i_stream, wxMemoryInputStream);
+  const unsigned char *direct = NULL;
+
   while (err == Z_OK && m_inflate->avail_out > 0) {
     if (m_inflate->avail_in == 0 && m_parent_i_stream->IsOk()) {
-      m_parent_i_stream->Read(m_z_buffer, m_z_size);
-      m_inflate->next_in = m_z_buffer;
-      m_inflate->avail_in = m_parent_i_stream->LastRead();
+      if (direct) {
+        memory->SeekI(m_inflate->next_in - direct, wxFromCurrent);
+        direct = NULL;
+      }
+
+      size_t len = 0;
+      if (memory)
+        direct = static_cast<const unsigned char *>(memory->GetUnreadData(&len));
+
+      if (direct && len) {
+        m_inflate->next_in = const_cast<unsigned char *>(direct);
+        m_inflate->avail_in = static_cast<uInt>(wxMin(len, size_t(INT_MAX)));
+      } else {
+        direct = NULL;
+        m_parent_i_stream->Read(m_z_buffer, m_z_size);
+        m_inflate->next_in = m_z_buffer;
+        m_inflate->avail_in = m_parent_i_stream->LastRead();
+      }
     }
     err = inflate(m_inflate, Z_SYNC_FLUSH);
   }
 
+  if (direct) {
+    memory->SeekI(m_inflate->next_in - direct, wxFromCurrent);
+    m_inflate->avail_in = 0;
+  }
+
   switch (err) {
     case Z_OK:
         break;
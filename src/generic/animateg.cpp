@@ -118,6 +118,21 @@ bool wxAnimation::LoadFile(const wxString& filename, wxAnimationType type)
     return Load(stream, type);
 }
 
+// Create the decoder to use for loading an animation using the given handler.
+static wxAnimationDecoder *CreateDecoder(const wxAnimationDecoder *handler)
+{
+    wxAnimationDecoder * const decoder = handler->Clone();
+
+#if wxUSE_GIF
+    // Animations can be long, so don't keep all their frames in memory:
+    // wxAnimationCtrl caches the composed frames it shows anyhow.
+    if ( decoder->GetType() == wxANIMATION_TYPE_GIF )
+        static_cast<wxGIFDecoder *>(decoder)->SetDecodeOnDemand();
+#endif // wxUSE_GIF
+
+    return decoder;
+}
+
 bool wxAnimation::Load(wxInputStream &stream, wxAnimationType type)
 {
     UnRef();
@@ -134,7 +149,7 @@ bool wxAnimation::Load(wxInputStream &stream, wxAnimationType type)
             {
                 // do a copy of the handler from the static list which we will own
                 // as our reference data
-                m_refData = handler->Clone();
+                m_refData = CreateDecoder(handler);
                 return M_ANIMDATA->Load(stream);
             }
         }
@@ -155,7 +170,7 @@ bool wxAnimation::Load(wxInputStream &stream, wxAnimationType type)
 
     // do a copy of the handler from the static list which we will own
     // as our reference data
-    m_refData = handler->Clone();
+    m_refData = CreateDecoder(handler);
 
     if (stream.IsSeekable() && !M_ANIMDATA->CanRead(stream))
     {
@@ -277,6 +292,9 @@ void wxAnimationCtrl::Init()
     m_looped = false;
     m_isPlaying = false;
 
+    m_frameCacheSize = DEFAULT_FRAME_CACHE_SIZE;
+    m_frameCacheUsed = 0;
+
     // use the window background colour by default to be consistent
     // with the GTK+ native version
     m_useWinBackgroundColour = true;
@@ -337,6 +355,7 @@ void wxAnimationCtrl::SetAnimation(const wxAnimation& animation)
 
     // set new animation even if it's wxNullAnimation
     m_animation = animation;
+    ClearFrameCache();
     if (!m_animation.IsOk())
     {
         DisplayStaticImage();
@@ -374,6 +393,9 @@ bool wxAnimationCtrl::SetBackgroundColour(const wxColour& colour)
     if ( !wxWindow::SetBackgroundColour(colour) )
         return false;
 
+    // the cached frames were composed using the old colour
+    ClearFrameCache();
+
     // if not playing, then this change must be seen immediately (unless
     // there's an inactive bitmap set which has higher priority than bg colour)
     if ( !IsPlaying() )
@@ -411,6 +433,8 @@ bool wxAnimationCtrl::Play(bool looped)
 
     m_isPlaying = true;
 
+    CacheCurrentFrame();
+
     // do a ClearBackground() to avoid that e.g. the custom static bitmap which
     // was eventually shown previously remains partially drawn
     ClearBackground();
@@ -448,6 +472,8 @@ bool wxAnimationCtrl::RebuildBackingStoreUpToFrame(unsigned int frame)
     {
         if (!m_backingStore.Create(w, h))
             return false;
+
+        ClearFrameCache();
     }
 
     wxMemoryDC dc;
@@ -563,6 +589,60 @@ void wxAnimationCtrl::DisplayStaticImage()
     Refresh();
 }
 
+// ----------------------------------------------------------------------------
+// wxAnimationCtrl - composed frames cache
+// ----------------------------------------------------------------------------
+
+void wxAnimationCtrl::SetFrameCacheSize(size_t size)
+{
+    m_frameCacheSize = size;
+
+    ClearFrameCache();
+}
+
+void wxAnimationCtrl::ClearFrameCache()
+{
+    m_frameCache.clear();
+    m_frameCacheUsed = 0;
+}
+
+void wxAnimationCtrl::CacheCurrentFrame()
+{
+    // As the animation is played in a loop, caching the frames until the
+    // cache is full is better than evicting any of them: the frames which
+    // don't fit are composed each time anyhow.
+    const size_t
+        frameSize = 4*(size_t)m_backingStore.GetWidth()*m_backingStore.GetHeight();
+    if ( m_frameCacheUsed + frameSize > m_frameCacheSize )
+        return;
+
+    if ( m_frameCache.empty() )
+        m_frameCache.resize(m_animation.GetFrameCount());
+
+    wxBitmap& cached = m_frameCache[m_currentFrame];
+    if ( cached.IsOk() )
+        return;
+
+    // This doesn't copy the bitmap but just shares its data which will be
+    // copied only when the backing store is modified to draw the next frame.
+    cached = m_backingStore;
+    m_frameCacheUsed += frameSize;
+}
+
+bool wxAnimationCtrl::UseCachedFrame()
+{
+    if ( m_currentFrame >= m_frameCache.size() )
+        return false;
+
+    const wxBitmap& cached = m_frameCache[m_currentFrame];
+    if ( !cached.IsOk() || cached.GetSize() != m_backingStore.GetSize() )
+        return false;
+
+    m_backingStore = cached;
+
+    return true;
+}
+
 void wxAnimationCtrl::DrawFrame(wxDC &dc, unsigned int frame)
 {
     // PERFORMANCE NOTE:
@@ -654,7 +734,16 @@ void wxAnimationCtrl::OnTimer(wxTimerEvent &WXUNUSED(event))
             m_currentFrame = 0;     // let's restart
     }
 
-    IncrementalUpdateBackingStore();
+    if ( !UseCachedFrame() )
+    {
+        IncrementalUpdateBackingStore();
+
+        // IncrementalUpdateBackingStore() may have stopped the animation
+        if ( !IsPlaying() )
+            return;
+
+        CacheCurrentFrame();
+    }
 
     wxClientDC dc(this);
     DrawCurrentFrame(dc);
@@ -39,6 +39,7 @@ bool wxCairoInit();
 #endif
 
 #include "wx/private/graphics.h"
+#include "wx/private/image.h"
 #include "wx/rawbmp.h"
 #include "wx/vector.h"
 #ifdef __WXMSW__
@@ -105,22 +106,6 @@ using namespace std;
 #include <cairo-quartz.h>
 #endif
 
-// Helper functions for dealing with alpha pre-multiplication.
-namespace
-{
-
-    inline unsigned char Premultiply(unsigned char alpha, unsigned char data)
-    {
-        return alpha ? (data * alpha) / 0xff : data;
-    }
-
-    inline unsigned char Unpremultiply(unsigned char alpha, unsigned char data)
-    {
-        return alpha ? (data * 0xff) / alpha : data;
-    }
-
-} // anonymous namespace
-
 class WXDLLIMPEXP_CORE wxCairoPathData : public wxGraphicsPathData
 {
 public :
@@ -1624,9 +1609,9 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
                         *data = 0;
                     else
                         *data = (alpha << 24
-                            | Premultiply(alpha, p.Red()) << 16
-                            | Premultiply(alpha, p.Green()) << 8
-                            | Premultiply(alpha, p.Blue()));
+                            | wxPremultiplyAlpha(alpha, p.Red()) << 16
+                            | wxPremultiplyAlpha(alpha, p.Green()) << 8
+                            | wxPremultiplyAlpha(alpha, p.Blue()));
 #endif // __WXMSW__, __WXOSX__ / !__WXMSW__, !__WXOSX__
                     ++data;
                     ++p;
@@ -1718,51 +1703,9 @@ wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
 
     int stride = InitBuffer(image.GetWidth(), image.GetHeight(), bufferFormat);
 
-    // Copy wxImage data into the buffer. Notice that we work with wxUint32
-    // values and not bytes becase Cairo always works with buffers in native
-    // endianness.
-    wxUint32* dst = reinterpret_cast<wxUint32*>(m_buffer);
-    const unsigned char* src = image.GetData();
-
-    if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
-    {
-        const unsigned char* alpha = image.GetAlpha();
-
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const unsigned char a = *alpha++;
-
-                *dst++ = a                      << 24 |
-                         Premultiply(a, src[0]) << 16 |
-                         Premultiply(a, src[1]) <<  8 |
-                         Premultiply(a, src[2]);
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
-    else // RGB
-    {
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                *dst++ = src[0] << 16 |
-                         src[1] <<  8 |
-                         src[2];
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
+    // Copy wxImage data into the buffer, this works for both formats as the
+    // alpha byte is ignored for CAIRO_FORMAT_RGB24.
+    image.GetRGBA(m_buffer, wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED, stride);
 
     InitSurface(bufferFormat, stride);
 }
@@ -1812,29 +1755,13 @@ wxImage wxCairoBitmapData::ConvertToImage() const
     stride /= sizeof(wxUint32);
 
     unsigned char* dst = image.GetData();
-    unsigned char *alpha = image.GetAlpha();
-    if ( alpha )
+    if ( image.HasAlpha() )
     {
         // We need to also copy alpha and undo the pre-multiplication as Cairo
         // stores pre-multiplied values in this format while wxImage does not.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                const unsigned char a = argb >> 24;
-                *alpha++ = a;
-
-                // Copy the RGB data undoing the pre-multiplication.
-                *dst++ = Unpremultiply(a, argb >> 16);
-                *dst++ = Unpremultiply(a, argb >>  8);
-                *dst++ = Unpremultiply(a, argb);
-            }
-
-            src = rowStart + stride;
-        }
+        image.SetRGBA(reinterpret_cast<const unsigned char*>(src),
+                      wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED,
+                      static_cast<int>(stride * sizeof(wxUint32)));
     }
     else // RGB
     {
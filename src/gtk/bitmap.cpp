@@ -609,14 +609,10 @@ wxBitmap::wxBitmap(const wxImage& image, int depth, double scale)
 
     guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
     const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
-    CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
-
     if (depth == 32 && alpha)
-    {
-        for (int j = 0; j < h; j++, dst += dstStride)
-            for (int i = 0; i < w; i++)
-                dst[i * 4 + 3] = *alpha++;
-    }
+        image.GetRGBA(dst, wxIMAGE_FORMAT_RGBA, dstStride);
+    else
+        CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
     if (image.HasMask())
     {
         const guchar r = image.GetMaskRed();
@@ -738,25 +734,8 @@ bool wxBitmap::CreateFromImageAsPixbuf(const wxImage& image)
         return false;
 
     // Copy the data:
-    const unsigned char* in = image.GetData();
-    unsigned char *out = gdk_pixbuf_get_pixels(pixbuf);
-    unsigned char *alpha = image.GetAlpha();
-
-    int rowpad = gdk_pixbuf_get_rowstride(pixbuf) - 4 * width;
-
-    for (int y = 0; y < height; y++, out += rowpad)
-    {
-        for (int x = 0; x < width; x++, out += 4, in += 3)
-        {
-            out[0] = in[0];
-            out[1] = in[1];
-            out[2] = in[2];
-            if (alpha)
-                out[3] = *alpha++;
-        }
-    }
-
-    return true;
+    return image.GetRGBA(gdk_pixbuf_get_pixels(pixbuf), wxIMAGE_FORMAT_RGBA,
+                         gdk_pixbuf_get_rowstride(pixbuf));
 }
 #endif
 
@@ -784,19 +763,10 @@ wxImage wxBitmap::ConvertToImage() const
         const guchar* src = gdk_pixbuf_get_pixels(pixbuf_src);
         const int srcStride = gdk_pixbuf_get_rowstride(pixbuf_src);
         const int srcChannels = gdk_pixbuf_get_n_channels(pixbuf_src);
-        CopyImageData(dst, 3, 3 * w, src, srcChannels, srcStride, w, h);
-
         if (srcChannels == 4)
-        {
-            image.SetAlpha();
-            guchar* alpha = image.GetAlpha();
-            for (int j = 0; j < h; j++, src += srcStride)
-            {
-                const guchar* s = src;
-                for (int i = 0; i < w; i++, s += 4)
-                    *alpha++ = s[3];
-            }
-        }
+            image.SetRGBA(src, wxIMAGE_FORMAT_RGBA, srcStride);
+        else
+            CopyImageData(dst, 3, 3 * w, src, srcChannels, srcStride, w, h);
     }
     cairo_surface_t* maskSurf = NULL;
     if (bmpData->m_mask)
@@ -327,6 +327,7 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
     wxString::const_iterator i(pos+1);
 
     // find tag's name and convert it to uppercase:
+    wxString name;
     while ((i < end_pos) &&
            ((c = *(i++)) != wxT(' ') && c != wxT('\r') &&
              c != wxT('\n') && c != wxT('\t') &&
@@ -334,9 +335,11 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
     {
         if ((c >= wxT('a')) && (c <= wxT('z')))
             c -= (wxT('a') - wxT('A'));
-        m_Name << c;
+        name << c;
     }
 
+    m_Name = wxStringAtom(name);
+
     // if the tag has parameters, read them and "normalize" them,
     // i.e. convert to uppercase, replace whitespaces by spaces and
     // remove whitespaces around '=':
@@ -365,12 +368,12 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
             {
                 if (state == ST_BEFORE_EQ || state == ST_NAME)
                 {
-                    m_ParamNames.Add(pname);
+                    m_ParamNames.push_back(wxStringAtom(pname));
                     m_ParamValues.Add(wxGetEmptyString());
                 }
                 else if (state == ST_VALUE && quote == 0)
                 {
-                    m_ParamNames.Add(pname);
+                    m_ParamNames.push_back(wxStringAtom(pname));
                     if (entParser)
                         m_ParamValues.Add(entParser->Parse(pvalue));
                     else
@@ -400,7 +403,7 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
                         state = ST_BEFORE_VALUE;
                     else if (!IS_WHITE(c))
                     {
-                        m_ParamNames.Add(pname);
+                        m_ParamNames.push_back(wxStringAtom(pname));
                         m_ParamValues.Add(wxGetEmptyString());
                         pname = c;
                         state = ST_NAME;
@@ -420,7 +423,7 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
                     if ((quote != 0 && c == quote) ||
                         (quote == 0 && IS_WHITE(c)))
                     {
-                        m_ParamNames.Add(pname);
+                        m_ParamNames.push_back(wxStringAtom(pname));
                         if (quote == 0)
                         {
                             // VS: backward compatibility, no real reason,
@@ -475,7 +478,7 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
         const EquivAttr& ea = equivAttrs[n];
         if ( styleParams.HasParam(ea.style) && !HasParam(ea.attr) )
         {
-            m_ParamNames.Add(ea.attr);
+            m_ParamNames.push_back(wxStringAtom(ea.attr));
             m_ParamValues.Add(styleParams.GetParam(ea.style));
         }
     }
@@ -493,14 +496,26 @@ wxHtmlTag::~wxHtmlTag()
     }
 }
 
+int wxHtmlTag::FindParam(const wxString& par) const
+{
+    const size_t cnt = m_ParamNames.size();
+    for (size_t i = 0; i < cnt; i++)
+    {
+        if (m_ParamNames[i].GetString().IsSameAs(par, false))
+            return static_cast<int>(i);
+    }
+
+    return wxNOT_FOUND;
+}
+
 bool wxHtmlTag::HasParam(const wxString& par) const
 {
-    return (m_ParamNames.Index(par, false) != wxNOT_FOUND);
+    return (FindParam(par) != wxNOT_FOUND);
 }
 
 wxString wxHtmlTag::GetParam(const wxString& par, bool with_quotes) const
 {
-    int index = m_ParamNames.Index(par, false);
+    int index = FindParam(par);
     if (index == wxNOT_FOUND)
         return wxGetEmptyString();
     if (with_quotes)
@@ -518,7 +533,7 @@ bool wxHtmlTag::GetParamAsString(const wxString& par, wxString *str) const
 {
     wxCHECK_MSG( str, false, wxT("NULL output string argument") );
 
-    int index = m_ParamNames.Index(par, false);
+    int index = FindParam(par);
     if (index == wxNOT_FOUND)
         return false;
 
@@ -643,10 +658,10 @@ wxString wxHtmlTag::GetAllParams() const
     // VS: this function is for backward compatibility only,
     //     never used by wxHTML
     wxString s;
-    size_t cnt = m_ParamNames.GetCount();
+    size_t cnt = m_ParamNames.size();
     for (size_t i = 0; i < cnt; i++)
     {
-        s << m_ParamNames[i];
+        s << m_ParamNames[i].GetString();
         s << wxT('=');
         if (m_ParamValues[i].Find(wxT('"')) != wxNOT_FOUND)
             s << wxT('\'') << m_ParamValues[i] << wxT('\'');
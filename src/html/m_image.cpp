@@ -400,6 +400,10 @@ wxHtmlImageCell::wxHtmlImageCell(wxHtmlWindowInterface *windowIface,
                       input->GetLocation().Matches(wxT("*.GIF"))) )
                 {
                     m_gifDecoder = new wxGIFDecoder();
+
+                    // only the current frame is needed at any moment
+                    m_gifDecoder->SetDecodeOnDemand();
+
                     if ( m_gifDecoder->LoadGIF(*s) == wxGIF_OK )
                     {
                         wxImage img;
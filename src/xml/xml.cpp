@@ -25,11 +25,14 @@
 #endif
 
 #include "wx/wfstream.h"
+#include "wx/mstream.h"
 #include "wx/datstrm.h"
 #include "wx/zstream.h"
 #include "wx/strconv.h"
 #include "wx/scopedptr.h"
 #include "wx/versioninfo.h"
+#include "wx/vector.h"
+#include "wx/buffer.h"
 
 #include "expat.h" // from Expat
 
@@ -82,6 +85,17 @@ wxXmlNode::wxXmlNode(wxXmlNodeType type, const wxString& name,
     wxASSERT_MSG ( type != wxXML_ELEMENT_NODE || content.empty(), "element nodes can't have content" );
 }
 
+wxXmlNode::wxXmlNode(wxXmlNodeType type, const wxStringAtom& name,
+                     const wxString& content,
+                     int lineNo)
+    : m_type(type), m_name(name), m_content(content),
+      m_attrs(NULL), m_parent(NULL),
+      m_children(NULL), m_next(NULL),
+      m_lineNo(lineNo), m_noConversion(false)
+{
+    wxASSERT_MSG ( type != wxXML_ELEMENT_NODE || content.empty(), "element nodes can't have content" );
+}
+
 wxXmlNode::wxXmlNode(const wxXmlNode& node)
 {
     m_next = NULL;
@@ -142,7 +156,7 @@ void wxXmlNode::DoCopy(const wxXmlNode& node)
     wxXmlAttribute *p = node.m_attrs;
     while (p)
     {
-       AddAttribute(p->GetName(), p->GetValue());
+       AddAttribute(new wxXmlAttribute(p->GetNameAtom(), p->GetValue()));
        p = p->GetNext();
     }
 }
@@ -520,7 +534,7 @@ void wxXmlDocument::DoCopy(const wxXmlDocument& doc)
 
 bool wxXmlDocument::Load(const wxString& filename, const wxString& encoding, int flags)
 {
-    wxFileInputStream stream(filename);
+    wxMappedFileInputStream stream(filename);
     if (!stream.IsOk())
         return false;
     return Load(stream, encoding, flags);
@@ -665,6 +679,54 @@ bool wxIsWhiteOnly(const wxString& buf)
 }
 
 
+// cache of the element and attribute names used in the document being parsed:
+// as the same few names typically occur many times, this allows to avoid both
+// allocating memory for them and looking them up in the global pool of atoms
+class wxXmlNamesCache
+{
+public:
+    wxXmlNamesCache() { }
+
+    wxStringAtom Get(const char *name)
+    {
+        const size_t len = strlen(name);
+        if ( !len )
+            return wxStringAtom();
+
+        Slot& slot = m_slots[GetIndex(name, len)];
+        if ( slot.len != len || memcmp(slot.name.data(), name, len) != 0 )
+        {
+            slot.name = wxCharBuffer(name);
+            slot.len = len;
+            slot.atom = wxStringAtom::FromUTF8(name, len);
+        }
+
+        return slot.atom;
+    }
+
+private:
+    enum { SIZE = 64 };
+
+    static size_t GetIndex(const char *name, size_t len)
+    {
+        return (len*31 + (unsigned char)name[0]*7 +
+                    (unsigned char)name[len - 1]) % SIZE;
+    }
+
+    struct Slot
+    {
+        Slot() : len(0) { }
+
+        wxCharBuffer name;
+        size_t len;
+        wxStringAtom atom;
+    };
+
+    Slot m_slots[SIZE];
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlNamesCache);
+};
+
 struct wxXmlParsingContext
 {
     wxXmlParsingContext()
@@ -673,7 +735,13 @@ struct wxXmlParsingContext
           lastChild(NULL),
           lastAsText(NULL),
           doctype(NULL),
-          removeWhiteOnlyNodes(false)
+          removeWhiteOnlyNodes(false),
+          textName(wxS("text")),
+          streamParser(NULL),
+          subtree(NULL),
+          depth(0),
+          skipDepth(0),
+          stopped(false)
     {}
 
     XML_Parser parser;
@@ -685,8 +753,60 @@ struct wxXmlParsingContext
     wxString   version;
     wxXmlDoctype *doctype;
     bool       removeWhiteOnlyNodes;
+    const wxStringAtom textName;        // name of all the text nodes
+    wxXmlNamesCache names;              // element and attribute names
+
+    // the fields below are only used by wxXmlStreamParser
+    wxXmlStreamParser *streamParser;
+    wxXmlNode *subtree;                 // the element being built, if any
+    int        depth;                   // the number of open elements
+    int        skipDepth;               // the depth inside skipped element
+    wxMemoryBuffer text;                // the text not notified yet, in UTF-8
+    bool       stopped;
+    wxVector<wxXmlAttribute> attrs;     // reused for all elements
+
+    // wrappers for wxXmlStreamParser notification functions
+    wxXmlStreamAction NotifyStartElement(const wxString& name,
+                                         const wxXmlAttribute *attrs)
+    {
+        if ( !depth )
+        {
+            // the document information was parsed by now
+            streamParser->m_version = version;
+            streamParser->m_fileEncoding = encoding;
+        }
+
+        return streamParser->OnStartElement(name, attrs);
+    }
+
+    void NotifyEndElement(const wxString& name)
+        { streamParser->OnEndElement(name); }
+    void NotifyElementNode(wxXmlNode *elementNode)
+        { streamParser->OnElementNode(elementNode); }
+    void NotifyText(const wxString& s)
+        { streamParser->OnText(s); }
+    void NotifyCData(const wxString& s)
+        { streamParser->OnCData(s); }
+    void NotifyComment(const wxString& s)
+        { streamParser->OnComment(s); }
+    void NotifyProcessingInstruction(const wxString& target,
+                                     const wxString& data)
+        { streamParser->OnProcessingInstruction(target, data); }
 };
 
+// same as CharToString() but returns the atom for the element or attribute
+// name: as the same names occur many times in a typical document, this avoids
+// storing multiple copies of them
+static wxStringAtom CharToAtom(wxXmlParsingContext *ctx, const char *s)
+{
+#if !wxUSE_UNICODE
+    if ( ctx->conv )
+        return wxStringAtom(CharToString(ctx->conv, s));
+#endif // !wxUSE_UNICODE
+
+    return ctx->names.Get(s);
+}
+
 // checks that ctx->lastChild is in consistent state
 #define ASSERT_LAST_CHILD_OK(ctx)                                   \
     wxASSERT( ctx->lastChild == NULL ||                             \
@@ -699,7 +819,7 @@ static void StartElementHnd(void *userData, const char *name, const char **atts)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
     wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE,
-                                    CharToString(ctx->conv, name),
+                                    CharToAtom(ctx, name),
                                     wxEmptyString,
                                     XML_GetCurrentLineNumber(ctx->parser));
     const char **a = atts;
@@ -707,7 +827,8 @@ static void StartElementHnd(void *userData, const char *name, const char **atts)
     // add node attributes
     while (*a)
     {
-        node->AddAttribute(CharToString(ctx->conv, a[0]), CharToString(ctx->conv, a[1]));
+        node->AddAttribute(new wxXmlAttribute(CharToAtom(ctx, a[0]),
+                                              CharToString(ctx->conv, a[1])));
         a += 2;
     }
 
@@ -750,7 +871,7 @@ static void TextHnd(void *userData, const char *s, int len)
         if (!whiteOnly)
         {
             wxXmlNode *textnode =
-                new wxXmlNode(wxXML_TEXT_NODE, wxS("text"), str,
+                new wxXmlNode(wxXML_TEXT_NODE, ctx->textName, str,
                               XML_GetCurrentLineNumber(ctx->parser));
 
             ASSERT_LAST_CHILD_OK(ctx);
@@ -878,61 +999,352 @@ static int UnknownEncodingHnd(void * WXUNUSED(encodingHandlerData),
     return 1;
 }
 
-} // extern "C"
+// handlers used by wxXmlStreamParser
 
-bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int flags)
+static void SetStreamHandlers(XML_Parser parser);
+
+// returns true if the given UTF-8 string contains only whitespaces
+static bool IsWhiteOnly(const char *s, size_t len)
 {
-#if wxUSE_UNICODE
-    (void)encoding;
-#else
-    m_encoding = encoding;
-#endif
+    for ( const char * const end = s + len; s != end; ++s )
+    {
+        if ( *s != ' ' && *s != '\t' && *s != '\n' && *s != '\r' )
+            return false;
+    }
+    return true;
+}
 
-    const size_t BUFSIZE = 1024;
-    char buf[BUFSIZE];
-    wxXmlParsingContext ctx;
-    bool done;
+static void StreamFlushText(wxXmlParsingContext *ctx)
+{
+    const size_t len = ctx->text.GetDataLen();
+    if ( !len )
+        return;
+
+    const char * const s = static_cast<const char *>(ctx->text.GetData());
+    if ( !ctx->removeWhiteOnlyNodes || !IsWhiteOnly(s, len) )
+        ctx->NotifyText(CharToString(ctx->conv, s, len));
+
+    ctx->text.SetDataLen(0);
+}
+
+static void SkipStartElementHnd(void *userData,
+                                const char* WXUNUSED(name),
+                                const char** WXUNUSED(atts))
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+
+    ctx->skipDepth++;
+}
+
+static void SkipEndElementHnd(void *userData, const char* WXUNUSED(name))
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+
+    if ( --ctx->skipDepth )
+        return;
+
+    // the skipped element ends here
+    ctx->depth--;
+    SetStreamHandlers(ctx->parser);
+}
+
+static void SubtreeEndElementHnd(void *userData, const char *name)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+
+    if ( ctx->node != ctx->subtree )
+    {
+        EndElementHnd(userData, name);
+        return;
+    }
+
+    // the element being built is complete now
+    wxXmlNode * const node = ctx->subtree;
+    ctx->subtree =
+    ctx->node =
+    ctx->lastChild =
+    ctx->lastAsText = NULL;
+
+    ctx->depth--;
+    SetStreamHandlers(ctx->parser);
+
+    ctx->NotifyElementNode(node);
+}
+
+static void StreamStartElementHnd(void *userData, const char *name, const char **atts)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    StreamFlushText(ctx);
+    if ( ctx->stopped )
+        return;
+
+    // fill the attributes reusing the existing objects to avoid allocating
+    // memory for them for every element
+    size_t count = 0;
+    while ( atts[2*count] )
+        count++;
+
+    if ( ctx->attrs.size() < count )
+        ctx->attrs.resize(count);
+
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxXmlAttribute& attr = ctx->attrs[n];
+        attr.SetName(CharToAtom(ctx, atts[2*n]));
+        attr.SetValue(CharToString(ctx->conv, atts[2*n + 1]));
+        attr.SetNext(n + 1 < count ? &ctx->attrs[n + 1] : NULL);
+    }
+
+    const wxStringAtom nodeName = CharToAtom(ctx, name);
+    const wxXmlStreamAction
+        action = ctx->NotifyStartElement(nodeName,
+                                         count ? &ctx->attrs[0] : NULL);
+    ctx->depth++;
+
+    if ( ctx->stopped )
+        return;
+
+    switch ( action )
+    {
+        case wxXML_STREAM_CONTINUE:
+            break;
+
+        case wxXML_STREAM_SKIP:
+            ctx->skipDepth = 1;
+            XML_SetElementHandler(ctx->parser,
+                                  SkipStartElementHnd, SkipEndElementHnd);
+            XML_SetCharacterDataHandler(ctx->parser, NULL);
+            XML_SetCdataSectionHandler(ctx->parser, NULL, NULL);
+            XML_SetCommentHandler(ctx->parser, NULL);
+            XML_SetProcessingInstructionHandler(ctx->parser, NULL);
+            break;
+
+        case wxXML_STREAM_BUILD_NODE:
+            {
+                wxXmlNode * const
+                    node = new wxXmlNode(wxXML_ELEMENT_NODE, nodeName,
+                                         wxEmptyString,
+                                         XML_GetCurrentLineNumber(ctx->parser));
+                for ( size_t n = 0; n < count; n++ )
+                {
+                    node->AddAttribute(
+                        new wxXmlAttribute(ctx->attrs[n].GetNameAtom(),
+                                           ctx->attrs[n].GetValue()));
+                }
+
+                // build the element contents using the same handlers as
+                // wxXmlDocument does
+                ctx->subtree =
+                ctx->node = node;
+                ctx->lastChild =
+                ctx->lastAsText = NULL;
+
+                XML_SetElementHandler(ctx->parser,
+                                      StartElementHnd, SubtreeEndElementHnd);
+                XML_SetCharacterDataHandler(ctx->parser, TextHnd);
+                XML_SetCdataSectionHandler(ctx->parser,
+                                           StartCdataHnd, EndCdataHnd);
+                XML_SetCommentHandler(ctx->parser, CommentHnd);
+                XML_SetProcessingInstructionHandler(ctx->parser, PIHnd);
+            }
+            break;
+    }
+}
+
+static void StreamEndElementHnd(void *userData, const char *name)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    StreamFlushText(ctx);
+    if ( ctx->stopped )
+        return;
+
+    ctx->depth--;
+    ctx->NotifyEndElement(CharToAtom(ctx, name));
+}
+
+static void StreamTextHnd(void *userData, const char *s, int len)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    // expat may split the text in several pieces, collect all of them to
+    // notify about the entire text at once
+    ctx->text.AppendData(s, len);
+}
+
+static void StreamStartCdataHnd(void *userData)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    StreamFlushText(ctx);
+}
+
+static void StreamEndCdataHnd(void *userData)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    ctx->NotifyCData(CharToString(ctx->conv,
+                                  static_cast<const char *>(ctx->text.GetData()),
+                                  ctx->text.GetDataLen()));
+    ctx->text.SetDataLen(0);
+}
+
+static void StreamCommentHnd(void *userData, const char *data)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    StreamFlushText(ctx);
+    if ( ctx->stopped )
+        return;
+
+    ctx->NotifyComment(CharToString(ctx->conv, data));
+}
+
+static void StreamPIHnd(void *userData, const char *target, const char *data)
+{
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    if ( ctx->stopped )
+        return;
+
+    StreamFlushText(ctx);
+    if ( ctx->stopped )
+        return;
+
+    ctx->NotifyProcessingInstruction(CharToString(ctx->conv, target),
+                                     CharToString(ctx->conv, data));
+}
+
+static void SetStreamHandlers(XML_Parser parser)
+{
+    XML_SetElementHandler(parser, StreamStartElementHnd, StreamEndElementHnd);
+    XML_SetCharacterDataHandler(parser, StreamTextHnd);
+    XML_SetCdataSectionHandler(parser, StreamStartCdataHnd, StreamEndCdataHnd);
+    XML_SetCommentHandler(parser, StreamCommentHnd);
+    XML_SetProcessingInstructionHandler(parser, StreamPIHnd);
+}
+
+} // extern "C"
+
+// creates the parser and sets up the handlers common to wxXmlDocument and
+// wxXmlStreamParser
+static XML_Parser CreateParser(wxXmlParsingContext& ctx,
+                               const wxString& encoding, int flags)
+{
     XML_Parser parser = XML_ParserCreate(NULL);
-    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
 
     ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
     ctx.conv = NULL;
 #if !wxUSE_UNICODE
     if ( encoding.CmpNoCase(wxS("UTF-8")) != 0 )
         ctx.conv = new wxCSConv(encoding);
+#else
+    wxUnusedVar(encoding);
 #endif
-    ctx.doctype = &m_doctype;
     ctx.removeWhiteOnlyNodes = (flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0;
     ctx.parser = parser;
-    ctx.node = root;
 
     XML_SetUserData(parser, (void*)&ctx);
-    XML_SetElementHandler(parser, StartElementHnd, EndElementHnd);
-    XML_SetCharacterDataHandler(parser, TextHnd);
-    XML_SetCdataSectionHandler(parser, StartCdataHnd, EndCdataHnd);
-    XML_SetCommentHandler(parser, CommentHnd);
-    XML_SetProcessingInstructionHandler(parser, PIHnd);
     XML_SetDoctypeDeclHandler(parser, StartDoctypeHnd, EndDoctypeHnd);
     XML_SetDefaultHandler(parser, DefaultHnd);
     XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, NULL);
 
-    bool ok = true;
+    return parser;
+}
+
+static void FreeParser(wxXmlParsingContext& ctx)
+{
+    XML_ParserFree(ctx.parser);
+#if !wxUSE_UNICODE
+    if ( ctx.conv )
+        delete ctx.conv;
+#endif
+}
+
+// passes all the data from the stream to the parser, returns false on error
+static bool ParseStream(XML_Parser parser, wxInputStream& stream)
+{
+    const size_t BUFSIZE = 16384;
+    char buf[BUFSIZE];
+    bool done;
+
+    // When the document is in memory, e.g. in a mapped file, let expat parse
+    // it directly instead of copying it into our buffer in small pieces.
+    wxMemoryInputStream * const
+        memory = wxDynamicCast(&stream, wxMemoryInputStream);
+
     do
     {
-        size_t len = stream.Read(buf, BUFSIZE).LastRead();
-        done = (len < BUFSIZE);
-        if (!XML_Parse(parser, buf, len, done))
+        const char *data = NULL;
+        size_t len = 0;
+        if ( memory )
+            data = static_cast<const char *>(memory->GetUnreadData(&len));
+
+        if ( data )
+        {
+            // expat takes the length as int
+            if ( len > INT_MAX )
+                len = INT_MAX;
+            memory->SeekI(len, wxFromCurrent);
+            done = !memory->CanRead();
+        }
+        else
         {
+            data = buf;
+            len = stream.Read(buf, BUFSIZE).LastRead();
+            done = (len < BUFSIZE);
+        }
+
+        if (!XML_Parse(parser, data, len, done))
+        {
+            // parsing was stopped by wxXmlStreamParser::Stop(), not an error
+            if (XML_GetErrorCode(parser) == XML_ERROR_ABORTED)
+                break;
+
             wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
                            *wxConvCurrent);
             wxLogError(_("XML parsing error: '%s' at line %d"),
                        error.c_str(),
                        (int)XML_GetCurrentLineNumber(parser));
-            ok = false;
-            break;
+            return false;
         }
     } while (!done);
 
+    return true;
+}
+
+bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int flags)
+{
+#if !wxUSE_UNICODE
+    m_encoding = encoding;
+#endif
+
+    wxXmlParsingContext ctx;
+    XML_Parser parser = CreateParser(ctx, encoding, flags);
+    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
+
+    ctx.doctype = &m_doctype;
+    ctx.node = root;
+
+    XML_SetElementHandler(parser, StartElementHnd, EndElementHnd);
+    XML_SetCharacterDataHandler(parser, TextHnd);
+    XML_SetCdataSectionHandler(parser, StartCdataHnd, EndCdataHnd);
+    XML_SetCommentHandler(parser, CommentHnd);
+    XML_SetProcessingInstructionHandler(parser, PIHnd);
+
+    const bool ok = ParseStream(parser, stream);
     if (ok)
     {
         if (!ctx.version.empty())
@@ -946,14 +1358,76 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
         delete root;
     }
 
-    XML_ParserFree(parser);
-#if !wxUSE_UNICODE
-    if ( ctx.conv )
-        delete ctx.conv;
-#endif
+    FreeParser(ctx);
+
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlStreamParser
+//-----------------------------------------------------------------------------
+
+bool wxXmlStreamParser::Parse(const wxString& filename,
+                              const wxString& encoding, int flags)
+{
+    wxMappedFileInputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return Parse(stream, encoding, flags);
+}
+
+bool wxXmlStreamParser::Parse(wxInputStream& stream,
+                              const wxString& encoding, int flags)
+{
+    wxCHECK_MSG( !m_ctx, false, wxS("can't parse recursively") );
+
+    m_version.clear();
+    m_fileEncoding.clear();
+    m_doctype.Clear();
+
+    wxXmlParsingContext ctx;
+    CreateParser(ctx, encoding, flags);
+
+    ctx.doctype = &m_doctype;
+    ctx.streamParser = this;
+
+    SetStreamHandlers(ctx.parser);
+
+    m_ctx = &ctx;
+    const bool ok = ParseStream(ctx.parser, stream);
+    m_ctx = NULL;
+
+    // the element being built if parsing was stopped or failed
+    delete ctx.subtree;
+
+    FreeParser(ctx);
 
     return ok;
+}
+
+void wxXmlStreamParser::Stop()
+{
+    wxCHECK_RET( m_ctx, wxS("can only be called while parsing") );
+
+    if ( !m_ctx->stopped )
+    {
+        m_ctx->stopped = true;
+        XML_StopParser(m_ctx->parser, XML_FALSE);
+    }
+}
+
+int wxXmlStreamParser::GetLineNumber() const
+{
+    wxCHECK_MSG( m_ctx, -1, wxS("can only be called while parsing") );
+
+    return XML_GetCurrentLineNumber(m_ctx->parser);
+}
+
+int wxXmlStreamParser::GetDepth() const
+{
+    wxCHECK_MSG( m_ctx, -1, wxS("can only be called while parsing") );
 
+    return m_ctx->depth;
 }
 
 
@@ -19,6 +19,7 @@
 #if wxUSE_STREAMS && wxUSE_ZIPSTREAM
 
 #include "archivetest.h"
+#include "wx/mstream.h"
 #include "wx/zipstrm.h"
 
 using std::string;
@@ -252,4 +253,152 @@ CppUnit::Test *ziptest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(ziptest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ziptest, "archive/zip");
 
+
+///////////////////////////////////////////////////////////////////////////////
+// wxZipIndex
+
+TEST_CASE("wxZipIndex", "[archive][zip]")
+{
+    wxMemoryOutputStream memOut;
+    {
+        wxZipOutputStream zip(memOut);
+        zip.SetComment("zip comment");
+        for ( int n = 0; n < 100; n++ )
+        {
+            REQUIRE( zip.PutNextEntry(wxString::Format("dir/file%d.txt", n)) );
+            const wxCharBuffer data(wxString::Format("contents %d", n).utf8_str());
+            zip.Write(data.data(), strlen(data));
+        }
+        REQUIRE( zip.PutNextDirEntry("empty") );
+        REQUIRE( zip.Close() );
+    }
+
+    wxMemoryInputStream memIn(memOut);
+
+    wxZipIndex index;
+    REQUIRE( index.Load(memIn) );
+    CHECK( index.GetCount() == 101 );
+    CHECK( index.GetComment() == "zip comment" );
+
+    CHECK( index.Find("dir/file0.txt", wxPATH_UNIX) == 0 );
+    CHECK( index.Find("./dir/file99.txt", wxPATH_UNIX) == 99 );
+    CHECK( index.Find("empty/", wxPATH_UNIX) == 100 );
+    CHECK( index.Find("dir/file100.txt", wxPATH_UNIX) == wxNOT_FOUND );
+    CHECK( index.Find("file1.txt", wxPATH_UNIX) == wxNOT_FOUND );
+
+    wxScopedPtr<wxZipEntry> entry(index.GetEntry(100));
+    REQUIRE( entry );
+    CHECK( entry->IsDir() );
+
+    // Open the entries in a different order than they appear in the archive
+    // and using a separate stream for each one, as concurrent readers would.
+    for ( int n = 99; n >= 0; n -= 7 )
+    {
+        const wxString name = wxString::Format("dir/file%d.txt", n);
+        const int found = index.Find(name, wxPATH_UNIX);
+        REQUIRE( found == n );
+
+        wxMemoryInputStream in(memOut);
+        wxZipInputStream zip(in);
+        REQUIRE( zip.OpenEntry(index, found) );
+
+        char buf[64];
+        const size_t len = zip.Read(buf, sizeof(buf)).LastRead();
+        CHECK( wxString::FromUTF8(buf, len) == wxString::Format("contents %d", n) );
+        CHECK( zip.Eof() );
+
+        // The stream initialized from the index can also be enumerated.
+        entry.reset(zip.GetNextEntry());
+        REQUIRE( entry );
+        CHECK( entry->GetName(wxPATH_UNIX) == "dir/file0.txt" );
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// wxZipParallelWriter
+
+static wxString GetParallelTestData(int n)
+{
+    // make the data compressible, but not for all entries
+    wxString data;
+    for ( int i = 0; i < n % 10; i++ )
+        data << wxString::Format("line %d of entry %d\n", i, n);
+    return data;
+}
+
+static void TestParallelWriter(int threads)
+{
+    const int count = 200;
+
+    wxMemoryOutputStream memOut;
+    {
+        wxZipOutputStream zip(memOut);
+        wxZipParallelWriter writer(zip, threads);
+
+        for ( int n = 0; n < count; n++ )
+        {
+            if ( n % 50 == 0 )
+            {
+                REQUIRE( writer.AddDirEntry(wxString::Format("dir%d", n)) );
+                continue;
+            }
+
+            const wxCharBuffer data(GetParallelTestData(n).utf8_str());
+            wxZipEntry *entry = new wxZipEntry(wxString::Format("file%d.txt", n));
+            if ( n % 7 == 0 )
+                entry->SetMethod(wxZIP_METHOD_STORE);
+            REQUIRE( writer.AddEntry(entry, data.data(), strlen(data)) );
+        }
+
+        REQUIRE( writer.Finish() );
+        REQUIRE( zip.Close() );
+    }
+
+    wxMemoryInputStream memIn(memOut);
+    wxZipInputStream zip(memIn);
+    CHECK( zip.GetTotalEntries() == count );
+
+    for ( int n = 0; n < count; n++ )
+    {
+        wxScopedPtr<wxZipEntry> entry(zip.GetNextEntry());
+        REQUIRE( entry );
+
+        if ( n % 50 == 0 )
+        {
+            CHECK( entry->IsDir() );
+            CHECK( entry->GetName(wxPATH_UNIX) == wxString::Format("dir%d/", n) );
+            continue;
+        }
+
+        INFO( "Entry " << n );
+        CHECK( entry->GetName(wxPATH_UNIX) == wxString::Format("file%d.txt", n) );
+        if ( n % 7 == 0 )
+            CHECK( entry->GetMethod() == wxZIP_METHOD_STORE );
+
+        wxMemoryOutputStream data;
+        zip.Read(data);
+        CHECK( zip.Eof() );
+        CHECK( zip.GetLastError() == wxSTREAM_EOF );
+
+        wxString contents;
+        if ( data.GetLength() )
+        {
+            wxCharBuffer buf(data.GetLength());
+            data.CopyTo(buf.data(), data.GetLength());
+            contents = wxString::FromUTF8(buf.data(), data.GetLength());
+        }
+        CHECK( contents == GetParallelTestData(n) );
+    }
+
+    wxScopedPtr<wxZipEntry> end(zip.GetNextEntry());
+    CHECK( !end );
+}
+
+TEST_CASE("wxZipParallelWriter", "[archive][zip]")
+{
+    SECTION("Synchronous") { TestParallelWriter(1); }
+    SECTION("Threads") { TestParallelWriter(4); }
+}
+
 #endif // wxUSE_STREAMS && wxUSE_ZIPSTREAM
@@ -171,6 +171,8 @@ private:
     CPPUNIT_TEST_SUITE( ArraysTestCase );
         CPPUNIT_TEST( wxStringArrayTest );
         CPPUNIT_TEST( SortedArray );
+        CPPUNIT_TEST( NaturalSort );
+        CPPUNIT_TEST( ParallelSort );
         CPPUNIT_TEST( wxStringArraySplitTest );
         CPPUNIT_TEST( wxStringArrayJoinTest );
         CPPUNIT_TEST( wxStringArraySplitJoinTest );
@@ -189,6 +191,8 @@ private:
 
     void wxStringArrayTest();
     void SortedArray();
+    void NaturalSort();
+    void ParallelSort();
     void wxStringArraySplitTest();
     void wxStringArrayJoinTest();
     void wxStringArraySplitJoinTest();
@@ -402,6 +406,86 @@ void ArraysTestCase::SortedArray()
     ad.Add("Aa");
     CPPUNIT_ASSERT_EQUAL( "a", ad[0] );
     CPPUNIT_ASSERT_EQUAL( "Aa", ad[1] );
+
+    wxSortedArrayString an(wxNaturalStringSortAscending);
+    an.Add("file10");
+    an.Add("File9");
+    an.Add("file1");
+    CPPUNIT_ASSERT_EQUAL( "file1", an[0] );
+    CPPUNIT_ASSERT_EQUAL( "File9", an[1] );
+    CPPUNIT_ASSERT_EQUAL( "file10", an[2] );
+}
+
+void ArraysTestCase::NaturalSort()
+{
+    CPPUNIT_ASSERT( wxCmpNatural("", "") == 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("", "a") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("abc", "abc") == 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("abc", "ABD") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a2", "a10") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a10", "a2") > 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a10b", "a10c") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a10", "a10b") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("1a", "a") < 0 );
+
+    // Numbers longer than any integer type must work too.
+    CPPUNIT_ASSERT( wxCmpNatural("x123456789012345678901234567890",
+                                 "x123456789012345678901234567891") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("x99999999999999999999999999999",
+                                 "x123456789012345678901234567890") < 0 );
+
+    // Strings equal in natural order are still ordered consistently.
+    CPPUNIT_ASSERT( wxCmpNatural("a01", "a1") != 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a01", "a1") == -wxCmpNatural("a1", "a01") );
+    CPPUNIT_ASSERT( wxCmpNatural("A1", "a1") != 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("A1", "a1") == -wxCmpNatural("a1", "A1") );
+
+    // But the numeric value and case-insensitive comparison take precedence.
+    CPPUNIT_ASSERT( wxCmpNatural("a01b", "a1c") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("A2", "a10") < 0 );
+    CPPUNIT_ASSERT( wxCmpNatural("a002", "a10") < 0 );
+
+    wxArrayString a;
+    a.Add("img12.png");
+    a.Add("img10.png");
+    a.Add("IMG2.png");
+    a.Add("img1.png");
+    a.Sort(wxNaturalStringSortAscending);
+    CPPUNIT_ASSERT_EQUAL( "img1.png", a[0] );
+    CPPUNIT_ASSERT_EQUAL( "IMG2.png", a[1] );
+    CPPUNIT_ASSERT_EQUAL( "img10.png", a[2] );
+    CPPUNIT_ASSERT_EQUAL( "img12.png", a[3] );
+
+    a.Sort(wxNaturalStringSortDescending);
+    CPPUNIT_ASSERT_EQUAL( "img12.png", a[0] );
+    CPPUNIT_ASSERT_EQUAL( "img1.png", a[3] );
+}
+
+void ArraysTestCase::ParallelSort()
+{
+    wxArrayString a;
+    a.ParallelSort();
+    CPPUNIT_ASSERT( a.empty() );
+
+    // Use an array big enough to be really sorted in parallel.
+    wxUint32 seed = 1;
+    for ( int n = 0; n < 50000; n++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        a.Add(wxString::Format("file%u", (seed >> 8) % 30000));
+    }
+
+    wxArrayString b(a);
+    b.Sort();
+    a.ParallelSort();
+    CPPUNIT_ASSERT( a == b );
+
+    b.Sort(wxNaturalStringSortAscending);
+    a.ParallelSort(wxNaturalStringSortAscending);
+    CPPUNIT_ASSERT( a == b );
+
+    for ( size_t n = 1; n < a.size(); n++ )
+        CPPUNIT_ASSERT( wxCmpNatural(a[n - 1], a[n]) <= 0 );
 }
 
 void ArraysTestCase::wxStringArraySplitTest()
@@ -0,0 +1,227 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/archive.cpp
+// Purpose:     Archive streams benchmarks
+// Created:     2020-03-02
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/filename.h"
+#include "wx/filesys.h"
+#include "wx/fs_arc.h"
+#include "wx/mstream.h"
+#include "wx/scopedptr.h"
+#include "wx/wfstream.h"
+#include "wx/zipstrm.h"
+
+#include "bench.h"
+
+// The archive used by the benchmarks below contains 50000 small entries by
+// default, use the numeric parameter to change this.
+static wxString gs_zipName;
+static int gs_zipCount;
+
+static wxString GetZipEntryName(int n)
+{
+    return wxString::Format("dir%d/file%d.txt", n % 100, n);
+}
+
+// the last entry is the worst case for the sequential search
+static wxString GetZipLastEntryName()
+{
+    return GetZipEntryName(gs_zipCount - 1);
+}
+
+static bool ZipInit()
+{
+    gs_zipCount = Bench::GetNumericParameter();
+    if ( gs_zipCount <= 1 )
+        gs_zipCount = 50000;
+
+    gs_zipName = wxFileName::CreateTempFileName("benchzip");
+    if ( gs_zipName.empty() )
+        return false;
+
+    wxFFileOutputStream out(gs_zipName);
+    wxZipOutputStream zip(out);
+    for ( int n = 0; n < gs_zipCount; n++ )
+    {
+        if ( !zip.PutNextEntry(GetZipEntryName(n)) )
+            return false;
+        zip.Write("data", 4);
+    }
+
+    if ( !wxFileSystem::HasHandlerForPath("file:x.zip#zip:x") )
+        wxFileSystem::AddHandler(new wxArchiveFSHandler);
+
+    return zip.Close() && out.Close();
+}
+
+static void ZipDone()
+{
+    wxRemoveFile(gs_zipName);
+}
+
+static bool ReadEntry(wxInputStream& in)
+{
+    char buf[16];
+    return in.Read(buf, sizeof(buf)).LastRead() == 4;
+}
+
+// Opening the entry without any cached information by enumerating the
+// archive entries until the one we're looking for is found.
+BENCHMARK_FUNC_WITH_INIT(ZipFirstOpenSequential, ZipInit, ZipDone)
+{
+    const wxString name = GetZipLastEntryName();
+
+    wxFFileInputStream in(gs_zipName);
+    wxZipInputStream zip(in);
+
+    wxScopedPtr<wxZipEntry> entry;
+    for ( ;; )
+    {
+        entry.reset(zip.GetNextEntry());
+        if ( !entry )
+            return false;
+
+        if ( entry->GetName(wxPATH_UNIX) == name )
+            break;
+    }
+
+    return zip.OpenEntry(*entry) && ReadEntry(zip);
+}
+
+// The same thing but loading the index of the central directory first.
+BENCHMARK_FUNC_WITH_INIT(ZipFirstOpenIndexed, ZipInit, ZipDone)
+{
+    wxFFileInputStream in(gs_zipName);
+
+    wxZipIndex index;
+    if ( !index.Load(in) )
+        return false;
+
+    const int n = index.Find(GetZipLastEntryName(), wxPATH_UNIX);
+    if ( n == wxNOT_FOUND )
+        return false;
+
+    wxZipInputStream zip(in);
+    return zip.OpenEntry(index, n) && ReadEntry(zip);
+}
+
+// Opening an entry when the index had been already loaded before.
+static wxZipIndex *gs_zipIndex;
+
+static bool ZipIndexInit()
+{
+    if ( !ZipInit() )
+        return false;
+
+    gs_zipIndex = new wxZipIndex;
+
+    wxFFileInputStream in(gs_zipName);
+    return gs_zipIndex->Load(in);
+}
+
+static void ZipIndexDone()
+{
+    wxDELETE(gs_zipIndex);
+    ZipDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipRepeatedOpenIndexed, ZipIndexInit, ZipIndexDone)
+{
+    static int s_next = 0;
+    s_next = (s_next + 7919) % gs_zipCount;
+
+    const int n = gs_zipIndex->Find(GetZipEntryName(s_next), wxPATH_UNIX);
+    if ( n == wxNOT_FOUND )
+        return false;
+
+    wxFFileInputStream in(gs_zipName);
+    wxZipInputStream zip(in);
+    return zip.OpenEntry(*gs_zipIndex, n) && ReadEntry(zip);
+}
+
+// Opening the entries using wxFileSystem, which caches the archive catalog,
+// so only the first iteration is slow.
+static wxFileSystem *gs_fs;
+
+static bool ZipFSInit()
+{
+    gs_fs = new wxFileSystem;
+    return ZipInit();
+}
+
+static void ZipFSDone()
+{
+    wxDELETE(gs_fs);
+    ZipDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipFileSystemOpen, ZipFSInit, ZipFSDone)
+{
+    static int s_next = 0;
+    s_next = (s_next + 7919) % gs_zipCount;
+
+    const wxString url = wxFileSystem::FileNameToURL(gs_zipName) +
+                            "#zip:" + GetZipEntryName(s_next);
+
+    wxScopedPtr<wxFSFile> file(gs_fs->OpenFile(url));
+    return file && ReadEntry(*file->GetStream());
+}
+
+// Writing a zip with many small, compressible entries.
+static const int ZIP_WRITE_COUNT = 10000;
+
+static const wxCharBuffer& GetZipEntryData(int n)
+{
+    // don't measure the time needed to build the data itself
+    static wxCharBuffer s_data[16];
+
+    wxCharBuffer& data = s_data[n % WXSIZEOF(s_data)];
+    if ( !data )
+    {
+        wxString s;
+        for ( int i = 0; i < 50; i++ )
+            s << "This is line " << i << " of the entry number " << n << ".\n";
+        data = s.utf8_str();
+    }
+
+    return data;
+}
+
+BENCHMARK_FUNC(ZipWriteSequential)
+{
+    wxMemoryOutputStream out;
+    wxZipOutputStream zip(out);
+    for ( int n = 0; n < ZIP_WRITE_COUNT; n++ )
+    {
+        const wxCharBuffer& data = GetZipEntryData(n);
+        if ( !zip.PutNextEntry(GetZipEntryName(n)) )
+            return false;
+        zip.Write(data.data(), data.length());
+    }
+
+    return zip.Close();
+}
+
+BENCHMARK_FUNC(ZipWriteParallel)
+{
+    wxMemoryOutputStream out;
+    wxZipOutputStream zip(out);
+    {
+        // Use the numeric parameter, if given, as the number of threads.
+        wxZipParallelWriter writer(zip, Bench::GetNumericParameter());
+        for ( int n = 0; n < ZIP_WRITE_COUNT; n++ )
+        {
+            const wxCharBuffer& data = GetZipEntryData(n);
+            if ( !writer.AddEntry(GetZipEntryName(n), data.data(), data.length()) )
+                return false;
+        }
+
+        if ( !writer.Finish() )
+            return false;
+    }
+
+    return zip.Close();
+}
@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/config.cpp
+// Purpose:     wxFileConfig loading and flushing benchmarks
+// Created:     2020-03-12
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/ffile.h"
+#include "wx/filename.h"
+#include "wx/fileconf.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The file used by the benchmarks below has 50000 entries in 500 groups by
+// default, use the numeric parameter to specify the number of entries.
+wxString gs_fileName;
+wxFileConfig *gs_config = NULL;
+long gs_counter = 0;
+
+bool ConfigFileInit()
+{
+    long entries = Bench::GetNumericParameter();
+    if ( !entries )
+        entries = 50000;
+
+    gs_fileName = wxFileName::CreateTempFileName("benchconf");
+    if ( gs_fileName.empty() )
+        return false;
+
+    wxString text;
+    for ( long n = 0; n < entries; n++ )
+    {
+        if ( n % 100 == 0 )
+            text += wxString::Format("\n[Group%ld]\n", n / 100);
+
+        text += wxString::Format("Entry%ld=Some value of the entry %ld\n", n, n);
+    }
+
+    wxFFile file(gs_fileName, "w");
+    return file.Write(text) && file.Close();
+}
+
+void ConfigFileDone()
+{
+    wxRemoveFile(gs_fileName);
+}
+
+wxFileConfig *CreateConfig()
+{
+    return new wxFileConfig(wxString(), wxString(), gs_fileName, wxString(),
+                            wxCONFIG_USE_LOCAL_FILE);
+}
+
+bool ConfigInit()
+{
+    if ( !ConfigFileInit() )
+        return false;
+
+    gs_config = CreateConfig();
+
+    return true;
+}
+
+#if wxUSE_THREADS
+bool ConfigInitBackground()
+{
+    if ( !ConfigInit() )
+        return false;
+
+    gs_config->EnableBackgroundFlush();
+
+    return true;
+}
+#endif // wxUSE_THREADS
+
+void ConfigDone()
+{
+    delete gs_config;
+    gs_config = NULL;
+
+    ConfigFileDone();
+}
+
+// Change a single value, as is typically done in response to the user action,
+// and flush the config.
+bool ChangeAndFlush()
+{
+    return gs_config->Write("/Group1/Entry100", ++gs_counter) &&
+                gs_config->Flush();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLoad, ConfigFileInit, ConfigFileDone)
+{
+    wxFileConfig * const config = CreateConfig();
+    const bool ok = config->GetNumberOfGroups() != 0;
+    delete config;
+
+    return ok;
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigFlush, ConfigInit, ConfigDone)
+{
+    return ChangeAndFlush();
+}
+
+#if wxUSE_THREADS
+// Notice that this measures the time spent in Flush() itself, i.e. the time
+// during which the caller is blocked, and it includes waiting for the previous
+// background flush to finish if it didn't finish yet.
+BENCHMARK_FUNC_WITH_INIT(FileConfigFlushBackground, ConfigInitBackground, ConfigDone)
+{
+    return ChangeAndFlush();
+}
+#endif // wxUSE_THREADS
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigFlushUnchanged, ConfigInit, ConfigDone)
+{
+    return gs_config->Write("/Group1/Entry100", "Some value of the entry 100") &&
+                gs_config->Flush();
+}
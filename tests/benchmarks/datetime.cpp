@@ -17,3 +17,34 @@ BENCHMARK_FUNC(ParseDate)
     return dt.ParseDate("May 23, 2011") && dt.GetMonth() == wxDateTime::May;
 }
 
+
+BENCHMARK_FUNC(ParseISOCombined)
+{
+    wxDateTime dt;
+    return dt.ParseISOCombined("2011-05-23T12:34:56") && dt.GetDay() == 23;
+}
+
+BENCHMARK_FUNC(ParseFormatter)
+{
+    static const wxDateTimeFormatter fmt("%Y-%m-%dT%H:%M:%S");
+
+    wxDateTime dt;
+    return fmt.Parse("2011-05-23T12:34:56", &dt, wxDateTime::UTC) &&
+                dt.GetDay(wxDateTime::UTC) == 23;
+}
+
+BENCHMARK_FUNC(FormatISOCombined)
+{
+    static const wxDateTime dt(23, wxDateTime::May, 2011, 12, 34, 56);
+
+    return dt.Format("%Y-%m-%dT%H:%M:%S").length() == 19;
+}
+
+BENCHMARK_FUNC(FormatFormatter)
+{
+    static const wxDateTimeFormatter fmt("%Y-%m-%dT%H:%M:%S");
+    static const wxDateTime dt(23, wxDateTime::May, 2011, 12, 34, 56);
+
+    wxChar buf[32];
+    return fmt.Format(dt, buf, WXSIZEOF(buf)) == 19;
+}
@@ -0,0 +1,187 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/files.cpp
+// Purpose:     File input streams benchmarks
+// Created:     2020-03-05
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/filename.h"
+#include "wx/wfstream.h"
+#include "wx/zipstrm.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The file used by the benchmarks below is 16MiB by default, use the numeric
+// parameter to specify its size in KiB instead.
+wxString gs_fileName;
+size_t gs_fileSize;
+
+bool FileInit()
+{
+    gs_fileSize = Bench::GetNumericParameter();
+    if ( !gs_fileSize )
+        gs_fileSize = 16*1024;
+    gs_fileSize *= 1024;
+
+    gs_fileName = wxFileName::CreateTempFileName("benchfile");
+    if ( gs_fileName.empty() )
+        return false;
+
+    char buf[4096];
+    for ( size_t n = 0; n < sizeof(buf); n++ )
+        buf[n] = static_cast<char>(n * 7);
+
+    wxFileOutputStream out(gs_fileName);
+    for ( size_t size = 0; size < gs_fileSize; size += sizeof(buf) )
+    {
+        if ( !out.WriteAll(buf, sizeof(buf)) )
+            return false;
+    }
+
+    return out.Close();
+}
+
+void FileDone()
+{
+    wxRemoveFile(gs_fileName);
+}
+
+// Read the entire stream in small pieces, as most parsers do.
+bool ReadInSmallPieces(wxInputStream& in)
+{
+    char buf[16];
+    size_t total = 0;
+    while ( in.Read(buf, sizeof(buf)).LastRead() )
+        total += in.LastRead();
+
+    return total == gs_fileSize;
+}
+
+// Jump around the stream reading small headers, as the image handlers checking
+// whether they can read the file or the archive readers do.
+bool SeekAndRead(wxInputStream& in)
+{
+    const wxFileOffset step = 4093;
+    wxFileOffset pos = 0;
+    char buf[8];
+    for ( int n = 0; n < 10000; n++ )
+    {
+        pos = (pos + step) % (gs_fileSize - sizeof(buf));
+        if ( in.SeekI(pos) != pos )
+            return false;
+
+        if ( in.Read(buf, sizeof(buf)).LastRead() != sizeof(buf) )
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(FileReadFile, FileInit, FileDone)
+{
+    wxFileInputStream in(gs_fileName);
+    return ReadInSmallPieces(in);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileReadFFile, FileInit, FileDone)
+{
+    wxFFileInputStream in(gs_fileName);
+    return ReadInSmallPieces(in);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileReadBuffered, FileInit, FileDone)
+{
+    wxFileInputStream in(gs_fileName);
+    wxBufferedInputStream bin(in);
+    return ReadInSmallPieces(bin);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileReadMapped, FileInit, FileDone)
+{
+    wxMappedFileInputStream in(gs_fileName);
+    return ReadInSmallPieces(in);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileSeekFile, FileInit, FileDone)
+{
+    wxFileInputStream in(gs_fileName);
+    return SeekAndRead(in);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileSeekMapped, FileInit, FileDone)
+{
+    wxMappedFileInputStream in(gs_fileName);
+    return SeekAndRead(in);
+}
+
+// Reading a zip archive with compressible entries from a file and from the
+// same file mapped into memory, where the data is inflated without copying.
+namespace
+{
+
+const int ZIP_ENTRIES = 1000;
+
+bool ZipInit()
+{
+    gs_fileName = wxFileName::CreateTempFileName("benchzip");
+    if ( gs_fileName.empty() )
+        return false;
+
+    wxString data;
+    for ( int n = 0; n < 1000; n++ )
+        data += wxString::Format("This is the line %d of the entry.\n", n);
+    const wxScopedCharBuffer buf(data.utf8_str());
+
+    wxFFileOutputStream out(gs_fileName);
+    wxZipOutputStream zip(out);
+    for ( int n = 0; n < ZIP_ENTRIES; n++ )
+    {
+        if ( !zip.PutNextEntry(wxString::Format("file%d.txt", n)) )
+            return false;
+        zip.Write(buf.data(), buf.length());
+    }
+
+    return zip.Close() && out.Close();
+}
+
+bool ReadAllZipEntries(wxInputStream& in)
+{
+    wxZipInputStream zip(in);
+
+    char buf[4096];
+    int count = 0;
+    for ( wxZipEntry* entry; (entry = zip.GetNextEntry()) != NULL; )
+    {
+        delete entry;
+
+        while ( zip.Read(buf, sizeof(buf)).LastRead() )
+            ;
+
+        if ( zip.GetLastError() != wxSTREAM_EOF )
+            return false;
+
+        count++;
+    }
+
+    return count == ZIP_ENTRIES;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(ZipReadFile, ZipInit, FileDone)
+{
+    wxFFileInputStream in(gs_fileName);
+    return ReadAllZipEntries(in);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipReadMapped, ZipInit, FileDone)
+{
+    wxMappedFileInputStream in(gs_fileName);
+    return ReadAllZipEntries(in);
+}
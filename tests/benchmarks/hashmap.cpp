@@ -0,0 +1,277 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/hashmap.cpp
+// Purpose:     wxHashMap benchmarks
+// Created:     2020-03-16
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/hashmap.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+// The benchmarks below compare the normal hash maps with the ones using open
+// addressing. Each of them uses 10000 keys by default, use the numeric
+// parameter to specify a different number.
+
+WX_DECLARE_HASH_MAP(long, long, wxIntegerHash, wxIntegerEqual, IntHashMap);
+WX_DECLARE_OPEN_HASH_MAP(long, long, wxIntegerHash, wxIntegerEqual,
+                         OpenIntHashMap);
+
+WX_DECLARE_STRING_HASH_MAP(long, StringHashMap);
+WX_DECLARE_OPEN_STRING_HASH_MAP(long, OpenStringHashMap);
+
+namespace
+{
+
+wxVector<long> gs_intKeys;
+wxVector<wxString> gs_stringKeys;
+
+// These vectors and maps are only used by the "Find" benchmarks: the keys are
+// looked up in a different order from the one in which they were inserted, as
+// it would be unrealistically favourable to the maps allocating a node for
+// each element otherwise, and the missing keys are all different.
+wxVector<long> gs_intLookupKeys,
+               gs_intMissingKeys;
+wxVector<wxString> gs_stringLookupKeys,
+                   gs_stringMissingKeys;
+
+IntHashMap *gs_intMap = NULL;
+OpenIntHashMap *gs_openIntMap = NULL;
+StringHashMap *gs_stringMap = NULL;
+OpenStringHashMap *gs_openStringMap = NULL;
+
+size_t GetKeysCount()
+{
+    const long count = Bench::GetNumericParameter();
+    return count > 0 ? count : 10000;
+}
+
+bool IntKeysInit()
+{
+    const size_t count = GetKeysCount();
+    gs_intKeys.reserve(count);
+
+    // Don't use consecutive keys as this would be too easy.
+    for ( size_t n = 0; n < count; n++ )
+        gs_intKeys.push_back(static_cast<long>(n * 2654435761u % 1000000007u));
+
+    return true;
+}
+
+void IntKeysDone()
+{
+    gs_intKeys.clear();
+}
+
+bool StringKeysInit()
+{
+    const size_t count = GetKeysCount();
+    gs_stringKeys.reserve(count);
+
+    for ( size_t n = 0; n < count; n++ )
+        gs_stringKeys.push_back(wxString::Format("key_%lu", (unsigned long)n));
+
+    return true;
+}
+
+void StringKeysDone()
+{
+    gs_stringKeys.clear();
+}
+
+// Return the keys in pseudo-random order.
+template <typename Key>
+wxVector<Key> ShuffleKeys(const wxVector<Key>& keys)
+{
+    wxVector<Key> shuffled(keys);
+
+    wxUint32 seed = 1;
+    for ( size_t n = shuffled.size(); n > 1; n-- )
+    {
+        seed = seed * 1103515245u + 12345u;
+        wxSwap(shuffled[n - 1], shuffled[(seed >> 8) % n]);
+    }
+
+    return shuffled;
+}
+
+template <typename Map, typename Key>
+void FillMap(Map& map, const wxVector<Key>& keys)
+{
+    for ( size_t n = 0; n < keys.size(); n++ )
+        map[keys[n]] = n;
+}
+
+template <typename Map, typename Key>
+bool InsertKeys(const wxVector<Key>& keys)
+{
+    Map map;
+    FillMap(map, keys);
+
+    return map.size() == keys.size();
+}
+
+// Look up all the existing keys and the same number of non-existing ones.
+template <typename Map, typename Key>
+bool FindKeys(const Map& map,
+              const wxVector<Key>& keys,
+              const wxVector<Key>& missing)
+{
+    for ( size_t n = 0; n < keys.size(); n++ )
+    {
+        if ( map.find(keys[n]) == map.end() )
+            return false;
+
+        if ( map.find(missing[n]) != map.end() )
+            return false;
+    }
+
+    return true;
+}
+
+// Fill the map and then erase all its elements.
+template <typename Map, typename Key>
+bool InsertEraseKeys(const wxVector<Key>& keys)
+{
+    Map map;
+    FillMap(map, keys);
+
+    for ( size_t n = 0; n < keys.size(); n++ )
+    {
+        if ( map.erase(keys[n]) != 1 )
+            return false;
+    }
+
+    return map.empty();
+}
+
+bool IntMapsInit()
+{
+    IntKeysInit();
+
+    gs_intMap = new IntHashMap;
+    FillMap(*gs_intMap, gs_intKeys);
+
+    gs_openIntMap = new OpenIntHashMap;
+    FillMap(*gs_openIntMap, gs_intKeys);
+
+    gs_intLookupKeys = ShuffleKeys(gs_intKeys);
+
+    // All the keys are positive, so their negations are not in the map.
+    for ( size_t n = 0; n < gs_intLookupKeys.size(); n++ )
+        gs_intMissingKeys.push_back(-1 - gs_intLookupKeys[n]);
+
+    return true;
+}
+
+void IntMapsDone()
+{
+    wxDELETE(gs_intMap);
+    wxDELETE(gs_openIntMap);
+
+    gs_intLookupKeys.clear();
+    gs_intMissingKeys.clear();
+
+    IntKeysDone();
+}
+
+bool StringMapsInit()
+{
+    StringKeysInit();
+
+    gs_stringMap = new StringHashMap;
+    FillMap(*gs_stringMap, gs_stringKeys);
+
+    gs_openStringMap = new OpenStringHashMap;
+    FillMap(*gs_openStringMap, gs_stringKeys);
+
+    gs_stringLookupKeys = ShuffleKeys(gs_stringKeys);
+
+    for ( size_t n = 0; n < gs_stringLookupKeys.size(); n++ )
+        gs_stringMissingKeys.push_back("no_" + gs_stringLookupKeys[n]);
+
+    return true;
+}
+
+void StringMapsDone()
+{
+    wxDELETE(gs_stringMap);
+    wxDELETE(gs_openStringMap);
+
+    gs_stringLookupKeys.clear();
+    gs_stringMissingKeys.clear();
+
+    StringKeysDone();
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// Integer keys
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC_WITH_INIT(HashMapIntInsert, IntKeysInit, IntKeysDone)
+{
+    return InsertKeys<IntHashMap>(gs_intKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapIntInsert, IntKeysInit, IntKeysDone)
+{
+    return InsertKeys<OpenIntHashMap>(gs_intKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(HashMapIntFind, IntMapsInit, IntMapsDone)
+{
+    return FindKeys(*gs_intMap, gs_intLookupKeys, gs_intMissingKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapIntFind, IntMapsInit, IntMapsDone)
+{
+    return FindKeys(*gs_openIntMap, gs_intLookupKeys, gs_intMissingKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(HashMapIntInsertErase, IntKeysInit, IntKeysDone)
+{
+    return InsertEraseKeys<IntHashMap>(gs_intKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapIntInsertErase, IntKeysInit, IntKeysDone)
+{
+    return InsertEraseKeys<OpenIntHashMap>(gs_intKeys);
+}
+
+// ----------------------------------------------------------------------------
+// String keys
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC_WITH_INIT(HashMapStringInsert, StringKeysInit, StringKeysDone)
+{
+    return InsertKeys<StringHashMap>(gs_stringKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapStringInsert, StringKeysInit, StringKeysDone)
+{
+    return InsertKeys<OpenStringHashMap>(gs_stringKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(HashMapStringFind, StringMapsInit, StringMapsDone)
+{
+    return FindKeys(*gs_stringMap, gs_stringLookupKeys, gs_stringMissingKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapStringFind, StringMapsInit, StringMapsDone)
+{
+    return FindKeys(*gs_openStringMap, gs_stringLookupKeys, gs_stringMissingKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(HashMapStringInsertErase, StringKeysInit, StringKeysDone)
+{
+    return InsertEraseKeys<StringHashMap>(gs_stringKeys);
+}
+
+BENCHMARK_FUNC_WITH_INIT(OpenHashMapStringInsertErase, StringKeysInit, StringKeysDone)
+{
+    return InsertEraseKeys<OpenStringHashMap>(gs_stringKeys);
+}
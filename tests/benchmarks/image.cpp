@@ -7,7 +7,16 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+#include "wx/anidecod.h" // wxImageArray
+#include "wx/bitmap.h"
+#include "wx/dcmemory.h"
+#include "wx/dir.h"
+#include "wx/filename.h"
+#include "wx/gifdecod.h"
+#include "wx/imagbatch.h"
 #include "wx/image.h"
+#include "wx/mstream.h"
+#include "wx/quantize.h"
 
 #include "bench.h"
 
@@ -30,6 +39,73 @@ BENCHMARK_FUNC(LoadJPEG)
     return image.LoadFile("horse.jpg");
 }
 
+// Creating thumbnails from a big JPEG image: the numeric parameter specifies
+// the thumbnail size, 160 pixels by default.
+static const wxMemoryOutputStream& GetBigJPEG()
+{
+    static wxMemoryOutputStream s_jpeg;
+    if ( !s_jpeg.GetLength() )
+    {
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+            wxImage::AddHandler(new wxJPEGHandler);
+
+        wxImage image;
+        if ( image.LoadFile("horse.jpg") )
+        {
+            image.Rescale(4000, 3000, wxIMAGE_QUALITY_BILINEAR);
+            image.SaveFile(s_jpeg, wxBITMAP_TYPE_JPEG);
+        }
+    }
+
+    return s_jpeg;
+}
+
+static bool MakeJPEGThumbnail(bool scaleWhileLoading, bool fast)
+{
+    const wxMemoryOutputStream& jpeg = GetBigJPEG();
+    wxMemoryInputStream stream(jpeg);
+
+    int size = static_cast<int>(Bench::GetNumericParameter());
+    if ( !size )
+        size = 160;
+
+    wxImage image;
+    if ( scaleWhileLoading )
+    {
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, size);
+        image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, size);
+    }
+    if ( fast )
+        image.SetOption(wxIMAGE_OPTION_JPEG_FAST_DECODE, 1);
+
+    if ( !image.LoadFile(stream, wxBITMAP_TYPE_JPEG) )
+        return false;
+
+    const int width = image.GetWidth();
+    const int height = image.GetHeight();
+    if ( width > height )
+        image.Rescale(size, (height*size) / width, wxIMAGE_QUALITY_BOX_AVERAGE);
+    else
+        image.Rescale((width*size) / height, size, wxIMAGE_QUALITY_BOX_AVERAGE);
+
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(JPEGThumbnailFull)
+{
+    return MakeJPEGThumbnail(false, false);
+}
+
+BENCHMARK_FUNC(JPEGThumbnailScaled)
+{
+    return MakeJPEGThumbnail(true, false);
+}
+
+BENCHMARK_FUNC(JPEGThumbnailScaledFast)
+{
+    return MakeJPEGThumbnail(true, true);
+}
+
 BENCHMARK_FUNC(LoadPNG)
 {
     static bool s_handlerAdded = false;
@@ -43,6 +119,92 @@ BENCHMARK_FUNC(LoadPNG)
     return image.LoadFile("horse.png");
 }
 
+// Loading and saving a big PNG image, with and without alpha.
+static const wxImage& GetBigPNGTestImage(bool alpha)
+{
+    static wxImage s_images[2];
+
+    wxImage& image = s_images[alpha];
+    if ( !image.IsOk() )
+    {
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+            wxImage::AddHandler(new wxPNGHandler);
+
+        if ( image.LoadFile("horse.png") )
+        {
+            image.Rescale(3000, 3000, wxIMAGE_QUALITY_BILINEAR);
+            if ( alpha )
+            {
+                image.SetAlpha();
+                unsigned char* p = image.GetAlpha();
+                for ( int n = 0; n < 3000*3000; n++ )
+                    *p++ = static_cast<unsigned char>(n / 7);
+            }
+        }
+    }
+
+    return image;
+}
+
+static const wxMemoryOutputStream& GetBigPNG(bool alpha)
+{
+    static wxMemoryOutputStream s_pngs[2];
+
+    wxMemoryOutputStream& png = s_pngs[alpha];
+    if ( !png.GetLength() )
+        GetBigPNGTestImage(alpha).SaveFile(png, wxBITMAP_TYPE_PNG);
+
+    return png;
+}
+
+static bool LoadBigPNG(bool alpha)
+{
+    wxMemoryInputStream stream(GetBigPNG(alpha));
+
+    wxImage image;
+    return image.LoadFile(stream, wxBITMAP_TYPE_PNG);
+}
+
+static bool SaveBigPNG(bool alpha, int level)
+{
+    wxImage image(GetBigPNGTestImage(alpha));
+    if ( level != -1 )
+        image.SetOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL, level);
+
+    wxMemoryOutputStream stream;
+    return image.SaveFile(stream, wxBITMAP_TYPE_PNG);
+}
+
+BENCHMARK_FUNC(LoadPNGBig)
+{
+    return LoadBigPNG(false);
+}
+
+BENCHMARK_FUNC(LoadPNGBigAlpha)
+{
+    return LoadBigPNG(true);
+}
+
+BENCHMARK_FUNC(SavePNGBig)
+{
+    return SaveBigPNG(false, -1);
+}
+
+BENCHMARK_FUNC(SavePNGBigAlpha)
+{
+    return SaveBigPNG(true, -1);
+}
+
+BENCHMARK_FUNC(SavePNGBigFast)
+{
+    return SaveBigPNG(false, 1);
+}
+
+BENCHMARK_FUNC(SavePNGBigUncompressed)
+{
+    return SaveBigPNG(false, 0);
+}
+
 #if wxUSE_LIBTIFF
 BENCHMARK_FUNC(LoadTIFF)
 {
@@ -56,8 +218,128 @@ BENCHMARK_FUNC(LoadTIFF)
     wxImage image;
     return image.LoadFile("horse.tif");
 }
+
+// Loading a big TIFF image entirely or only a part of it: notice that, in
+// addition to being faster, reading a part also uses only as much memory as
+// needed for this part and a band of rows of the image.
+static const wxMemoryOutputStream& GetBigTIFF()
+{
+    static wxMemoryOutputStream s_tiff;
+
+    if ( !s_tiff.GetLength() )
+    {
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_TIFF) )
+            wxImage::AddHandler(new wxTIFFHandler);
+
+        GetBigPNGTestImage(false).SaveFile(s_tiff, wxBITMAP_TYPE_TIFF);
+    }
+
+    return s_tiff;
+}
+
+BENCHMARK_FUNC(LoadTIFFBig)
+{
+    wxMemoryInputStream stream(GetBigTIFF());
+
+    wxImage image;
+    return image.LoadFile(stream, wxBITMAP_TYPE_TIFF);
+}
+
+BENCHMARK_FUNC(ReadTIFFBigRegion)
+{
+    wxMemoryInputStream stream(GetBigTIFF());
+
+    wxTIFFReader reader;
+    if ( !reader.Open(stream) )
+        return false;
+
+    wxImage image;
+    return reader.Read(&image, wxRect(1000, 1000, 500, 500));
+}
 #endif // wxUSE_LIBTIFF
 
+#if wxUSE_GIF && wxUSE_PALETTE
+// Loading a long GIF animation and getting all of its frames, as when playing
+// it, with all frames decoded when loading or decoded on demand: the latter
+// only keeps the compressed data and a few decoded frames in memory instead
+// of all of them, which is not measured by these benchmarks but can be seen
+// in the difference between the time needed for loading the animation.
+static const wxMemoryOutputStream& GetLongGIFAnimation()
+{
+    static wxMemoryOutputStream s_gif;
+
+    if ( !s_gif.GetLength() )
+    {
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_GIF) )
+            wxImage::AddHandler(new wxGIFHandler);
+
+        wxImage image;
+        if ( !image.LoadFile("horse.gif") )
+            return s_gif;
+
+        wxImageArray images;
+        images.Add(image);
+        for ( int i = 1; i < 200; i++ )
+        {
+            images.Add(i % 4 ? images[i - 1].Rotate90() : images[i - 1].Mirror());
+            images[i].SetPalette(image.GetPalette());
+        }
+
+        wxGIFHandler().SaveAnimation(images, &s_gif);
+    }
+
+    return s_gif;
+}
+
+static bool LoadLongGIFAnimation(bool onDemand)
+{
+    wxMemoryInputStream stream(GetLongGIFAnimation());
+
+    wxGIFDecoder decoder;
+    decoder.SetDecodeOnDemand(onDemand);
+    return decoder.LoadGIF(stream) == wxGIF_OK;
+}
+
+static bool PlayLongGIFAnimation(bool onDemand)
+{
+    wxMemoryInputStream stream(GetLongGIFAnimation());
+
+    wxGIFDecoder decoder;
+    decoder.SetDecodeOnDemand(onDemand);
+    if ( decoder.LoadGIF(stream) != wxGIF_OK )
+        return false;
+
+    wxImage image;
+    for ( unsigned int n = 0; n < decoder.GetFrameCount(); n++ )
+    {
+        if ( !decoder.ConvertToImage(n, &image) )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC(LoadGIFAnimation)
+{
+    return LoadLongGIFAnimation(false);
+}
+
+BENCHMARK_FUNC(LoadGIFAnimationOnDemand)
+{
+    return LoadLongGIFAnimation(true);
+}
+
+BENCHMARK_FUNC(PlayGIFAnimation)
+{
+    return PlayLongGIFAnimation(false);
+}
+
+BENCHMARK_FUNC(PlayGIFAnimationOnDemand)
+{
+    return PlayLongGIFAnimation(true);
+}
+#endif // wxUSE_GIF && wxUSE_PALETTE
+
 static const wxImage& GetTestImage()
 {
     static wxImage s_image;
@@ -90,3 +372,349 @@ BENCHMARK_FUNC(ShrinkHighQuality)
 {
     return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+// Scaling a big image, use the numeric parameter to specify the number of
+// threads to use, by default as many as there are CPUs.
+static const wxImage& GetBigTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        const wxImage& image = GetTestImage();
+        if ( image.IsOk() )
+            s_image = image.Scale(2000, 1500, wxIMAGE_QUALITY_NEAREST);
+    }
+
+    return s_image;
+}
+
+static bool ScaleBig(int width, int height, wxImageResizeQuality quality)
+{
+    wxImage::SetProcessingThreads(static_cast<int>(Bench::GetNumericParameter()));
+
+    return GetBigTestImage().Scale(width, height, quality).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBoxAverage)
+{
+    return ScaleBig(500, 375, wxIMAGE_QUALITY_BOX_AVERAGE);
+}
+
+BENCHMARK_FUNC(ShrinkBigBilinear)
+{
+    return ScaleBig(1000, 750, wxIMAGE_QUALITY_BILINEAR);
+}
+
+BENCHMARK_FUNC(ShrinkBigBicubic)
+{
+    return ScaleBig(1000, 750, wxIMAGE_QUALITY_BICUBIC);
+}
+
+BENCHMARK_FUNC(EnlargeBigBilinear)
+{
+    return ScaleBig(4000, 3000, wxIMAGE_QUALITY_BILINEAR);
+}
+
+BENCHMARK_FUNC(EnlargeBigBicubic)
+{
+    return ScaleBig(4000, 3000, wxIMAGE_QUALITY_BICUBIC);
+}
+
+// Blurring an 8K image with a big radius, the numeric parameter is used as the
+// number of threads, as above.
+static const int BLUR_RADIUS = 50;
+
+static wxImage& GetBlurTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        const wxImage& image = GetTestImage();
+        if ( image.IsOk() )
+        {
+            s_image = image.Scale(7680, 4320, wxIMAGE_QUALITY_NEAREST);
+            s_image.SetAlpha();
+        }
+    }
+
+    wxImage::SetProcessingThreads(static_cast<int>(Bench::GetNumericParameter()));
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(BlurBig)
+{
+    return GetBlurTestImage().Blur(BLUR_RADIUS).IsOk();
+}
+
+BENCHMARK_FUNC(BlurBigHorizontal)
+{
+    return GetBlurTestImage().BlurHorizontal(BLUR_RADIUS).IsOk();
+}
+
+BENCHMARK_FUNC(BlurBigVertical)
+{
+    return GetBlurTestImage().BlurVertical(BLUR_RADIUS).IsOk();
+}
+
+BENCHMARK_FUNC(BlurBigInPlace)
+{
+    // The image is blurred again on each iteration, which doesn't matter for
+    // measuring the time taken.
+    return GetBlurTestImage().BlurInPlace(BLUR_RADIUS).IsOk();
+}
+
+BENCHMARK_FUNC(GaussianBlurBig)
+{
+    return GetBlurTestImage().GaussianBlur(BLUR_RADIUS / 2.0).IsOk();
+}
+
+// Converting images with and without alpha to interleaved RGBA data and to
+// bitmaps, which uses such data internally in most ports.
+static const int RGBA_IMAGE_SIZE = 1000;
+
+static const wxImage& GetRGBATestImage(bool alpha)
+{
+    static wxImage s_images[2];
+
+    wxImage& image = s_images[alpha];
+    if ( !image.IsOk() )
+    {
+        const wxImage& original = GetTestImage();
+        if ( original.IsOk() )
+        {
+            image = original.Scale(RGBA_IMAGE_SIZE, RGBA_IMAGE_SIZE,
+                                   wxIMAGE_QUALITY_NEAREST);
+            if ( alpha )
+            {
+                image.SetAlpha();
+                unsigned char* p = image.GetAlpha();
+                for ( int n = 0; n < RGBA_IMAGE_SIZE*RGBA_IMAGE_SIZE; n++ )
+                    *p++ = static_cast<unsigned char>(n);
+            }
+        }
+    }
+
+    return image;
+}
+
+static wxVector<wxUint32>& GetRGBABuffer()
+{
+    static wxVector<wxUint32> s_buffer(RGBA_IMAGE_SIZE*RGBA_IMAGE_SIZE);
+    return s_buffer;
+}
+
+static bool ImageToRGBA(wxImageRGBAFormat format)
+{
+    unsigned char* const
+        buffer = reinterpret_cast<unsigned char*>(&GetRGBABuffer()[0]);
+    return GetRGBATestImage(true).GetRGBA(buffer, format);
+}
+
+BENCHMARK_FUNC(ImageGetRGBA)
+{
+    return ImageToRGBA(wxIMAGE_FORMAT_RGBA);
+}
+
+BENCHMARK_FUNC(ImageGetRGBAPremultiplied)
+{
+    return ImageToRGBA(wxIMAGE_FORMAT_RGBA_PREMULTIPLIED);
+}
+
+BENCHMARK_FUNC(ImageGetARGB32)
+{
+    return ImageToRGBA(wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED);
+}
+
+BENCHMARK_FUNC(ImageSetARGB32)
+{
+    static wxImage s_image(RGBA_IMAGE_SIZE, RGBA_IMAGE_SIZE);
+
+    const unsigned char* const
+        buffer = reinterpret_cast<unsigned char*>(&GetRGBABuffer()[0]);
+    return s_image.SetRGBA(buffer, wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED);
+}
+
+BENCHMARK_FUNC(BitmapFromImage)
+{
+    return wxBitmap(GetRGBATestImage(false)).IsOk();
+}
+
+BENCHMARK_FUNC(BitmapFromImageAlpha)
+{
+    return wxBitmap(GetRGBATestImage(true)).IsOk();
+}
+
+static bool DrawImage(bool alpha)
+{
+    static wxBitmap s_target(RGBA_IMAGE_SIZE, RGBA_IMAGE_SIZE);
+
+    wxMemoryDC dc(s_target);
+    dc.DrawBitmap(wxBitmap(GetRGBATestImage(alpha)), 0, 0, true);
+
+    return true;
+}
+
+BENCHMARK_FUNC(DrawImage)
+{
+    return DrawImage(false);
+}
+
+BENCHMARK_FUNC(DrawImageAlpha)
+{
+    return DrawImage(true);
+}
+
+// Colour operations on a 1000*1000 image.
+static wxImage& GetColourTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+        s_image = GetRGBATestImage(false).Copy();
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(ConvertToGreyscale)
+{
+    return GetColourTestImage().ConvertToGreyscale().IsOk();
+}
+
+BENCHMARK_FUNC(ConvertToDisabled)
+{
+    return GetColourTestImage().ConvertToDisabled().IsOk();
+}
+
+BENCHMARK_FUNC(ConvertToMono)
+{
+    return GetColourTestImage().ConvertToMono(255, 255, 255).IsOk();
+}
+
+BENCHMARK_FUNC(ChangeLightness)
+{
+    return GetColourTestImage().ChangeLightness(120).IsOk();
+}
+
+BENCHMARK_FUNC(ReplaceColour)
+{
+    wxImage& image = GetColourTestImage();
+    image.Replace(255, 255, 255, 254, 254, 254);
+    image.Replace(254, 254, 254, 255, 255, 255);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(RotateHue)
+{
+    wxImage& image = GetColourTestImage();
+    image.RotateHue(0.5);
+    return image.IsOk();
+}
+
+BENCHMARK_FUNC(SetRGBRect)
+{
+    static wxImage s_image(RGBA_IMAGE_SIZE, RGBA_IMAGE_SIZE);
+    s_image.SetRGB(wxRect(100, 100, 800, 800), 10, 20, 30);
+    return s_image.IsOk();
+}
+
+// Computing the histogram of a big image and quantizing it, use the numeric
+// parameter to specify the number of threads to use for the histogram.
+BENCHMARK_FUNC(ComputeHistogramBig)
+{
+    wxImage::SetProcessingThreads(static_cast<int>(Bench::GetNumericParameter()));
+
+    wxImageHistogram histogram;
+    return GetBigTestImage().ComputeHistogram(histogram) != 0;
+}
+
+BENCHMARK_FUNC(CountColoursBig)
+{
+    return GetBigTestImage().CountColours() != 0;
+}
+
+BENCHMARK_FUNC(CountColoursBigStop)
+{
+    // This is what the handlers of palettized formats do.
+    return GetBigTestImage().CountColours(256) != 0;
+}
+
+static bool QuantizeBig(int flags)
+{
+    wxImage quantized;
+    return wxQuantize::Quantize(GetBigTestImage(), quantized, NULL, 236, NULL,
+                                flags | wxQUANTIZE_FILL_DESTINATION_IMAGE);
+}
+
+BENCHMARK_FUNC(QuantizeBig)
+{
+    return QuantizeBig(0);
+}
+
+BENCHMARK_FUNC(QuantizeBigNoDithering)
+{
+    return QuantizeBig(wxQUANTIZE_NO_DITHERING);
+}
+
+BENCHMARK_FUNC(QuantizeBigRefine)
+{
+    return QuantizeBig(wxQUANTIZE_REFINE_COLOURS);
+}
+
+// Loading all the images in a directory, given by the string parameter and
+// the current one by default, using the number of threads specified by the
+// numeric parameter.
+static const wxArrayString& GetBatchFiles()
+{
+    static wxArrayString s_files;
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+            wxImage::AddHandler(new wxPNGHandler);
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+            wxImage::AddHandler(new wxJPEGHandler);
+#if wxUSE_GIF
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_GIF) )
+            wxImage::AddHandler(new wxGIFHandler);
+#endif // wxUSE_GIF
+#if wxUSE_LIBTIFF
+        if ( !wxImage::FindHandler(wxBITMAP_TYPE_TIFF) )
+            wxImage::AddHandler(new wxTIFFHandler);
+#endif // wxUSE_LIBTIFF
+
+        wxString dir = Bench::GetStringParameter();
+        if ( dir.empty() )
+            dir = ".";
+
+        wxArrayString files;
+        wxDir::GetAllFiles(dir, &files, wxString(), wxDIR_FILES);
+        for ( size_t n = 0; n < files.size(); n++ )
+        {
+            if ( wxImage::FindHandler(wxFileName(files[n]).GetExt(),
+                                      wxBITMAP_TYPE_ANY) )
+                s_files.push_back(files[n]);
+        }
+    }
+
+    return s_files;
+}
+
+BENCHMARK_FUNC(LoadImagesBatch)
+{
+    const wxArrayString& files = GetBatchFiles();
+
+    wxImageBatchLoader
+        loader(NULL, static_cast<int>(Bench::GetNumericParameter()));
+    for ( size_t n = 0; n < files.size(); n++ )
+        loader.Add(files[n]);
+
+    for ( size_t n = 0; n < files.size(); n++ )
+    {
+        if ( !loader.GetImage(n).IsOk() )
+            return false;
+    }
+
+    return !files.empty();
+}
@@ -41,6 +41,31 @@ private:
     wxDECLARE_NO_COPY_CLASS(LogLevelSetter);
 };
 
+// Log target simply throwing away the log messages, to remove the actual
+// logging overhead from the benchmarks.
+class NulLog : public wxLog
+{
+public:
+    NulLog()
+        : m_logOld(wxLog::SetActiveTarget(this))
+    {
+    }
+
+    virtual ~NulLog()
+    {
+        wxLog::SetActiveTarget(m_logOld);
+    }
+
+protected:
+    virtual void DoLogRecord(wxLogLevel,
+                             const wxString&,
+                             const wxLogRecordInfo&) wxOVERRIDE
+    {
+    }
+
+    wxLog* m_logOld;
+};
+
 BENCHMARK_FUNC(LogDebugDisabled)
 {
     LogLevelSetter level(wxLOG_Info);
@@ -68,31 +93,6 @@ BENCHMARK_FUNC(LogTraceActive)
         wxLog::AddTraceMask("logbench");
     }
 
-    // Remove the actual logging overhead by simply throwing away the log
-    // messages.
-    class NulLog : public wxLog
-    {
-    public:
-        NulLog()
-            : m_logOld(wxLog::SetActiveTarget(this))
-        {
-        }
-
-        virtual ~NulLog()
-        {
-            wxLog::SetActiveTarget(m_logOld);
-        }
-
-    protected:
-        virtual void DoLogRecord(wxLogLevel,
-                                 const wxString&,
-                                 const wxLogRecordInfo&)
-        {
-        }
-
-        wxLog* m_logOld;
-    };
-
     NulLog nulLog;
 
     wxLogTrace("logbench", "Trace message");
@@ -106,3 +106,185 @@ BENCHMARK_FUNC(LogTraceInactive)
 
     return true;
 }
+
+BENCHMARK_FUNC(LogTraceHandleActive)
+{
+    static wxLogTraceMaskHandle s_mask("logbench");
+    if ( !s_mask.IsEnabled() )
+        wxLog::AddTraceMask("logbench");
+
+    NulLog nulLog;
+
+    wxLogTrace(s_mask, "Trace message");
+
+    return true;
+}
+
+BENCHMARK_FUNC(LogTraceHandleInactive)
+{
+    static wxLogTraceMaskHandle s_mask("bloordyblop");
+
+    // The other arguments are not even evaluated when the mask is disabled.
+    wxLogTrace(s_mask, "Trace message: %s", NotCreated().AsStr());
+
+    return true;
+}
+
+// Check whether the messages from a component whose level was changed are
+// enabled, using either its name or a handle for it.
+static wxLogComponentHandle gs_benchComponent("logbench/off/sub");
+
+static bool LogComponentInit()
+{
+    wxLog::SetComponentLevel("logbench/off", wxLOG_Error);
+    return true;
+}
+
+static void LogComponentDone()
+{
+    wxLog::SetComponentLevel("logbench/off", wxLOG_Max);
+}
+
+BENCHMARK_FUNC_WITH_INIT(LogComponentDisabled,
+                         LogComponentInit, LogComponentDone)
+{
+    return !wxLog::IsLevelEnabled(wxLOG_Info, "logbench/off/sub");
+}
+
+BENCHMARK_FUNC_WITH_INIT(LogComponentHandleDisabled,
+                         LogComponentInit, LogComponentDone)
+{
+    return !wxLog::IsLevelEnabled(wxLOG_Info, gs_benchComponent);
+}
+
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// Producer-side latency under contention
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Log target formatting the messages, including their time stamps, as usual
+// but throwing them away instead of outputting them.
+class FormatOnlyLog : public wxLog
+{
+protected:
+    virtual void DoLogText(const wxString&) wxOVERRIDE
+    {
+    }
+};
+
+// Thread-safe version of the above serializing all calls to it, this is what
+// the threads logging into the same synchronous target have to do.
+class LockedFormatOnlyLog : public FormatOnlyLog
+{
+protected:
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) wxOVERRIDE
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        FormatOnlyLog::DoLogRecord(level, msg, info);
+    }
+
+    virtual bool IsThreadSafe() const wxOVERRIDE { return true; }
+
+private:
+    wxCriticalSection m_cs;
+};
+
+// Thread logging messages continuously until it is deleted.
+class LoggingThread : public wxThread
+{
+public:
+    LoggingThread() : wxThread(wxTHREAD_JOINABLE) { }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( unsigned n = 0; !TestDestroy(); n++ )
+            wxLogMessage("Message %u from the background thread", n);
+
+        return NULL;
+    }
+};
+
+const int NUM_LOGGING_THREADS = 3;
+
+wxLog* gs_logOld = NULL;
+wxLog* gs_logContended = NULL;
+LoggingThread* gs_loggingThreads[NUM_LOGGING_THREADS];
+
+void StartContention(wxLog* log)
+{
+    gs_logContended = log;
+    gs_logOld = wxLog::SetActiveTarget(log);
+
+    for ( int n = 0; n < NUM_LOGGING_THREADS; n++ )
+    {
+        gs_loggingThreads[n] = new LoggingThread;
+        gs_loggingThreads[n]->Run();
+    }
+}
+
+void StopContention()
+{
+    for ( int n = 0; n < NUM_LOGGING_THREADS; n++ )
+    {
+        gs_loggingThreads[n]->Delete();
+        delete gs_loggingThreads[n];
+    }
+
+    wxLog::SetActiveTarget(gs_logOld);
+    delete gs_logContended;
+}
+
+bool LogSyncInit()
+{
+    StartContention(new LockedFormatOnlyLog);
+    return true;
+}
+
+bool LogAsyncInit()
+{
+    StartContention(new wxLogAsync(new FormatOnlyLog, 4096));
+    return true;
+}
+
+bool LogAsyncDiscardInit()
+{
+    StartContention(new wxLogAsync(new FormatOnlyLog, 4096,
+                                   wxLOG_ASYNC_DISCARD));
+    return true;
+}
+
+} // anonymous namespace
+
+// These benchmarks measure the time taken by wxLogMessage() in the main thread
+// while several other threads are logging into the same target too.
+BENCHMARK_FUNC_WITH_INIT(LogSyncContended, LogSyncInit, StopContention)
+{
+    wxLogMessage("Message from the main thread");
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(LogAsyncContended, LogAsyncInit, StopContention)
+{
+    wxLogMessage("Message from the main thread");
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(LogAsyncDiscardContended, LogAsyncDiscardInit,
+                         StopContention)
+{
+    wxLogMessage("Message from the main thread");
+
+    return true;
+}
+
+#endif // wxUSE_THREADS
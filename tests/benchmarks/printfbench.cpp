@@ -137,3 +137,22 @@ BENCHMARK_FUNC(SystemSnprintf)
     return true;
 }
 
+
+BENCHMARK_FUNC(StringFormatShort)
+{
+    const wxString s = wxString::Format("Item %d of %d: %s", 17, 42, "name");
+    return s.length() == 19;
+}
+
+BENCHMARK_FUNC(StringFormatLong)
+{
+    const wxString s = wxString::Format
+                       (
+                        "This is a reasonably long string with various %s "
+                        "arguments, exactly %d, and is used as benchmark "
+                        "for %s - %% %.2f %d %s",
+                        "(many!!)", 6, "this program", 23.342f, 999,
+                        g_verylongString
+                       );
+    return s.length() > g_verylongString.length();
+}
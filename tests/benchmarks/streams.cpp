@@ -0,0 +1,175 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/streams.cpp
+// Purpose:     Bulk and vectored stream I/O benchmarks
+// Created:     2020-03-08
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/datstrm.h"
+#include "wx/filename.h"
+#include "wx/mstream.h"
+#include "wx/wfstream.h"
+
+#include "bench.h"
+
+// Writing and reading back arrays of integers in big endian byte order, which
+// requires swapping their bytes on the usual little endian machines. The
+// arrays have 1M elements by default, use the numeric parameter to change it.
+namespace
+{
+
+wxUint32 *gs_data;
+size_t gs_count;
+wxMemoryOutputStream *gs_output;
+
+bool DataInit()
+{
+    gs_count = Bench::GetNumericParameter();
+    if ( !gs_count )
+        gs_count = 1024*1024;
+
+    gs_data = new wxUint32[gs_count];
+    for ( size_t n = 0; n < gs_count; n++ )
+        gs_data[n] = static_cast<wxUint32>(n * 0x01020304);
+
+    gs_output = new wxMemoryOutputStream;
+    wxDataOutputStream out(*gs_output);
+    out.BigEndianOrdered(true);
+    out.Write32(gs_data, gs_count);
+
+    return gs_output->IsOk();
+}
+
+void DataDone()
+{
+    wxDELETE(gs_output);
+    wxDELETEA(gs_data);
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(DataWrite32Array, DataInit, DataDone)
+{
+    wxMemoryOutputStream mout;
+    wxDataOutputStream out(mout);
+    out.BigEndianOrdered(true);
+    out.Write32(gs_data, gs_count);
+
+    return mout.GetLength() == static_cast<wxFileOffset>(gs_count*4);
+}
+
+BENCHMARK_FUNC_WITH_INIT(DataRead32Array, DataInit, DataDone)
+{
+    wxMemoryInputStream min(*gs_output);
+    wxDataInputStream in(min);
+    in.BigEndianOrdered(true);
+
+    wxUint32 buf[4096];
+    for ( size_t count = gs_count; count; )
+    {
+        const size_t n = count < WXSIZEOF(buf) ? count : WXSIZEOF(buf);
+        in.Read32(buf, n);
+        count -= n;
+    }
+
+    return in.IsOk();
+}
+
+// Writing records consisting of several separate parts to a file, either one
+// part at a time or all of them at once using WriteV().
+namespace
+{
+
+const int RECORD_COUNT = 10000;
+
+wxString gs_fileName;
+
+bool FileInit()
+{
+    gs_fileName = wxFileName::CreateTempFileName("benchstream");
+    return !gs_fileName.empty();
+}
+
+void FileDone()
+{
+    wxRemoveFile(gs_fileName);
+}
+
+char gs_header[16] = "header";
+char gs_body[200] = "body";
+char gs_trailer[8] = "trailer";
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(FileWriteParts, FileInit, FileDone)
+{
+    wxFileOutputStream out(gs_fileName);
+    for ( int n = 0; n < RECORD_COUNT; n++ )
+    {
+        out.Write(gs_header, sizeof(gs_header));
+        out.Write(gs_body, sizeof(gs_body));
+        out.Write(gs_trailer, sizeof(gs_trailer));
+    }
+
+    return out.Close();
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileWriteVectored, FileInit, FileDone)
+{
+    wxStreamIOVec vec[3];
+    vec[0].data = gs_header;
+    vec[0].size = sizeof(gs_header);
+    vec[1].data = gs_body;
+    vec[1].size = sizeof(gs_body);
+    vec[2].data = gs_trailer;
+    vec[2].size = sizeof(gs_trailer);
+
+    wxFileOutputStream out(gs_fileName);
+    for ( int n = 0; n < RECORD_COUNT; n++ )
+        out.WriteV(vec, WXSIZEOF(vec));
+
+    return out.Close();
+}
+
+// Copying a big file using a buffered output stream, as wxFileSystem and
+// wxCopyFile-like code do: with big writes bypassing the buffer, the data is
+// not copied into it first.
+namespace
+{
+
+const size_t COPY_SIZE = 16*1024*1024;
+
+bool CopyInit()
+{
+    if ( !FileInit() )
+        return false;
+
+    wxCharBuffer buf(COPY_SIZE);
+    memset(buf.data(), 'x', COPY_SIZE);
+
+    wxFileOutputStream out(gs_fileName);
+    return out.WriteAll(buf, COPY_SIZE) && out.Close();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(FileCopyBuffered, CopyInit, FileDone)
+{
+    wxFileInputStream in(gs_fileName);
+    wxBufferedInputStream bufIn(in);
+    wxInputStream& bin = bufIn;
+
+    const wxString name = gs_fileName + ".copy";
+    bool ok;
+    {
+        wxFileOutputStream out(name);
+        wxBufferedOutputStream bout(out);
+        bin.Read(bout);
+        ok = bout.Close() && bin.LastRead() == COPY_SIZE;
+    }
+
+    wxRemoveFile(name);
+
+    return ok;
+}
@@ -8,7 +8,10 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "wx/string.h"
+#include "wx/arrstr.h"
 #include "wx/ffile.h"
+#include "wx/stratom.h"
+#include "wx/tokenzr.h"
 
 #include "bench.h"
 #include "htmlparser/htmlpars.h"
@@ -72,6 +75,70 @@ BENCHMARK_FUNC(Strlen)
     return true;
 }
 
+// ----------------------------------------------------------------------------
+// wxStringAtom benchmarks
+// ----------------------------------------------------------------------------
+
+// Names typically occurring in XML or HTML documents.
+static const char *const atomNames[] =
+{
+    "html", "head", "body", "table", "tr", "td", "div", "span", "class", "id",
+};
+
+// As the strings are removed from the pool when the last atom using them is
+// destroyed, keep them alive to measure the lookup of the existing strings,
+// as happens when parsing a document containing many elements.
+static void InitAtomNames()
+{
+    static wxStringAtom s_atoms[WXSIZEOF(atomNames)];
+    if ( s_atoms[0].IsEmpty() )
+    {
+        for ( size_t n = 0; n < WXSIZEOF(atomNames); n++ )
+            s_atoms[n] = wxStringAtom(atomNames[n]);
+    }
+}
+
+BENCHMARK_FUNC(StringAtomFromString)
+{
+    InitAtomNames();
+
+    for ( size_t n = 0; n < WXSIZEOF(atomNames); n++ )
+    {
+        const wxStringAtom atom(wxString::FromUTF8(atomNames[n]));
+        if ( atom.IsEmpty() )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC(StringAtomFromUTF8)
+{
+    InitAtomNames();
+
+    for ( size_t n = 0; n < WXSIZEOF(atomNames); n++ )
+    {
+        const wxStringAtom atom(wxStringAtom::FromUTF8(atomNames[n]));
+        if ( atom.IsEmpty() )
+            return false;
+    }
+
+    return true;
+}
+
+// This is the baseline for the benchmarks above: just creating the strings.
+BENCHMARK_FUNC(StringAtomStringsOnly)
+{
+    for ( size_t n = 0; n < WXSIZEOF(atomNames); n++ )
+    {
+        const wxString s(wxString::FromUTF8(atomNames[n]));
+        if ( s.empty() )
+            return false;
+    }
+
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // FromUTF8() benchmarks
 // ----------------------------------------------------------------------------
@@ -292,6 +359,95 @@ BENCHMARK_FUNC(ReplaceShorter)
     return str.Replace("xx", "y") != 0;
 }
 
+BENCHMARK_FUNC(ReplaceSameLength)
+{
+    wxString str('x', ASCIISTR_LEN);
+    return str.Replace("xx", "yy") != 0;
+}
+
+BENCHMARK_FUNC(ReplaceWords)
+{
+    wxString str(GetTestAsciiString());
+    return str.Replace("line", "row") != 0;
+}
+
+BENCHMARK_FUNC(ReplaceWordsLonger)
+{
+    wxString str(GetTestAsciiString());
+    return str.Replace("line", "paragraph") != 0;
+}
+
+// ----------------------------------------------------------------------------
+// searching in strings
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(FindCharMissing)
+{
+    return GetTestAsciiString().Find('!') == wxNOT_FOUND;
+}
+
+BENCHMARK_FUNC(FindStringMissing)
+{
+    return GetTestAsciiString().Find("8 bit") == wxNOT_FOUND;
+}
+
+BENCHMARK_FUNC(Contains)
+{
+    return GetTestAsciiString().Contains("ninth line");
+}
+
+BENCHMARK_FUNC(StartsWith)
+{
+    const wxString& s = GetTestAsciiString();
+
+    return s.StartsWith(s);
+}
+
+BENCHMARK_FUNC(EndsWith)
+{
+    const wxString& s = GetTestAsciiString();
+
+    return s.EndsWith(s);
+}
+
+// ----------------------------------------------------------------------------
+// wxStringTokenizer
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(TokenizerGetNextToken)
+{
+    wxStringTokenizer tkz(GetTestAsciiString(), " ");
+
+    size_t count = 0;
+    while ( tkz.HasMoreTokens() )
+    {
+        if ( !tkz.GetNextToken().empty() )
+            count++;
+    }
+
+    return count != 0;
+}
+
+BENCHMARK_FUNC(TokenizerGetNextTokenRange)
+{
+    wxStringTokenizer tkz(GetTestAsciiString(), " ");
+
+    size_t count = 0;
+    wxString::const_iterator start, end;
+    while ( tkz.GetNextTokenRange(&start, &end) )
+    {
+        if ( start != end )
+            count++;
+    }
+
+    return count != 0;
+}
+
+BENCHMARK_FUNC(StringTokenize)
+{
+    return !wxStringTokenize(GetTestAsciiString(), " ,").empty();
+}
+
 // ----------------------------------------------------------------------------
 // string case conversion
 // ----------------------------------------------------------------------------
@@ -352,6 +508,25 @@ BENCHMARK_FUNC(StringCmpNoCase)
     return s.CmpNoCase(s) == 0;
 }
 
+BENCHMARK_FUNC(StringCmpNoCaseCopy)
+{
+    // Unlike above, compare different, even if equal, strings.
+    static wxString s2;
+    if ( s2.empty() )
+        s2 = wxString(GetTestAsciiString().wx_str(), GetTestAsciiString().length());
+
+    return GetTestAsciiString().CmpNoCase(s2) == 0;
+}
+
+BENCHMARK_FUNC(StringCmpNoCaseUpper)
+{
+    static wxString s2;
+    if ( s2.empty() )
+        s2 = GetTestAsciiString().Upper();
+
+    return GetTestAsciiString().CmpNoCase(s2) == 0;
+}
+
 // Also benchmark various native functions under MSW. Surprisingly/annoyingly
 // they sometimes have vastly better performance than alternatives, especially
 // for case-sensitive comparison (see #10375).
@@ -401,6 +576,94 @@ BENCHMARK_FUNC(MSWCompareStringIgnoreCase)
 
 #endif // __WINDOWS__
 
+// ----------------------------------------------------------------------------
+// sorting string arrays
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Array of 100000 strings looking like the names of files in some directory,
+// all starting with the same prefix and containing numbers.
+wxArrayString gs_fileNames;
+
+bool InitFileNames()
+{
+    wxUint32 seed = 1;
+    for ( int n = 0; n < 100000; n++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        gs_fileNames.push_back(wxString::Format("/home/user/Pictures/%s_%u.jpg",
+                                                seed & 0x100 ? "IMG" : "img",
+                                                (seed >> 8) % 100000));
+    }
+
+    return true;
+}
+
+void DoneFileNames()
+{
+    gs_fileNames.clear();
+}
+
+int wxCMPFUNC_CONV CompareNoCase(const wxString& s1, const wxString& s2)
+{
+    return s1.CmpNoCase(s2);
+}
+
+bool IsSorted(const wxArrayString& names, wxArrayString::CompareFunction cmp)
+{
+    for ( size_t n = 1; n < names.size(); n++ )
+    {
+        if ( (*cmp)(names[n - 1], names[n]) > 0 )
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(SortStrings, InitFileNames, DoneFileNames)
+{
+    wxArrayString names(gs_fileNames);
+    names.Sort();
+
+    return IsSorted(names, wxStringSortAscending);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SortStringsNoCase, InitFileNames, DoneFileNames)
+{
+    wxArrayString names(gs_fileNames);
+    names.Sort(CompareNoCase);
+
+    return IsSorted(names, CompareNoCase);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SortStringsNatural, InitFileNames, DoneFileNames)
+{
+    wxArrayString names(gs_fileNames);
+    names.Sort(wxNaturalStringSortAscending);
+
+    return IsSorted(names, wxNaturalStringSortAscending);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ParallelSortStrings, InitFileNames, DoneFileNames)
+{
+    wxArrayString names(gs_fileNames);
+    names.ParallelSort();
+
+    return IsSorted(names, wxStringSortAscending);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ParallelSortStringsNatural, InitFileNames, DoneFileNames)
+{
+    wxArrayString names(gs_fileNames);
+    names.ParallelSort(wxNaturalStringSortAscending);
+
+    return IsSorted(names, wxNaturalStringSortAscending);
+}
+
 // ----------------------------------------------------------------------------
 // string buffers: wx[W]CharBuffer
 // ----------------------------------------------------------------------------
@@ -417,6 +680,57 @@ BENCHMARK_FUNC(CharBuffer)
 }
 
 
+// ----------------------------------------------------------------------------
+// conversions of wxString to char* and back
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+const wxString& GetTestUTF8String()
+{
+    static const wxString testString = wxString::FromUTF8(utf8str);
+
+    return testString;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(MbStr)
+{
+    return strlen(GetTestAsciiString().mb_str()) ==
+            GetTestAsciiString().length();
+}
+
+BENCHMARK_FUNC(CStrAsChar)
+{
+    const char* const p = GetTestAsciiString().c_str();
+    return strlen(p) == GetTestAsciiString().length();
+}
+
+BENCHMARK_FUNC(ToUTF8)
+{
+    return strlen(GetTestAsciiString().ToUTF8()) ==
+            GetTestAsciiString().length();
+}
+
+BENCHMARK_FUNC(ToUTF8NonASCII)
+{
+    return strlen(GetTestUTF8String().ToUTF8()) == strlen(utf8str);
+}
+
+BENCHMARK_FUNC(UTF8RoundTrip)
+{
+    const wxString& s = GetTestAsciiString();
+    return wxString::FromUTF8(s.ToUTF8()).length() == s.length();
+}
+
+BENCHMARK_FUNC(UTF8RoundTripNonASCII)
+{
+    const wxString& s = GetTestUTF8String();
+    return wxString::FromUTF8(s.ToUTF8()).length() == s.length();
+}
+
 // ----------------------------------------------------------------------------
 // wxString::operator[] - parse large HTML page
 // ----------------------------------------------------------------------------
@@ -0,0 +1,235 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/xml.cpp
+// Purpose:     XML parsing benchmarks
+// Created:     2020-03-10
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/filename.h"
+#include "wx/wfstream.h"
+#include "wx/xml/xml.h"
+
+#include "bench.h"
+
+// The document used by the benchmarks below is a typical data export with
+// 100000 records by default, use the numeric parameter to change this.
+namespace
+{
+
+wxString gs_xmlName;
+long gs_xmlRecords;
+
+bool XmlInit()
+{
+    gs_xmlRecords = Bench::GetNumericParameter();
+    if ( !gs_xmlRecords )
+        gs_xmlRecords = 100000;
+
+    gs_xmlName = wxFileName::CreateTempFileName("benchxml");
+    if ( gs_xmlName.empty() )
+        return false;
+
+    wxFFileOutputStream out(gs_xmlName);
+
+    wxString s = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<export>\n";
+    for ( long n = 0; n < gs_xmlRecords; n++ )
+    {
+        s << "  <record id=\"" << n << "\" type=\"item\">\n"
+             "    <name>Record number " << n << "</name>\n"
+             "    <value>" << n * 17 << "</value>\n"
+             "    <note>Some longer text describing the record &amp; its "
+             "contents which is not used by the benchmark.</note>\n"
+             "  </record>\n";
+
+        if ( s.length() > 65536 )
+        {
+            const wxScopedCharBuffer buf(s.utf8_str());
+            if ( !out.WriteAll(buf.data(), buf.length()) )
+                return false;
+            s.clear();
+        }
+    }
+
+    s << "</export>\n";
+    const wxScopedCharBuffer buf(s.utf8_str());
+    return out.WriteAll(buf.data(), buf.length()) && out.Close();
+}
+
+void XmlDone()
+{
+    wxRemoveFile(gs_xmlName);
+}
+
+// Extracts the value of all records, either using the entire document or the
+// nodes built for them by wxXmlStreamParser.
+long GetRecordValue(const wxXmlNode *record)
+{
+    for ( const wxXmlNode *child = record->GetChildren();
+          child;
+          child = child->GetNext() )
+    {
+        if ( child->GetName() == "value" )
+        {
+            long value;
+            if ( child->GetNodeContent().ToLong(&value) )
+                return value;
+        }
+    }
+
+    return -1;
+}
+
+class RecordValuesParser : public wxXmlStreamParser
+{
+public:
+    explicit RecordValuesParser(bool buildNodes)
+        : m_buildNodes(buildNodes), m_inValue(false), m_sum(0), m_count(0)
+    {
+    }
+
+    bool IsOk() const { return m_count == gs_xmlRecords; }
+
+protected:
+    virtual wxXmlStreamAction
+    OnStartElement(const wxString& name, const wxXmlAttribute*) wxOVERRIDE
+    {
+        if ( name == "record" )
+        {
+            m_count++;
+            if ( m_buildNodes )
+                return wxXML_STREAM_BUILD_NODE;
+        }
+        else if ( name == "value" )
+        {
+            m_inValue = true;
+        }
+        else if ( name == "note" )
+        {
+            return wxXML_STREAM_SKIP;
+        }
+
+        return wxXML_STREAM_CONTINUE;
+    }
+
+    virtual void OnEndElement(const wxString&) wxOVERRIDE
+    {
+        m_inValue = false;
+    }
+
+    virtual void OnText(const wxString& text) wxOVERRIDE
+    {
+        long value;
+        if ( m_inValue && text.ToLong(&value) )
+            m_sum += value;
+    }
+
+    virtual void OnElementNode(wxXmlNode *node) wxOVERRIDE
+    {
+        m_sum += GetRecordValue(node);
+        delete node;
+    }
+
+private:
+    const bool m_buildNodes;
+    bool m_inValue;
+    long m_sum;
+    long m_count;
+};
+
+// The document used by the benchmarks searching for the nodes by name, it is
+// loaded only once.
+wxXmlDocument *gs_xmlDoc = NULL;
+
+bool XmlDocInit()
+{
+    if ( !XmlInit() )
+        return false;
+
+    gs_xmlDoc = new wxXmlDocument;
+    return gs_xmlDoc->Load(gs_xmlName);
+}
+
+void XmlDocDone()
+{
+    delete gs_xmlDoc;
+    gs_xmlDoc = NULL;
+
+    XmlDone();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(XmlLoadDocument, XmlInit, XmlDone)
+{
+    wxXmlDocument doc;
+    if ( !doc.Load(gs_xmlName) )
+        return false;
+
+    long count = 0;
+    for ( const wxXmlNode *record = doc.GetRoot()->GetChildren();
+          record;
+          record = record->GetNext() )
+    {
+        if ( GetRecordValue(record) != -1 )
+            count++;
+    }
+
+    return count == gs_xmlRecords;
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlStreamParse, XmlInit, XmlDone)
+{
+    RecordValuesParser parser(false);
+    return parser.Parse(gs_xmlName) && parser.IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlStreamBuildNodes, XmlInit, XmlDone)
+{
+    RecordValuesParser parser(true);
+    return parser.Parse(gs_xmlName) && parser.IsOk();
+}
+
+// Compare the names of all elements with the given string.
+BENCHMARK_FUNC_WITH_INIT(XmlFindByName, XmlDocInit, XmlDocDone)
+{
+    const wxString name("value");
+
+    long count = 0;
+    for ( const wxXmlNode *record = gs_xmlDoc->GetRoot()->GetChildren();
+          record;
+          record = record->GetNext() )
+    {
+        for ( const wxXmlNode *child = record->GetChildren();
+              child;
+              child = child->GetNext() )
+        {
+            if ( child->GetName() == name )
+                count++;
+        }
+    }
+
+    return count == gs_xmlRecords;
+}
+
+// Same as above, but compare the names as atoms.
+BENCHMARK_FUNC_WITH_INIT(XmlFindByNameAtom, XmlDocInit, XmlDocDone)
+{
+    const wxStringAtom name("value");
+
+    long count = 0;
+    for ( const wxXmlNode *record = gs_xmlDoc->GetRoot()->GetChildren();
+          record;
+          record = record->GetNext() )
+    {
+        for ( const wxXmlNode *child = record->GetChildren();
+              child;
+              child = child->GetNext() )
+        {
+            if ( child->GetNameAtom() == name )
+                count++;
+        }
+    }
+
+    return count == gs_xmlRecords;
+}
@@ -24,6 +24,8 @@
 #include "wx/fileconf.h"
 #include "wx/sstream.h"
 #include "wx/log.h"
+#include "wx/ffile.h"
+#include "wx/filename.h"
 
 static const wxChar *testconfig =
 wxT("[root]\n")
@@ -83,6 +85,11 @@ private:
         CPPUNIT_TEST( ReadNonExistent );
         CPPUNIT_TEST( ReadEmpty );
         CPPUNIT_TEST( ReadFloat );
+        CPPUNIT_TEST( ReadFile );
+        CPPUNIT_TEST( WriteUnchanged );
+#if wxUSE_THREADS
+        CPPUNIT_TEST( BackgroundFlush );
+#endif // wxUSE_THREADS
     CPPUNIT_TEST_SUITE_END();
 
     void Path();
@@ -108,6 +115,11 @@ private:
     void ReadNonExistent();
     void ReadEmpty();
     void ReadFloat();
+    void ReadFile();
+    void WriteUnchanged();
+#if wxUSE_THREADS
+    void BackgroundFlush();
+#endif // wxUSE_THREADS
 
 
     static wxString ChangePath(wxFileConfig& fc, const wxChar *path)
@@ -699,5 +711,140 @@ void FileConfigTestCase::ReadFloat()
     CPPUNIT_ASSERT_EQUAL( -9876.5432f, f );
 }
 
-#endif // wxUSE_FILECONFIG
+// Helper creating a temporary file with the given contents and removing it
+// when it goes out of scope.
+class TempConfigFile
+{
+public:
+    explicit TempConfigFile(const char* contents = "")
+    {
+        m_path = wxFileName::CreateTempFileName("fileconftest");
+
+        wxFFile file(m_path, "wb");
+        CPPUNIT_ASSERT( file.Write(contents, strlen(contents)) );
+    }
+
+    ~TempConfigFile()
+    {
+        wxRemoveFile(m_path);
+    }
+
+    const wxString& GetPath() const { return m_path; }
+
+    wxString ReadContents() const
+    {
+        wxString contents;
+
+        wxFFile file(m_path);
+        CPPUNIT_ASSERT( file.ReadAll(&contents) );
+
+        return wxTextFile::Translate(contents, wxTextFileType_Unix);
+    }
+
+private:
+    wxString m_path;
+};
+
+void FileConfigTestCase::ReadFile()
+{
+    TempConfigFile file
+    (
+        "; comment\r\n"
+        "\r\n"
+        "top = 1\r\n"
+        "[group]  # comment\r"
+        "  spaced key \t =  value with spaces  \n"
+        "escaped=\" quoted\\tvalue\"\n"
+        "\n"
+        "[group/sub]\n"
+        "last=no newline"
+    );
+
+    wxFileConfig fc(wxString(), wxString(), file.GetPath(), wxString(),
+                    wxCONFIG_USE_LOCAL_FILE);
+
+    CPPUNIT_ASSERT_EQUAL( 1, fc.ReadLong("top", 0) );
+    CPPUNIT_ASSERT_EQUAL( "value with spaces  ",
+                          fc.Read("group/spaced key", wxString()) );
+    CPPUNIT_ASSERT_EQUAL( " quoted\tvalue", fc.Read("group/escaped", wxString()) );
+    CPPUNIT_ASSERT_EQUAL( "no newline", fc.Read("group/sub/last", wxString()) );
+
+    // all the lines, including the comments and the empty ones, must be
+    // preserved when the file is modified
+    fc.Write("group/new", "added");
+    wxVERIFY_FILECONFIG( "; comment\n"
+                         "\n"
+                         "top = 1\n"
+                         "[group]  # comment\n"
+                         "  spaced key \t =  value with spaces  \n"
+                         "escaped=\" quoted\\tvalue\"\n"
+                         "new=added\n"
+                         "\n"
+                         "[group/sub]\n"
+                         "last=no newline\n",
+                         fc );
+}
+
+void FileConfigTestCase::WriteUnchanged()
+{
+    TempConfigFile file("key=value\n");
+
+    wxFileConfig fc(wxString(), wxString(), file.GetPath(), wxString(),
+                    wxCONFIG_USE_LOCAL_FILE);
+
+    // writing the same value doesn't change the config, so the file must not
+    // be written when it's flushed
+    CPPUNIT_ASSERT( wxRemoveFile(file.GetPath()) );
+    CPPUNIT_ASSERT( fc.Write("key", "value") );
+    CPPUNIT_ASSERT( fc.Flush() );
+    CPPUNIT_ASSERT( !wxFileExists(file.GetPath()) );
+
+    CPPUNIT_ASSERT( fc.Write("key", "other") );
+    CPPUNIT_ASSERT( fc.Flush() );
+    CPPUNIT_ASSERT_EQUAL( "key=other\n", file.ReadContents() );
+}
+
+#if wxUSE_THREADS
+
+void FileConfigTestCase::BackgroundFlush()
+{
+    TempConfigFile file("[group]\nkey=value\n");
+
+    {
+        wxFileConfig fc(wxString(), wxString(), file.GetPath(), wxString(),
+                        wxCONFIG_USE_LOCAL_FILE);
 
+        CPPUNIT_ASSERT( !fc.IsBackgroundFlushEnabled() );
+        fc.EnableBackgroundFlush();
+        CPPUNIT_ASSERT( fc.IsBackgroundFlushEnabled() );
+
+        // nothing to wait for yet
+        CPPUNIT_ASSERT( fc.WaitForFlush() );
+
+        fc.Write("group/key", "first");
+        CPPUNIT_ASSERT( fc.Flush() );
+
+        // the second flush must wait for the first one to finish
+        fc.Write("group/another", "second");
+        CPPUNIT_ASSERT( fc.Flush() );
+
+        CPPUNIT_ASSERT( fc.WaitForFlush() );
+        CPPUNIT_ASSERT_EQUAL( "[group]\n"
+                              "key=first\n"
+                              "another=second\n",
+                              file.ReadContents() );
+
+        // the last changes must be written by the dtor
+        fc.Write("group/key", "last");
+        CPPUNIT_ASSERT( fc.Flush() );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( "[group]\n"
+                          "key=last\n"
+                          "another=second\n",
+                          file.ReadContents() );
+}
+
+#endif // wxUSE_THREADS
+
+#endif // wxUSE_FILECONFIG
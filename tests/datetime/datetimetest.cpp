@@ -1750,4 +1750,77 @@ TEST_CASE("wxDateTime::UNow", "[datetime][now][unow]")
     CHECK( gotMS );
 }
 
+TEST_CASE("wxDateTimeFormatter", "[datetime][format][parse]")
+{
+    const wxDateTime dt(wxLongLong(wxLL(1306154096789))); // 2011-05-23T12:34:56.789Z
+
+    SECTION("Format")
+    {
+        wxDateTimeFormatter fmt("%Y-%m-%dT%H:%M:%S.%l%z");
+        REQUIRE( fmt.IsCompiled() );
+        CHECK( fmt.Format(dt, wxDateTime::UTC) == "2011-05-23T12:34:56.789+0000" );
+        CHECK( fmt.Format(dt, wxDateTime::TimeZone(-3*3600 - 1800)) ==
+                "2011-05-23T09:04:56.789-0330" );
+
+        wxChar buf[11];
+        CHECK( fmt.Format(dt, buf, WXSIZEOF(buf), wxDateTime::UTC) == 28 );
+        CHECK( wxString(buf) == "2011-05-23" );
+
+        fmt.SetFormat("%d/%m/%y %% %H:%M");
+        CHECK( fmt.Format(dt, wxDateTime::UTC) == "23/05/11 % 12:34" );
+
+        // Formats which are not compiled must still work.
+        fmt.SetFormat("%A, %d %B %Y");
+        CHECK( !fmt.IsCompiled() );
+        CHECK( fmt.Format(dt, wxDateTime::UTC) ==
+                dt.Format("%A, %d %B %Y", wxDateTime::UTC) );
+
+        // And the result must be the same as with wxDateTime::Format() for
+        // the local time zone too.
+        fmt.SetFormat("%Y-%m-%d %H:%M:%S.%l");
+        CHECK( fmt.Format(dt) == dt.Format("%Y-%m-%d %H:%M:%S.%l") );
+    }
+
+    SECTION("Parse")
+    {
+        wxDateTimeFormatter iso("%Y-%m-%dT%H:%M:%S%z");
+        REQUIRE( iso.IsCompiled() );
+
+        wxDateTime parsed;
+        CHECK( iso.Parse("2011-05-23T12:34:56Z", &parsed) );
+        CHECK( parsed == dt - wxTimeSpan::Milliseconds(789) );
+        CHECK( iso.Parse("2011-05-23T14:34:56+02:00", &parsed) );
+        CHECK( parsed == dt - wxTimeSpan::Milliseconds(789) );
+
+        CHECK( !iso.Parse("2011-05-23T12:34:56", &parsed) );
+        CHECK( !iso.Parse("2011-02-30T12:34:56Z", &parsed) );
+        CHECK( !iso.Parse("2011-05-23T24:00:00Z", &parsed) );
+
+        const wxString str("2011-05-23T12:34:56.789 and more");
+        wxString::const_iterator end;
+        wxDateTimeFormatter fmt("%Y-%m-%dT%H:%M:%S.%l");
+        CHECK( fmt.Parse(str, &parsed, wxDateTime::UTC, &end) );
+        CHECK( parsed == dt );
+        CHECK( wxString(end, str.end()) == " and more" );
+
+        // Local time is used by default and the result must be the same as
+        // with wxDateTime::ParseFormat().
+        wxDateTime parsedLocal;
+        CHECK( fmt.Parse(str, &parsed, wxDateTime::Local, &end) );
+        CHECK( parsedLocal.ParseFormat(str, "%Y-%m-%dT%H:%M:%S.%l", &end) );
+        CHECK( parsed == parsedLocal );
+
+        // Time is set to 0 if not specified.
+        fmt.SetFormat("%d.%m.%Y");
+        CHECK( fmt.Parse("23.05.2011", &parsed, wxDateTime::UTC) );
+        CHECK( parsed == wxDateTime(wxLongLong(wxLL(1306108800000))) );
+
+        // Formats which are not compiled must still work.
+        fmt.SetFormat("%d %b %Y");
+        CHECK( !fmt.IsCompiled() );
+        CHECK( fmt.Parse("23 May 2011", &parsed) );
+        CHECK( parsed == wxDateTime(23, wxDateTime::May, 2011) );
+    }
+}
+
 #endif // wxUSE_DATETIME
@@ -83,6 +83,12 @@ private:
         CPPUNIT_TEST( LLongHashMapTest );
         CPPUNIT_TEST( ULLongHashMapTest );
 #endif
+        CPPUNIT_TEST( OpenStringHashMapTest );
+        CPPUNIT_TEST( OpenPtrHashMapTest );
+        CPPUNIT_TEST( OpenLongHashMapTest );
+        CPPUNIT_TEST( OpenShortHashMapTest );
+        CPPUNIT_TEST( OpenHashMapEraseTest );
+        CPPUNIT_TEST( OpenHashMapCopyTest );
         CPPUNIT_TEST( wxHashSetTest );
     CPPUNIT_TEST_SUITE_END();
 
@@ -101,6 +107,12 @@ private:
     void LLongHashMapTest();
     void ULLongHashMapTest();
 #endif
+    void OpenStringHashMapTest();
+    void OpenPtrHashMapTest();
+    void OpenLongHashMapTest();
+    void OpenShortHashMapTest();
+    void OpenHashMapEraseTest();
+    void OpenHashMapCopyTest();
     void wxHashSetTest();
 
     wxDECLARE_NO_COPY_CLASS(HashesTestCase);
@@ -475,6 +487,112 @@ void HashesTestCase::LLongHashMapTest()  { HashMapTest<myLLongHashMap>();    }
 void HashesTestCase::ULLongHashMapTest() { HashMapTest<myULLongHashMap>();   }
 #endif
 
+// the same tests for the maps using open addressing
+WX_DECLARE_OPEN_STRING_HASH_MAP( wxString, myOpenStringHashMap );
+WX_DECLARE_OPEN_HASH_MAP( int*, int*, wxPointerHash, wxPointerEqual,
+                          myOpenPtrHashMap );
+WX_DECLARE_OPEN_HASH_MAP( long, long, wxIntegerHash, wxIntegerEqual,
+                          myOpenLongHashMap );
+WX_DECLARE_OPEN_HASH_MAP( short, unsigned, wxIntegerHash, wxIntegerEqual,
+                          myOpenShortHashMap );
+
+void HashesTestCase::OpenStringHashMapTest() { HashMapTest<myOpenStringHashMap>(); }
+void HashesTestCase::OpenPtrHashMapTest()    { HashMapTest<myOpenPtrHashMap>();    }
+void HashesTestCase::OpenLongHashMapTest()   { HashMapTest<myOpenLongHashMap>();   }
+void HashesTestCase::OpenShortHashMapTest()  { HashMapTest<myOpenShortHashMap>();  }
+
+void HashesTestCase::OpenHashMapEraseTest()
+{
+    myOpenLongHashMap h;
+    h.reserve(1000);
+
+    for ( long n = 0; n < 1000; n++ )
+        h[n] = 2*n;
+
+    CPPUNIT_ASSERT_EQUAL( 1000, h.size() );
+
+    // inserting an existing key doesn't change the map
+    myOpenLongHashMap::Insert_Result res =
+        h.insert(myOpenLongHashMap::value_type(17, 0));
+    CPPUNIT_ASSERT( !res.second );
+    CPPUNIT_ASSERT_EQUAL( 34, res.first->second );
+
+    // erasing the elements doesn't invalidate the other iterators
+    for ( myOpenLongHashMap::iterator it = h.begin(); it != h.end(); )
+    {
+        if ( it->first % 3 )
+            h.erase(it++);
+        else
+            ++it;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 334, h.size() );
+
+    for ( long n = 0; n < 1000; n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( (n % 3 ? 0u : 1u), h.count(n) );
+    }
+
+    // the slots of the erased elements are reused
+    for ( long n = 0; n < 1000; n++ )
+        h[n] = n;
+
+    CPPUNIT_ASSERT_EQUAL( 1000, h.size() );
+    CPPUNIT_ASSERT_EQUAL( 999, h[999] );
+
+    h.clear();
+    CPPUNIT_ASSERT( h.empty() );
+    CPPUNIT_ASSERT( h.begin() == h.end() );
+    CPPUNIT_ASSERT( h.find(0) == h.end() );
+}
+
+// hash function mapping all keys to the same value to test collisions
+class CollidingHash
+{
+public:
+    unsigned long operator()(long WXUNUSED(n)) const { return 0; }
+};
+
+WX_DECLARE_OPEN_HASH_MAP( long, long, CollidingHash, wxIntegerEqual,
+                          myOpenCollidingHashMap );
+
+void HashesTestCase::OpenHashMapCopyTest()
+{
+    myOpenCollidingHashMap h;
+    h[1] = 10;
+    h[2] = 20;
+    h[3] = 30;
+
+    // the other elements are found after the slot of the first one which is
+    // now marked as deleted
+    h.erase(1);
+
+    myOpenCollidingHashMap h2(h);
+    CPPUNIT_ASSERT_EQUAL( 2, h2.size() );
+    CPPUNIT_ASSERT_EQUAL( 0u, h2.count(1) );
+    CPPUNIT_ASSERT_EQUAL( 1u, h2.count(2) );
+    CPPUNIT_ASSERT_EQUAL( 1u, h2.count(3) );
+    CPPUNIT_ASSERT_EQUAL( 30, h2[3] );
+
+    myOpenCollidingHashMap h3;
+    h3[4] = 40;
+    h3 = h;
+    CPPUNIT_ASSERT_EQUAL( 2, h3.size() );
+    CPPUNIT_ASSERT_EQUAL( 0u, h3.count(4) );
+    CPPUNIT_ASSERT_EQUAL( 1u, h3.count(2) );
+    CPPUNIT_ASSERT_EQUAL( 1u, h3.count(3) );
+    CPPUNIT_ASSERT_EQUAL( 20, h3[2] );
+
+    // the copies can be modified independently of the original map
+    h3.erase(2);
+    h3[5] = 50;
+    CPPUNIT_ASSERT_EQUAL( 2, h3.size() );
+    CPPUNIT_ASSERT_EQUAL( 30, h3[3] );
+    CPPUNIT_ASSERT_EQUAL( 50, h3[5] );
+    CPPUNIT_ASSERT_EQUAL( 2, h.size() );
+    CPPUNIT_ASSERT_EQUAL( 1u, h.count(2) );
+}
+
 // test compilation of basic set types
 WX_DECLARE_HASH_SET( int*, wxPointerHash, wxPointerEqual, myPtrHashSet );
 WX_DECLARE_HASH_SET( long, wxIntegerHash, wxIntegerEqual, myLongHashSet );
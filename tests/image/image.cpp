@@ -23,7 +23,11 @@
 #endif // WX_PRECOMP
 
 #include "wx/anidecod.h" // wxImageArray
+#include "wx/colour.h"
+#include "wx/gifdecod.h"
+#include "wx/imagbatch.h"
 #include "wx/palette.h"
+#include "wx/quantize.h"
 #include "wx/url.h"
 #include "wx/log.h"
 #include "wx/mstream.h"
@@ -1363,6 +1367,25 @@ FindMaxChannelDiff(const wxImage& i1, const wxImage& i2)
     return maxDiff;
 }
 
+// Fill the image, and its alpha channel if it has one, with the values which
+// differ between the neighbouring pixels and don't repeat too regularly.
+static void FillWithTestData(wxImage& image)
+{
+    const int width = image.GetWidth();
+    const int count = width*image.GetHeight();
+
+    unsigned char* data = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+    for ( int n = 0; n < count; n++ )
+    {
+        *data++ = static_cast<unsigned char>(n);
+        *data++ = static_cast<unsigned char>(n / width);
+        *data++ = static_cast<unsigned char>(n * 7);
+        if ( alpha )
+            *alpha++ = static_cast<unsigned char>(n % 3 ? n / 5 : 0);
+    }
+}
+
 // Note that we accept up to one pixel difference, this happens because of
 // different rounding behaviours in different compiler versions
 // even under the same architecture, see the example in
@@ -1452,6 +1475,1182 @@ void ImageTestCase::ScaleCompare()
                                "image/cross_nearest_neighb_256x256.png");
 }
 
+TEST_CASE("wxImage::ScaleThreads", "[image][scale]")
+{
+    // Create an image big enough to be processed by several threads.
+    const int width = 1000;
+    const int height = 800;
+    wxImage image(width, height, false);
+    image.SetAlpha();
+    FillWithTestData(image);
+
+    const int oldThreads = wxImage::GetProcessingThreads();
+
+    const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(qualities); n++ )
+    {
+        INFO("Quality " << qualities[n]);
+
+        wxImage::SetProcessingThreads(1);
+        const wxImage smaller = image.Scale(333, 222, qualities[n]);
+        const wxImage bigger = image.Scale(1234, 987, qualities[n]);
+
+        // The results must be exactly the same whichever number of threads
+        // is used.
+        wxImage::SetProcessingThreads(4);
+        const wxImage smallerMT = image.Scale(333, 222, qualities[n]);
+        const wxImage biggerMT = image.Scale(1234, 987, qualities[n]);
+
+        CHECK( FindMaxChannelDiff(smaller, smallerMT) == 0 );
+        CHECK( memcmp(smaller.GetAlpha(), smallerMT.GetAlpha(), 333*222) == 0 );
+        CHECK( FindMaxChannelDiff(bigger, biggerMT) == 0 );
+        CHECK( memcmp(bigger.GetAlpha(), biggerMT.GetAlpha(), 1234*987) == 0 );
+    }
+
+    wxImage::SetProcessingThreads(oldThreads);
+}
+
+TEST_CASE("wxImage::ScaleAlpha", "[image][scale]")
+{
+    // The colour of the fully transparent pixels must not affect the result
+    // of the algorithms weighting the colours by alpha.
+    wxImage image(16, 16, false);
+    image.SetAlpha();
+    for ( int y = 0; y < 16; y++ )
+    {
+        for ( int x = 0; x < 16; x++ )
+        {
+            if ( (x + y) % 2 )
+            {
+                image.SetRGB(x, y, 255, 0, 0);
+                image.SetAlpha(x, y, wxIMAGE_ALPHA_TRANSPARENT);
+            }
+            else
+            {
+                image.SetRGB(x, y, 0, 0, 255);
+                image.SetAlpha(x, y, wxIMAGE_ALPHA_OPAQUE);
+            }
+        }
+    }
+
+    const wxImage box = image.Scale(4, 4, wxIMAGE_QUALITY_BOX_AVERAGE);
+    const wxImage bicubic = image.Scale(7, 7, wxIMAGE_QUALITY_BICUBIC);
+
+    CHECK( box.GetRed(1, 2) == 0 );
+    CHECK( box.GetBlue(1, 2) == 255 );
+    CHECK( box.GetAlpha(1, 2) == 128 );
+
+    CHECK( bicubic.GetRed(3, 3) == 0 );
+    CHECK( bicubic.GetBlue(3, 3) == 255 );
+}
+
+// Straightforward implementation of the box blur in one direction, with the
+// pixels beyond the image edges considered to be the same as the edge pixels.
+static wxImage NaiveBoxBlur(const wxImage& image, int radius, bool horizontal)
+{
+    const int width = image.GetWidth();
+    const int height = image.GetHeight();
+
+    wxImage blurred(width, height, false);
+    if ( image.HasAlpha() )
+        blurred.SetAlpha();
+
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            int r = 0, g = 0, b = 0, a = 0;
+            for ( int k = -radius; k <= radius; k++ )
+            {
+                const int px = horizontal ? wxMin(wxMax(x + k, 0), width - 1) : x;
+                const int py = horizontal ? y : wxMin(wxMax(y + k, 0), height - 1);
+
+                r += image.GetRed(px, py);
+                g += image.GetGreen(px, py);
+                b += image.GetBlue(px, py);
+                if ( image.HasAlpha() )
+                    a += image.GetAlpha(px, py);
+            }
+
+            const int area = 2*radius + 1;
+            blurred.SetRGB(x, y, r / area, g / area, b / area);
+            if ( image.HasAlpha() )
+                blurred.SetAlpha(x, y, a / area);
+        }
+    }
+
+    return blurred;
+}
+
+static void CheckSameImage(const wxImage& image, const wxImage& expected)
+{
+    REQUIRE( image.GetSize() == expected.GetSize() );
+    CHECK( FindMaxChannelDiff(image, expected) == 0 );
+    REQUIRE( image.HasAlpha() == expected.HasAlpha() );
+    if ( expected.HasAlpha() )
+    {
+        CHECK( memcmp(image.GetAlpha(), expected.GetAlpha(),
+                      image.GetWidth()*image.GetHeight()) == 0 );
+    }
+}
+
+TEST_CASE("wxImage::Blur", "[image][blur]")
+{
+    const int width = 700;
+    const int height = 500;
+    wxImage image(width, height, false);
+    image.SetAlpha();
+    FillWithTestData(image);
+
+    const int oldThreads = wxImage::GetProcessingThreads();
+
+    SECTION("Box")
+    {
+        // Compare with the straightforward implementation, including for the
+        // radius bigger than the image size.
+        wxImage small(37, 23, false);
+        small.SetAlpha();
+        FillWithTestData(small);
+
+        const int radii[] = { 0, 1, 4, 30, 50 };
+        for ( size_t n = 0; n < WXSIZEOF(radii); n++ )
+        {
+            const int radius = radii[n];
+            INFO("Radius " << radius);
+
+            CheckSameImage(small.BlurHorizontal(radius),
+                           NaiveBoxBlur(small, radius, true));
+            CheckSameImage(small.BlurVertical(radius),
+                           NaiveBoxBlur(small, radius, false));
+            CheckSameImage(small.Blur(radius),
+                           NaiveBoxBlur(NaiveBoxBlur(small, radius, true),
+                                        radius, false));
+        }
+
+        // Also check a few pixels explicitly: the red component is equal to
+        // x in the first row and the green one to y everywhere, and the edge
+        // pixels are counted twice with radius 1, so e.g. the green value at
+        // the bottom is (21 + 22 + 22)/3.
+        const wxImage blurredSmall = small.Blur(1);
+        CHECK( small.BlurHorizontal(1).GetRed(0, 0) == 0 );
+        CHECK( small.BlurHorizontal(1).GetRed(5, 0) == 5 );
+        CHECK( blurredSmall.GetGreen(0, 0) == 0 );
+        CHECK( blurredSmall.GetGreen(3, 22) == 21 );
+
+        wxImage::SetProcessingThreads(1);
+        const wxImage blurred = image.Blur(10);
+
+        // Blurring in both directions at once is the same as doing it in
+        // each direction in turn.
+        const wxImage separate = image.BlurHorizontal(10).BlurVertical(10);
+        CHECK( FindMaxChannelDiff(blurred, separate) == 0 );
+        CHECK( memcmp(blurred.GetAlpha(), separate.GetAlpha(), width*height) == 0 );
+
+        // Check that blurring in place gives the same result and doesn't
+        // affect the original image.
+        wxImage inPlace(image);
+        inPlace.BlurInPlace(10);
+        CHECK( FindMaxChannelDiff(blurred, inPlace) == 0 );
+        CHECK( memcmp(blurred.GetAlpha(), inPlace.GetAlpha(), width*height) == 0 );
+        CHECK( image.GetRed(0, 0) == 0 );
+
+        // And that the results don't depend on the number of threads.
+        wxImage::SetProcessingThreads(4);
+        const wxImage blurredMT = image.Blur(10);
+        CHECK( FindMaxChannelDiff(blurred, blurredMT) == 0 );
+        CHECK( memcmp(blurred.GetAlpha(), blurredMT.GetAlpha(), width*height) == 0 );
+
+        // Radius bigger than the image is fine too.
+        CHECK( image.GetSubImage(wxRect(0, 0, 3, 2)).Blur(5).IsOk() );
+    }
+
+    SECTION("Gaussian")
+    {
+        wxImage::SetProcessingThreads(1);
+        const wxImage blurred = image.GaussianBlur(7.5);
+
+        wxImage::SetProcessingThreads(4);
+        const wxImage blurredMT = image.GaussianBlur(7.5);
+        CHECK( FindMaxChannelDiff(blurred, blurredMT) == 0 );
+        CHECK( memcmp(blurred.GetAlpha(), blurredMT.GetAlpha(), width*height) == 0 );
+
+        // Blurring a uniform image must not change it.
+        wxImage uniform(30, 20, false);
+        uniform.SetRGB(wxRect(0, 0, 30, 20), 10, 200, 255);
+        const wxImage uniformBlurred = uniform.GaussianBlur(4);
+        CHECK( FindMaxChannelDiff(uniform, uniformBlurred) == 0 );
+
+        // Blurring a single pixel must spread it symmetrically around it,
+        // with the values decreasing from the centre, and preserve the total
+        // up to the rounding errors.
+        wxImage impulse(31, 31);
+        impulse.SetAlpha();
+        memset(impulse.GetAlpha(), 0, 31*31);
+        impulse.SetRGB(15, 15, 255, 255, 255);
+        impulse.SetAlpha(15, 15, 255);
+
+        const wxImage spread = impulse.GaussianBlur(1.5);
+        CHECK( FindMaxChannelDiff(spread, spread.Mirror(true)) == 0 );
+        CHECK( FindMaxChannelDiff(spread, spread.Mirror(false)) == 0 );
+
+        int total = 0;
+        for ( int y = 0; y < 31; y++ )
+        {
+            for ( int x = 0; x < 31; x++ )
+            {
+                total += spread.GetRed(x, y);
+
+                CHECK( spread.GetAlpha(x, y) == spread.GetRed(x, y) );
+                if ( x < 15 )
+                    CHECK( spread.GetRed(x, y) <= spread.GetRed(x + 1, y) );
+                if ( y < 15 )
+                    CHECK( spread.GetRed(x, y) <= spread.GetRed(x, y + 1) );
+            }
+        }
+
+        CHECK( spread.GetRed(15, 15) < 255 );
+        CHECK( spread.GetRed(12, 15) > 0 );
+        CHECK( std::abs(total - 255) <= 10 );
+    }
+
+    wxImage::SetProcessingThreads(oldThreads);
+}
+
+TEST_CASE("wxImage::LoadJPEGScaled", "[image][jpeg]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    wxImage full;
+    REQUIRE( full.LoadFile("horse.jpg", wxBITMAP_TYPE_JPEG) );
+    CHECK( !full.HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) );
+
+    // The image is 200*200, so it can be decoded at 1/4 of its size.
+    wxImage scaled;
+    scaled.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 60);
+    scaled.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 80);
+    REQUIRE( scaled.LoadFile("horse.jpg", wxBITMAP_TYPE_JPEG) );
+    CHECK( scaled.GetSize() == wxSize(50, 50) );
+    CHECK( scaled.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 200 );
+    CHECK( scaled.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == 200 );
+
+    // Fast decoding results are not exactly the same but must be close.
+    wxImage fast;
+    fast.SetOption(wxIMAGE_OPTION_JPEG_FAST_DECODE, 1);
+    REQUIRE( fast.LoadFile("horse.jpg", wxBITMAP_TYPE_JPEG) );
+    CHECK( fast.GetSize() == full.GetSize() );
+    CHECK( FindMaxChannelDiff(full, fast) <= 16 );
+}
+
+#if wxUSE_LIBTIFF
+
+// Cancels reading after the given number of rows.
+class TIFFCancellingNotifier : public wxTIFFReadNotifier
+{
+public:
+    explicit TIFFCancellingNotifier(int rowsMax)
+        : m_rowsMax(rowsMax)
+    {
+        m_rowsRead = 0;
+        m_calls = 0;
+    }
+
+    virtual bool OnProgress(int rowsRead, int WXUNUSED(rowsTotal)) wxOVERRIDE
+    {
+        m_rowsRead = rowsRead;
+        m_calls++;
+
+        return rowsRead < m_rowsMax;
+    }
+
+    const int m_rowsMax;
+    int m_rowsRead;
+    int m_calls;
+};
+
+// Check that reading parts of the image gives the same results as reading all
+// of it.
+static void CheckTIFFReaderRects(wxTIFFReader& reader, const wxImage& full)
+{
+    // Read the rectangles in an order requiring going back in the file too.
+    const wxRect rects[] =
+    {
+        wxRect(50, 60, 70, 80),
+        wxRect(0, 0, 1, 1),
+        wxRect(0, 150, full.GetWidth(), 3),
+        wxRect(full.GetWidth() - 5, 0, 5, full.GetHeight()),
+        wxRect(130, 100, 20, 10),
+    };
+
+    wxImage image;
+    for ( size_t n = 0; n < WXSIZEOF(rects); n++ )
+    {
+        const wxRect& rect = rects[n];
+        INFO("Rectangle " << rect.x << "," << rect.y << " "
+                << rect.width << "x" << rect.height);
+
+        // Use a notifier which doesn't cancel reading, as it's never called
+        // with more rows than there are in the rectangle.
+        TIFFCancellingNotifier notifier(rect.height + 1);
+        REQUIRE( reader.Read(&image, rect, &notifier) );
+        CHECK( notifier.m_rowsRead == rect.height );
+        CHECK( notifier.m_calls > 0 );
+
+        const wxImage expected = full.GetSubImage(rect);
+        CHECK( image.GetSize() == rect.GetSize() );
+        CHECK( image.HasAlpha() == expected.HasAlpha() );
+        CHECK( FindMaxChannelDiff(image, expected) == 0 );
+        if ( expected.HasAlpha() )
+        {
+            CHECK( memcmp(image.GetAlpha(), expected.GetAlpha(),
+                          rect.width*rect.height) == 0 );
+        }
+    }
+}
+
+static void CheckTIFFReader(const wxImage& source)
+{
+    wxMemoryOutputStream memOut;
+    REQUIRE( source.SaveFile(memOut, wxBITMAP_TYPE_TIFF) );
+
+    wxMemoryInputStream memIn(memOut);
+    const wxImage full(memIn, wxBITMAP_TYPE_TIFF);
+    REQUIRE( full.IsOk() );
+    CHECK( full.HasAlpha() == source.HasAlpha() );
+
+    wxMemoryInputStream memInReader(memOut);
+    wxTIFFReader reader;
+    REQUIRE( reader.Open(memInReader) );
+    CHECK( reader.GetImageCount() == 1 );
+    CHECK( reader.GetSize() == full.GetSize() );
+    CHECK( !reader.IsReducedImage() );
+    CHECK( reader.FindImage(wxSize(10, 10)) == 0 );
+    CHECK( reader.FindImage(full.GetSize() + wxSize(1, 0)) == wxNOT_FOUND );
+
+    wxImage image;
+    REQUIRE( reader.Read(&image) );
+    CHECK( FindMaxChannelDiff(image, full) == 0 );
+
+    CheckTIFFReaderRects(reader, full);
+
+    // Reading can be cancelled.
+    TIFFCancellingNotifier notifier(1);
+    CHECK( !reader.Read(&image, wxRect(), &notifier) );
+    CHECK( notifier.m_calls == 1 );
+    CHECK( !image.IsOk() );
+
+    // And the reader remains usable after it.
+    REQUIRE( reader.Read(&image, wxRect(10, 20, 30, 40)) );
+    CHECK( FindMaxChannelDiff(image, full.GetSubImage(wxRect(10, 20, 30, 40))) == 0 );
+}
+
+// Check reading the file containing the same pixels as the given image, but
+// stored differently.
+static void CheckTIFFReaderFile(const wxString& file, const wxImage& source)
+{
+    const wxImage full(file, wxBITMAP_TYPE_TIFF);
+    REQUIRE( full.IsOk() );
+    CHECK( FindMaxChannelDiff(full, source) == 0 );
+
+    wxFileInputStream stream(file);
+    REQUIRE( stream.IsOk() );
+
+    wxTIFFReader reader;
+    REQUIRE( reader.Open(stream) );
+    CHECK( reader.GetSize() == full.GetSize() );
+
+    CheckTIFFReaderRects(reader, full);
+}
+
+TEST_CASE("wxImage::TIFFReader", "[image][tiff]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_TIFF) )
+        wxImage::AddHandler(new wxTIFFHandler);
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+
+    wxImage image("horse.png");
+    REQUIRE( image.IsOk() );
+
+    SECTION("RGB")
+    {
+        CheckTIFFReader(image);
+    }
+
+    SECTION("RGBA")
+    {
+        SetAlpha(&image);
+        CheckTIFFReader(image);
+    }
+
+    SECTION("Grey with alpha")
+    {
+        // Use compression to check that reading the rows of the strips out
+        // of order works too.
+        SetAlpha(&image);
+        image.SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, 2);
+        image.SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, 5 /* LZW */);
+        CheckTIFFReader(image);
+    }
+
+    // The files below contain the same image as horse.png.
+    SECTION("Tiled")
+    {
+        CheckTIFFReaderFile("image/horse_tiled.tif", image);
+    }
+
+    SECTION("Bottom left orientation")
+    {
+        CheckTIFFReaderFile("image/horse_botleft.tif", image);
+    }
+
+    SECTION("Tiled with top right orientation")
+    {
+        CheckTIFFReaderFile("image/horse_topright.tif", image);
+    }
+}
+
+#endif // wxUSE_LIBTIFF
+
+#if wxUSE_GIF && wxUSE_PALETTE
+
+TEST_CASE("wxGIFDecoder::DecodeOnDemand", "[image][gif]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_GIF) )
+        wxImage::AddHandler(new wxGIFHandler);
+
+    wxImage image("horse.gif");
+    REQUIRE( image.IsOk() );
+
+    // Use more frames than are kept decoded when decoding on demand.
+    wxImageArray images;
+    images.Add(image);
+    for ( int i = 1; i < 10; ++i )
+    {
+        images.Add(i % 3 ? images[i - 1].Rotate90() : images[i - 1].Mirror());
+        images[i].SetPalette(images[0].GetPalette());
+    }
+
+    wxMemoryOutputStream memOut;
+    REQUIRE( wxGIFHandler().SaveAnimation(images, &memOut) );
+
+    wxMemoryInputStream memInAll(memOut);
+    wxGIFDecoder decoderAll;
+    REQUIRE( decoderAll.LoadGIF(memInAll) == wxGIF_OK );
+
+    wxMemoryInputStream memIn(memOut);
+    wxGIFDecoder decoder;
+    decoder.SetDecodeOnDemand();
+    REQUIRE( decoder.LoadGIF(memIn) == wxGIF_OK );
+    REQUIRE( decoder.GetFrameCount() == images.size() );
+
+    // Access the frames out of order to check that they're decoded again
+    // after being dropped from the cache.
+    const unsigned int frames[] = { 0, 5, 1, 9, 2, 3, 4, 0, 6, 7, 8, 5, 9, 9 };
+    for ( size_t n = 0; n < WXSIZEOF(frames); n++ )
+    {
+        const unsigned int frame = frames[n];
+        INFO("Frame " << frame);
+
+        wxImage expected, actual;
+        REQUIRE( decoderAll.ConvertToImage(frame, &expected) );
+        REQUIRE( decoder.ConvertToImage(frame, &actual) );
+        CHECK_THAT( actual, RGBSameAs(expected) );
+        CHECK_THAT( actual, RGBSameAs(images[frame]) );
+    }
+}
+
+#endif // wxUSE_GIF && wxUSE_PALETTE
+
+TEST_CASE("wxImage::PNGAlpha", "[image][png]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+
+    const int width = 50;
+    const int height = 20;
+    wxImage image(width, height, false);
+    image.SetAlpha();
+
+    unsigned char* data = image.GetData();
+    for ( int n = 0; n < width*height*3; n++ )
+        *data++ = static_cast<unsigned char>(n);
+    memset(image.GetAlpha(), wxIMAGE_ALPHA_OPAQUE, width*height);
+
+    // An image with the alpha channel containing only opaque pixels is loaded
+    // without alpha.
+    wxMemoryOutputStream mos;
+    REQUIRE( image.SaveFile(mos, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis(mos);
+    wxImage opaque;
+    REQUIRE( opaque.LoadFile(mis, wxBITMAP_TYPE_PNG) );
+    CHECK( !opaque.HasAlpha() );
+    CHECK( FindMaxChannelDiff(image, opaque) == 0 );
+
+    // But the alpha channel must be created, with the correct values for the
+    // opaque pixels preceding it, as soon as a transparent pixel is found.
+    image.SetAlpha(17, 11, 100);
+    image.SetAlpha(0, 12, 200);
+
+    wxMemoryOutputStream mos2;
+    REQUIRE( image.SaveFile(mos2, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis2(mos2);
+    wxImage transparent;
+    REQUIRE( transparent.LoadFile(mis2, wxBITMAP_TYPE_PNG) );
+    REQUIRE( transparent.HasAlpha() );
+    CHECK( FindMaxChannelDiff(image, transparent) == 0 );
+    CHECK( memcmp(image.GetAlpha(), transparent.GetAlpha(), width*height) == 0 );
+
+    // Saving with the fast compression options must work as well.
+    image.SetOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL, 0);
+
+    wxMemoryOutputStream mos3;
+    REQUIRE( image.SaveFile(mos3, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis3(mos3);
+    wxImage uncompressed;
+    REQUIRE( uncompressed.LoadFile(mis3, wxBITMAP_TYPE_PNG) );
+    CHECK( FindMaxChannelDiff(image, uncompressed) == 0 );
+    CHECK( memcmp(image.GetAlpha(), uncompressed.GetAlpha(), width*height) == 0 );
+}
+
+TEST_CASE("wxImage::RGBA", "[image][alpha]")
+{
+    wxImage image(3, 2, false);
+    image.SetRGB(0, 0, 10, 20, 30);
+    image.SetRGB(1, 0, 255, 128, 0);
+    image.SetRGB(2, 0, 1, 2, 3);
+    image.SetRGB(0, 1, 200, 100, 50);
+    image.SetRGB(1, 1, 0, 0, 0);
+    image.SetRGB(2, 1, 255, 255, 255);
+
+    // Without alpha, all pixels are opaque.
+    unsigned char rgba[2*16];
+    REQUIRE( image.GetRGBA(rgba) );
+    CHECK( rgba[0] == 10 );
+    CHECK( rgba[1] == 20 );
+    CHECK( rgba[2] == 30 );
+    CHECK( rgba[3] == wxIMAGE_ALPHA_OPAQUE );
+    CHECK( rgba[23] == wxIMAGE_ALPHA_OPAQUE );
+
+    image.SetAlpha();
+    image.SetAlpha(0, 0, wxIMAGE_ALPHA_OPAQUE);
+    image.SetAlpha(1, 0, 128);
+    image.SetAlpha(2, 0, wxIMAGE_ALPHA_TRANSPARENT);
+    image.SetAlpha(0, 1, 51);
+    image.SetAlpha(1, 1, 1);
+    image.SetAlpha(2, 1, 254);
+
+    SECTION("Straight")
+    {
+        // Use a stride bigger than the row size.
+        REQUIRE( image.GetRGBA(rgba, wxIMAGE_FORMAT_RGBA, 16) );
+        CHECK( rgba[4] == 255 );
+        CHECK( rgba[5] == 128 );
+        CHECK( rgba[7] == 128 );
+        CHECK( rgba[16] == 200 );
+        CHECK( rgba[19] == 51 );
+
+        wxImage copy(3, 2, false);
+        REQUIRE( copy.SetRGBA(rgba, wxIMAGE_FORMAT_RGBA, 16) );
+        REQUIRE( copy.HasAlpha() );
+        CHECK( FindMaxChannelDiff(image, copy) == 0 );
+        CHECK( memcmp(image.GetAlpha(), copy.GetAlpha(), 6) == 0 );
+    }
+
+    SECTION("Premultiplied")
+    {
+        REQUIRE( image.GetRGBA(rgba, wxIMAGE_FORMAT_RGBA_PREMULTIPLIED) );
+        CHECK( rgba[0] == 10 );
+        CHECK( rgba[4] == 128 );
+        CHECK( rgba[5] == 64 );
+        CHECK( rgba[8] == 0 );
+        CHECK( rgba[12] == 40 );
+        CHECK( rgba[13] == 20 );
+        CHECK( rgba[14] == 10 );
+
+        wxImage copy(3, 2, false);
+        REQUIRE( copy.SetRGBA(rgba, wxIMAGE_FORMAT_RGBA_PREMULTIPLIED) );
+        CHECK( memcmp(image.GetAlpha(), copy.GetAlpha(), 6) == 0 );
+        CHECK( copy.GetRed(0, 0) == 10 );
+        CHECK( copy.GetRed(1, 0) == 255 );
+        CHECK( copy.GetGreen(1, 0) == 128 );
+        CHECK( copy.GetRed(2, 0) == 0 );
+        CHECK( copy.GetRed(0, 1) == 200 );
+        CHECK( copy.GetRed(2, 1) == 255 );
+    }
+
+    SECTION("ARGB32")
+    {
+        wxUint32 argb[6];
+        unsigned char* const buf = reinterpret_cast<unsigned char*>(argb);
+        REQUIRE( image.GetRGBA(buf, wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED) );
+        CHECK( argb[0] == 0xff0a141e );
+        CHECK( argb[1] == 0x80804000 );
+        CHECK( argb[2] == 0 );
+
+        wxImage copy(3, 2, false);
+        REQUIRE( copy.SetRGBA(buf, wxIMAGE_FORMAT_ARGB32_PREMULTIPLIED) );
+        CHECK( memcmp(image.GetAlpha(), copy.GetAlpha(), 6) == 0 );
+        CHECK( copy.GetRed(0, 0) == 10 );
+        CHECK( copy.GetGreen(1, 0) == 128 );
+        CHECK( copy.GetBlue(0, 1) == 50 );
+    }
+}
+
+TEST_CASE("wxImage::ColourOperations", "[image][colour]")
+{
+    // Use an image containing many different colours, with a mask.
+    const int width = 300;
+    const int height = 200;
+    wxImage image(width, height, false);
+    unsigned char* data = image.GetData();
+    for ( int n = 0; n < width*height; n++ )
+    {
+        *data++ = static_cast<unsigned char>(n * 7);
+        *data++ = static_cast<unsigned char>(n / 3);
+        *data++ = static_cast<unsigned char>(n * 13 + n / 5);
+    }
+    image.SetRGB(wxRect(10, 20, 30, 40), 1, 2, 3);
+    image.SetMaskColour(1, 2, 3);
+
+    // Check that the result of the operation is the same as that of the
+    // given wxColour function applied to each pixel, but for the mask.
+    #define CHECK_SAME_AS_COLOUR_FUNC(result, func)                         \
+        {                                                                   \
+            int differences = 0;                                            \
+            for ( int y = 0; y < height; y++ )                              \
+            {                                                               \
+                for ( int x = 0; x < width; x++ )                           \
+                {                                                           \
+                    unsigned char r = image.GetRed(x, y),                   \
+                                  g = image.GetGreen(x, y),                 \
+                                  b = image.GetBlue(x, y);                  \
+                    if ( r != 1 || g != 2 || b != 3 )                       \
+                        func;                                               \
+                    if ( result.GetRed(x, y) != r ||                        \
+                            result.GetGreen(x, y) != g ||                   \
+                                result.GetBlue(x, y) != b )                 \
+                        differences++;                                      \
+                }                                                           \
+            }                                                               \
+            CHECK( differences == 0 );                                      \
+        }
+
+    SECTION("Greyscale")
+    {
+        const wxImage grey = image.ConvertToGreyscale();
+        CHECK( grey.HasMask() );
+        CHECK_SAME_AS_COLOUR_FUNC(grey, wxColour::MakeGrey(&r, &g, &b,
+                                                           0.299, 0.587, 0.114));
+
+        const wxImage grey2 = image.ConvertToGreyscale(0.5, 0.25, 0.25);
+        CHECK_SAME_AS_COLOUR_FUNC(grey2, wxColour::MakeGrey(&r, &g, &b,
+                                                            0.5, 0.25, 0.25));
+    }
+
+    SECTION("Disabled")
+    {
+        const wxImage disabled = image.ConvertToDisabled(200);
+        CHECK_SAME_AS_COLOUR_FUNC(disabled, wxColour::MakeDisabled(&r, &g, &b, 200));
+    }
+
+    SECTION("Lightness")
+    {
+        const wxImage darker = image.ChangeLightness(70);
+        CHECK_SAME_AS_COLOUR_FUNC(darker, wxColour::ChangeLightness(&r, &g, &b, 70));
+
+        const wxImage lighter = image.ChangeLightness(150);
+        CHECK_SAME_AS_COLOUR_FUNC(lighter, wxColour::ChangeLightness(&r, &g, &b, 150));
+    }
+
+    #undef CHECK_SAME_AS_COLOUR_FUNC
+
+    SECTION("Mono")
+    {
+        const wxImage mono = image.ConvertToMono(1, 2, 3);
+        CHECK( mono.GetRed(10, 20) == 255 );
+        CHECK( mono.GetBlue(39, 59) == 255 );
+        CHECK( mono.GetGreen(40, 59) == 0 );
+        CHECK( mono.GetRed(9, 20) == 0 );
+        CHECK( mono.GetMaskRed() == 255 );
+    }
+
+    SECTION("Replace")
+    {
+        const wxImage orig = image.Copy();
+        image.Replace(1, 2, 3, 4, 5, 6);
+        CHECK( image.GetRed(10, 20) == 4 );
+        CHECK( image.GetGreen(39, 59) == 5 );
+        CHECK( image.GetBlue(25, 30) == 6 );
+        CHECK( image.GetRed(40, 59) == orig.GetRed(40, 59) );
+        CHECK( image.GetBlue(9, 20) == orig.GetBlue(9, 20) );
+    }
+
+    SECTION("RotateHue")
+    {
+        wxImage rotated = image.Copy();
+        rotated.RotateHue(0.3);
+
+        int maxDiff = 0;
+        for ( int y = 0; y < height; y++ )
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                const wxImage::RGBValue
+                    rgb(image.GetRed(x, y), image.GetGreen(x, y), image.GetBlue(x, y));
+                wxImage::HSVValue hsv = wxImage::RGBtoHSV(rgb);
+                hsv.hue = fmod(hsv.hue + 1.3, 1.0);
+                const wxImage::RGBValue expected = wxImage::HSVtoRGB(hsv);
+
+                maxDiff = wxMax(maxDiff, std::abs(expected.red - rotated.GetRed(x, y)));
+                maxDiff = wxMax(maxDiff, std::abs(expected.green - rotated.GetGreen(x, y)));
+                maxDiff = wxMax(maxDiff, std::abs(expected.blue - rotated.GetBlue(x, y)));
+            }
+        }
+
+        CHECK( maxDiff <= 1 );
+
+        // Rotating the hue by a full circle must not change anything.
+        rotated = image.Copy();
+        rotated.RotateHue(1.0);
+        CHECK( FindMaxChannelDiff(image, rotated) == 0 );
+    }
+}
+
+// Check that ComputeHistogram() returns the same result as the simplest
+// possible implementation.
+static void CheckHistogram(const wxImage& image)
+{
+    wxImageHistogram expected;
+    unsigned long expectedCount = 0;
+    const unsigned char* p = image.GetData();
+    for ( int n = 0; n < image.GetWidth()*image.GetHeight(); n++, p += 3 )
+    {
+        wxImageHistogramEntry&
+            entry = expected[wxImageHistogram::MakeKey(p[0], p[1], p[2])];
+        if ( entry.value++ == 0 )
+            entry.index = expectedCount++;
+    }
+
+    wxImageHistogram histogram;
+    CHECK( image.ComputeHistogram(histogram) == expectedCount );
+    REQUIRE( histogram.size() == expected.size() );
+
+    int differences = 0;
+    for ( wxImageHistogram::const_iterator it = expected.begin();
+          it != expected.end();
+          ++it )
+    {
+        wxImageHistogram::const_iterator found = histogram.find(it->first);
+        if ( found == histogram.end() ||
+                found->second.index != it->second.index ||
+                    found->second.value != it->second.value )
+            differences++;
+    }
+    CHECK( differences == 0 );
+
+    CHECK( image.CountColours() == expectedCount );
+    if ( expectedCount > 10 )
+        CHECK( image.CountColours(10) == 11 );
+}
+
+TEST_CASE("wxImage::Histogram", "[image][histogram]")
+{
+    // Use images with runs of pixels of the same colour and a part with many
+    // different colours, both small and big enough to use a dense histogram.
+    int width = 0, height = 0;
+    SECTION("Small") { width = 50; height = 40; }
+    SECTION("Big") { width = 800; height = 600; }
+
+    wxImage image(width, height);
+    image.SetRGB(wxRect(0, 0, width / 2, height), 10, 20, 30);
+    image.SetRGB(wxRect(width / 4, height / 4, width / 2, height / 2), 0, 0, 0);
+    for ( int y = height / 2; y < height; y++ )
+    {
+        for ( int x = width / 2; x < width; x++ )
+            image.SetRGB(x, y, x * 11, y * 7, (x + y) * 5);
+    }
+
+    const int oldThreads = wxImage::GetProcessingThreads();
+
+    wxImage::SetProcessingThreads(1);
+    CheckHistogram(image);
+
+    // Using several threads must not change the result.
+    wxImage::SetProcessingThreads(4);
+    CheckHistogram(image);
+
+    wxImage::SetProcessingThreads(oldThreads);
+
+    // And check an image with a single colour too.
+    CheckHistogram(wxImage(width, height));
+}
+
+// Quantize the image to the given number of colours and return the mean
+// squared error of the result.
+static double QuantizeAndCheck(const wxImage& image, int colours, int flags)
+{
+    const int width = image.GetWidth();
+    const int height = image.GetHeight();
+
+    wxImage quantized;
+    unsigned char* data8bit = NULL;
+    REQUIRE( wxQuantize::Quantize(image, quantized, NULL, colours, &data8bit,
+                                  flags |
+                                  wxQUANTIZE_FILL_DESTINATION_IMAGE |
+                                  wxQUANTIZE_RETURN_8BIT_DATA) );
+    REQUIRE( data8bit );
+
+    CHECK( quantized.CountColours() <= static_cast<unsigned long>(colours) );
+
+    // All pixels with the same index must have the same colour.
+    unsigned long indexColours[256];
+    for ( int n = 0; n < 256; n++ )
+        indexColours[n] = (unsigned long)-1;
+
+    int differences = 0;
+    double error = 0;
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            const unsigned long colour = wxImageHistogram::MakeKey
+                                         (
+                                            quantized.GetRed(x, y),
+                                            quantized.GetGreen(x, y),
+                                            quantized.GetBlue(x, y)
+                                         );
+            unsigned long& expected = indexColours[data8bit[y*width + x]];
+            if ( expected == (unsigned long)-1 )
+                expected = colour;
+            else if ( expected != colour )
+                differences++;
+
+            const int dr = image.GetRed(x, y) - quantized.GetRed(x, y);
+            const int dg = image.GetGreen(x, y) - quantized.GetGreen(x, y);
+            const int db = image.GetBlue(x, y) - quantized.GetBlue(x, y);
+            error += dr*dr + dg*dg + db*db;
+        }
+    }
+
+    delete [] data8bit;
+
+    CHECK( differences == 0 );
+
+    return error / (3*width*height);
+}
+
+TEST_CASE("wxImage::Quantize", "[image][quantize]")
+{
+    const int width = 300;
+    const int height = 200;
+    wxImage image(width, height, false);
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+            image.SetRGB(x, y, x * 255 / width, y * 255 / height, (x + y) % 256);
+    }
+
+    SECTION("Dithering")
+    {
+        const double error = QuantizeAndCheck(image, 50, 0);
+        CHECK( error < 400 );
+
+        // Refining the colours must make the result better.
+        CHECK( QuantizeAndCheck(image, 50, wxQUANTIZE_REFINE_COLOURS) < error );
+    }
+
+    SECTION("No dithering")
+    {
+        const double error = QuantizeAndCheck(image, 50, wxQUANTIZE_NO_DITHERING);
+        CHECK( error < 400 );
+
+        CHECK( QuantizeAndCheck(image, 50, wxQUANTIZE_NO_DITHERING |
+                                           wxQUANTIZE_REFINE_COLOURS) < error );
+    }
+}
+
+#if wxUSE_THREADS
+
+// Return true for the formats which are guaranteed to be thread-safe and add
+// the handler for them if necessary.
+static bool UseThreadSafeHandler(wxBitmapType type)
+{
+    wxImageHandler* handler;
+    switch ( type )
+    {
+        case wxBITMAP_TYPE_BMP:
+            handler = new wxBMPHandler;
+            break;
+
+        case wxBITMAP_TYPE_PNG:
+            handler = new wxPNGHandler;
+            break;
+
+#if wxUSE_GIF
+        case wxBITMAP_TYPE_GIF:
+            handler = new wxGIFHandler;
+            break;
+#endif // wxUSE_GIF
+
+        case wxBITMAP_TYPE_JPEG:
+            handler = new wxJPEGHandler;
+            break;
+
+#if wxUSE_LIBTIFF
+        case wxBITMAP_TYPE_TIFF:
+            handler = new wxTIFFHandler;
+            break;
+#endif // wxUSE_LIBTIFF
+
+        default:
+            return false;
+    }
+
+    if ( wxImage::FindHandler(type) )
+        delete handler;
+    else
+        wxImage::AddHandler(handler);
+
+    return true;
+}
+
+// Loads the same file and saves it back to memory repeatedly and checks that
+// the results are always the same as the expected ones.
+class ImageLoadSaveThread : public wxThread
+{
+public:
+    ImageLoadSaveThread(const char* file,
+                        wxBitmapType type,
+                        const wxImage& expectedImage,
+                        const wxMemoryOutputStream& expectedSaved)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_file(file),
+          m_type(type),
+          m_expectedImage(expectedImage),
+          m_expectedSaved(expectedSaved),
+          m_ok(false)
+    {
+    }
+
+    bool IsOk() const { return m_ok; }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_ok = true;
+        for ( int n = 0; n < 20 && m_ok; n++ )
+        {
+            wxImage image;
+            wxMemoryOutputStream mos;
+            m_ok = image.LoadFile(m_file, m_type) &&
+                   image.GetSize() == m_expectedImage.GetSize() &&
+                   FindMaxChannelDiff(image, m_expectedImage) == 0 &&
+                   image.SaveFile(mos, m_type) &&
+                   mos.GetLength() == m_expectedSaved.GetLength() &&
+                   memcmp(mos.GetOutputStreamBuffer()->GetBufferStart(),
+                          m_expectedSaved.GetOutputStreamBuffer()->GetBufferStart(),
+                          mos.GetLength()) == 0;
+        }
+
+        return 0;
+    }
+
+private:
+    const char* const m_file;
+    const wxBitmapType m_type;
+    const wxImage& m_expectedImage;
+    const wxMemoryOutputStream& m_expectedSaved;
+    bool m_ok;
+};
+
+TEST_CASE("wxImage::LoadSaveThreads", "[image][thread]")
+{
+    wxVector<wxImage> images;
+    wxVector<wxMemoryOutputStream*> saved;
+    wxVector<ImageLoadSaveThread*> threads;
+
+    for ( size_t i = 0; i < WXSIZEOF(g_testfiles); i++ )
+    {
+        if ( !UseThreadSafeHandler(g_testfiles[i].type) )
+            continue;
+
+        wxImage image;
+        REQUIRE( image.LoadFile(g_testfiles[i].file, g_testfiles[i].type) );
+        images.push_back(image);
+
+        wxMemoryOutputStream* mos = new wxMemoryOutputStream;
+        REQUIRE( image.SaveFile(*mos, g_testfiles[i].type) );
+        saved.push_back(mos);
+    }
+
+    // Run several threads for each format to check that using the same
+    // handler from several threads at once works too.
+    size_t n = 0;
+    for ( size_t i = 0; i < WXSIZEOF(g_testfiles); i++ )
+    {
+        if ( !UseThreadSafeHandler(g_testfiles[i].type) )
+            continue;
+
+        for ( int copy = 0; copy < 3; copy++ )
+        {
+            ImageLoadSaveThread* thread =
+                new ImageLoadSaveThread(g_testfiles[i].file,
+                                        g_testfiles[i].type,
+                                        images[n], *saved[n]);
+            REQUIRE( thread->Run() == wxTHREAD_NO_ERROR );
+            threads.push_back(thread);
+        }
+
+        n++;
+    }
+
+    for ( size_t i = 0; i < threads.size(); i++ )
+    {
+        threads[i]->Wait();
+        CHECK( threads[i]->IsOk() );
+        delete threads[i];
+    }
+
+    for ( size_t i = 0; i < saved.size(); i++ )
+        delete saved[i];
+}
+
+// Collects the images sent by wxImageBatchLoader.
+class ImageBatchHandler : public wxEvtHandler
+{
+public:
+    ImageBatchHandler()
+        : m_events(0)
+    {
+        Bind(wxEVT_IMAGE_BATCH_LOADED, &ImageBatchHandler::OnLoaded, this);
+    }
+
+    wxVector<wxImage> m_images;
+    int m_events;
+
+private:
+    void OnLoaded(wxImageBatchEvent& event)
+    {
+        if ( event.GetIndex() >= m_images.size() )
+            m_images.resize(event.GetIndex() + 1);
+        m_images[event.GetIndex()] = event.GetImage();
+        m_events++;
+    }
+};
+
+// Counts the errors logged while it is the active log target.
+class ErrorCountingLog : public wxLog
+{
+public:
+    ErrorCountingLog()
+        : m_errors(0)
+    {
+    }
+
+    int m_errors;
+
+protected:
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& WXUNUSED(msg),
+                             const wxLogRecordInfo& WXUNUSED(info)) wxOVERRIDE
+    {
+        if ( level == wxLOG_Error )
+            m_errors++;
+    }
+};
+
+TEST_CASE("wxImage::BatchLoader", "[image][thread]")
+{
+    wxVector<const char*> files;
+    wxVector<wxImage> expected;
+    for ( size_t i = 0; i < WXSIZEOF(g_testfiles); i++ )
+    {
+        if ( !UseThreadSafeHandler(g_testfiles[i].type) )
+            continue;
+
+        wxImage image;
+        REQUIRE( image.LoadFile(g_testfiles[i].file, g_testfiles[i].type) );
+        files.push_back(g_testfiles[i].file);
+        expected.push_back(image);
+    }
+
+    ImageBatchHandler handler;
+
+    wxImageBatchLoader loader(&handler, 3);
+    CHECK( loader.GetThreadCount() == 3 );
+
+    // Add every file twice, once by name and once as a stream.
+    for ( size_t i = 0; i < files.size(); i++ )
+    {
+        CHECK( loader.Add(files[i]) == 2*i );
+
+        wxFileInputStream* stream = new wxFileInputStream(files[i]);
+        REQUIRE( stream->IsOk() );
+        CHECK( loader.Add(stream) == 2*i + 1 );
+    }
+
+    // Loading a non-existent file fails, but doesn't prevent the other
+    // files from being loaded.
+    // Notice that wxLogNull can't be used here as it only affects the current
+    // thread, while the errors are logged by the worker ones, so collect them
+    // in our own log target instead.
+    wxImageBatchLoader loaderNoEvents(NULL, 2);
+    {
+        ErrorCountingLog log;
+        wxLog* const logOld = wxLog::SetActiveTarget(&log);
+
+        loaderNoEvents.Add("nosuchfile.png", wxBITMAP_TYPE_PNG);
+        loaderNoEvents.Add(files[0]);
+        loaderNoEvents.Wait();
+
+        // Deliver the messages buffered by the worker threads.
+        wxLog::FlushActive();
+        wxLog::SetActiveTarget(logOld);
+
+        CHECK( log.m_errors > 0 );
+    }
+    CHECK( loaderNoEvents.IsDone(0) );
+    CHECK( !loaderNoEvents.GetImage(0).IsOk() );
+    CHECK( loaderNoEvents.GetImage(1).IsOk() );
+
+    loader.Wait();
+    REQUIRE( loader.GetCount() == 2*files.size() );
+    for ( size_t i = 0; i < loader.GetCount(); i++ )
+    {
+        INFO("Image " << i);
+        CHECK( loader.IsDone(i) );
+
+        const wxImage image = loader.GetImage(i);
+        REQUIRE( image.IsOk() );
+        CHECK( FindMaxChannelDiff(image, expected[i / 2]) == 0 );
+    }
+
+    // The events are only processed by the main thread, one at a time.
+    CHECK( handler.m_events == 0 );
+    for ( size_t i = 0; i < loader.GetCount(); i++ )
+        handler.ProcessPendingEvents();
+    CHECK( handler.m_events == static_cast<int>(loader.GetCount()) );
+    REQUIRE( handler.m_images.size() == loader.GetCount() );
+    for ( size_t i = 0; i < handler.m_images.size(); i++ )
+    {
+        INFO("Image " << i);
+        REQUIRE( handler.m_images[i].IsOk() );
+        CHECK( FindMaxChannelDiff(handler.m_images[i], expected[i / 2]) == 0 );
+    }
+}
+
+#endif // wxUSE_THREADS
+
 #endif //wxUSE_IMAGE
 
 
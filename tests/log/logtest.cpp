@@ -98,6 +98,79 @@ private:
     wxDECLARE_NO_COPY_CLASS(TestLog);
 };
 
+#if wxUSE_THREADS
+
+// log sink counting the messages and optionally blocking when the first one
+// is logged until it's allowed to continue, used as wxLogAsync target: notice
+// that it doesn't need to be MT-safe as it's only used from its writer thread
+class BlockingTestLog : public TestLogBase
+{
+public:
+    explicit BlockingTestLog(bool blockFirst = false)
+        : m_blockFirst(blockFirst)
+    {
+        m_count = 0;
+    }
+
+    unsigned GetCount() const { return m_count; }
+
+    // wait until the first message is being logged
+    void WaitUntilBlocked() { m_blocked.Wait(); }
+
+    // allow the first message to be logged
+    void Unblock() { m_unblock.Post(); }
+
+protected:
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) wxOVERRIDE
+    {
+        if ( m_blockFirst )
+        {
+            m_blockFirst = false;
+            m_blocked.Post();
+            m_unblock.Wait();
+        }
+
+        m_count++;
+        m_logs[level] = msg;
+        m_logsInfo[level] = info;
+    }
+
+private:
+    bool m_blockFirst;
+    unsigned m_count;
+    wxSemaphore m_blocked,
+                m_unblock;
+
+    wxDECLARE_NO_COPY_CLASS(BlockingTestLog);
+};
+
+// thread logging the given number of messages
+class LoggingTestThread : public wxThread
+{
+public:
+    explicit LoggingTestThread(unsigned count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_count(count)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( unsigned n = 0; n < m_count; n++ )
+            wxLogMessage("Message %u", n);
+
+        return NULL;
+    }
+
+private:
+    const unsigned m_count;
+};
+
+#endif // wxUSE_THREADS
+
 #if WXWIN_COMPATIBILITY_2_8
 
 // log sink overriding the old DoLogXXX() functions should still work too
@@ -169,8 +242,10 @@ private:
         CPPUNIT_TEST( Functions );
         CPPUNIT_TEST( Null );
         CPPUNIT_TEST( Component );
+        CPPUNIT_TEST( ComponentHandle );
 #if wxDEBUG_LEVEL
         CPPUNIT_TEST( Trace );
+        CPPUNIT_TEST( TraceHandle );
 #endif // wxDEBUG_LEVEL
 #if WXWIN_COMPATIBILITY_2_8
         CPPUNIT_TEST( CompatLogger );
@@ -178,13 +253,20 @@ private:
 #endif // WXWIN_COMPATIBILITY_2_8
         CPPUNIT_TEST( SysError );
         CPPUNIT_TEST( NoWarnings );
+#if wxUSE_THREADS
+        CPPUNIT_TEST( Async );
+        CPPUNIT_TEST( AsyncThreads );
+        CPPUNIT_TEST( AsyncDiscard );
+#endif // wxUSE_THREADS
     CPPUNIT_TEST_SUITE_END();
 
     void Functions();
     void Null();
     void Component();
+    void ComponentHandle();
 #if wxDEBUG_LEVEL
     void Trace();
+    void TraceHandle();
 #endif // wxDEBUG_LEVEL
 #if WXWIN_COMPATIBILITY_2_8
     void CompatLogger();
@@ -192,6 +274,11 @@ private:
 #endif // WXWIN_COMPATIBILITY_2_8
     void SysError();
     void NoWarnings();
+#if wxUSE_THREADS
+    void Async();
+    void AsyncThreads();
+    void AsyncDiscard();
+#endif // wxUSE_THREADS
 
     TestLog *m_log;
     wxLog *m_logOld;
@@ -283,6 +370,42 @@ void LogTestCase::Component()
     #define wxLOG_COMPONENT "test"
 }
 
+void LogTestCase::ComponentHandle()
+{
+    wxLogComponentHandle component("test/handle/sub");
+    CPPUNIT_ASSERT_EQUAL( wxLog::GetLogLevel(), component.GetLevel() );
+    CPPUNIT_ASSERT( wxLog::IsLevelEnabled(wxLOG_Info, component) );
+
+    // the handle level must be updated when the level of the component or,
+    // as here, its parent changes
+    wxLog::SetComponentLevel("test/handle", wxLOG_Warning);
+    CPPUNIT_ASSERT_EQUAL( wxLOG_Warning, component.GetLevel() );
+    CPPUNIT_ASSERT( !wxLog::IsLevelEnabled(wxLOG_Info, component) );
+    CPPUNIT_ASSERT( wxLog::IsLevelEnabled(wxLOG_Error, component) );
+
+    // the handles created later must use the existing level too
+    wxLogComponentHandle component2("test/handle");
+    CPPUNIT_ASSERT_EQUAL( wxLOG_Warning, component2.GetLevel() );
+
+    // check that the handle can be used as the log component
+    #undef wxLOG_COMPONENT
+    #define wxLOG_COMPONENT component
+
+    wxLogInfo("Info");
+    CPPUNIT_ASSERT_EQUAL( "", m_log->GetLog(wxLOG_Info) );
+
+    wxLogError("Error");
+    CPPUNIT_ASSERT_EQUAL( "Error", m_log->GetLog(wxLOG_Error) );
+    CPPUNIT_ASSERT_EQUAL( std::string("test/handle/sub"),
+                          m_log->GetInfo(wxLOG_Error).component );
+
+    #undef wxLOG_COMPONENT
+    #define wxLOG_COMPONENT "test"
+
+    wxLog::SetComponentLevel("test/handle", wxLOG_Max);
+    CPPUNIT_ASSERT_EQUAL( wxLOG_Max, component.GetLevel() );
+}
+
 #if wxDEBUG_LEVEL
 
 namespace
@@ -322,6 +445,34 @@ void LogTestCase::Trace()
     CPPUNIT_ASSERT_EQUAL( "", m_log->GetLog(wxLOG_Trace) );
 }
 
+void LogTestCase::TraceHandle()
+{
+    wxLogTraceMaskHandle mask(TEST_MASK);
+    CPPUNIT_ASSERT( !mask.IsEnabled() );
+
+    wxLogTrace(mask, "Not shown");
+    CPPUNIT_ASSERT_EQUAL( "", m_log->GetLog(wxLOG_Trace) );
+
+    wxLog::AddTraceMask(TEST_MASK);
+    CPPUNIT_ASSERT( mask.IsEnabled() );
+
+    wxLogTrace(mask, "Shown %d", 1);
+    CPPUNIT_ASSERT_EQUAL( wxString::Format("(%s) Shown 1", TEST_MASK),
+                          m_log->GetLog(wxLOG_Trace) );
+
+    // the handles created after adding the mask must be enabled too
+    wxLogTraceMaskHandle mask2(TEST_MASK);
+    CPPUNIT_ASSERT( mask2.IsEnabled() );
+
+    wxLog::RemoveTraceMask(TEST_MASK);
+    CPPUNIT_ASSERT( !mask.IsEnabled() );
+    CPPUNIT_ASSERT( !mask2.IsEnabled() );
+    m_log->Clear();
+
+    wxLogTrace(mask, "Not shown again");
+    CPPUNIT_ASSERT_EQUAL( "", m_log->GetLog(wxLOG_Trace) );
+}
+
 #endif // wxDEBUG_LEVEL
 
 #if WXWIN_COMPATIBILITY_2_8
@@ -394,4 +545,96 @@ void LogTestCase::NoWarnings()
     CPPUNIT_ASSERT_EQUAL( "If", m_log->GetLog(wxLOG_Error) );
 }
 
+#if wxUSE_THREADS
+
+void LogTestCase::Async()
+{
+    BlockingTestLog* const log = new BlockingTestLog;
+    wxLogAsync logAsync(log);
+    CPPUNIT_ASSERT( logAsync.GetTarget() == log );
+
+    wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1( wxLog::SetActiveTarget, m_log );
+
+    wxLogMessage("Message");
+    wxLogError("Error %d", 17);
+
+    // the messages are only guaranteed to be written after flushing
+    logAsync.Flush();
+    CPPUNIT_ASSERT_EQUAL( 2, log->GetCount() );
+    CPPUNIT_ASSERT_EQUAL( "Message", log->GetLog(wxLOG_Message) );
+    CPPUNIT_ASSERT_EQUAL( "Error 17", log->GetLog(wxLOG_Error) );
+    CPPUNIT_ASSERT_EQUAL( std::string(wxLOG_COMPONENT),
+                          log->GetInfo(wxLOG_Message).component );
+    CPPUNIT_ASSERT( log->GetInfo(wxLOG_Message).threadId
+                        == wxThread::GetCurrentId() );
+
+    // the capacity is rounded up to a power of 2
+    wxLogAsync logAsync2(new BlockingTestLog, 100, wxLOG_ASYNC_DISCARD);
+    CPPUNIT_ASSERT_EQUAL( 128, logAsync2.GetCapacity() );
+    CPPUNIT_ASSERT_EQUAL( wxLOG_ASYNC_DISCARD, logAsync2.GetOverflowPolicy() );
+}
+
+void LogTestCase::AsyncThreads()
+{
+    BlockingTestLog* const log = new BlockingTestLog;
+
+    // use a small queue to check that the threads correctly wait for the free
+    // space in it when it's full
+    wxLogAsync logAsync(log, 4);
+
+    wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1( wxLog::SetActiveTarget, m_log );
+
+    static const unsigned NUM_THREADS = 4;
+    static const unsigned NUM_MESSAGES = 1000;
+
+    LoggingTestThread* threads[NUM_THREADS];
+    for ( unsigned n = 0; n < NUM_THREADS; n++ )
+    {
+        threads[n] = new LoggingTestThread(NUM_MESSAGES);
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads[n]->Run() );
+    }
+
+    for ( unsigned n = 0; n < NUM_THREADS; n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    logAsync.Flush();
+    CPPUNIT_ASSERT_EQUAL( NUM_THREADS*NUM_MESSAGES, log->GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, logAsync.GetDroppedCount() );
+}
+
+void LogTestCase::AsyncDiscard()
+{
+    BlockingTestLog* const log = new BlockingTestLog(true /* block first */);
+    wxLogAsync logAsync(log, 2, wxLOG_ASYNC_DISCARD);
+
+    wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1( wxLog::SetActiveTarget, m_log );
+
+    // wait until the writer thread blocks writing the first message
+    wxLogMessage("First");
+    log->WaitUntilBlocked();
+
+    // the next 2 messages fit into the queue, the remaining ones don't
+    for ( int n = 0; n < 5; n++ )
+        wxLogMessage("Message %d", n);
+
+    CPPUNIT_ASSERT_EQUAL( 3, logAsync.GetDroppedCount() );
+
+    log->Unblock();
+    logAsync.Flush();
+
+    CPPUNIT_ASSERT_EQUAL( "Message 1", log->GetLog(wxLOG_Message) );
+
+    // the number of dropped messages is logged once they're discarded
+    CPPUNIT_ASSERT_EQUAL( 4, log->GetCount() );
+    CPPUNIT_ASSERT( log->GetLog(wxLOG_Warning).StartsWith("3 ") );
+}
+
+#endif // wxUSE_THREADS
+
 #endif // wxUSE_LOG
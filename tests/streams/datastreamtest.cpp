@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "wx/datstrm.h"
+#include "wx/mstream.h"
 #include "wx/wfstream.h"
 #include "wx/math.h"
 
@@ -313,3 +314,84 @@ void DataStreamTestCase::NaNRW()
 }
 
 
+
+// Check that writing and reading back arrays, big enough to be processed in
+// several chunks, preserves the data and uses the expected byte order.
+static void DoTestArrays(bool bigEndian)
+{
+    const size_t count = 10000;
+
+    std::vector<wxUint16> v16(count);
+    std::vector<wxUint32> v32(count);
+    std::vector<float> vf(count);
+    std::vector<double> vd(count);
+    for ( size_t n = 0; n < count; n++ )
+    {
+        v16[n] = static_cast<wxUint16>(n * 0x0102);
+        v32[n] = static_cast<wxUint32>(n * 0x01020304);
+        vf[n] = n / 4.0f;
+        vd[n] = n / -8.0;
+    }
+
+    wxMemoryOutputStream mout;
+    {
+        wxDataOutputStream out(mout);
+        out.BigEndianOrdered(bigEndian);
+#if wxUSE_APPLE_IEEE
+        out.UseBasicPrecisions();
+#endif // wxUSE_APPLE_IEEE
+
+        out.Write16(&v16[0], count);
+        out.Write32(&v32[0], count);
+        out.WriteFloat(&vf[0], count);
+        out.WriteDouble(&vd[0], count);
+    }
+
+    wxStreamBuffer* const buf = mout.GetOutputStreamBuffer();
+    const unsigned char* const p =
+        static_cast<unsigned char*>(buf->GetBufferStart());
+    REQUIRE( buf->GetIntPosition() == count*(2 + 4 + 4 + 8) );
+
+    // check the last element as it may be the only one written separately
+    const size_t last = count - 1;
+    const wxUint16 last16 = v16[last];
+    if ( bigEndian )
+    {
+        CHECK( p[2*last] == (last16 >> 8) );
+        CHECK( p[2*last + 1] == (last16 & 0xff) );
+    }
+    else
+    {
+        CHECK( p[2*last] == (last16 & 0xff) );
+        CHECK( p[2*last + 1] == (last16 >> 8) );
+    }
+
+    wxMemoryInputStream min(mout);
+    wxDataInputStream in(min);
+    in.BigEndianOrdered(bigEndian);
+#if wxUSE_APPLE_IEEE
+    in.UseBasicPrecisions();
+#endif // wxUSE_APPLE_IEEE
+
+    std::vector<wxUint16> r16(count);
+    std::vector<wxUint32> r32(count);
+    std::vector<float> rf(count);
+    std::vector<double> rd(count);
+
+    in.Read16(&r16[0], count);
+    in.Read32(&r32[0], count);
+    in.ReadFloat(&rf[0], count);
+    in.ReadDouble(&rd[0], count);
+    CHECK( in.IsOk() );
+
+    CHECK( r16 == v16 );
+    CHECK( r32 == v32 );
+    CHECK( rf == vf );
+    CHECK( rd == vd );
+}
+
+TEST_CASE("wxDataStream::Arrays", "[stream][data]")
+{
+    SECTION("Little endian") { DoTestArrays(false); }
+    SECTION("Big endian") { DoTestArrays(true); }
+}
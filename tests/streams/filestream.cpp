@@ -19,9 +19,11 @@
     #include "wx/wx.h"
 #endif
 
+#include "wx/filename.h"
 #include "wx/wfstream.h"
 
 #include "bstream.h"
+#include "testfile.h"
 
 #define DATABUFFER_SIZE     1024
 
@@ -147,3 +149,185 @@ wxString fileStream::GetInFileName() const
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(fileStream)
+
+TEST_CASE("wxMappedFileInputStream", "[stream][file]")
+{
+    static const char data[] = "Hello, mapped file!";
+    const size_t len = strlen(data);
+
+    const wxString name = wxFileName::CreateTempFileName("mapped");
+    REQUIRE( !name.empty() );
+
+    {
+        wxFileOutputStream out(name);
+        REQUIRE( out.WriteAll(data, len) );
+    }
+
+    SECTION("Read")
+    {
+        wxMappedFileInputStream in(name);
+        REQUIRE( in.IsOk() );
+        CHECK( in.IsSeekable() );
+        CHECK( in.GetLength() == static_cast<wxFileOffset>(len) );
+
+        char buf[64];
+        CHECK( in.Read(buf, sizeof(buf)).LastRead() == len );
+        CHECK( memcmp(buf, data, len) == 0 );
+        CHECK( !in.CanRead() );
+    }
+
+    SECTION("Seek")
+    {
+        wxMappedFileInputStream in(name);
+        REQUIRE( in.IsOk() );
+
+        CHECK( in.SeekI(7) == 7 );
+        CHECK( in.TellI() == 7 );
+        CHECK( in.Peek() == 'm' );
+        CHECK( in.GetC() == 'm' );
+        CHECK( in.SeekI(-1, wxFromEnd) == static_cast<wxFileOffset>(len - 1) );
+        CHECK( in.GetC() == '!' );
+    }
+
+    SECTION("UnreadData")
+    {
+        wxMappedFileInputStream in(name);
+        REQUIRE( in.IsOk() );
+
+        size_t size;
+        const char* p = static_cast<const char*>(in.GetUnreadData(&size));
+        REQUIRE( p );
+        CHECK( size == len );
+        CHECK( memcmp(p, data, len) == 0 );
+
+        CHECK( in.GetC() == 'H' );
+        p = static_cast<const char*>(in.GetUnreadData(&size));
+        REQUIRE( p );
+        CHECK( size == len - 1 );
+        CHECK( *p == 'e' );
+
+        // the data put back isn't contiguous with the rest of it
+        CHECK( in.Ungetch('X') );
+        CHECK( !in.GetUnreadData(&size) );
+        CHECK( in.GetC() == 'X' );
+        CHECK( in.GetUnreadData(&size) );
+    }
+
+    SECTION("Empty")
+    {
+        {
+            wxFileOutputStream out(name);
+        }
+
+        wxMappedFileInputStream in(name);
+        CHECK( in.IsOk() );
+        CHECK( in.GetLength() == 0 );
+        CHECK( !in.CanRead() );
+    }
+
+    wxRemoveFile(name);
+
+    SECTION("Missing")
+    {
+        wxLogNull noLog;
+        wxMappedFileInputStream in(name);
+        CHECK( !in.IsOk() );
+    }
+}
+
+TEST_CASE("wxFileStream::ReadV-WriteV", "[stream][file]")
+{
+    char head[] = "Hello, ";
+    char empty[1];
+    char tail[] = "vectored world!";
+
+    wxStreamIOVec out[3];
+    out[0].data = head;
+    out[0].size = strlen(head);
+    out[1].data = empty;
+    out[1].size = 0;
+    out[2].data = tail;
+    out[2].size = strlen(tail);
+
+    const size_t len = out[0].size + out[2].size;
+
+    TempFile f("vectored.dat");
+
+    {
+        wxFileOutputStream fout(f.GetName());
+        CHECK( fout.WriteV(out, WXSIZEOF(out)).LastWrite() == len );
+        CHECK( fout.IsOk() );
+        CHECK( fout.TellO() == static_cast<wxFileOffset>(len) );
+    }
+
+    wxFileInputStream fin(f.GetName());
+    REQUIRE( fin.IsOk() );
+
+    char buf1[5], buf2[64];
+    wxStreamIOVec in[2];
+    in[0].data = buf1;
+    in[0].size = sizeof(buf1);
+    in[1].data = buf2;
+    in[1].size = sizeof(buf2);
+
+    SECTION("File")
+    {
+        CHECK( fin.ReadV(in, WXSIZEOF(in)).LastRead() == len );
+        CHECK( fin.GetLastError() == wxSTREAM_EOF );
+    }
+
+    SECTION("Ungetch")
+    {
+        // the data put back must be read first
+        CHECK( fin.GetC() == 'H' );
+        CHECK( fin.Ungetch('H') );
+        CHECK( fin.ReadV(in, WXSIZEOF(in)).LastRead() == len );
+        CHECK( fin.GetLastError() == wxSTREAM_EOF );
+    }
+
+    SECTION("Buffered")
+    {
+        // this uses the default implementation
+        wxBufferedInputStream bin(fin);
+        CHECK( bin.ReadV(in, WXSIZEOF(in)).LastRead() == len );
+        CHECK( bin.GetLastError() == wxSTREAM_EOF );
+    }
+
+    CHECK( memcmp(buf1, "Hello", sizeof(buf1)) == 0 );
+    CHECK( memcmp(buf2, ", vectored world!", len - sizeof(buf1)) == 0 );
+}
+
+TEST_CASE("wxBufferedStream::LargeTransfer", "[stream][file]")
+{
+    // use blocks bigger than the buffer size to exercise direct transfers
+    const size_t size = 100000;
+    wxCharBuffer data(size);
+    for ( size_t n = 0; n < size; n++ )
+        data.data()[n] = static_cast<char>(n % 251);
+
+    TempFile f("buffered.dat");
+
+    {
+        wxFileOutputStream fout(f.GetName());
+        wxBufferedOutputStream bout(fout);
+
+        bout.Write("x", 1);
+        CHECK( bout.Write(data, size).LastWrite() == size );
+        bout.Write("y", 1);
+        CHECK( bout.TellO() == static_cast<wxFileOffset>(size + 2) );
+    }
+
+    wxFileInputStream fin(f.GetName());
+    wxBufferedInputStream bin(fin);
+
+    CHECK( bin.GetC() == 'x' );
+
+    wxCharBuffer buf(size);
+    CHECK( bin.Read(buf.data(), size).LastRead() == size );
+    CHECK( memcmp(buf, data, size) == 0 );
+    CHECK( bin.TellI() == static_cast<wxFileOffset>(size + 1) );
+
+    CHECK( bin.GetC() == 'y' );
+    CHECK( bin.Read(buf.data(), size).LastRead() == 0 );
+    CHECK( bin.Eof() );
+}
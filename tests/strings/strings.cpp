@@ -20,6 +20,13 @@
     #include "wx/wx.h"
 #endif // WX_PRECOMP
 
+#include "wx/stratom.h"
+#include "wx/vector.h"
+
+#if __cplusplus >= 201103L
+    #include <type_traits>
+#endif
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -326,6 +333,20 @@ void StringTestCase::Extraction()
     TEST_ENDS_WITH( wxT("Gello, world!"),    wxT(""),              false );
 
     #undef TEST_ENDS_WITH
+
+    rest = "Hello world";
+    CPPUNIT_ASSERT( rest.EndsWith(" world", &rest) );
+    CPPUNIT_ASSERT_EQUAL("Hello", rest);
+
+#if wxUSE_UNICODE
+    const wxString strGerman = wxString::FromUTF8("\xc3\xbc" "ber alles \xc3\xa4");
+    CPPUNIT_ASSERT( strGerman.StartsWith(wxString::FromUTF8("\xc3\xbc" "ber "), &rest) );
+    CPPUNIT_ASSERT( rest == wxString::FromUTF8("alles \xc3\xa4") );
+    CPPUNIT_ASSERT( !strGerman.StartsWith(wxString::FromUTF8("\xc3\xa4")) );
+    CPPUNIT_ASSERT( strGerman.EndsWith(wxString::FromUTF8(" \xc3\xa4"), &rest) );
+    CPPUNIT_ASSERT( rest == wxString::FromUTF8("\xc3\xbc" "ber alles") );
+    CPPUNIT_ASSERT( !strGerman.EndsWith(wxString::FromUTF8("\xc3\xbc")) );
+#endif // wxUSE_UNICODE
 }
 
 void StringTestCase::Trim()
@@ -402,6 +423,56 @@ void StringTestCase::Replace()
     TEST_WXREPLACE( "life", 4, "fe", "ve", true, "live", 4 );
     TEST_WXREPLACE( "xx", 2, "x", "yy", true, "yyyy", 4 );
     TEST_WXREPLACE( "xxx", 3, "xx", "z", true, "zx", 2 );
+    TEST_WXREPLACE( "xxxx", 4, "x", "y", false, "yxxx", 4 );
+    TEST_WXREPLACE( "axbxcx", 6, "x", "y", true, "aybycy", 6 );
+    TEST_WXREPLACE( "axbxcx", 6, "z", "y", true, "axbxcx", 6 );
+    TEST_WXREPLACE( "a--b--c", 7, "--", "+", true, "a+b+c", 5 );
+    TEST_WXREPLACE( "a--b--c", 7, "--", "++", true, "a++b++c", 7 );
+    TEST_WXREPLACE( "a--b--c", 7, "--", "", true, "abc", 3 );
+    TEST_WXREPLACE( "--a--b--", 8, "--", "", true, "ab", 2 );
+    TEST_WXREPLACE( "a--b--c", 7, "--", "+", false, "a+b--c", 6 );
+    TEST_WXREPLACE( "a--b--c", 7, "--", "=+=", true, "a=+=b=+=c", 9 );
+
+    {
+        wxString s("----");
+        CPPUNIT_ASSERT_EQUAL( 2, s.Replace("--", "") );
+        CPPUNIT_ASSERT( s.empty() );
+    }
+
+    // Check that replacing in a copy of the string doesn't modify it.
+    {
+        const wxString orig("foo bar foo");
+        wxString copy(orig);
+        CPPUNIT_ASSERT_EQUAL( 2, copy.Replace("foo", "baz") );
+        CPPUNIT_ASSERT_EQUAL( "baz bar baz", copy );
+        CPPUNIT_ASSERT_EQUAL( "foo bar foo", orig );
+
+        copy = orig;
+        CPPUNIT_ASSERT_EQUAL( 2, copy.Replace("foo", "f") );
+        CPPUNIT_ASSERT_EQUAL( "f bar f", copy );
+        CPPUNIT_ASSERT_EQUAL( "foo bar foo", orig );
+
+        copy = orig;
+        CPPUNIT_ASSERT_EQUAL( 4, copy.Replace("o", "0") );
+        CPPUNIT_ASSERT_EQUAL( "f00 bar f00", copy );
+        CPPUNIT_ASSERT_EQUAL( "foo bar foo", orig );
+
+        // And that replacing the string with itself works too.
+        copy = orig;
+        CPPUNIT_ASSERT_EQUAL( 1, copy.Replace(copy, copy) );
+        CPPUNIT_ASSERT_EQUAL( orig, copy );
+    }
+
+#if wxUSE_UNICODE
+    {
+        wxString s = wxString::FromUTF8("\xc3\xa4-\xc3\xa4-\xc3\xa4");
+        CPPUNIT_ASSERT_EQUAL( 3, s.Replace(wxString::FromUTF8("\xc3\xa4"), "a") );
+        CPPUNIT_ASSERT_EQUAL( "a-a-a", s );
+
+        CPPUNIT_ASSERT_EQUAL( 2, s.Replace("-", wxString::FromUTF8("\xc3\xbc")) );
+        CPPUNIT_ASSERT( s == wxString::FromUTF8("a\xc3\xbc" "a\xc3\xbc" "a") );
+    }
+#endif // wxUSE_UNICODE
 
     #undef TEST_WXREPLACE
     #undef TEST_NULLCHARREPLACE
@@ -566,6 +637,22 @@ void StringTestCase::CompareNoCase()
     CPPUNIT_ASSERT( wxString("\n").CmpNoCase(" ") < 0 );
     CPPUNIT_ASSERT( wxString("'").CmpNoCase("!") > 0);
     CPPUNIT_ASSERT( wxString("!").Cmp("Z") < 0 );
+
+    // Check that long common prefixes, which are skipped in a special way,
+    // are handled correctly.
+    const wxString prefix(wxString(wxT("0123456789abcdef")) + wxT("ghijklmnopqrstuvwxyz"));
+    wxString prefixNul(prefix);
+    prefixNul.insert(20, 1, '\0');
+
+    CPPUNIT_CNCEQ_ASSERT( prefix, prefix.Upper() );
+    CPPUNIT_CNCEQ_ASSERT( prefixNul, prefixNul.Upper() );
+    CPPUNIT_CNCNEQ_ASSERT( prefix, prefixNul );
+
+    CPPUNIT_ASSERT( (prefix + "a").CmpNoCase(prefix + "B") < 0 );
+    CPPUNIT_ASSERT( (prefix + "b").CmpNoCase(prefix + "A") > 0 );
+    CPPUNIT_ASSERT( prefix.CmpNoCase(prefix + "a") < 0 );
+    CPPUNIT_ASSERT( (prefix + prefix).CmpNoCase(prefix) > 0 );
+    CPPUNIT_ASSERT( (prefix + "x" + prefix).CmpNoCase(prefix + "X" + prefix) == 0 );
 }
 
 void StringTestCase::Contains()
@@ -1316,3 +1403,116 @@ void StringTestCase::SupplementaryUniChar()
     */
 #endif
 }
+
+TEST_CASE("wxStringAtom", "[string][atom]")
+{
+    const wxStringAtom empty;
+    CHECK( empty.IsEmpty() );
+    CHECK( empty.GetString() == "" );
+    CHECK( empty == wxStringAtom("") );
+    CHECK( empty == wxStringAtom::FromUTF8("") );
+
+    const size_t poolSize = wxStringAtom::GetPoolSize();
+    {
+        const wxStringAtom foo("foo");
+        CHECK( !foo.IsEmpty() );
+        CHECK( foo.GetString() == "foo" );
+        CHECK( foo == wxStringAtom(L"foo") );
+        CHECK( foo == wxStringAtom(wxString("foo")) );
+        CHECK( foo == wxStringAtom::FromUTF8("foobar", 3) );
+        CHECK( foo.GetHash() == wxStringAtom::FromUTF8("foo").GetHash() );
+        CHECK( foo != wxStringAtom("Foo") );
+        CHECK( foo != wxStringAtom("fo") );
+        CHECK( foo != empty );
+
+        wxStringAtom copy(foo);
+        CHECK( copy == foo );
+        copy = empty;
+        CHECK( copy.IsEmpty() );
+        CHECK( foo.GetString() == "foo" );
+
+        const wxString& s = foo;
+        CHECK( s == "foo" );
+
+        const wxStringAtom
+            nonASCII = wxStringAtom::FromUTF8("\xc3\xa9t\xc3\xa9");
+        CHECK( nonASCII.GetString() == wxString::FromUTF8("\xc3\xa9t\xc3\xa9") );
+        CHECK( nonASCII == wxStringAtom(wxString::FromUTF8("\xc3\xa9t\xc3\xa9")) );
+
+        CHECK( wxStringAtom::GetPoolSize() == poolSize + 2 );
+    }
+
+    // The strings are removed from the pool when they're not used any more.
+    CHECK( wxStringAtom::GetPoolSize() == poolSize );
+
+    // Check that the pool still works after growing.
+    wxVector<wxStringAtom> atoms;
+    for ( int n = 0; n < 10000; n++ )
+        atoms.push_back(wxStringAtom(wxString::Format("atom%d", n)));
+
+    CHECK( wxStringAtom::GetPoolSize() == poolSize + 10000 );
+
+    for ( int n = 0; n < 10000; n += 1000 )
+    {
+        const wxStringAtom atom = wxStringAtom::FromUTF8(wxString::Format("atom%d", n).utf8_str());
+        CHECK( atom == atoms[n] );
+    }
+
+    atoms.clear();
+    CHECK( wxStringAtom::GetPoolSize() == poolSize );
+}
+
+TEST_CASE("wxString::Move", "[string]")
+{
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)
+    wxString s1("Hello, world");
+    wxString s2(std::move(s1));
+    CHECK( s2 == "Hello, world" );
+
+    // The moved from string must still be usable.
+    s1 = "Hi";
+    CHECK( s1 == "Hi" );
+
+    s1 = std::move(s2);
+    CHECK( s1 == "Hello, world" );
+
+#if __cplusplus >= 201103L
+    // This allows the standard containers to move the strings instead of
+    // copying them when reallocating.
+    CHECK( std::is_nothrow_move_constructible<wxString>::value );
+    CHECK( std::is_nothrow_move_assignable<wxString>::value );
+#endif
+
+#if wxUSE_UNICODE_WCHAR
+    // The conversion buffer is preserved when moving.
+    const char* const p = s1.utf8_str();
+    CHECK( wxString(std::move(s1)).utf8_str().data() == p );
+#endif // wxUSE_UNICODE_WCHAR
+#endif // C++11
+}
+
+TEST_CASE("wxString::ConversionBuffers", "[string]")
+{
+    wxString s("Hello, world");
+    CHECK( strcmp(s.utf8_str(), "Hello, world") == 0 );
+
+    const wxString nonASCII = wxString::FromUTF8("\xc3\xa9t\xc3\xa9");
+    CHECK( strcmp(nonASCII.utf8_str(), "\xc3\xa9t\xc3\xa9") == 0 );
+
+#if wxUSE_UNICODE_WCHAR
+    // The same buffer is reused if the string doesn't become longer.
+    const char* const p = s.utf8_str();
+    s = "Hello";
+    CHECK( s.utf8_str().data() == p );
+    CHECK( strcmp(s.utf8_str(), "Hello") == 0 );
+
+    s = nonASCII;
+    CHECK( strcmp(s.utf8_str(), "\xc3\xa9t\xc3\xa9") == 0 );
+
+    // Embedded NULs are preserved by the conversion.
+    s = wxString("a\0b", 3);
+    const wxScopedCharBuffer buf = s.utf8_str();
+    CHECK( buf.length() == 3 );
+    CHECK( memcmp(buf.data(), "a\0b", 4) == 0 );
+#endif // wxUSE_UNICODE_WCHAR
+}
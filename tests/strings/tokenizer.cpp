@@ -37,6 +37,8 @@ private:
         CPPUNIT_TEST( GetPosition );
         CPPUNIT_TEST( GetString );
         CPPUNIT_TEST( LastDelimiter );
+        CPPUNIT_TEST( GetRange );
+        CPPUNIT_TEST( NonAsciiDelims );
         CPPUNIT_TEST( StrtokCompat );
         CPPUNIT_TEST( CopyObj );
         CPPUNIT_TEST( AssignObj );
@@ -46,6 +48,8 @@ private:
     void GetPosition();
     void GetString();
     void LastDelimiter();
+    void GetRange();
+    void NonAsciiDelims();
     void StrtokCompat();
     void CopyObj();
     void AssignObj();
@@ -246,6 +250,55 @@ void TokenizerTestCase::LastDelimiter()
     CPPUNIT_ASSERT_EQUAL( wxT('\0'), tkz.GetLastDelimiter() );
 }
 
+void TokenizerTestCase::GetRange()
+{
+    // Check that GetNextTokenRange() returns the same tokens as
+    // GetNextToken() in all modes.
+    for ( size_t n = 0; n < WXSIZEOF(gs_testData); n++ )
+    {
+        const TokenizerTestData& ttd = gs_testData[n];
+
+        wxStringTokenizer tkz(ttd.str, ttd.delims, ttd.mode);
+        wxStringTokenizer tkzRange(ttd.str, ttd.delims, ttd.mode);
+
+        wxString::const_iterator start, end;
+        while ( tkz.HasMoreTokens() )
+        {
+            const wxString token = tkz.GetNextToken();
+
+            CPPUNIT_ASSERT_MESSAGE( Nth(n), tkzRange.GetNextTokenRange(&start, &end) );
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( Nth(n), token, wxString(start, end) );
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( Nth(n), tkz.GetPosition(), tkzRange.GetPosition() );
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( Nth(n), tkz.GetLastDelimiter(), tkzRange.GetLastDelimiter() );
+        }
+
+        CPPUNIT_ASSERT_MESSAGE( Nth(n), !tkzRange.GetNextTokenRange(&start, &end) );
+    }
+
+    wxStringTokenizer tkz(wxT("foo:bar"), wxT(":"));
+    wxString::const_iterator start, end;
+    CPPUNIT_ASSERT( tkz.GetNextTokenRange(&start, &end) );
+    CPPUNIT_ASSERT( start == tkz.GetInputString().begin() );
+    CPPUNIT_ASSERT_EQUAL( 3, end - start );
+}
+
+void TokenizerTestCase::NonAsciiDelims()
+{
+#if wxUSE_UNICODE
+    const wxString delims = wxString::FromUTF8("\xc2\xa7;");
+    const wxString s = wxString::FromUTF8("a\xc2\xa7" "b;\xc3\xa4\xc2\xa7");
+
+    wxStringTokenizer tkz(s, delims, wxTOKEN_RET_EMPTY_ALL);
+    CPPUNIT_ASSERT_EQUAL( 4, tkz.CountTokens() );
+    CPPUNIT_ASSERT_EQUAL( "a", tkz.GetNextToken() );
+    CPPUNIT_ASSERT( tkz.GetLastDelimiter() == wxUniChar(0xa7) );
+    CPPUNIT_ASSERT_EQUAL( "b", tkz.GetNextToken() );
+    CPPUNIT_ASSERT( tkz.GetNextToken() == wxString::FromUTF8("\xc3\xa4") );
+    CPPUNIT_ASSERT_EQUAL( "", tkz.GetNextToken() );
+    CPPUNIT_ASSERT( !tkz.HasMoreTokens() );
+#endif // wxUSE_UNICODE
+}
+
 void TokenizerTestCase::StrtokCompat()
 {
     for ( size_t n = 0; n < WXSIZEOF(gs_testData); n++ )
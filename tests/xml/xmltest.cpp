@@ -613,3 +613,191 @@ void XmlTestCase::Doctype()
     dt = wxXmlDoctype( "root", "O'Reilly (\"editor\")", "Public-ID" );
     CPPUNIT_ASSERT( !dt.IsValid() );
 }
+
+// ----------------------------------------------------------------------------
+// wxXmlStreamParser tests
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// records all the notifications in a string
+class TestStreamParser : public wxXmlStreamParser
+{
+public:
+    TestStreamParser() { }
+
+    wxString m_log;
+    wxString m_build;   // name of the elements to build
+    wxString m_skip;    // name of the elements to skip
+    wxString m_stop;    // name of the element to stop at
+
+protected:
+    virtual wxXmlStreamAction
+    OnStartElement(const wxString& name, const wxXmlAttribute *attrs) wxOVERRIDE
+    {
+        m_log << "<" << name << ":" << GetDepth();
+        for ( ; attrs; attrs = attrs->GetNext() )
+            m_log << " " << attrs->GetName() << "=" << attrs->GetValue();
+        m_log << ">";
+
+        if ( name == m_stop )
+            Stop();
+
+        if ( name == m_build )
+            return wxXML_STREAM_BUILD_NODE;
+
+        if ( name == m_skip )
+            return wxXML_STREAM_SKIP;
+
+        return wxXML_STREAM_CONTINUE;
+    }
+
+    virtual void OnEndElement(const wxString& name) wxOVERRIDE
+    {
+        m_log << "</" << name << ":" << GetDepth() << ">";
+    }
+
+    virtual void OnElementNode(wxXmlNode *node) wxOVERRIDE
+    {
+        wxXmlDocument doc;
+        doc.SetRoot(node);
+
+        wxStringOutputStream sos;
+        doc.Save(sos, wxXML_NO_INDENTATION);
+
+        // skip the XML declaration
+        m_log << "[" << sos.GetString().AfterFirst('\n') << "]";
+    }
+
+    virtual void OnText(const wxString& text) wxOVERRIDE
+    {
+        m_log << "'" << text << "'";
+    }
+
+    virtual void OnCData(const wxString& text) wxOVERRIDE
+    {
+        m_log << "{" << text << "}";
+    }
+
+    virtual void OnComment(const wxString& text) wxOVERRIDE
+    {
+        m_log << "#" << text << "#";
+    }
+
+    virtual void OnProcessingInstruction(const wxString& target,
+                                         const wxString& data) wxOVERRIDE
+    {
+        m_log << "?" << target << " " << data << "?";
+    }
+};
+
+bool ParseString(wxXmlStreamParser& parser, const char *xml, int flags = 0)
+{
+    wxStringInputStream sis(wxString::FromUTF8(xml));
+    return parser.Parse(sis, "UTF-8", flags);
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxXmlStreamParser", "[xml]")
+{
+    const char *xml =
+        "<?xml version='1.0' encoding='UTF-8'?>\n"
+        "<root a='1' b='2'>\n"
+        "  <item id='x'>text &amp; more</item>\n"
+        "  <!--comment-->\n"
+        "  <?pi data?>\n"
+        "  <skip><deep>ignored</deep></skip>\n"
+        "  <build n='3'>inner<sub/><![CDATA[<cdata>]]></build>\n"
+        "  <last/>\n"
+        "</root>\n";
+
+    TestStreamParser parser;
+
+    SECTION("Stream")
+    {
+        REQUIRE( ParseString(parser, xml) );
+        CHECK( parser.m_log ==
+               "<root:0 a=1 b=2>"
+               "<item:1 id=x>'text & more'</item:1>"
+               "#comment#"
+               "?pi data?"
+               "<skip:1><deep:2>'ignored'</deep:2></skip:1>"
+               "<build:1 n=3>'inner'<sub:2></sub:2>{<cdata>}</build:1>"
+               "<last:1></last:1>"
+               "</root:0>" );
+        CHECK( parser.GetVersion() == "1.0" );
+        CHECK( parser.GetFileEncoding() == "UTF-8" );
+    }
+
+    SECTION("Whitespace")
+    {
+        REQUIRE( ParseString(parser, "<root> <a/> </root>",
+                             wxXMLDOC_KEEP_WHITESPACE_NODES) );
+        CHECK( parser.m_log == "<root:0>' '<a:1></a:1>' '</root:0>" );
+    }
+
+    SECTION("Skip")
+    {
+        parser.m_skip = "skip";
+        REQUIRE( ParseString(parser, xml) );
+        CHECK( parser.m_log.Contains("<skip:1><build:1") );
+        CHECK( !parser.m_log.Contains("deep") );
+    }
+
+    SECTION("Build")
+    {
+        parser.m_build = "build";
+        REQUIRE( ParseString(parser, xml) );
+        CHECK( parser.m_log.Contains(
+               "<build:1 n=3>"
+               "[<build n=\"3\">inner<sub/><![CDATA[<cdata>]]></build>\n]"
+               "<last:1>") );
+        CHECK( parser.m_log.EndsWith("</root:0>") );
+    }
+
+    SECTION("Stop")
+    {
+        parser.m_stop = "skip";
+        REQUIRE( ParseString(parser, xml) );
+        CHECK( parser.m_log.EndsWith("<skip:1>") );
+    }
+
+    SECTION("Error")
+    {
+        wxLogNull noLog;
+        CHECK( !ParseString(parser, "<root><unclosed></root>") );
+    }
+}
+
+TEST_CASE("wxXmlNode::NameAtom", "[xml]")
+{
+    const char *xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<root><item id=\"1\"/><item id=\"2\"/></root>\n";
+
+    wxStringInputStream sis(xml);
+    wxXmlDocument doc;
+    REQUIRE( doc.Load(sis) );
+
+    const wxXmlNode* const first = doc.GetRoot()->GetChildren();
+    REQUIRE( first );
+    const wxXmlNode* const second = first->GetNext();
+    REQUIRE( second );
+
+    CHECK( first->GetName() == "item" );
+    CHECK( first->GetNameAtom() == second->GetNameAtom() );
+    CHECK( first->GetNameAtom() == wxStringAtom("item") );
+    CHECK( first->GetNameAtom() != doc.GetRoot()->GetNameAtom() );
+    CHECK( first->GetAttributes()->GetNameAtom() ==
+                second->GetAttributes()->GetNameAtom() );
+
+    wxXmlNode copy(*second);
+    CHECK( copy.GetNameAtom() == second->GetNameAtom() );
+    CHECK( copy.GetAttribute("id") == "2" );
+
+    copy.SetName("other");
+    CHECK( copy.GetName() == "other" );
+    CHECK( copy.GetNameAtom() == wxStringAtom("other") );
+}